@@ -0,0 +1,331 @@
+#include <string.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include "xapian-glib.h"
+
+/* Remove a directory and all files directly inside it. */
+static void
+delete_database (const char *dir)
+{
+  GDir *d = g_dir_open (dir, 0, NULL);
+  const char *name;
+
+  while ((name = g_dir_read_name (d)) != NULL)
+    {
+      char *path = g_build_filename (dir, name, NULL);
+
+      g_unlink (path);
+      g_free (path);
+    }
+
+  g_dir_close (d);
+
+  g_rmdir (dir);
+}
+
+/* Adds a document containing the NULL-terminated list of terms */
+static void
+add_terms (XapianWritableDatabase *db,
+           const char             *first_term,
+           ...)
+{
+  GError *error = NULL;
+  XapianDocument *doc = xapian_document_new ();
+  const char *term = first_term;
+  va_list args;
+
+  va_start (args, first_term);
+  while (term != NULL)
+    {
+      xapian_document_add_term (doc, term);
+      term = va_arg (args, const char *);
+    }
+  va_end (args);
+
+  xapian_writable_database_add_document (db, doc, NULL, &error);
+  g_assert_no_error (error);
+  xapian_writable_database_commit (db, &error);
+  g_assert_no_error (error);
+
+  g_object_unref (doc);
+}
+
+static XapianWritableDatabase *
+create_database (const char            *path,
+                 XapianDatabaseBackend  backend)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *db =
+    xapian_writable_database_new_with_backend (path,
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               backend,
+                                               &error);
+  g_assert_no_error (error);
+
+  return db;
+}
+
+/* Returns the inode of @path, which changes every time the index
+ * file is rebuilt, since the file is atomically replaced
+ */
+static guint64
+get_inode (const char *path)
+{
+  GStatBuf buf;
+
+  g_assert_cmpint (g_stat (path, &buf), ==, 0);
+
+  return buf.st_ino;
+}
+
+static void
+completion_index_complete (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *db = create_database ("inmemory", XAPIAN_DATABASE_BACKEND_INMEMORY);
+
+  add_terms (db, "Sxapian", "Sxml", "SXfoo", "xapian", NULL);
+  add_terms (db, "Sxapian", "Sxylophone", NULL);
+  add_terms (db, "Sxapian", "Sxylophone", "Syoda", NULL);
+
+  XapianCompletionIndex *index =
+    xapian_completion_index_new (XAPIAN_DATABASE (db), NULL, "S", 10, &error);
+  g_assert_no_error (error);
+
+  guint32 *freqs = NULL;
+  gsize n_results = 0;
+  char **res = xapian_completion_index_complete (index, "x", 10, &freqs, &n_results);
+
+  /* The prefix is not part of the completions, and terms with a
+   * longer prefix are skipped
+   */
+  g_assert_cmpuint (n_results, ==, 3);
+  g_assert_cmpstr (res[0], ==, "xapian");
+  g_assert_cmpuint (freqs[0], ==, 3);
+  g_assert_cmpstr (res[1], ==, "xylophone");
+  g_assert_cmpuint (freqs[1], ==, 2);
+  g_assert_cmpstr (res[2], ==, "xml");
+  g_assert_cmpuint (freqs[2], ==, 1);
+  g_assert_null (res[3]);
+  g_strfreev (res);
+  g_free (freqs);
+
+  /* The number of results is limited */
+  res = xapian_completion_index_complete (index, "x", 1, NULL, &n_results);
+  g_assert_cmpuint (n_results, ==, 1);
+  g_assert_cmpstr (res[0], ==, "xapian");
+  g_strfreev (res);
+
+  res = xapian_completion_index_complete (index, "xy", 10, NULL, &n_results);
+  g_assert_cmpuint (n_results, ==, 1);
+  g_assert_cmpstr (res[0], ==, "xylophone");
+  g_strfreev (res);
+
+  res = xapian_completion_index_complete (index, "z", 10, NULL, &n_results);
+  g_assert_cmpuint (n_results, ==, 0);
+  g_assert_null (res[0]);
+  g_strfreev (res);
+
+  g_object_unref (index);
+  g_object_unref (db);
+}
+
+static void
+completion_index_empty_prefix (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *db = create_database ("inmemory", XAPIAN_DATABASE_BACKEND_INMEMORY);
+
+  add_terms (db, "Zebra", "Szoo", "zoo", NULL);
+  add_terms (db, "Zebra", NULL);
+
+  /* Without a prefix, the stemmed terms and the terms of the other
+   * prefixes are skipped
+   */
+  XapianCompletionIndex *index =
+    xapian_completion_index_new (XAPIAN_DATABASE (db), NULL, NULL, 10, &error);
+  g_assert_no_error (error);
+
+  gsize n_results = 0;
+  char **res = xapian_completion_index_complete (index, "Z", 10, NULL, &n_results);
+  g_assert_cmpuint (n_results, ==, 0);
+  g_strfreev (res);
+
+  res = xapian_completion_index_complete (index, "", 10, NULL, &n_results);
+  g_assert_cmpuint (n_results, ==, 1);
+  g_assert_cmpstr (res[0], ==, "zoo");
+  g_strfreev (res);
+
+  res = xapian_completion_index_complete (index, "z", 10, NULL, &n_results);
+  g_assert_cmpuint (n_results, ==, 1);
+  g_assert_cmpstr (res[0], ==, "zoo");
+  g_strfreev (res);
+
+  g_object_unref (index);
+  g_object_unref (db);
+}
+
+static void
+completion_index_large_top_k (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *db = create_database ("inmemory", XAPIAN_DATABASE_BACKEND_INMEMORY);
+  XapianDocument *doc = xapian_document_new ();
+
+  for (int i = 0; i < 300; i++)
+    {
+      char *term = g_strdup_printf ("t%03d", i);
+
+      xapian_document_add_term (doc, term);
+      g_free (term);
+    }
+
+  xapian_writable_database_add_document (db, doc, NULL, &error);
+  g_assert_no_error (error);
+  g_object_unref (doc);
+
+  /* The number of completions is not capped at 255 */
+  XapianCompletionIndex *index =
+    xapian_completion_index_new (XAPIAN_DATABASE (db), NULL, NULL, 300, &error);
+  g_assert_no_error (error);
+
+  gsize n_results = 0;
+  char **res = xapian_completion_index_complete (index, "t", 1000, NULL, &n_results);
+  g_assert_cmpuint (n_results, ==, 300);
+  g_assert_cmpstr (res[0], ==, "t000");
+  g_assert_cmpstr (res[299], ==, "t299");
+  g_strfreev (res);
+
+  g_object_unref (index);
+  g_object_unref (db);
+}
+
+static void
+completion_index_refresh (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *writer = create_database ("completion-db", XAPIAN_DATABASE_BACKEND_GLASS);
+
+  add_terms (writer, "Sxapian", NULL);
+
+  XapianDatabase *db = xapian_database_new_with_path ("completion-db", &error);
+  g_assert_no_error (error);
+
+  XapianCompletionIndex *index =
+    xapian_completion_index_new (db, "completion.idx", "S", 10, &error);
+  g_assert_no_error (error);
+
+  guint64 inode = get_inode ("completion.idx");
+
+  /* An up to date index is not rebuilt, and an existing index file
+   * is loaded if it matches the database
+   */
+  g_assert_true (xapian_completion_index_refresh (index, &error));
+  g_assert_no_error (error);
+  g_assert_cmpuint (get_inode ("completion.idx"), ==, inode);
+
+  XapianCompletionIndex *loaded =
+    xapian_completion_index_new (db, "completion.idx", "S", 10, &error);
+  g_assert_no_error (error);
+  g_assert_cmpuint (get_inode ("completion.idx"), ==, inode);
+  g_object_unref (loaded);
+
+  /* The index is not updated until it is refreshed */
+  add_terms (writer, "Sxapian", "Sxml", NULL);
+  xapian_database_reopen (db);
+
+  gsize n_results = 0;
+  char **res = xapian_completion_index_complete (index, "x", 10, NULL, &n_results);
+  g_assert_cmpuint (n_results, ==, 1);
+  g_strfreev (res);
+
+  g_assert_true (xapian_completion_index_refresh (index, &error));
+  g_assert_no_error (error);
+  g_assert_cmpuint (get_inode ("completion.idx"), !=, inode);
+
+  res = xapian_completion_index_complete (index, "x", 10, NULL, &n_results);
+  g_assert_cmpuint (n_results, ==, 2);
+  g_assert_cmpstr (res[0], ==, "xapian");
+  g_assert_cmpstr (res[1], ==, "xml");
+  g_strfreev (res);
+
+  g_object_unref (index);
+  g_object_unref (db);
+  g_object_unref (writer);
+
+  g_unlink ("completion.idx");
+  delete_database ("completion-db");
+}
+
+static void
+completion_index_refresh_shards (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *writer_a = create_database ("completion-db-a", XAPIAN_DATABASE_BACKEND_GLASS);
+  XapianWritableDatabase *writer_b = create_database ("completion-db-b", XAPIAN_DATABASE_BACKEND_GLASS);
+
+  add_terms (writer_a, "Sxapian", NULL);
+  add_terms (writer_b, "Sxml", NULL);
+
+  XapianDatabase *db = xapian_database_new (&error);
+  g_assert_no_error (error);
+
+  XapianDatabase *shard = xapian_database_new_with_path ("completion-db-a", &error);
+  g_assert_no_error (error);
+  xapian_database_add_database (db, shard);
+  g_object_unref (shard);
+
+  shard = xapian_database_new_with_path ("completion-db-b", &error);
+  g_assert_no_error (error);
+  xapian_database_add_database (db, shard);
+  g_object_unref (shard);
+
+  XapianCompletionIndex *index =
+    xapian_completion_index_new (db, "completion-shards.idx", "S", 10, &error);
+  g_assert_no_error (error);
+
+  guint64 inode = get_inode ("completion-shards.idx");
+
+  /* Databases with multiple shards are not rebuilt if no shard changed */
+  g_assert_true (xapian_completion_index_refresh (index, &error));
+  g_assert_no_error (error);
+  g_assert_cmpuint (get_inode ("completion-shards.idx"), ==, inode);
+
+  /* A change in any shard is picked up */
+  add_terms (writer_b, "Sxylophone", NULL);
+  xapian_database_reopen (db);
+
+  g_assert_true (xapian_completion_index_refresh (index, &error));
+  g_assert_no_error (error);
+  g_assert_cmpuint (get_inode ("completion-shards.idx"), !=, inode);
+
+  gsize n_results = 0;
+  char **res = xapian_completion_index_complete (index, "x", 10, NULL, &n_results);
+  g_assert_cmpuint (n_results, ==, 3);
+  g_assert_true (g_strv_contains ((const char * const *) res, "xylophone"));
+  g_strfreev (res);
+
+  g_object_unref (index);
+  g_object_unref (db);
+  g_object_unref (writer_a);
+  g_object_unref (writer_b);
+
+  g_unlink ("completion-shards.idx");
+  delete_database ("completion-db-a");
+  delete_database ("completion-db-b");
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/completion-index/complete", completion_index_complete);
+  g_test_add_func ("/completion-index/empty-prefix", completion_index_empty_prefix);
+  g_test_add_func ("/completion-index/large-top-k", completion_index_large_top_k);
+  g_test_add_func ("/completion-index/refresh", completion_index_refresh);
+  g_test_add_func ("/completion-index/refresh-shards", completion_index_refresh_shards);
+
+  return g_test_run ();
+}
@@ -218,6 +218,463 @@ database_writable_all_terms (void)
   delete_database ("glass-db");
 }
 
+static void
+add_empty_document (XapianWritableDatabase *db)
+{
+  GError *error = NULL;
+  XapianDocument *doc = xapian_document_new ();
+
+  xapian_writable_database_add_document (db, doc, NULL, &error);
+  g_assert_no_error (error);
+  xapian_writable_database_commit (db, &error);
+  g_assert_no_error (error);
+
+  g_object_unref (doc);
+}
+
+static void
+database_searcher_pool (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *writer =
+    xapian_writable_database_new_with_backend ("pool-db",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_GLASS,
+                                               &error);
+
+  g_assert_no_error (error);
+  add_empty_document (writer);
+
+  XapianSearcherPool *pool = xapian_searcher_pool_new ("pool-db", 2, &error);
+  g_assert_no_error (error);
+  g_assert_cmpuint (xapian_searcher_pool_get_size (pool), ==, 2);
+
+  XapianSearcher *a = xapian_searcher_pool_acquire (pool, NULL, &error);
+  g_assert_no_error (error);
+  XapianSearcher *b = xapian_searcher_pool_acquire (pool, NULL, &error);
+  g_assert_no_error (error);
+
+  g_assert_true (xapian_searcher_get_database (a) != xapian_searcher_get_database (b));
+  g_assert_nonnull (xapian_searcher_get_enquire (a));
+  g_assert_nonnull (xapian_searcher_get_query_parser (a));
+  g_assert_cmpuint (xapian_searcher_pool_get_n_in_use (pool), ==, 2);
+  g_assert_null (xapian_searcher_pool_try_acquire (pool));
+
+  /* A cancelled acquisition fails instead of blocking, and is not
+   * counted as a wait
+   */
+  GCancellable *cancellable = g_cancellable_new ();
+  g_cancellable_cancel (cancellable);
+  g_assert_null (xapian_searcher_pool_acquire (pool, cancellable, &error));
+  g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+  g_clear_error (&error);
+  g_object_unref (cancellable);
+
+  g_assert_cmpuint (xapian_searcher_pool_get_n_waited (pool), ==, 0);
+
+  XapianQueryParser *parser = g_object_ref (xapian_searcher_get_query_parser (b));
+  xapian_query_parser_add_prefix (parser, "title", "S");
+
+  xapian_searcher_release (b);
+  g_assert_null (xapian_searcher_get_database (b));
+  g_assert_cmpuint (xapian_searcher_pool_get_n_in_use (pool), ==, 1);
+  g_object_unref (b);
+  g_assert_cmpuint (xapian_searcher_pool_get_n_in_use (pool), ==, 1);
+
+  /* The next user does not see the configuration of the query parser */
+  b = xapian_searcher_pool_try_acquire (pool);
+  g_assert_nonnull (b);
+  g_assert_nonnull (xapian_searcher_get_query_parser (b));
+  g_assert_true (xapian_searcher_get_query_parser (b) != parser);
+  g_object_unref (b);
+  g_object_unref (parser);
+
+  g_assert_cmpuint (xapian_database_get_doc_count (xapian_searcher_get_database (a)), ==, 1);
+
+  add_empty_document (writer);
+  xapian_searcher_pool_reopen (pool);
+  g_object_unref (a);
+
+  /* The databases are reopened in the background */
+  gint64 end_time = g_get_monotonic_time () + 10 * G_TIME_SPAN_SECOND;
+  unsigned int doc_count = 0;
+
+  while (doc_count != 2 && g_get_monotonic_time () < end_time)
+    {
+      XapianSearcher *searcher = xapian_searcher_pool_acquire (pool, NULL, &error);
+      g_assert_no_error (error);
+
+      doc_count = xapian_database_get_doc_count (xapian_searcher_get_database (searcher));
+      g_object_unref (searcher);
+
+      if (doc_count != 2)
+        g_usleep (G_USEC_PER_SEC / 100);
+    }
+
+  g_assert_cmpuint (doc_count, ==, 2);
+
+  g_assert_cmpuint (xapian_searcher_pool_get_n_in_use (pool), ==, 0);
+  g_assert_cmpuint (xapian_searcher_pool_get_peak_in_use (pool), ==, 2);
+  g_assert_cmpuint (xapian_searcher_pool_get_n_acquired (pool), >=, 4);
+  g_assert_cmpuint (xapian_searcher_pool_get_n_waited (pool), ==, 0);
+
+  g_object_unref (pool);
+  g_object_unref (writer);
+
+  delete_database ("pool-db");
+}
+
+static void
+database_handle (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *writer =
+    xapian_writable_database_new_with_backend ("handle-db",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_GLASS,
+                                               &error);
+
+  g_assert_no_error (error);
+  add_empty_document (writer);
+
+  XapianDatabaseHandle *handle = xapian_database_handle_new ("handle-db", &error);
+  g_assert_no_error (error);
+  g_assert_cmpstr (xapian_database_handle_get_path (handle), ==, "handle-db");
+
+  XapianDatabase *old_db = xapian_database_handle_acquire (handle, &error);
+  g_assert_no_error (error);
+  g_object_add_weak_pointer (G_OBJECT (old_db), (gpointer *) &old_db);
+
+  /* Concurrent readers get their own database at the same revision */
+  XapianDatabase *db = xapian_database_handle_acquire (handle, &error);
+  g_assert_no_error (error);
+  g_assert_true (db != old_db);
+  g_assert_cmpuint (xapian_database_get_revision (db), ==,
+                    xapian_database_get_revision (old_db));
+
+  XapianDatabase *idle_db = db;
+  xapian_database_handle_release (handle, db);
+
+  /* Reopening without changes keeps the released databases */
+  g_assert_true (xapian_database_handle_reopen (handle, &error));
+  g_assert_no_error (error);
+
+  db = xapian_database_handle_acquire (handle, &error);
+  g_assert_no_error (error);
+  g_assert_true (db == idle_db);
+  xapian_database_handle_release (handle, db);
+
+  add_empty_document (writer);
+  g_assert_true (xapian_database_handle_reopen (handle, &error));
+  g_assert_no_error (error);
+
+  /* Readers of the old revision are not affected by the reopen */
+  db = xapian_database_handle_acquire (handle, &error);
+  g_assert_no_error (error);
+  g_assert_true (db != old_db);
+  g_assert_cmpuint (xapian_database_get_doc_count (old_db), ==, 1);
+  g_assert_cmpuint (xapian_database_get_doc_count (db), ==, 2);
+  xapian_database_handle_release (handle, db);
+
+  /* Databases at an old revision are closed once released */
+  xapian_database_handle_release (handle, old_db);
+  g_assert_null (old_db);
+
+  g_object_unref (handle);
+  g_object_unref (writer);
+
+  delete_database ("handle-db");
+}
+
+#define N_READER_THREADS        4
+#define N_READS                 200
+#define N_REOPENS               5
+
+typedef struct {
+  XapianDatabaseHandle *handle;
+
+  /* The databases currently used by a reader */
+  GMutex lock;
+  GHashTable *in_use;
+} HandleThreadsData;
+
+static gpointer
+handle_reader_thread (gpointer user_data)
+{
+  HandleThreadsData *data = user_data;
+  guint last_count = 0;
+
+  for (int i = 0; i < N_READS; i++)
+    {
+      GError *error = NULL;
+      XapianDatabase *db = xapian_database_handle_acquire (data->handle, &error);
+      g_assert_no_error (error);
+
+      /* No other reader is using the same database */
+      g_mutex_lock (&data->lock);
+      g_assert_false (g_hash_table_contains (data->in_use, db));
+      g_hash_table_add (data->in_use, db);
+      g_mutex_unlock (&data->lock);
+
+      /* Readers never go back to an older revision */
+      guint count = xapian_database_get_doc_count (db);
+      g_assert_cmpuint (count, >=, last_count);
+      last_count = count;
+
+      g_mutex_lock (&data->lock);
+      g_hash_table_remove (data->in_use, db);
+      g_mutex_unlock (&data->lock);
+
+      xapian_database_handle_release (data->handle, db);
+    }
+
+  return NULL;
+}
+
+static void
+database_handle_threads (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *writer =
+    xapian_writable_database_new_with_backend ("handle-threads-db",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_GLASS,
+                                               &error);
+
+  g_assert_no_error (error);
+  add_empty_document (writer);
+
+  HandleThreadsData data;
+
+  data.handle = xapian_database_handle_new ("handle-threads-db", &error);
+  g_assert_no_error (error);
+  g_mutex_init (&data.lock);
+  data.in_use = g_hash_table_new (NULL, NULL);
+
+  GThread *threads[N_READER_THREADS];
+
+  for (int i = 0; i < N_READER_THREADS; i++)
+    threads[i] = g_thread_new ("reader", handle_reader_thread, &data);
+
+  /* Publish new revisions while the readers are running */
+  for (int i = 0; i < N_REOPENS; i++)
+    {
+      add_empty_document (writer);
+      g_assert_true (xapian_database_handle_reopen (data.handle, &error));
+      g_assert_no_error (error);
+    }
+
+  for (int i = 0; i < N_READER_THREADS; i++)
+    g_thread_join (threads[i]);
+
+  g_assert_cmpuint (g_hash_table_size (data.in_use), ==, 0);
+
+  XapianDatabase *db = xapian_database_handle_acquire (data.handle, &error);
+  g_assert_no_error (error);
+  g_assert_cmpuint (xapian_database_get_doc_count (db), ==, N_REOPENS + 1);
+  xapian_database_handle_release (data.handle, db);
+
+  g_hash_table_unref (data.in_use);
+  g_mutex_clear (&data.lock);
+  g_object_unref (data.handle);
+  g_object_unref (writer);
+
+  delete_database ("handle-threads-db");
+}
+
+#define N_FILLER_KEYS   2000
+
+/* Sets "key" to "value-@round", and rewrites enough metadata to need
+ * multiple levels of blocks, so that a reader has to load blocks from
+ * the disk to find a key; each commit frees all the blocks of the
+ * previous revisions, and the following commits recycle them
+ */
+static void
+commit_metadata (XapianWritableDatabase *writer,
+                 int                     round)
+{
+  GError *error = NULL;
+  char *filler = g_strnfill (200, 'a' + round);
+  char *value = g_strdup_printf ("value-%d", round);
+
+  for (int i = 0; i < N_FILLER_KEYS; i++)
+    {
+      char *key = g_strdup_printf ("filler-%04d", i);
+
+      xapian_writable_database_set_metadata (writer, key, filler);
+      g_free (key);
+    }
+
+  xapian_writable_database_set_metadata (writer, "key", value);
+  xapian_writable_database_commit (writer, &error);
+  g_assert_no_error (error);
+
+  g_free (value);
+  g_free (filler);
+}
+
+static void
+database_reopen_retries (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *writer =
+    xapian_writable_database_new_with_backend ("retries-db",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_GLASS,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  commit_metadata (writer, 0);
+
+  XapianDatabase *db = xapian_database_new_with_path ("retries-db", &error);
+  g_assert_no_error (error);
+  g_assert_cmpuint (xapian_database_get_max_reopen_retries (db), ==, 0);
+
+  xapian_database_set_max_reopen_retries (db, 3);
+  g_assert_cmpuint (xapian_database_get_max_reopen_retries (db), ==, 3);
+
+  XapianDatabase *stale = xapian_database_new_with_path ("retries-db", &error);
+  g_assert_no_error (error);
+
+  /* Recycle the revision the readers were opened at */
+  for (int i = 1; i <= 3; i++)
+    commit_metadata (writer, i);
+
+  /* Without retries, the error is reported */
+  char *value = xapian_database_get_metadata (stale, "key", &error);
+  g_assert_error (error, XAPIAN_ERROR, XAPIAN_ERROR_DATABASE_MODIFIED);
+  g_assert_null (value);
+  g_clear_error (&error);
+
+  /* With retries, the database is reopened at the latest revision */
+  value = xapian_database_get_metadata (db, "key", &error);
+  g_assert_no_error (error);
+  g_assert_cmpstr (value, ==, "value-3");
+  g_free (value);
+
+  g_object_unref (stale);
+  g_object_unref (db);
+  g_object_unref (writer);
+
+  delete_database ("retries-db");
+}
+
+static void
+on_revision_changed (XapianDatabase *db,
+                     guint64         revision,
+                     gpointer        user_data)
+{
+  guint64 *res = user_data;
+
+  *res = revision;
+}
+
+static void
+database_monitor (void)
+{
+  GError *error = NULL;
+
+  /* Databases without a path cannot be monitored */
+  XapianDatabase *empty = xapian_database_new (&error);
+  g_assert_no_error (error);
+  g_assert_false (xapian_database_start_monitor (empty, &error));
+  g_assert_error (error, XAPIAN_ERROR, XAPIAN_ERROR_INVALID_OPERATION);
+  g_clear_error (&error);
+  g_object_unref (empty);
+
+  XapianWritableDatabase *writer =
+    xapian_writable_database_new_with_backend ("monitor-db",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_GLASS,
+                                               &error);
+
+  g_assert_no_error (error);
+  add_empty_document (writer);
+
+  XapianDatabase *db = xapian_database_new_with_path ("monitor-db", &error);
+  g_assert_no_error (error);
+
+  guint64 revision = 0;
+  g_signal_connect (db, "revision-changed", G_CALLBACK (on_revision_changed), &revision);
+
+  g_assert_true (xapian_database_start_monitor (db, &error));
+  g_assert_no_error (error);
+
+  add_empty_document (writer);
+
+  gint64 end_time = g_get_monotonic_time () + 10 * G_TIME_SPAN_SECOND;
+
+  while (revision == 0 && g_get_monotonic_time () < end_time)
+    g_main_context_iteration (NULL, FALSE);
+
+  g_assert_cmpuint (revision, >, 1);
+
+  /* The database is not reopened automatically */
+  g_assert_cmpuint (xapian_database_get_doc_count (db), ==, 1);
+  xapian_database_reopen (db);
+  g_assert_cmpuint (xapian_database_get_doc_count (db), ==, 2);
+
+  xapian_database_stop_monitor (db);
+
+  g_object_unref (db);
+  g_object_unref (writer);
+
+  delete_database ("monitor-db");
+}
+
+static void
+database_snapshot (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *writer =
+    xapian_writable_database_new_with_backend ("snapshot-db",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_GLASS,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  commit_metadata (writer, 0);
+  add_empty_document (writer);
+
+  guint64 revision = xapian_database_get_revision (XAPIAN_DATABASE (writer));
+  g_assert_cmpuint (revision, >, 0);
+
+  XapianDatabaseSnapshot *snapshot = xapian_database_snapshot_new ("snapshot-db", &error);
+  g_assert_no_error (error);
+  g_assert_true (XAPIAN_IS_DATABASE (snapshot));
+
+  XapianDatabase *db = XAPIAN_DATABASE (snapshot);
+  g_assert_cmpuint (xapian_database_get_revision (db), ==, revision);
+
+  /* Retries never move a snapshot to a newer revision */
+  xapian_database_set_max_reopen_retries (db, 3);
+
+  for (int i = 1; i <= 3; i++)
+    {
+      commit_metadata (writer, i);
+      add_empty_document (writer);
+    }
+
+  g_assert_cmpuint (xapian_database_get_revision (XAPIAN_DATABASE (writer)), >, revision);
+  g_assert_cmpuint (xapian_database_get_revision (db), ==, revision);
+  g_assert_cmpuint (xapian_database_get_doc_count (db), ==, 1);
+
+  /* The revision of the snapshot has been recycled */
+  char *value = xapian_database_get_metadata (db, "key", &error);
+  g_assert_error (error, XAPIAN_ERROR, XAPIAN_ERROR_REVISION_UNAVAILABLE);
+  g_assert_null (value);
+  g_clear_error (&error);
+
+  g_assert_cmpuint (xapian_database_get_revision (db), ==, revision);
+
+  g_object_unref (snapshot);
+  g_object_unref (writer);
+
+  delete_database ("snapshot-db");
+}
+
 int
 main (int   argc,
       char *argv[])
@@ -230,6 +687,12 @@ main (int   argc,
   g_test_add_func ("/database/writable/backend/glass", database_writable_backend_glass);
   g_test_add_func ("/database/writable/flags/no-termlist", database_writable_flags_no_termlist);
   g_test_add_func ("/database/writable/all_terms", database_writable_all_terms);
+  g_test_add_func ("/database/searcher-pool", database_searcher_pool);
+  g_test_add_func ("/database/handle", database_handle);
+  g_test_add_func ("/database/handle/threads", database_handle_threads);
+  g_test_add_func ("/database/reopen-retries", database_reopen_retries);
+  g_test_add_func ("/database/monitor", database_monitor);
+  g_test_add_func ("/database/snapshot", database_snapshot);
 
   return g_test_run ();
 }
@@ -0,0 +1,237 @@
+#include <string.h>
+#include <glib.h>
+#include "xapian-glib.h"
+
+/* Each document is indexed with its own terms, plus the terms of the
+ * "topic" it belongs to
+ */
+static const char *documents[][4] = {
+  { "rebel", "luke", "xwing", NULL },
+  { "rebel", "leia", "xwing", NULL },
+  { "rebel", "han", "falcon", NULL },
+  { "empire", "vader", "tie", NULL },
+  { "empire", "tarkin", "tie", NULL },
+};
+
+static XapianWritableDatabase *
+create_database (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  for (unsigned int i = 0; i < G_N_ELEMENTS (documents); i++)
+    {
+      XapianDocument *doc = xapian_document_new ();
+
+      for (unsigned int j = 0; documents[i][j] != NULL; j++)
+        xapian_document_add_term (doc, documents[i][j]);
+
+      xapian_writable_database_add_document (db, doc, NULL, &error);
+      g_assert_no_error (error);
+
+      g_object_unref (doc);
+    }
+
+  return db;
+}
+
+static void
+enquire_rset (void)
+{
+  const guint32 docids[] = { 1, 2, 2 };
+  XapianRSet *rset = xapian_rset_new_for_docids (docids, G_N_ELEMENTS (docids));
+
+  g_assert_nonnull (rset);
+  g_assert_cmpuint (xapian_rset_get_size (rset), ==, 2);
+  g_assert_true (xapian_rset_contains (rset, 1));
+  g_assert_true (xapian_rset_contains (rset, 2));
+  g_assert_false (xapian_rset_contains (rset, 3));
+
+  xapian_rset_add_document (rset, 3);
+  xapian_rset_remove_document (rset, 1);
+  g_assert_cmpuint (xapian_rset_get_size (rset), ==, 2);
+  g_assert_false (xapian_rset_contains (rset, 1));
+  g_assert_true (xapian_rset_contains (rset, 3));
+
+  xapian_rset_remove_document (rset, 2);
+  xapian_rset_remove_document (rset, 3);
+  g_assert_true (xapian_rset_is_empty (rset));
+
+  g_object_unref (rset);
+}
+
+static void
+enquire_rset_invalid_docid (void)
+{
+  if (g_test_subprocess ())
+    {
+      const guint32 docids[] = { 1, 0 };
+
+      g_assert_null (xapian_rset_new_for_docids (docids, G_N_ELEMENTS (docids)));
+      return;
+    }
+
+  g_test_trap_subprocess (NULL, 0, 0);
+  g_test_trap_assert_failed ();
+  g_test_trap_assert_stderr ("*docids[i] != 0*");
+}
+
+static void
+enquire_eset (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *db = create_database ();
+  XapianEnquire *enquire = xapian_enquire_new (XAPIAN_DATABASE (db), &error);
+
+  g_assert_no_error (error);
+
+  XapianQuery *query = xapian_query_new_for_term ("luke");
+  xapian_enquire_set_query (enquire, query, 0);
+
+  const guint32 docids[] = { 1, 2 };
+  XapianRSet *rset = xapian_rset_new_for_docids (docids, G_N_ELEMENTS (docids));
+  XapianESet *eset = xapian_enquire_get_eset (enquire, 10, rset,
+                                              XAPIAN_EXPAND_FLAGS_NONE,
+                                              &error);
+
+  g_assert_no_error (error);
+  g_assert_false (xapian_eset_is_empty (eset));
+
+  /* The terms shared by both relevant documents come first */
+  char **terms = xapian_eset_get_terms (eset);
+  gsize n_weights = 0;
+  double *weights = xapian_eset_get_weights (eset, &n_weights);
+
+  g_assert_cmpuint (g_strv_length (terms), ==, xapian_eset_get_size (eset));
+  g_assert_cmpuint (n_weights, ==, xapian_eset_get_size (eset));
+  g_assert_true (g_strv_contains ((const char * const *) terms, "rebel"));
+  g_assert_true (g_strv_contains ((const char * const *) terms, "xwing"));
+  g_assert_false (g_strv_contains ((const char * const *) terms, "luke"));
+  g_assert_false (g_strv_contains ((const char * const *) terms, "empire"));
+
+  for (gsize i = 1; i < n_weights; i++)
+    g_assert_cmpfloat (weights[i - 1], >=, weights[i]);
+
+  char *first = xapian_eset_get_term (eset, 0);
+  g_assert_cmpstr (first, ==, terms[0]);
+  g_assert_cmpfloat (xapian_eset_get_weight (eset, 0), ==, weights[0]);
+  g_assert_null (xapian_eset_get_term (eset, n_weights));
+  g_free (first);
+
+  g_free (weights);
+  g_strfreev (terms);
+  g_object_unref (eset);
+
+  /* Query terms are only included when asked to */
+  eset = xapian_enquire_get_eset (enquire, 10, rset,
+                                  XAPIAN_EXPAND_FLAGS_INCLUDE_QUERY_TERMS,
+                                  &error);
+  g_assert_no_error (error);
+
+  terms = xapian_eset_get_terms (eset);
+  g_assert_true (g_strv_contains ((const char * const *) terms, "luke"));
+  g_strfreev (terms);
+  g_object_unref (eset);
+
+  /* Related documents do not cross the topics */
+  XapianMSet *mset = xapian_enquire_get_related_mset (enquire, rset, 2,
+                                                      XAPIAN_QUERY_OP_OR,
+                                                      0, 10,
+                                                      &error);
+  g_assert_no_error (error);
+  g_assert_cmpuint (xapian_mset_get_size (mset), ==, 3);
+  g_object_unref (mset);
+
+  g_object_unref (rset);
+  g_object_unref (query);
+  g_object_unref (enquire);
+  g_object_unref (db);
+}
+
+static void
+enquire_matching_terms (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *db = create_database ();
+  XapianEnquire *enquire = xapian_enquire_new (XAPIAN_DATABASE (db), &error);
+
+  g_assert_no_error (error);
+
+  const char *query_terms[] = { "xwing", "tie", "rebel", "luke", NULL };
+  XapianQuery *query = xapian_query_new_for_terms (XAPIAN_QUERY_OP_OR, query_terms);
+  xapian_enquire_set_query (enquire, query, 0);
+
+  /* The terms are in query order */
+  char **terms = xapian_enquire_get_matching_terms (enquire, 1, &error);
+  g_assert_no_error (error);
+  g_assert_cmpuint (g_strv_length (terms), ==, 3);
+  g_assert_cmpstr (terms[0], ==, "xwing");
+  g_assert_cmpstr (terms[1], ==, "rebel");
+  g_assert_cmpstr (terms[2], ==, "luke");
+  g_strfreev (terms);
+
+  /* Missing documents are reported as errors */
+  terms = xapian_enquire_get_matching_terms (enquire, 100, &error);
+  g_assert_error (error, XAPIAN_ERROR, XAPIAN_ERROR_DOC_NOT_FOUND);
+  g_assert_null (terms);
+  g_clear_error (&error);
+
+  XapianMSet *mset = xapian_enquire_get_mset (enquire, 0, 10, &error);
+  g_assert_no_error (error);
+
+  GVariant *matches = xapian_enquire_get_matching_terms_for_mset (enquire, mset, &error);
+  g_assert_no_error (error);
+  g_assert_false (g_variant_is_floating (matches));
+  g_assert_cmpstr (g_variant_get_type_string (matches), ==, "a(uas)");
+  g_assert_cmpuint (g_variant_n_children (matches), ==, xapian_mset_get_size (mset));
+
+  XapianMSetIterator *iter = xapian_mset_get_begin (mset);
+  gsize i = 0;
+
+  while (xapian_mset_iterator_next (iter))
+    {
+      unsigned int docid = xapian_mset_iterator_get_doc_id (iter, NULL);
+      unsigned int match_docid = 0;
+      const char **match_terms = NULL;
+
+      g_variant_get_child (matches, i++, "(u^a&s)", &match_docid, &match_terms);
+      g_assert_cmpuint (match_docid, ==, docid);
+
+      terms = xapian_enquire_get_matching_terms (enquire, docid, &error);
+      g_assert_no_error (error);
+      g_assert_cmpuint (g_strv_length ((char **) match_terms), ==, g_strv_length (terms));
+
+      for (unsigned int j = 0; terms[j] != NULL; j++)
+        g_assert_cmpstr (match_terms[j], ==, terms[j]);
+
+      g_strfreev (terms);
+      g_free (match_terms);
+    }
+
+  g_object_unref (iter);
+  g_variant_unref (matches);
+  g_object_unref (mset);
+  g_object_unref (query);
+  g_object_unref (enquire);
+  g_object_unref (db);
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/enquire/rset", enquire_rset);
+  g_test_add_func ("/enquire/rset/invalid-docid", enquire_rset_invalid_docid);
+  g_test_add_func ("/enquire/eset", enquire_eset);
+  g_test_add_func ("/enquire/matching-terms", enquire_matching_terms);
+
+  return g_test_run ();
+}
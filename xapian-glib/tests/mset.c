@@ -0,0 +1,173 @@
+#include <string.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include "xapian-glib.h"
+
+/* Remove a directory and all files directly inside it. */
+static void
+delete_database (const char *dir)
+{
+  GDir *d = g_dir_open (dir, 0, NULL);
+  const char *name;
+
+  while ((name = g_dir_read_name (d)) != NULL)
+    {
+      char *path = g_build_filename (dir, name, NULL);
+
+      g_unlink (path);
+      g_free (path);
+    }
+
+  g_dir_close (d);
+
+  g_rmdir (dir);
+}
+
+static void
+add_document (XapianWritableDatabase *db,
+              unsigned int            docid,
+              const char             *data)
+{
+  GError *error = NULL;
+  XapianDocument *doc = xapian_document_new ();
+  XapianTermGenerator *generator = xapian_term_generator_new ();
+
+  xapian_term_generator_set_document (generator, doc);
+  xapian_term_generator_index_text (generator, data);
+  xapian_document_set_data (doc, data);
+
+  xapian_writable_database_replace_document (db, docid, doc, &error);
+  g_assert_no_error (error);
+  xapian_writable_database_commit (db, &error);
+  g_assert_no_error (error);
+
+  g_object_unref (generator);
+  g_object_unref (doc);
+}
+
+static char **
+get_snippets (XapianDatabase     *db,
+              const char         *term,
+              const char         *hi_start,
+              XapianSnippetCache *cache)
+{
+  GError *error = NULL;
+  XapianEnquire *enquire = xapian_enquire_new (db, &error);
+  g_assert_no_error (error);
+
+  XapianQuery *query = xapian_query_new_for_term (term);
+  xapian_enquire_set_query (enquire, query, 0);
+
+  XapianMSet *mset = xapian_enquire_get_mset (enquire, 0, 10, &error);
+  g_assert_no_error (error);
+
+  char **res = xapian_mset_get_snippets (mset, 100, NULL,
+                                         XAPIAN_SNIPPET_FLAGS_NONE,
+                                         hi_start, NULL, NULL,
+                                         cache,
+                                         &error);
+  g_assert_no_error (error);
+
+  g_object_unref (mset);
+  g_object_unref (query);
+  g_object_unref (enquire);
+
+  return res;
+}
+
+static void
+mset_snippets_cache (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *writer =
+    xapian_writable_database_new_with_backend ("snippets-db",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_GLASS,
+                                               &error);
+  g_assert_no_error (error);
+
+  add_document (writer, 1, "the rebels steal the plans");
+  add_document (writer, 2, "the empire builds a station");
+
+  XapianDatabase *db = xapian_database_new_with_path ("snippets-db", &error);
+  g_assert_no_error (error);
+
+  XapianSnippetCache *cache = xapian_snippet_cache_new (16);
+  char **snippets = get_snippets (db, "rebels", NULL, cache);
+
+  g_assert_cmpuint (g_strv_length (snippets), ==, 1);
+  g_assert_cmpstr (snippets[0], ==, "the <b>rebels</b> steal the plans");
+  g_assert_cmpuint (xapian_snippet_cache_get_size (cache), ==, 1);
+  g_strfreev (snippets);
+
+  /* The same query and arguments hit the cache */
+  snippets = get_snippets (db, "rebels", NULL, cache);
+  g_assert_cmpstr (snippets[0], ==, "the <b>rebels</b> steal the plans");
+  g_assert_cmpuint (xapian_snippet_cache_get_size (cache), ==, 1);
+  g_strfreev (snippets);
+
+  /* Different arguments and different queries do not */
+  snippets = get_snippets (db, "rebels", "<em>", cache);
+  g_assert_cmpstr (snippets[0], ==, "the <em>rebels</b> steal the plans");
+  g_assert_cmpuint (xapian_snippet_cache_get_size (cache), ==, 2);
+  g_strfreev (snippets);
+
+  snippets = get_snippets (db, "plans", NULL, cache);
+  g_assert_cmpstr (snippets[0], ==, "the rebels steal the <b>plans</b>");
+  g_assert_cmpuint (xapian_snippet_cache_get_size (cache), ==, 3);
+  g_strfreev (snippets);
+
+  /* A new revision of the database does not see stale snippets */
+  add_document (writer, 1, "the rebels lose the plans");
+  xapian_database_reopen (db);
+
+  snippets = get_snippets (db, "rebels", NULL, cache);
+  g_assert_cmpstr (snippets[0], ==, "the <b>rebels</b> lose the plans");
+  g_assert_cmpuint (xapian_snippet_cache_get_size (cache), ==, 4);
+  g_strfreev (snippets);
+
+  g_object_unref (cache);
+  g_object_unref (db);
+  g_object_unref (writer);
+
+  delete_database ("snippets-db");
+}
+
+static void
+mset_snippets_no_revision (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+  g_assert_no_error (error);
+
+  add_document (db, 1, "the rebels steal the plans");
+
+  /* In-memory databases change without a new revision, so their
+   * snippets are never cached
+   */
+  XapianSnippetCache *cache = xapian_snippet_cache_new (16);
+  char **snippets = get_snippets (XAPIAN_DATABASE (db), "rebels", NULL, cache);
+
+  g_assert_cmpstr (snippets[0], ==, "the <b>rebels</b> steal the plans");
+  g_assert_cmpuint (xapian_snippet_cache_get_size (cache), ==, 0);
+  g_strfreev (snippets);
+
+  g_object_unref (cache);
+  g_object_unref (db);
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/mset/snippets/cache", mset_snippets_cache);
+  g_test_add_func ("/mset/snippets/no-revision", mset_snippets_no_revision);
+
+  return g_test_run ();
+}
@@ -0,0 +1,917 @@
+#include <math.h>
+#include <glib/gstdio.h>
+
+#include "xapian-glib.h"
+
+#define N_DOCS  20
+
+/* A posting source returning the even documents, weighted by their
+ * identifier, a few at a time
+ */
+typedef struct {
+  XapianPostingSource parent_instance;
+
+  unsigned int n_blocks;
+} EvenPostingSource;
+
+typedef struct {
+  XapianPostingSourceClass parent_class;
+} EvenPostingSourceClass;
+
+G_DEFINE_TYPE (EvenPostingSource, even_posting_source, XAPIAN_TYPE_POSTING_SOURCE)
+
+static void
+even_posting_source_init_source (XapianPostingSource *source,
+                                 XapianDatabase      *database)
+{
+  EvenPostingSource *self = (EvenPostingSource *) source;
+
+  g_assert_true (XAPIAN_IS_DATABASE (database));
+  g_assert_cmpint (xapian_database_get_doc_count (database), ==, N_DOCS);
+
+  self->n_blocks = 0;
+
+  xapian_posting_source_set_max_weight (source, N_DOCS);
+}
+
+static gsize
+even_posting_source_next_block (XapianPostingSource *source,
+                                unsigned int         first_docid,
+                                double               min_weight,
+                                guint32             *docids,
+                                double              *weights,
+                                gsize                max_entries)
+{
+  EvenPostingSource *self = (EvenPostingSource *) source;
+  gsize n = 0;
+
+  self->n_blocks += 1;
+
+  for (unsigned int docid = first_docid; docid <= N_DOCS && n < MIN (max_entries, 3); docid++)
+    {
+      if (docid % 2 != 0)
+        continue;
+
+      docids[n] = docid;
+      weights[n] = docid;
+      n += 1;
+    }
+
+  return n;
+}
+
+static void
+even_posting_source_class_init (EvenPostingSourceClass *klass)
+{
+  XapianPostingSourceClass *source_class = XAPIAN_POSTING_SOURCE_CLASS (klass);
+
+  source_class->init = even_posting_source_init_source;
+  source_class->next_block = even_posting_source_next_block;
+}
+
+static void
+even_posting_source_init (EvenPostingSource *self)
+{
+}
+
+/* A posting source returning the documents with an identifier
+ * multiple of three, weighted by their identifier, one at a time
+ */
+typedef struct {
+  XapianPostingSource parent_instance;
+
+  XapianDatabase *database;
+  unsigned int docid;
+  unsigned int n_docs;
+
+  unsigned int n_inits;
+  unsigned int n_skip_to;
+  unsigned int n_check;
+} ThirdPostingSource;
+
+typedef struct {
+  XapianPostingSourceClass parent_class;
+} ThirdPostingSourceClass;
+
+G_DEFINE_TYPE (ThirdPostingSource, third_posting_source, XAPIAN_TYPE_POSTING_SOURCE)
+
+static void
+third_posting_source_init_source (XapianPostingSource *source,
+                                  XapianDatabase      *database)
+{
+  ThirdPostingSource *self = (ThirdPostingSource *) source;
+
+  /* The same database wrapper is used for every search */
+  if (self->database != NULL)
+    g_assert_true (self->database == database);
+
+  self->database = database;
+  self->n_docs = xapian_database_get_doc_count (database);
+  self->docid = 0;
+  self->n_inits += 1;
+
+  xapian_posting_source_set_max_weight (source, self->n_docs);
+}
+
+static void
+third_posting_source_skip_to (XapianPostingSource *source,
+                              unsigned int         docid,
+                              double               min_weight)
+{
+  ThirdPostingSource *self = (ThirdPostingSource *) source;
+
+  self->n_skip_to += 1;
+
+  if (docid <= self->docid)
+    return;
+
+  self->docid = ((docid + 2) / 3) * 3;
+}
+
+static void
+third_posting_source_next (XapianPostingSource *source,
+                           double               min_weight)
+{
+  ThirdPostingSource *self = (ThirdPostingSource *) source;
+
+  self->docid = (self->docid / 3 + 1) * 3;
+}
+
+static gboolean
+third_posting_source_check (XapianPostingSource *source,
+                            unsigned int         docid,
+                            double               min_weight)
+{
+  ThirdPostingSource *self = (ThirdPostingSource *) source;
+
+  self->n_check += 1;
+
+  if (docid % 3 != 0)
+    {
+      /* Leave the source on a document before the next match */
+      self->docid = docid;
+      return FALSE;
+    }
+
+  self->docid = docid;
+
+  return TRUE;
+}
+
+static gboolean
+third_posting_source_at_end (XapianPostingSource *source)
+{
+  ThirdPostingSource *self = (ThirdPostingSource *) source;
+
+  return self->docid > self->n_docs;
+}
+
+static unsigned int
+third_posting_source_get_docid (XapianPostingSource *source)
+{
+  return ((ThirdPostingSource *) source)->docid;
+}
+
+static double
+third_posting_source_get_weight (XapianPostingSource *source)
+{
+  return ((ThirdPostingSource *) source)->docid;
+}
+
+static void
+third_posting_source_get_termfreqs (XapianPostingSource *source,
+                                    unsigned int        *termfreq_min,
+                                    unsigned int        *termfreq_est,
+                                    unsigned int        *termfreq_max)
+{
+  ThirdPostingSource *self = (ThirdPostingSource *) source;
+
+  /* Overestimate, so that the matcher checks the posting source
+   * against the terms, instead of iterating it
+   */
+  *termfreq_min = self->n_docs / 3;
+  *termfreq_est = *termfreq_max = self->n_docs;
+}
+
+static void
+third_posting_source_class_init (ThirdPostingSourceClass *klass)
+{
+  XapianPostingSourceClass *source_class = XAPIAN_POSTING_SOURCE_CLASS (klass);
+
+  source_class->init = third_posting_source_init_source;
+  source_class->next = third_posting_source_next;
+  source_class->skip_to = third_posting_source_skip_to;
+  source_class->check = third_posting_source_check;
+  source_class->at_end = third_posting_source_at_end;
+  source_class->get_docid = third_posting_source_get_docid;
+  source_class->get_weight = third_posting_source_get_weight;
+  source_class->get_termfreqs = third_posting_source_get_termfreqs;
+}
+
+static void
+third_posting_source_init (ThirdPostingSource *self)
+{
+}
+
+static void
+posting_source_next_block (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  for (unsigned int i = 0; i < N_DOCS; i++)
+    {
+      XapianDocument *doc = xapian_document_new ();
+
+      xapian_writable_database_add_document (db, doc, NULL, &error);
+      g_assert_no_error (error);
+
+      g_object_unref (doc);
+    }
+
+  XapianPostingSource *source = g_object_new (even_posting_source_get_type (), NULL);
+  XapianQuery *query = xapian_query_new_from_posting_source (source);
+  XapianEnquire *enquire = xapian_enquire_new (XAPIAN_DATABASE (db), &error);
+
+  g_assert_no_error (error);
+
+  xapian_enquire_set_query (enquire, query, 0);
+
+  XapianMSet *mset = xapian_enquire_get_mset (enquire, 0, N_DOCS, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpint (xapian_mset_get_size (mset), ==, N_DOCS / 2);
+  g_assert_cmpint (((EvenPostingSource *) source)->n_blocks, >, 1);
+
+  XapianMSetIterator *iter = xapian_mset_get_begin (mset);
+  unsigned int expected = N_DOCS;
+
+  while (xapian_mset_iterator_next (iter))
+    {
+      g_assert_cmpint (xapian_mset_iterator_get_doc_id (iter, NULL), ==, expected);
+      g_assert_cmpfloat (xapian_mset_iterator_get_weight (iter), ==, expected);
+      expected -= 2;
+    }
+
+  g_object_unref (iter);
+  g_object_unref (mset);
+  g_object_unref (enquire);
+  g_object_unref (query);
+  g_object_unref (source);
+  g_object_unref (db);
+}
+
+static void
+posting_source_next (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  for (unsigned int i = 1; i <= N_DOCS; i++)
+    {
+      XapianDocument *doc = xapian_document_new ();
+
+      if (i % 2 == 0)
+        xapian_document_add_term (doc, "even");
+
+      xapian_writable_database_add_document (db, doc, NULL, &error);
+      g_assert_no_error (error);
+
+      g_object_unref (doc);
+    }
+
+  ThirdPostingSource *source = g_object_new (third_posting_source_get_type (), NULL);
+  XapianQuery *query = xapian_query_new_from_posting_source (XAPIAN_POSTING_SOURCE (source));
+  XapianEnquire *enquire = xapian_enquire_new (XAPIAN_DATABASE (db), &error);
+
+  g_assert_no_error (error);
+
+  /* On its own, the posting source is iterated with next() */
+  xapian_enquire_set_query (enquire, query, 0);
+
+  XapianMSet *mset = xapian_enquire_get_mset (enquire, 0, N_DOCS, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpint (xapian_mset_get_size (mset), ==, N_DOCS / 3);
+
+  XapianMSetIterator *iter = xapian_mset_get_begin (mset);
+  unsigned int expected = (N_DOCS / 3) * 3;
+
+  while (xapian_mset_iterator_next (iter))
+    {
+      g_assert_cmpint (xapian_mset_iterator_get_doc_id (iter, NULL), ==, expected);
+      g_assert_cmpfloat (xapian_mset_iterator_get_weight (iter), ==, expected);
+      expected -= 3;
+    }
+
+  g_object_unref (iter);
+  g_object_unref (mset);
+
+  /* Filtered by a rarer term, the matcher uses skip_to() and check() */
+  XapianQuery *even = xapian_query_new_for_term ("even");
+  XapianQuery *both = xapian_query_new_for_pair (XAPIAN_QUERY_OP_FILTER, query, even);
+
+  xapian_enquire_set_query (enquire, both, 0);
+
+  mset = xapian_enquire_get_mset (enquire, 0, N_DOCS, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpint (xapian_mset_get_size (mset), ==, N_DOCS / 6);
+  g_assert_cmpint (source->n_inits, ==, 2);
+  g_assert_cmpint (source->n_skip_to + source->n_check, >, 0);
+
+  iter = xapian_mset_get_begin (mset);
+  expected = (N_DOCS / 6) * 6;
+
+  while (xapian_mset_iterator_next (iter))
+    {
+      g_assert_cmpint (xapian_mset_iterator_get_doc_id (iter, NULL), ==, expected);
+      g_assert_cmpfloat (xapian_mset_iterator_get_weight (iter), ==, expected);
+      expected -= 6;
+    }
+
+  g_object_unref (iter);
+  g_object_unref (mset);
+  g_object_unref (both);
+  g_object_unref (even);
+  g_object_unref (enquire);
+  g_object_unref (query);
+  g_object_unref (source);
+  g_object_unref (db);
+}
+
+static void
+posting_source_static_weight (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  for (unsigned int i = 1; i <= N_DOCS; i++)
+    {
+      XapianDocument *doc = xapian_document_new ();
+
+      /* Only the documents with an even identifier have a weight */
+      if (i % 2 == 0)
+        xapian_document_add_numeric_value (doc, 0, i);
+
+      xapian_writable_database_add_document (db, doc, NULL, &error);
+      g_assert_no_error (error);
+
+      g_object_unref (doc);
+    }
+
+  char *tmpdir = g_dir_make_tmp ("xapian-glib-XXXXXX", &error);
+  g_assert_no_error (error);
+
+  char *path = g_build_filename (tmpdir, "weights", NULL);
+
+  xapian_static_weight_posting_source_build_from_slot (XAPIAN_DATABASE (db), 0, path, &error);
+  g_assert_no_error (error);
+
+  XapianStaticWeightPostingSource *source =
+    xapian_static_weight_posting_source_new (path, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpfloat (xapian_posting_source_get_max_weight (XAPIAN_POSTING_SOURCE (source)), ==, N_DOCS);
+
+  XapianQuery *query = xapian_query_new_from_posting_source (XAPIAN_POSTING_SOURCE (source));
+  XapianEnquire *enquire = xapian_enquire_new (XAPIAN_DATABASE (db), &error);
+
+  g_assert_no_error (error);
+
+  xapian_enquire_set_query (enquire, query, 0);
+
+  XapianMSet *mset = xapian_enquire_get_mset (enquire, 0, N_DOCS, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpint (xapian_mset_get_size (mset), ==, N_DOCS / 2);
+
+  XapianMSetIterator *iter = xapian_mset_get_begin (mset);
+  unsigned int expected = N_DOCS;
+
+  while (xapian_mset_iterator_next (iter))
+    {
+      g_assert_cmpint (xapian_mset_iterator_get_doc_id (iter, NULL), ==, expected);
+      g_assert_cmpfloat (xapian_mset_iterator_get_weight (iter), ==, expected);
+      expected -= 2;
+    }
+
+  g_object_unref (iter);
+  g_object_unref (mset);
+
+  /* Removed documents are skipped, even if the file has their weight */
+  xapian_writable_database_delete_document (db, N_DOCS, &error);
+  g_assert_no_error (error);
+
+  mset = xapian_enquire_get_mset (enquire, 0, N_DOCS, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpint (xapian_mset_get_size (mset), ==, N_DOCS / 2 - 1);
+
+  iter = xapian_mset_get_begin (mset);
+  g_assert_true (xapian_mset_iterator_next (iter));
+  g_assert_cmpint (xapian_mset_iterator_get_doc_id (iter, NULL), ==, N_DOCS - 2);
+
+  g_object_unref (iter);
+  g_object_unref (mset);
+  g_object_unref (enquire);
+  g_object_unref (query);
+  g_object_unref (source);
+  g_object_unref (db);
+
+  g_unlink (path);
+  g_rmdir (tmpdir);
+  g_free (path);
+  g_free (tmpdir);
+}
+
+static void
+posting_source_fixed_weight (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  for (unsigned int i = 1; i <= N_DOCS; i++)
+    {
+      XapianDocument *doc = xapian_document_new ();
+
+      if (i % 2 == 0)
+        xapian_document_add_term (doc, "even");
+
+      xapian_writable_database_add_document (db, doc, NULL, &error);
+      g_assert_no_error (error);
+
+      g_object_unref (doc);
+    }
+
+  XapianFixedWeightPostingSource *source =
+    xapian_fixed_weight_posting_source_new (2.5, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpfloat (xapian_fixed_weight_posting_source_get_weight (source), ==, 2.5);
+
+  XapianQuery *query = xapian_query_new_from_posting_source (XAPIAN_POSTING_SOURCE (source));
+  XapianEnquire *enquire = xapian_enquire_new (XAPIAN_DATABASE (db), &error);
+
+  g_assert_no_error (error);
+
+  /* Every document matches, with the same weight, so they are
+   * sorted by identifier
+   */
+  xapian_enquire_set_query (enquire, query, 0);
+
+  XapianMSet *mset = xapian_enquire_get_mset (enquire, 0, N_DOCS, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpint (xapian_mset_get_size (mset), ==, N_DOCS);
+
+  XapianMSetIterator *iter = xapian_mset_get_begin (mset);
+  unsigned int expected = 1;
+
+  while (xapian_mset_iterator_next (iter))
+    {
+      g_assert_cmpint (xapian_mset_iterator_get_doc_id (iter, NULL), ==, expected);
+      g_assert_cmpfloat (xapian_mset_iterator_get_weight (iter), ==, 2.5);
+      expected += 1;
+    }
+
+  g_object_unref (iter);
+  g_object_unref (mset);
+
+  /* Filtered by a term, only the matching documents are returned */
+  XapianQuery *even = xapian_query_new_for_term ("even");
+  XapianQuery *filtered = xapian_query_new_for_pair (XAPIAN_QUERY_OP_FILTER, query, even);
+
+  xapian_enquire_set_query (enquire, filtered, 0);
+
+  mset = xapian_enquire_get_mset (enquire, 0, N_DOCS, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpint (xapian_mset_get_size (mset), ==, N_DOCS / 2);
+
+  iter = xapian_mset_get_begin (mset);
+  expected = 2;
+
+  while (xapian_mset_iterator_next (iter))
+    {
+      g_assert_cmpint (xapian_mset_iterator_get_doc_id (iter, NULL), ==, expected);
+      g_assert_cmpfloat (xapian_mset_iterator_get_weight (iter), ==, 2.5);
+      expected += 2;
+    }
+
+  g_object_unref (iter);
+  g_object_unref (mset);
+  g_object_unref (filtered);
+  g_object_unref (even);
+  g_object_unref (enquire);
+  g_object_unref (query);
+  g_object_unref (source);
+  g_object_unref (db);
+}
+
+static void
+posting_source_decreasing_value_weight (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  /* The weights decrease with the document identifier */
+  for (unsigned int i = 1; i <= N_DOCS; i++)
+    {
+      XapianDocument *doc = xapian_document_new ();
+
+      xapian_document_add_numeric_value (doc, 0, N_DOCS - i + 1);
+      xapian_writable_database_add_document (db, doc, NULL, &error);
+      g_assert_no_error (error);
+
+      g_object_unref (doc);
+    }
+
+  XapianDecreasingValueWeightPostingSource *source =
+    xapian_decreasing_value_weight_posting_source_new (0, 1, N_DOCS, &error);
+
+  g_assert_no_error (error);
+
+  XapianQuery *query = xapian_query_new_from_posting_source (XAPIAN_POSTING_SOURCE (source));
+  XapianEnquire *enquire = xapian_enquire_new (XAPIAN_DATABASE (db), &error);
+
+  g_assert_no_error (error);
+
+  xapian_enquire_set_query (enquire, query, 0);
+
+  /* Asking for the top results lets the matcher stop early */
+  XapianMSet *mset = xapian_enquire_get_mset (enquire, 0, 5, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpint (xapian_mset_get_size (mset), ==, 5);
+
+  XapianMSetIterator *iter = xapian_mset_get_begin (mset);
+  unsigned int expected = 1;
+
+  while (xapian_mset_iterator_next (iter))
+    {
+      g_assert_cmpint (xapian_mset_iterator_get_doc_id (iter, NULL), ==, expected);
+      g_assert_cmpfloat (xapian_mset_iterator_get_weight (iter), ==, N_DOCS - expected + 1);
+      expected += 1;
+    }
+
+  g_object_unref (iter);
+  g_object_unref (mset);
+
+  mset = xapian_enquire_get_mset (enquire, 0, N_DOCS, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpint (xapian_mset_get_size (mset), ==, N_DOCS);
+
+  iter = xapian_mset_get_begin (mset);
+  expected = 1;
+
+  while (xapian_mset_iterator_next (iter))
+    {
+      g_assert_cmpint (xapian_mset_iterator_get_doc_id (iter, NULL), ==, expected);
+      g_assert_cmpfloat (xapian_mset_iterator_get_weight (iter), ==, N_DOCS - expected + 1);
+      expected += 1;
+    }
+
+  g_object_unref (iter);
+  g_object_unref (mset);
+  g_object_unref (enquire);
+  g_object_unref (query);
+  g_object_unref (source);
+  g_object_unref (db);
+}
+
+static void
+posting_source_value_map (void)
+{
+  static const char *colors[] = { "red", "green", "blue" };
+  GError *error = NULL;
+  XapianWritableDatabase *db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  for (unsigned int i = 1; i <= N_DOCS; i++)
+    {
+      XapianDocument *doc = xapian_document_new ();
+
+      xapian_document_add_value (doc, 0, colors[i % 3]);
+      xapian_writable_database_add_document (db, doc, NULL, &error);
+      g_assert_no_error (error);
+
+      g_object_unref (doc);
+    }
+
+  XapianValueMapPostingSource *source =
+    xapian_value_map_posting_source_new (0, &error);
+
+  g_assert_no_error (error);
+
+  /* Unmapped values use the default weight */
+  xapian_value_map_posting_source_add_mapping (source, "red", 3.0);
+  xapian_value_map_posting_source_add_mapping (source, "green", 2.0);
+  xapian_value_map_posting_source_set_default_weight (source, 1.0);
+
+  XapianQuery *query = xapian_query_new_from_posting_source (XAPIAN_POSTING_SOURCE (source));
+  XapianEnquire *enquire = xapian_enquire_new (XAPIAN_DATABASE (db), &error);
+
+  g_assert_no_error (error);
+
+  xapian_enquire_set_query (enquire, query, 0);
+
+  XapianMSet *mset = xapian_enquire_get_mset (enquire, 0, N_DOCS, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpint (xapian_mset_get_size (mset), ==, N_DOCS);
+
+  XapianMSetIterator *iter = xapian_mset_get_begin (mset);
+  unsigned int last_docid = 0;
+  double last_weight = 3.0;
+
+  /* The results are sorted by weight, and then by identifier */
+  while (xapian_mset_iterator_next (iter))
+    {
+      unsigned int docid = xapian_mset_iterator_get_doc_id (iter, NULL);
+      double weight = xapian_mset_iterator_get_weight (iter);
+
+      g_assert_cmpfloat (weight, ==, 3.0 - docid % 3);
+
+      if (weight == last_weight)
+        g_assert_cmpint (docid, >, last_docid);
+      else
+        g_assert_cmpfloat (weight, <, last_weight);
+
+      last_docid = docid;
+      last_weight = weight;
+    }
+
+  g_object_unref (iter);
+  g_object_unref (mset);
+
+  /* Without mappings, every document has the default weight */
+  xapian_value_map_posting_source_clear_mappings (source);
+
+  mset = xapian_enquire_get_mset (enquire, 0, N_DOCS, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpint (xapian_mset_get_size (mset), ==, N_DOCS);
+
+  iter = xapian_mset_get_begin (mset);
+
+  while (xapian_mset_iterator_next (iter))
+    g_assert_cmpfloat (xapian_mset_iterator_get_weight (iter), ==, 1.0);
+
+  g_object_unref (iter);
+  g_object_unref (mset);
+  g_object_unref (enquire);
+  g_object_unref (query);
+  g_object_unref (source);
+  g_object_unref (db);
+}
+
+static void
+posting_source_recency (void)
+{
+  const double now = 1500000000;
+  const double half_life = 3600;
+  GError *error = NULL;
+  XapianWritableDatabase *db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  /* Each document is one half-life older than the previous one */
+  for (unsigned int i = 0; i < 4; i++)
+    {
+      XapianDocument *doc = xapian_document_new ();
+
+      xapian_document_add_numeric_value (doc, 0, now - i * half_life);
+      xapian_writable_database_add_document (db, doc, NULL, &error);
+      g_assert_no_error (error);
+
+      g_object_unref (doc);
+    }
+
+  XapianRecencyPostingSource *source =
+    xapian_recency_posting_source_new (0, XAPIAN_DECAY_FUNCTION_EXPONENTIAL,
+                                       now, half_life, 8.0,
+                                       &error);
+
+  g_assert_no_error (error);
+
+  XapianQuery *query = xapian_query_new_from_posting_source (XAPIAN_POSTING_SOURCE (source));
+  XapianEnquire *enquire = xapian_enquire_new (XAPIAN_DATABASE (db), &error);
+
+  g_assert_no_error (error);
+
+  xapian_enquire_set_query (enquire, query, 0);
+
+  XapianMSet *mset = xapian_enquire_get_mset (enquire, 0, 10, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpint (xapian_mset_get_size (mset), ==, 4);
+
+  XapianMSetIterator *iter = xapian_mset_get_begin (mset);
+  unsigned int expected = 1;
+  double weight = 8.0;
+
+  while (xapian_mset_iterator_next (iter))
+    {
+      g_assert_cmpint (xapian_mset_iterator_get_doc_id (iter, NULL), ==, expected);
+      g_assert_cmpfloat (fabs (xapian_mset_iterator_get_weight (iter) - weight), <, 1e-9);
+      expected += 1;
+      weight /= 2;
+    }
+
+  g_object_unref (iter);
+  g_object_unref (mset);
+  g_object_unref (enquire);
+  g_object_unref (query);
+  g_object_unref (source);
+
+  /* The linear decay reaches half the scale after one half-life; the
+   * documents are half of the new half-life apart
+   */
+  source = xapian_recency_posting_source_new (0, XAPIAN_DECAY_FUNCTION_LINEAR,
+                                              now, 2 * half_life, 8.0,
+                                              &error);
+
+  g_assert_no_error (error);
+
+  query = xapian_query_new_from_posting_source (XAPIAN_POSTING_SOURCE (source));
+  enquire = xapian_enquire_new (XAPIAN_DATABASE (db), &error);
+
+  g_assert_no_error (error);
+
+  xapian_enquire_set_query (enquire, query, 0);
+
+  mset = xapian_enquire_get_mset (enquire, 0, 10, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpint (xapian_mset_get_size (mset), ==, 4);
+
+  iter = xapian_mset_get_begin (mset);
+  expected = 1;
+  weight = 8.0;
+
+  while (xapian_mset_iterator_next (iter))
+    {
+      g_assert_cmpint (xapian_mset_iterator_get_doc_id (iter, NULL), ==, expected);
+      g_assert_cmpfloat (fabs (xapian_mset_iterator_get_weight (iter) - weight), <, 1e-9);
+      expected += 1;
+      weight -= 2.0;
+    }
+
+  g_object_unref (iter);
+  g_object_unref (mset);
+  g_object_unref (enquire);
+  g_object_unref (query);
+  g_object_unref (source);
+  g_object_unref (db);
+}
+
+static void
+posting_source_lat_long_distance (void)
+{
+  /* Coordinates of documents at increasing distance from the centre */
+  const double coords[][2] = {
+    { 51.5, -0.12 },
+    { 51.52, -0.12 },
+    { 51.55, -0.12 },
+    { 48.85, 2.35 },
+  };
+  GError *error = NULL;
+  XapianWritableDatabase *db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  for (unsigned int i = 0; i < G_N_ELEMENTS (coords); i++)
+    {
+      XapianDocument *doc = xapian_document_new ();
+      XapianLatLongCoords *doc_coords =
+        xapian_lat_long_coords_new_for_coord (coords[i][0], coords[i][1]);
+
+      xapian_document_add_lat_long_coords (doc, 0, doc_coords);
+      xapian_writable_database_add_document (db, doc, NULL, &error);
+      g_assert_no_error (error);
+
+      g_object_unref (doc_coords);
+      g_object_unref (doc);
+    }
+
+  XapianLatLongCoords *centre = xapian_lat_long_coords_new_for_coord (51.5, -0.12);
+
+  /* Paris is further than 10km from the centre */
+  XapianLatLongDistancePostingSource *source =
+    xapian_lat_long_distance_posting_source_new (0, centre, 10000, &error);
+
+  g_assert_no_error (error);
+
+  XapianQuery *query = xapian_query_new_from_posting_source (XAPIAN_POSTING_SOURCE (source));
+  XapianEnquire *enquire = xapian_enquire_new (XAPIAN_DATABASE (db), &error);
+
+  g_assert_no_error (error);
+
+  xapian_enquire_set_query (enquire, query, 0);
+
+  XapianMSet *mset = xapian_enquire_get_mset (enquire, 0, 10, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpint (xapian_mset_get_size (mset), ==, 3);
+
+  XapianMSetIterator *iter = xapian_mset_get_begin (mset);
+  unsigned int expected = 1;
+
+  while (xapian_mset_iterator_next (iter))
+    g_assert_cmpint (xapian_mset_iterator_get_doc_id (iter, NULL), ==, expected++);
+
+  g_object_unref (iter);
+  g_object_unref (mset);
+
+  /* Sorting by distance, furthest first, includes every document */
+  XapianLatLongDistanceKeyMaker *sorter =
+    xapian_lat_long_distance_key_maker_new (0, centre, G_MAXDOUBLE);
+  XapianQuery *all = xapian_query_new_match_all ();
+
+  xapian_enquire_set_query (enquire, all, 0);
+  xapian_enquire_set_sort_by_key (enquire, XAPIAN_KEY_MAKER (sorter), TRUE);
+
+  mset = xapian_enquire_get_mset (enquire, 0, 10, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpint (xapian_mset_get_size (mset), ==, 4);
+
+  iter = xapian_mset_get_begin (mset);
+  expected = 4;
+
+  while (xapian_mset_iterator_next (iter))
+    g_assert_cmpint (xapian_mset_iterator_get_doc_id (iter, NULL), ==, expected--);
+
+  g_object_unref (iter);
+  g_object_unref (mset);
+  g_object_unref (all);
+  g_object_unref (sorter);
+  g_object_unref (enquire);
+  g_object_unref (query);
+  g_object_unref (source);
+  g_object_unref (centre);
+  g_object_unref (db);
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/posting-source/next", posting_source_next);
+  g_test_add_func ("/posting-source/next-block", posting_source_next_block);
+  g_test_add_func ("/posting-source/static-weight", posting_source_static_weight);
+  g_test_add_func ("/posting-source/fixed-weight", posting_source_fixed_weight);
+  g_test_add_func ("/posting-source/decreasing-value-weight", posting_source_decreasing_value_weight);
+  g_test_add_func ("/posting-source/value-map", posting_source_value_map);
+  g_test_add_func ("/posting-source/recency", posting_source_recency);
+  g_test_add_func ("/posting-source/lat-long-distance", posting_source_lat_long_distance);
+
+  return g_test_run ();
+}
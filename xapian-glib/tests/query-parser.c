@@ -1,6 +1,50 @@
+#include <string.h>
 #include <glib.h>
 #include "xapian-glib.h"
 
+typedef struct {
+  XapianFieldProcessor parent_instance;
+} TestFieldProcessor;
+
+typedef struct {
+  XapianFieldProcessorClass parent_class;
+} TestFieldProcessorClass;
+
+GType test_field_processor_get_type (void);
+
+G_DEFINE_TYPE (TestFieldProcessor, test_field_processor, XAPIAN_TYPE_FIELD_PROCESSOR)
+
+static XapianQuery *
+test_field_processor_process (XapianFieldProcessor  *self,
+                              const char            *value,
+                              GError               **error)
+{
+  if (strcmp (value, "error") == 0)
+    {
+      g_set_error_literal (error, XAPIAN_ERROR, XAPIAN_ERROR_INVALID_ARGUMENT,
+                           "Invalid custom value");
+      return NULL;
+    }
+
+  char *term = g_strconcat ("XCUSTOM", value, NULL);
+  XapianQuery *res = xapian_query_new_for_term (term);
+
+  g_free (term);
+
+  return res;
+}
+
+static void
+test_field_processor_class_init (TestFieldProcessorClass *klass)
+{
+  XAPIAN_FIELD_PROCESSOR_CLASS (klass)->process = test_field_processor_process;
+}
+
+static void
+test_field_processor_init (TestFieldProcessor *self)
+{
+}
+
 static void
 query_parser_default (void)
 {
@@ -22,6 +66,241 @@ query_parser_set_default_op (void)
   g_object_unref (query_parser);
 }
 
+static void
+query_parser_range_processors (void)
+{
+  XapianQueryParser *query_parser = xapian_query_parser_new ();
+  XapianNumberRangeProcessor *price =
+    xapian_number_range_processor_new (1, "price:", XAPIAN_RANGE_PROCESSOR_FLAGS_NONE);
+  XapianDateRangeProcessor *date =
+    xapian_date_range_processor_new (2, NULL, XAPIAN_RANGE_PROCESSOR_FLAGS_NONE, 1970);
+  GError *error = NULL;
+
+  xapian_query_parser_add_range_processor (query_parser, XAPIAN_RANGE_PROCESSOR (price), NULL);
+  xapian_query_parser_add_range_processor (query_parser, XAPIAN_RANGE_PROCESSOR (date), NULL);
+
+  XapianQuery *query = xapian_query_parser_parse_query (query_parser, "price:10..50", &error);
+  char *desc = xapian_query_get_description (query);
+
+  g_assert_no_error (error);
+  g_assert_nonnull (strstr (desc, "VALUE_RANGE 1"));
+
+  g_free (desc);
+  g_object_unref (query);
+
+  query = xapian_query_parser_parse_query (query_parser, "2024-01-01..2024-06-30", &error);
+  desc = xapian_query_get_description (query);
+
+  g_assert_no_error (error);
+  g_assert_cmpstr (desc, ==, "Query(VALUE_RANGE 2 20240101 20240630)");
+
+  g_free (desc);
+  g_object_unref (query);
+  g_object_unref (date);
+  g_object_unref (price);
+  g_object_unref (query_parser);
+}
+
+static void
+query_parser_field_processors (void)
+{
+  XapianQueryParser *query_parser = xapian_query_parser_new ();
+  XapianTermFieldProcessor *id = xapian_term_field_processor_new ("Q", FALSE);
+  XapianTermFieldProcessor *tag = xapian_term_field_processor_new ("K", TRUE);
+  XapianNumberFieldProcessor *year = xapian_number_field_processor_new (3);
+  XapianFieldProcessor *custom = g_object_new (test_field_processor_get_type (), NULL);
+  GError *error = NULL;
+
+  xapian_query_parser_add_field_processor (query_parser, "id", XAPIAN_FIELD_PROCESSOR (id), TRUE);
+  xapian_query_parser_add_field_processor (query_parser, "tag", XAPIAN_FIELD_PROCESSOR (tag), TRUE);
+  xapian_query_parser_add_field_processor (query_parser, "year", XAPIAN_FIELD_PROCESSOR (year), TRUE);
+  xapian_query_parser_add_field_processor (query_parser, "custom", custom, FALSE);
+
+  XapianQuery *query = xapian_query_parser_parse_query (query_parser, "id:AbC-12", &error);
+  char *desc = xapian_query_get_description (query);
+
+  g_assert_no_error (error);
+  g_assert_cmpstr (desc, ==, "Query(0 * QAbC-12)");
+  g_free (desc);
+  g_object_unref (query);
+
+  query = xapian_query_parser_parse_query (query_parser, "tag:Fiction", &error);
+  desc = xapian_query_get_description (query);
+
+  g_assert_no_error (error);
+  g_assert_cmpstr (desc, ==, "Query(0 * Kfiction)");
+  g_free (desc);
+  g_object_unref (query);
+
+  query = xapian_query_parser_parse_query (query_parser, "year:1980..1989", &error);
+  desc = xapian_query_get_description (query);
+
+  g_assert_no_error (error);
+  g_assert_nonnull (strstr (desc, "VALUE_RANGE 3"));
+  g_free (desc);
+  g_object_unref (query);
+
+  query = xapian_query_parser_parse_query (query_parser, "custom:droid", &error);
+  desc = xapian_query_get_description (query);
+
+  g_assert_no_error (error);
+  g_assert_cmpstr (desc, ==, "Query(XCUSTOMdroid)");
+  g_free (desc);
+  g_object_unref (query);
+
+  /* Errors in custom processors make the parsing fail */
+  query = xapian_query_parser_parse_query (query_parser, "custom:error", &error);
+
+  g_assert_error (error, XAPIAN_ERROR, XAPIAN_ERROR_QUERY_PARSER);
+  g_assert_null (query);
+  g_clear_error (&error);
+
+  query = xapian_field_processor_process (XAPIAN_FIELD_PROCESSOR (custom), "error", &error);
+
+  g_assert_error (error, XAPIAN_ERROR, XAPIAN_ERROR_QUERY_PARSER);
+  g_assert_null (query);
+  g_clear_error (&error);
+
+  static const char *invalid_numbers[] = {
+    "many", " 1984", "1984 ", "nan", "inf", "-infinity", "0x7c0", "1e999",
+  };
+
+  for (unsigned int i = 0; i < G_N_ELEMENTS (invalid_numbers); i++)
+    {
+      query = xapian_field_processor_process (XAPIAN_FIELD_PROCESSOR (year),
+                                              invalid_numbers[i],
+                                              &error);
+
+      g_assert_error (error, XAPIAN_ERROR, XAPIAN_ERROR_QUERY_PARSER);
+      g_assert_null (query);
+      g_clear_error (&error);
+    }
+
+  query = xapian_field_processor_process (XAPIAN_FIELD_PROCESSOR (year), "-1.5e3..+2E3", &error);
+
+  g_assert_no_error (error);
+  g_assert_nonnull (query);
+  g_object_unref (query);
+
+  g_object_unref (custom);
+  g_object_unref (year);
+  g_object_unref (tag);
+  g_object_unref (id);
+  g_object_unref (query_parser);
+}
+
+static const char *fruit_documents[] = {
+  "apple", "apple avocado", "apple", "apricot", "avocado",
+};
+
+static XapianWritableDatabase *
+create_fruit_database (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  for (unsigned int i = 0; i < G_N_ELEMENTS (fruit_documents); i++)
+    {
+      XapianDocument *doc = xapian_document_new ();
+      char **terms = g_strsplit (fruit_documents[i], " ", -1);
+
+      for (unsigned int j = 0; terms[j] != NULL; j++)
+        xapian_document_add_term (doc, terms[j]);
+
+      xapian_writable_database_add_document (db, doc, NULL, &error);
+      g_assert_no_error (error);
+
+      g_strfreev (terms);
+      g_object_unref (doc);
+    }
+
+  return db;
+}
+
+/* Returns a bitmask of the documents matching "a*" */
+static unsigned int
+match_wildcard (XapianDatabase      *db,
+                unsigned int         max_expansion,
+                XapianWildcardLimit  limit,
+                GError             **error)
+{
+  XapianQueryParser *query_parser = xapian_query_parser_new ();
+
+  xapian_query_parser_set_database (query_parser, db);
+  xapian_query_parser_set_max_expansion (query_parser, max_expansion, limit,
+                                         XAPIAN_QUERY_PARSER_FEATURE_WILDCARD);
+
+  XapianQuery *query =
+    xapian_query_parser_parse_query_full (query_parser, "a*",
+                                          XAPIAN_QUERY_PARSER_FEATURE_WILDCARD,
+                                          NULL,
+                                          error);
+  g_assert_nonnull (query);
+
+  XapianEnquire *enquire = xapian_enquire_new (db, NULL);
+  xapian_enquire_set_query (enquire, query, 0);
+
+  unsigned int res = 0;
+  XapianMSet *mset = xapian_enquire_get_mset (enquire, 0, 10, error);
+
+  if (mset != NULL)
+    {
+      XapianMSetIterator *iter = xapian_mset_get_begin (mset);
+
+      while (xapian_mset_iterator_next (iter))
+        res |= 1 << xapian_mset_iterator_get_doc_id (iter, NULL);
+
+      g_object_unref (iter);
+      g_object_unref (mset);
+    }
+
+  g_object_unref (enquire);
+  g_object_unref (query);
+  g_object_unref (query_parser);
+
+  return res;
+}
+
+static void
+query_parser_max_expansion (void)
+{
+  XapianWritableDatabase *db = create_fruit_database ();
+  GError *error = NULL;
+
+  /* No limit: apple, apricot and avocado */
+  g_assert_cmphex (match_wildcard (XAPIAN_DATABASE (db), 0, XAPIAN_WILDCARD_LIMIT_ERROR, &error),
+                   ==, 0x3e);
+  g_assert_no_error (error);
+
+  /* The limit is not exceeded */
+  g_assert_cmphex (match_wildcard (XAPIAN_DATABASE (db), 3, XAPIAN_WILDCARD_LIMIT_ERROR, &error),
+                   ==, 0x3e);
+  g_assert_no_error (error);
+
+  g_assert_cmphex (match_wildcard (XAPIAN_DATABASE (db), 2, XAPIAN_WILDCARD_LIMIT_ERROR, &error),
+                   ==, 0);
+  g_assert_error (error, XAPIAN_ERROR, XAPIAN_ERROR_WILDCARD);
+  g_clear_error (&error);
+
+  /* apple and apricot */
+  g_assert_cmphex (match_wildcard (XAPIAN_DATABASE (db), 2, XAPIAN_WILDCARD_LIMIT_FIRST, &error),
+                   ==, 0x1e);
+  g_assert_no_error (error);
+
+  /* apple and avocado */
+  g_assert_cmphex (match_wildcard (XAPIAN_DATABASE (db), 2, XAPIAN_WILDCARD_LIMIT_MOST_FREQUENT, &error),
+                   ==, 0x2e);
+  g_assert_no_error (error);
+
+  g_object_unref (db);
+}
+
 int
 main (int   argc,
       char *argv[])
@@ -30,6 +309,11 @@ main (int   argc,
 
   g_test_add_func ("/query-parser/default", query_parser_default);
   g_test_add_func ("/query-parser/set-default-op", query_parser_set_default_op);
+  g_test_add_func ("/query-parser/max-expansion", query_parser_max_expansion);
+
+  g_test_add_func ("/query-parser/range-processors", query_parser_range_processors);
+
+  g_test_add_func ("/query-parser/field-processors", query_parser_field_processors);
 
   return g_test_run ();
 }
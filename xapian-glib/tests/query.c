@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include "xapian-glib.h"
 
 static void
@@ -31,6 +33,54 @@ query_new_for_queries (void)
   g_slist_free_full (queries, g_object_unref);
 }
 
+static void
+query_new_for_terms_full (void)
+{
+  const char *terms[] = { "han", "chewie", "lando" };
+  const unsigned int wqfs[] = { 1, 2, 1 };
+  const unsigned int positions[] = { 1, 2, 3 };
+  g_autoptr(XapianQuery) q =
+    xapian_query_new_for_terms_full (XAPIAN_QUERY_OP_OR, terms, wqfs, positions,
+                                     G_N_ELEMENTS (terms));
+
+  g_assert_nonnull (q);
+  g_assert_cmpint (xapian_query_get_length (q), ==, 4);
+  g_assert_cmpstr (xapian_query_get_description (q), ==,
+                   "Query((han@1 OR chewie#2@2 OR lando@3))");
+}
+
+static void
+query_new_for_query_array (void)
+{
+  g_autoptr(GPtrArray) queries = g_ptr_array_new_with_free_func (g_object_unref);
+
+  g_ptr_array_add (queries, xapian_query_new_match_all ());
+  g_ptr_array_add (queries, xapian_query_new_for_term ("leia"));
+  g_ptr_array_add (queries, xapian_query_new_for_term ("luke"));
+
+  g_autoptr(XapianQuery) q = xapian_query_new_for_query_array (XAPIAN_QUERY_OP_AND_NOT, queries);
+
+  g_assert_nonnull (q);
+  g_assert_cmpint (xapian_query_get_length (q), ==, 3);
+  g_assert_cmpstr (xapian_query_get_description (q), ==,
+                   "Query((<alldocuments> AND_NOT leia AND_NOT luke))");
+}
+
+static void
+query_new_for_prefixed_terms (void)
+{
+  const char *terms[] = {
+    "rebel", "jedi", NULL,
+  };
+  g_autoptr(XapianQuery) q =
+    xapian_query_new_for_prefixed_terms (XAPIAN_QUERY_OP_SYNONYM, "XTAG", terms);
+
+  g_assert_nonnull (q);
+  g_assert_cmpint (xapian_query_get_length (q), ==, 2);
+  g_assert_cmpstr (xapian_query_get_description (q), ==,
+                   "Query((XTAGrebel SYNONYM XTAGjedi))");
+}
+
 static void
 query_new_wildcard (void)
 {
@@ -41,6 +91,235 @@ query_new_wildcard (void)
                    "Query(WILDCARD SYNONYM darth)");
 }
 
+static void
+query_new_for_docids (void)
+{
+  const guint32 docids[] = { 9, 2, 5, 100, 5, 7 };
+  g_autoptr(GError) error = NULL;
+  g_autoptr(XapianWritableDatabase) db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  for (unsigned int i = 0; i < 10; i++)
+    {
+      g_autoptr(XapianDocument) doc = xapian_document_new ();
+
+      xapian_writable_database_add_document (db, doc, NULL, &error);
+      g_assert_no_error (error);
+    }
+
+  /* Documents that do not exist are not matched */
+  xapian_writable_database_delete_document (db, 7, &error);
+  g_assert_no_error (error);
+
+  g_autoptr(XapianQuery) all = xapian_query_new_match_all ();
+  g_autoptr(XapianQuery) allowed = xapian_query_new_for_docids (docids, G_N_ELEMENTS (docids));
+  g_autoptr(XapianQuery) filtered = xapian_query_new_for_pair (XAPIAN_QUERY_OP_FILTER, all, allowed);
+  g_autoptr(XapianEnquire) enquire = xapian_enquire_new (XAPIAN_DATABASE (db), &error);
+
+  g_assert_no_error (error);
+
+  const guint32 expected[] = { 2, 5, 9 };
+
+  XapianQuery *queries[] = { allowed, filtered };
+
+  for (unsigned int i = 0; i < G_N_ELEMENTS (queries); i++)
+    {
+      xapian_enquire_set_query (enquire, queries[i], 0);
+
+      g_autoptr(XapianMSet) mset = xapian_enquire_get_mset (enquire, 0, 10, &error);
+
+      g_assert_no_error (error);
+      g_assert_cmpint (xapian_mset_get_size (mset), ==, G_N_ELEMENTS (expected));
+
+      /* All documents have the same weight, so they are sorted by identifier */
+      g_autoptr(XapianMSetIterator) iter = xapian_mset_get_begin (mset);
+      unsigned int j = 0;
+
+      while (xapian_mset_iterator_next (iter))
+        g_assert_cmpint (xapian_mset_iterator_get_doc_id (iter, NULL), ==, expected[j++]);
+    }
+}
+
+static void
+query_new_for_docids_large (void)
+{
+  g_autoptr(GError) error = NULL;
+  g_autoptr(XapianWritableDatabase) db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  for (unsigned int i = 0; i < 10; i++)
+    {
+      g_autoptr(XapianDocument) doc = xapian_document_new ();
+
+      xapian_writable_database_add_document (db, doc, NULL, &error);
+      g_assert_no_error (error);
+    }
+
+  /* A dense range of identifiers, with a hole, and identifiers close
+   * to the end of the range, which must not require a huge bitmap
+   */
+  g_autoptr(GArray) docids = g_array_new (FALSE, FALSE, sizeof (guint32));
+
+  for (guint32 i = 1; i <= 6000; i++)
+    {
+      if (i != 4)
+        g_array_append_val (docids, i);
+    }
+
+  guint32 last = G_MAXUINT32;
+  g_array_append_val (docids, last);
+  last = G_MAXUINT32 - 70000;
+  g_array_append_val (docids, last);
+
+  g_autoptr(XapianQuery) allowed =
+    xapian_query_new_for_docids ((const guint32 *) docids->data, docids->len);
+  g_autoptr(XapianEnquire) enquire = xapian_enquire_new (XAPIAN_DATABASE (db), &error);
+
+  g_assert_no_error (error);
+
+  xapian_enquire_set_query (enquire, allowed, 0);
+
+  g_autoptr(XapianMSet) mset = xapian_enquire_get_mset (enquire, 0, 20, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpint (xapian_mset_get_size (mset), ==, 9);
+
+  g_autoptr(XapianMSetIterator) iter = xapian_mset_get_begin (mset);
+
+  while (xapian_mset_iterator_next (iter))
+    g_assert_cmpint (xapian_mset_iterator_get_doc_id (iter, NULL), !=, 4);
+
+  /* The set survives a round trip through the serialised form */
+  g_autoptr(GBytes) data = xapian_query_serialise_bytes (allowed, &error);
+
+  g_assert_no_error (error);
+
+  g_autoptr(XapianQuery) res = xapian_query_new_from_bytes (data, NULL, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpstr (xapian_query_get_description (res), ==,
+                   xapian_query_get_description (allowed));
+}
+
+static void
+query_optimize (void)
+{
+  g_autoptr(GError) error = NULL;
+  g_autoptr(XapianQuery) all = xapian_query_new_match_all ();
+  g_autoptr(XapianQuery) a = xapian_query_new_for_term ("yoda");
+  g_autoptr(XapianQuery) b = xapian_query_new_for_term ("obiwan");
+  g_autoptr(XapianQuery) c = xapian_query_new_for_term ("quigon");
+  g_autoptr(XapianQuery) ab = xapian_query_new_for_pair (XAPIAN_QUERY_OP_OR, a, b);
+  g_autoptr(XapianQuery) ab_a = xapian_query_new_for_pair (XAPIAN_QUERY_OP_OR, ab, a);
+  g_autoptr(XapianQuery) ab_a_c = xapian_query_new_for_pair (XAPIAN_QUERY_OP_OR, ab_a, c);
+  g_autoptr(XapianQuery) q = xapian_query_new_for_pair (XAPIAN_QUERY_OP_AND, all, ab_a_c);
+
+  g_autoptr(XapianQuery) res = xapian_query_optimize (q, NULL, 0, &error);
+
+  g_assert_no_error (error);
+  g_assert_nonnull (res);
+  g_assert_cmpstr (xapian_query_get_description (res), ==,
+                   "Query((yoda OR obiwan OR quigon))");
+
+  /* Terms that are not in the database are dropped */
+  g_autoptr(XapianWritableDatabase) db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+  g_assert_no_error (error);
+
+  g_autoptr(XapianDocument) doc = xapian_document_new ();
+  xapian_document_add_term (doc, "yoda");
+  xapian_document_add_term (doc, "obiwan");
+  xapian_writable_database_add_document (db, doc, NULL, &error);
+  g_assert_no_error (error);
+
+  g_autoptr(XapianQuery) with_db = xapian_query_optimize (q, XAPIAN_DATABASE (db), 0, &error);
+
+  g_assert_no_error (error);
+  g_assert_cmpstr (xapian_query_get_description (with_db), ==,
+                   "Query((yoda OR obiwan))");
+
+  /* Wide disjunctions are turned into an elite set */
+  g_autoptr(XapianQuery) elite = xapian_query_optimize (q, NULL, 2, &error);
+
+  g_assert_no_error (error);
+  g_assert_nonnull (strstr (xapian_query_get_description (elite), "ELITE_SET"));
+}
+
+static void
+query_serialise_bytes (void)
+{
+  const guint32 docids[] = { 3, 1, 4, 1, 5, 9, 2, 6 };
+  g_autoptr(GError) error = NULL;
+  g_autoptr(XapianQuery) term = xapian_query_new_for_term ("vader");
+  g_autoptr(XapianQuery) allowed = xapian_query_new_for_docids (docids, G_N_ELEMENTS (docids));
+  g_autoptr(XapianQuery) q = xapian_query_new_for_pair (XAPIAN_QUERY_OP_FILTER, term, allowed);
+
+  g_autoptr(GBytes) data = xapian_query_serialise_bytes (q, &error);
+
+  g_assert_no_error (error);
+  g_assert_nonnull (data);
+
+  g_autoptr(XapianQuery) res = xapian_query_new_from_bytes (data, NULL, &error);
+
+  g_assert_no_error (error);
+  g_assert_nonnull (res);
+  g_assert_cmpstr (xapian_query_get_description (res), ==,
+                   xapian_query_get_description (q));
+
+  /* Posting sources need to be registered before unserialising */
+  g_autoptr(XapianRecencyPostingSource) recency =
+    xapian_recency_posting_source_new (0, XAPIAN_DECAY_FUNCTION_LINEAR,
+                                       1000, 60, 2.0, &error);
+  g_assert_no_error (error);
+
+  g_autoptr(XapianQuery) recent =
+    xapian_query_new_from_posting_source (XAPIAN_POSTING_SOURCE (recency));
+  g_autoptr(GBytes) recent_data = xapian_query_serialise_bytes (recent, &error);
+
+  g_assert_no_error (error);
+
+  g_autoptr(XapianQuery) unregistered = xapian_query_new_from_bytes (recent_data, NULL, &error);
+
+  g_assert_error (error, XAPIAN_ERROR, XAPIAN_ERROR_SERIALISATION);
+  g_assert_null (unregistered);
+  g_clear_error (&error);
+
+  g_autoptr(XapianRegistry) registry = xapian_registry_new ();
+  xapian_registry_register_posting_source (registry, XAPIAN_POSTING_SOURCE (recency));
+
+  g_autoptr(XapianQuery) registered = xapian_query_new_from_bytes (recent_data, registry, &error);
+
+  g_assert_no_error (error);
+  g_assert_nonnull (registered);
+
+  /* Corrupt data is reported as an error */
+  gsize size = 0;
+  const char *bytes = g_bytes_get_data (data, &size);
+  g_autoptr(GByteArray) buf = g_byte_array_new ();
+
+  g_byte_array_append (buf, (const guint8 *) bytes, size);
+  g_byte_array_append (buf, (const guint8 *) "junk", 4);
+
+  g_autoptr(GBytes) corrupt = g_bytes_new (buf->data, buf->len);
+  g_autoptr(XapianQuery) invalid = xapian_query_new_from_bytes (corrupt, NULL, &error);
+
+  g_assert_error (error, XAPIAN_ERROR, XAPIAN_ERROR_SERIALISATION);
+  g_assert_null (invalid);
+}
+
 int
 main (int   argc,
       char *argv[])
@@ -49,7 +328,16 @@ main (int   argc,
 
   g_test_add_func ("/query/new-for-terms", query_new_for_terms);
   g_test_add_func ("/query/new-for-queries", query_new_for_queries);
+  g_test_add_func ("/query/new-for-terms-full", query_new_for_terms_full);
+  g_test_add_func ("/query/new-for-query-array", query_new_for_query_array);
+  g_test_add_func ("/query/new-for-prefixed-terms", query_new_for_prefixed_terms);
   g_test_add_func ("/query/new-wildcard", query_new_wildcard);
+  g_test_add_func ("/query/new-for-docids", query_new_for_docids);
+  g_test_add_func ("/query/new-for-docids/large", query_new_for_docids_large);
+
+  g_test_add_func ("/query/optimize", query_optimize);
+
+  g_test_add_func ("/query/serialise-bytes", query_serialise_bytes);
 
   return g_test_run ();
 }
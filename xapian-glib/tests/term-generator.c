@@ -0,0 +1,456 @@
+#include <string.h>
+#include <glib.h>
+#include "xapian-glib.h"
+
+/* Enough filler to push "brûlée" across the first chunk boundary
+ * used by xapian_term_generator_index_stream(), so that the 'û' is
+ * split in two
+ */
+#define N_FILLER        10921
+
+static char *
+build_text (void)
+{
+  GString *buf = g_string_new (NULL);
+
+  for (unsigned int i = 0; i < N_FILLER; i++)
+    g_string_append (buf, "lorem ");
+
+  g_string_append (buf, "crème brûlée gâteau");
+
+  return g_string_free (buf, FALSE);
+}
+
+static unsigned int
+count_matches (XapianDatabase *db,
+               const char    **terms)
+{
+  GError *error = NULL;
+  XapianQuery *query = xapian_query_new_for_terms (XAPIAN_QUERY_OP_PHRASE, terms);
+  XapianEnquire *enquire = xapian_enquire_new (db, &error);
+
+  g_assert_no_error (error);
+
+  xapian_enquire_set_query (enquire, query, 0);
+
+  XapianMSet *mset = xapian_enquire_get_mset (enquire, 0, 10, &error);
+  g_assert_no_error (error);
+
+  unsigned int res = xapian_mset_get_size (mset);
+
+  g_object_unref (mset);
+  g_object_unref (enquire);
+  g_object_unref (query);
+
+  return res;
+}
+
+static void
+term_generator_index_stream (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  char *text = build_text ();
+  g_assert_cmpuint ((guchar) text[65535], ==, 0xc3);
+
+  XapianTermGenerator *generator = xapian_term_generator_new ();
+
+  XapianDocument *expected = xapian_document_new ();
+  xapian_term_generator_set_document (generator, expected);
+  xapian_term_generator_index_text (generator, text);
+
+  XapianDocument *doc = xapian_document_new ();
+  xapian_term_generator_set_document (generator, doc);
+
+  GInputStream *stream = g_memory_input_stream_new_from_data (text, strlen (text), g_free);
+  gboolean res = xapian_term_generator_index_stream (generator, stream, 1, NULL, NULL, &error);
+
+  g_assert_no_error (error);
+  g_assert_true (res);
+  g_assert_cmpuint (xapian_document_get_termlist_count (doc), ==,
+                    xapian_document_get_termlist_count (expected));
+
+  xapian_writable_database_add_document (db, doc, NULL, &error);
+  g_assert_no_error (error);
+  xapian_writable_database_commit (db, &error);
+  g_assert_no_error (error);
+
+  const char *phrase[] = { "lorem", "crème", "brûlée", "gâteau", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), phrase), ==, 1);
+
+  const char *split[] = { "br", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), split), ==, 0);
+
+  g_object_unref (stream);
+  g_object_unref (doc);
+  g_object_unref (expected);
+  g_object_unref (generator);
+  g_object_unref (db);
+}
+
+static void
+term_generator_positionless (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  XapianTermGenerator *generator = xapian_term_generator_new ();
+  XapianDocument *doc = xapian_document_new ();
+
+  xapian_term_generator_set_document (generator, doc);
+
+  g_assert_true (xapian_term_generator_get_prefix_positional (generator, "XT"));
+  xapian_term_generator_set_prefix_positional (generator, "XT", FALSE);
+  g_assert_false (xapian_term_generator_get_prefix_positional (generator, "XT"));
+  g_assert_true (xapian_term_generator_get_prefix_positional (generator, NULL));
+
+  xapian_term_generator_index_text (generator, "red apple");
+  xapian_term_generator_index_text_full (generator, "red apple", 1, "XT");
+  xapian_term_generator_index_text_without_positions (generator, "red apple", 1, "K");
+
+  xapian_writable_database_add_document (db, doc, NULL, &error);
+  g_assert_no_error (error);
+
+  const char *body[] = { "red", "apple", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), body), ==, 1);
+
+  const char *tags[] = { "XTred", "XTapple", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), tags), ==, 0);
+
+  const char *tag[] = { "XTred", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), tag), ==, 1);
+
+  const char *keywords[] = { "Kred", "Kapple", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), keywords), ==, 0);
+
+  xapian_term_generator_set_prefix_positional (generator, "XT", TRUE);
+  g_assert_true (xapian_term_generator_get_prefix_positional (generator, "XT"));
+
+  g_object_unref (doc);
+  g_object_unref (generator);
+  g_object_unref (db);
+}
+
+static void
+term_generator_index_fields (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  XapianTermGenerator *generator = xapian_term_generator_new ();
+  XapianDocument *doc = xapian_document_new ();
+
+  xapian_term_generator_set_document (generator, doc);
+
+  xapian_term_generator_add_field (generator, "title", "S", 5, TRUE, XAPIAN_STEM_STRATEGY_STEM_NONE);
+  xapian_term_generator_add_field (generator, "tags", "K", 1, FALSE, XAPIAN_STEM_STRATEGY_STEM_NONE);
+  xapian_term_generator_add_field (generator, "body", NULL, 1, TRUE, XAPIAN_STEM_STRATEGY_STEM_NONE);
+
+  const char *tags[] = { "fruit", "red food", NULL };
+  const char *body[] = { "a sweet red", "apple pie", NULL };
+  GVariantBuilder builder;
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+  g_variant_builder_add (&builder, "{sv}", "title", g_variant_new_string ("Red Apple"));
+  g_variant_builder_add (&builder, "{sv}", "tags", g_variant_new_strv (tags, -1));
+  g_variant_builder_add (&builder, "{sv}", "body", g_variant_new_strv (body, -1));
+
+  gboolean res = xapian_term_generator_index_fields (generator, g_variant_builder_end (&builder), &error);
+  g_assert_no_error (error);
+  g_assert_true (res);
+
+  unsigned int n_terms = xapian_document_get_termlist_count (doc);
+
+  /* Unknown fields are rejected before anything is indexed */
+  g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+  g_variant_builder_add (&builder, "{sv}", "title", g_variant_new_string ("banana"));
+  g_variant_builder_add (&builder, "{sv}", "author", g_variant_new_string ("nobody"));
+
+  res = xapian_term_generator_index_fields (generator, g_variant_builder_end (&builder), &error);
+  g_assert_error (error, XAPIAN_ERROR, XAPIAN_ERROR_INVALID_ARGUMENT);
+  g_assert_false (res);
+  g_assert_cmpuint (xapian_document_get_termlist_count (doc), ==, n_terms);
+  g_clear_error (&error);
+
+  xapian_writable_database_add_document (db, doc, NULL, &error);
+  g_assert_no_error (error);
+
+  const char *title[] = { "Sred", "Sapple", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), title), ==, 1);
+
+  const char *tag[] = { "Kfruit", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), tag), ==, 1);
+
+  const char *tag_phrase[] = { "Kred", "Kfood", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), tag_phrase), ==, 0);
+
+  const char *body_phrase[] = { "apple", "pie", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), body_phrase), ==, 1);
+
+  /* Phrases do not match across values */
+  const char *across[] = { "red", "apple", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), across), ==, 0);
+
+  g_object_unref (doc);
+  g_object_unref (generator);
+  g_object_unref (db);
+}
+
+static void
+term_generator_limits (void)
+{
+  GError *error = NULL;
+  XapianWritableDatabase *db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  XapianTermGenerator *generator = xapian_term_generator_new ();
+  XapianDocument *doc = xapian_document_new ();
+
+  g_assert_cmpuint (xapian_term_generator_get_max_word_length (generator), ==, 64);
+  g_assert_cmpuint (xapian_term_generator_get_max_terms (generator), ==, 0);
+
+  xapian_term_generator_set_max_word_length (generator, 10);
+  xapian_term_generator_set_document (generator, doc);
+  xapian_term_generator_index_text (generator, "short aGVsbG8gd29ybGQgaGVsbG8gd29ybGQK");
+  g_assert_cmpuint (xapian_document_get_termlist_count (doc), ==, 1);
+
+  /* Long words are not counted as capped terms */
+  g_assert_cmpuint (xapian_term_generator_get_capped_terms_count (generator), ==, 0);
+  g_object_unref (doc);
+
+  doc = xapian_document_new ();
+  xapian_term_generator_set_max_terms (generator, 3);
+  xapian_term_generator_set_document (generator, doc);
+  xapian_term_generator_index_text (generator, "one two three four five five");
+  xapian_term_generator_index_text (generator, "one two");
+
+  g_assert_cmpuint (xapian_document_get_termlist_count (doc), ==, 3);
+  g_assert_cmpuint (xapian_term_generator_get_capped_terms_count (generator), ==, 2);
+  g_assert_cmpuint (xapian_term_generator_get_capped_tokens_count (generator), ==, 3);
+
+  xapian_writable_database_add_document (db, doc, NULL, &error);
+  g_assert_no_error (error);
+
+  /* Positions of the kept terms are preserved */
+  const char *kept[] = { "one", "two", "three", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), kept), ==, 1);
+
+  /* The first terms in the text are kept, not the first in term order */
+  const char *dropped[] = { "four", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), dropped), ==, 0);
+
+  const char *dropped_last[] = { "five", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), dropped_last), ==, 0);
+
+  xapian_term_generator_set_document (generator, doc);
+  g_assert_cmpuint (xapian_term_generator_get_capped_terms_count (generator), ==, 0);
+
+  g_object_unref (doc);
+
+  /* The same applies to data indexed without positions */
+  doc = xapian_document_new ();
+  xapian_term_generator_set_document (generator, doc);
+  xapian_term_generator_index_text_without_positions (generator, "zulu yankee xray alpha", 1, NULL);
+
+  g_assert_cmpuint (xapian_document_get_termlist_count (doc), ==, 3);
+  g_assert_cmpuint (xapian_term_generator_get_capped_terms_count (generator), ==, 1);
+
+  xapian_writable_database_add_document (db, doc, NULL, &error);
+  g_assert_no_error (error);
+
+  const char *kept_positionless[] = { "xray", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), kept_positionless), ==, 1);
+
+  const char *dropped_positionless[] = { "alpha", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), dropped_positionless), ==, 0);
+
+  g_object_unref (doc);
+  g_object_unref (generator);
+  g_object_unref (db);
+}
+
+/* Words separated by U+3001 IDEOGRAPHIC COMMA, without any whitespace;
+ * the 5 bytes long head puts the first chunk boundary used by
+ * xapian_term_generator_index_stream() in the middle of a word
+ */
+#define N_CJK_FILLER    8200
+
+static void
+term_generator_index_stream_no_whitespace (void)
+{
+  GError *error = NULL;
+  GString *buf = g_string_new ("ab\xe3\x80\x81");
+
+  for (unsigned int i = 0; i < N_CJK_FILLER; i++)
+    g_string_append (buf, "lorem\xe3\x80\x81");
+
+  char *text = g_string_free (buf, FALSE);
+  g_assert_cmpuint (strlen (text), >, 65536);
+  g_assert_cmpint (memcmp (text + 65536 - 3, "lorem", 5), ==, 0);
+
+  XapianWritableDatabase *db =
+    xapian_writable_database_new_with_backend ("inmemory",
+                                               XAPIAN_DATABASE_ACTION_CREATE_OR_OVERWRITE,
+                                               XAPIAN_DATABASE_BACKEND_INMEMORY,
+                                               &error);
+
+  g_assert_no_error (error);
+
+  XapianTermGenerator *generator = xapian_term_generator_new ();
+
+  XapianDocument *expected = xapian_document_new ();
+  xapian_term_generator_set_document (generator, expected);
+  xapian_term_generator_index_text (generator, text);
+
+  XapianDocument *doc = xapian_document_new ();
+  xapian_term_generator_set_document (generator, doc);
+
+  GInputStream *stream = g_memory_input_stream_new_from_data (text, strlen (text), g_free);
+  gboolean res = xapian_term_generator_index_stream (generator, stream, 1, NULL, NULL, &error);
+
+  g_assert_no_error (error);
+  g_assert_true (res);
+  g_assert_cmpuint (xapian_document_get_termlist_count (doc), ==,
+                    xapian_document_get_termlist_count (expected));
+
+  xapian_writable_database_add_document (db, doc, NULL, &error);
+  g_assert_no_error (error);
+  xapian_writable_database_commit (db, &error);
+  g_assert_no_error (error);
+
+  /* The word across the chunk boundary is not split in two */
+  const char *head[] = { "lor", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), head), ==, 0);
+
+  const char *tail[] = { "em", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), tail), ==, 0);
+
+  const char *phrase[] = { "ab", "lorem", "lorem", NULL };
+  g_assert_cmpuint (count_matches (XAPIAN_DATABASE (db), phrase), ==, 1);
+
+  g_object_unref (stream);
+  g_object_unref (doc);
+  g_object_unref (expected);
+  g_object_unref (generator);
+  g_object_unref (db);
+}
+
+static void
+term_generator_cjk_ngram (void)
+{
+  XapianTermGenerator *generator = xapian_term_generator_new ();
+  XapianDocument *doc = xapian_document_new ();
+
+  xapian_term_generator_set_document (generator, doc);
+  xapian_term_generator_index_text (generator, "中文");
+  g_assert_cmpuint (xapian_document_get_termlist_count (doc), ==, 1);
+  g_object_unref (doc);
+
+  /* Unigrams and bigrams */
+  doc = xapian_document_new ();
+  g_object_set (generator, "flags", XAPIAN_TERM_GENERATOR_FEATURE_CJK_NGRAM, NULL);
+  xapian_term_generator_set_document (generator, doc);
+  xapian_term_generator_index_text (generator, "中文");
+  g_assert_cmpuint (xapian_document_get_termlist_count (doc), ==, 3);
+  g_object_unref (doc);
+
+  g_object_unref (generator);
+}
+
+static void
+term_generator_cjk_words (void)
+{
+  GError *error = NULL;
+  XapianTermGenerator *generator = xapian_term_generator_new ();
+  XapianDocument *doc = xapian_document_new ();
+
+  g_object_set (generator, "flags", XAPIAN_TERM_GENERATOR_FEATURE_CJK_WORDS, NULL);
+  xapian_term_generator_set_document (generator, doc);
+
+  /* Word segmentation is only available if Xapian was built with
+   * ICU support; the functions returning a GError report it
+   */
+  GInputStream *stream = g_memory_input_stream_new_from_data ("中文", -1, NULL);
+  gboolean res = xapian_term_generator_index_stream (generator, stream, 1, NULL, NULL, &error);
+  gboolean available = res;
+
+  if (res)
+    {
+      g_assert_no_error (error);
+      g_assert_cmpuint (xapian_document_get_termlist_count (doc), >, 0);
+    }
+  else
+    {
+      g_assert_error (error, XAPIAN_ERROR, XAPIAN_ERROR_FEATURE_UNAVAILABLE);
+      g_clear_error (&error);
+    }
+
+  g_object_unref (stream);
+  g_object_unref (doc);
+  g_object_unref (generator);
+
+  if (available)
+    return;
+
+  /* The other functions emit a critical warning, instead of letting
+   * the exception escape
+   */
+  if (g_test_subprocess ())
+    {
+      generator = xapian_term_generator_new ();
+      doc = xapian_document_new ();
+
+      g_object_set (generator, "flags", XAPIAN_TERM_GENERATOR_FEATURE_CJK_WORDS, NULL);
+      xapian_term_generator_set_document (generator, doc);
+      xapian_term_generator_index_text (generator, "中文");
+
+      g_object_unref (doc);
+      g_object_unref (generator);
+      return;
+    }
+
+  g_test_trap_subprocess (NULL, 0, 0);
+  g_test_trap_assert_failed ();
+  g_test_trap_assert_stderr ("*Unable to index text*");
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/term-generator/index-stream", term_generator_index_stream);
+  g_test_add_func ("/term-generator/index-stream/no-whitespace", term_generator_index_stream_no_whitespace);
+  g_test_add_func ("/term-generator/positionless", term_generator_positionless);
+  g_test_add_func ("/term-generator/index-fields", term_generator_index_fields);
+  g_test_add_func ("/term-generator/limits", term_generator_limits);
+  g_test_add_func ("/term-generator/cjk-ngram", term_generator_cjk_ngram);
+  g_test_add_func ("/term-generator/cjk-words", term_generator_cjk_words);
+
+  return g_test_run ();
+}
@@ -0,0 +1,1035 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-completion-index
+ * @Title: XapianCompletionIndex
+ * @short_description: Prefix completion index
+ *
+ * #XapianCompletionIndex is a compact index of the terms inside a
+ * #XapianDatabase, suited for completing the words typed by the user,
+ * for instance when implementing search-as-you-type.
+ *
+ * The index is a trie of all the terms in the database, optionally
+ * limited to the terms with a given prefix, like `S` for titles; each
+ * node of the trie stores the most frequent terms starting with the
+ * text leading to the node, so looking up the completions of a string
+ * only costs a walk down the trie.
+ *
+ * The index can be stored in a file, which is memory mapped when the
+ * #XapianCompletionIndex is initialized; the file is rebuilt only if
+ * the database changed since the last time the index was built. For
+ * databases combining multiple shards, the index is rebuilt if any of
+ * the shards changed.
+ *
+ * Terms starting with an upper case letter are considered to belong
+ * to a longer prefix, and are never indexed; without a prefix, this
+ * skips the boolean filter terms and the stemmed terms, which start
+ * with `Z`.
+ *
+ * The index is not updated automatically when the database changes:
+ * you need to call xapian_completion_index_refresh() after reopening
+ * the database, for instance from a handler of the
+ * #XapianDatabase::revision-changed signal. Since the most frequent
+ * completions of each node depend on the frequencies of all the terms,
+ * refreshing rebuilds the whole index instead of merging the changes.
+ *
+ * |[<!-- language="C" -->
+ *   XapianCompletionIndex *index =
+ *     xapian_completion_index_new (db, "titles.idx", "S", 10, &error);
+ *
+ *   char **completions =
+ *     xapian_completion_index_complete (index, "xap", 5, NULL, NULL);
+ * ]|
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <xapian.h>
+
+#include "xapian-completion-index.h"
+
+#include "xapian-database-private.h"
+#include "xapian-enums.h"
+#include "xapian-error-private.h"
+
+#define DEFAULT_TOP_K           10
+
+#define COMPLETION_INDEX_MAGIC          "XGCIDX\0\2"
+#define COMPLETION_INDEX_MAGIC_LEN      8
+#define COMPLETION_INDEX_BYTE_ORDER     0x01020304
+
+/* The index file is made of:
+ *
+ *  - a header
+ *  - the revision of each shard of the database
+ *  - the UUID of the database, and the prefix of the terms, padded
+ *    to a multiple of 4 bytes
+ *  - the nodes of the trie; the children of each node are stored
+ *    contiguously, sorted by their label
+ *  - the top-k table, containing the identifiers of the most frequent
+ *    terms below each node
+ *  - the offsets of each term inside the strings table
+ *  - the frequency of each term
+ *  - the strings table
+ *
+ * All integers are stored in the native byte order.
+ */
+typedef struct {
+  char magic[COMPLETION_INDEX_MAGIC_LEN];
+  guint32 byte_order;
+  guint32 top_k;
+  guint32 root;
+  guint32 n_nodes;
+  guint32 n_top;
+  guint32 n_terms;
+  guint32 strings_size;
+  guint32 uuid_size;
+  guint32 prefix_size;
+  guint32 n_revisions;
+} CompletionIndexHeader;
+
+typedef struct {
+  guint32 first_child;
+  guint32 top_start;
+  guint32 n_top;
+  guint16 n_children;
+  guint8 label;
+  guint8 padding;
+} CompletionIndexNode;
+
+typedef struct {
+  const CompletionIndexHeader *header;
+  const guint64 *revisions;
+  const char *uuid;
+  const char *prefix;
+  const CompletionIndexNode *nodes;
+  const guint32 *top;
+  const guint32 *offsets;
+  const guint32 *freqs;
+  const char *strings;
+} CompletionIndexLayout;
+
+static inline gsize
+align_to_4 (gsize size)
+{
+  return (size + 3) & ~((gsize) 3);
+}
+
+/* Checks that @bytes contains a valid index, and fills @layout */
+static gboolean
+completion_index_layout_init (CompletionIndexLayout *layout,
+                              GBytes                *bytes)
+{
+  gsize size = 0;
+  const char *data = static_cast<const char *> (g_bytes_get_data (bytes, &size));
+
+  if (size < sizeof (CompletionIndexHeader))
+    return FALSE;
+
+  const CompletionIndexHeader *header = reinterpret_cast<const CompletionIndexHeader *> (data);
+
+  if (memcmp (header->magic, COMPLETION_INDEX_MAGIC, COMPLETION_INDEX_MAGIC_LEN) != 0 ||
+      header->byte_order != COMPLETION_INDEX_BYTE_ORDER)
+    return FALSE;
+
+  /* Use 64 bits to avoid overflows with corrupted headers */
+  guint64 offset = sizeof (CompletionIndexHeader) + (guint64) header->n_revisions * sizeof (guint64);
+  guint64 nodes_offset = align_to_4 (offset + (guint64) header->uuid_size + header->prefix_size);
+  guint64 top_offset = nodes_offset + (guint64) header->n_nodes * sizeof (CompletionIndexNode);
+  guint64 offsets_offset = top_offset + (guint64) header->n_top * sizeof (guint32);
+  guint64 freqs_offset = offsets_offset + ((guint64) header->n_terms + 1) * sizeof (guint32);
+  guint64 table_offset = freqs_offset + (guint64) header->n_terms * sizeof (guint32);
+
+  if (table_offset + header->strings_size > size)
+    return FALSE;
+
+  if (header->n_nodes == 0 || header->root >= header->n_nodes)
+    return FALSE;
+
+  const CompletionIndexNode *nodes = reinterpret_cast<const CompletionIndexNode *> (data + nodes_offset);
+  const guint32 *top = reinterpret_cast<const guint32 *> (data + top_offset);
+  const guint32 *offsets = reinterpret_cast<const guint32 *> (data + offsets_offset);
+
+  /* Check all the references once, so that lookups can trust them */
+  for (guint32 i = 0; i < header->n_nodes; i++)
+    {
+      if ((guint64) nodes[i].first_child + nodes[i].n_children > header->n_nodes ||
+          (guint64) nodes[i].top_start + nodes[i].n_top > header->n_top)
+        return FALSE;
+    }
+
+  for (guint32 i = 0; i < header->n_top; i++)
+    {
+      if (top[i] >= header->n_terms)
+        return FALSE;
+    }
+
+  for (guint32 i = 0; i < header->n_terms; i++)
+    {
+      if (offsets[i] > offsets[i + 1])
+        return FALSE;
+    }
+
+  if (offsets[header->n_terms] > header->strings_size)
+    return FALSE;
+
+  layout->header = header;
+  layout->revisions = reinterpret_cast<const guint64 *> (data + sizeof (CompletionIndexHeader));
+  layout->uuid = data + offset;
+  layout->prefix = data + offset + header->uuid_size;
+  layout->nodes = nodes;
+  layout->top = top;
+  layout->offsets = offsets;
+  layout->freqs = reinterpret_cast<const guint32 *> (data + freqs_offset);
+  layout->strings = data + table_offset;
+
+  return TRUE;
+}
+
+/* Builds the trie from the sorted list of terms.
+ *
+ * Since the terms are sorted, we only need to keep the path from the
+ * root to the current term; every time a term diverges from the
+ * previous one, the nodes that are not shared are complete, and we
+ * can write out their children, and select their most frequent terms.
+ */
+class CompletionIndexBuilder {
+    CompletionIndexBuilder (const CompletionIndexBuilder &aBuilder);
+
+    void operator= (const CompletionIndexBuilder &aBuilder);
+
+    struct PendingNode {
+      guint8 label;
+      bool terminal;
+      guint32 term;
+
+      std::vector<CompletionIndexNode> children;
+      std::vector<std::vector<guint32> > children_top;
+
+      explicit PendingNode (guint8 aLabel)
+        : label (aLabel), terminal (false), term (0)
+      {
+      }
+    };
+
+    unsigned int mTopK;
+
+    std::vector<PendingNode> mStack;
+    std::string mLastTerm;
+
+  public:
+    std::vector<CompletionIndexNode> mNodes;
+    std::vector<guint32> mTop;
+    std::vector<guint32> mOffsets;
+    std::vector<guint32> mFreqs;
+    std::string mStrings;
+    guint32 mRoot;
+
+    explicit CompletionIndexBuilder (unsigned int top_k)
+      : mTopK (top_k), mRoot (0)
+    {
+      mStack.push_back (PendingNode (0));
+      mOffsets.push_back (0);
+    }
+
+  private:
+    void finish_node (PendingNode               &node,
+                      CompletionIndexNode       &record,
+                      std::vector<guint32>      &top) {
+      /* Share the top-k terms of nodes with a single child */
+      if (!node.terminal && node.children.size () == 1)
+        {
+          top = node.children_top[0];
+          record.top_start = node.children[0].top_start;
+        }
+      else
+        {
+          if (node.terminal)
+            top.push_back (node.term);
+
+          for (const std::vector<guint32> &child_top : node.children_top)
+            top.insert (top.end (), child_top.begin (), child_top.end ());
+
+          const std::vector<guint32> &freqs = mFreqs;
+          auto by_freq = [&freqs] (guint32 a, guint32 b) {
+            if (freqs[a] != freqs[b])
+              return freqs[a] > freqs[b];
+
+            return a < b;
+          };
+
+          if (top.size () > mTopK)
+            {
+              std::partial_sort (top.begin (), top.begin () + mTopK, top.end (), by_freq);
+              top.resize (mTopK);
+            }
+          else
+            std::sort (top.begin (), top.end (), by_freq);
+
+          record.top_start = mTop.size ();
+          mTop.insert (mTop.end (), top.begin (), top.end ());
+        }
+
+      record.first_child = mNodes.size ();
+      record.n_children = node.children.size ();
+      record.n_top = top.size ();
+      record.label = node.label;
+      record.padding = 0;
+
+      mNodes.insert (mNodes.end (), node.children.begin (), node.children.end ());
+    }
+
+    void pop_node () {
+      CompletionIndexNode record;
+      std::vector<guint32> top;
+
+      finish_node (mStack.back (), record, top);
+      mStack.pop_back ();
+
+      mStack.back ().children.push_back (record);
+      mStack.back ().children_top.push_back (top);
+    }
+
+  public:
+    void add_term (const std::string &term,
+                   guint32            freq) {
+      size_t common = 0;
+      size_t max_common = std::min (term.size (), mLastTerm.size ());
+
+      while (common < max_common && term[common] == mLastTerm[common])
+        common++;
+
+      while (mStack.size () > common + 1)
+        pop_node ();
+
+      for (size_t i = common; i < term.size (); i++)
+        mStack.push_back (PendingNode (static_cast<guint8> (term[i])));
+
+      guint32 id = mFreqs.size ();
+
+      mStack.back ().terminal = true;
+      mStack.back ().term = id;
+
+      mFreqs.push_back (freq);
+      mStrings += term;
+      mOffsets.push_back (mStrings.size ());
+
+      mLastTerm = term;
+    }
+
+    void finish () {
+      while (mStack.size () > 1)
+        pop_node ();
+
+      CompletionIndexNode record;
+      std::vector<guint32> top;
+
+      finish_node (mStack.back (), record, top);
+      mStack.pop_back ();
+
+      mRoot = mNodes.size ();
+      mNodes.push_back (record);
+    }
+};
+
+static std::string
+build_index (const Xapian::Database     &db,
+             const std::string          &prefix,
+             unsigned int                top_k,
+             const std::vector<guint64> &revisions)
+{
+  CompletionIndexBuilder builder (top_k);
+
+  Xapian::TermIterator end = db.allterms_end (prefix);
+  for (Xapian::TermIterator it = db.allterms_begin (prefix); it != end; ++it)
+    {
+      const std::string &term = *it;
+
+      if (term.size () == prefix.size ())
+        continue;
+
+      /* Skip terms belonging to a longer prefix, like the boolean
+       * filter terms or the `Z` prefixed stemmed terms; by convention,
+       * the prefixes are in upper case
+       */
+      char first = term[prefix.size ()];
+      if (first >= 'A' && first <= 'Z')
+        continue;
+
+      builder.add_term (term.substr (prefix.size ()), it.get_termfreq ());
+    }
+
+  builder.finish ();
+
+  std::string uuid = db.get_uuid ();
+
+  CompletionIndexHeader header;
+  memset (&header, 0, sizeof (header));
+  memcpy (header.magic, COMPLETION_INDEX_MAGIC, COMPLETION_INDEX_MAGIC_LEN);
+  header.byte_order = COMPLETION_INDEX_BYTE_ORDER;
+  header.top_k = top_k;
+  header.root = builder.mRoot;
+  header.n_nodes = builder.mNodes.size ();
+  header.n_top = builder.mTop.size ();
+  header.n_terms = builder.mFreqs.size ();
+  header.strings_size = builder.mStrings.size ();
+  header.uuid_size = uuid.size ();
+  header.prefix_size = prefix.size ();
+  header.n_revisions = revisions.size ();
+
+  std::string res;
+
+  res.append (reinterpret_cast<const char *> (&header), sizeof (header));
+  res.append (reinterpret_cast<const char *> (revisions.data ()),
+              revisions.size () * sizeof (guint64));
+  res += uuid;
+  res += prefix;
+  res.resize (align_to_4 (res.size ()), '\0');
+  res.append (reinterpret_cast<const char *> (builder.mNodes.data ()),
+              builder.mNodes.size () * sizeof (CompletionIndexNode));
+  res.append (reinterpret_cast<const char *> (builder.mTop.data ()),
+              builder.mTop.size () * sizeof (guint32));
+  res.append (reinterpret_cast<const char *> (builder.mOffsets.data ()),
+              builder.mOffsets.size () * sizeof (guint32));
+  res.append (reinterpret_cast<const char *> (builder.mFreqs.data ()),
+              builder.mFreqs.size () * sizeof (guint32));
+  res += builder.mStrings;
+
+  return res;
+}
+
+#define XAPIAN_COMPLETION_INDEX_GET_PRIVATE(obj) \
+  ((XapianCompletionIndexPrivate *) xapian_completion_index_get_instance_private ((XapianCompletionIndex *) (obj)))
+
+typedef struct {
+  XapianDatabase *database;
+  char *path;
+  char *prefix;
+  guint top_k;
+
+  /* Protects the index contents, which are replaced on refresh; the
+   * layout is validated when the index is loaded
+   */
+  GMutex lock;
+  GBytes *index;
+  CompletionIndexLayout layout;
+} XapianCompletionIndexPrivate;
+
+enum {
+  PROP_0,
+
+  PROP_DATABASE,
+  PROP_PATH,
+  PROP_PREFIX,
+  PROP_TOP_K,
+
+  LAST_PROP
+};
+
+static GParamSpec *obj_props[LAST_PROP] = { NULL, };
+
+static void initable_iface_init (GInitableIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (XapianCompletionIndex, xapian_completion_index, G_TYPE_OBJECT,
+                         G_ADD_PRIVATE (XapianCompletionIndex)
+                         G_IMPLEMENT_INTERFACE (G_TYPE_INITABLE, initable_iface_init))
+
+/* Checks whether the index in @layout matches the state of the database */
+static gboolean
+is_index_current (XapianCompletionIndex       *self,
+                  const CompletionIndexLayout &layout,
+                  const Xapian::Database      &db)
+{
+  XapianCompletionIndexPrivate *priv = XAPIAN_COMPLETION_INDEX_GET_PRIVATE (self);
+
+  /* A database without revisions, like an in-memory one, can change
+   * at any time, so we cannot trust an existing index
+   */
+  std::vector<guint64> revisions = xapian_database_get_revisions (priv->database);
+  if (revisions.empty () ||
+      std::find (revisions.begin (), revisions.end (), 0) != revisions.end ())
+    return FALSE;
+
+  if (layout.header->n_revisions != revisions.size () ||
+      !std::equal (revisions.begin (), revisions.end (), layout.revisions))
+    return FALSE;
+
+  if (layout.header->top_k != priv->top_k)
+    return FALSE;
+
+  std::string uuid = db.get_uuid ();
+  if (std::string (layout.uuid, layout.header->uuid_size) != uuid)
+    return FALSE;
+
+  if (std::string (layout.prefix, layout.header->prefix_size) != priv->prefix)
+    return FALSE;
+
+  return TRUE;
+}
+
+static GBytes *
+load_index (XapianCompletionIndex *self,
+            CompletionIndexLayout *layout)
+{
+  XapianCompletionIndexPrivate *priv = XAPIAN_COMPLETION_INDEX_GET_PRIVATE (self);
+
+  if (priv->path == NULL)
+    return NULL;
+
+  GMappedFile *mapped_file = g_mapped_file_new (priv->path, FALSE, NULL);
+  if (mapped_file == NULL)
+    return NULL;
+
+  GBytes *res = g_mapped_file_get_bytes (mapped_file);
+  g_mapped_file_unref (mapped_file);
+
+  gboolean is_current = FALSE;
+
+  try
+    {
+      if (completion_index_layout_init (layout, res))
+        is_current = is_index_current (self, *layout, *xapian_database_get_internal (priv->database));
+    }
+  catch (const Xapian::Error &err)
+    {
+      is_current = FALSE;
+    }
+
+  if (!is_current)
+    {
+      g_bytes_unref (res);
+      return NULL;
+    }
+
+  return res;
+}
+
+static GBytes *
+rebuild_index (XapianCompletionIndex  *self,
+               CompletionIndexLayout  *layout,
+               GError                **error)
+{
+  XapianCompletionIndexPrivate *priv = XAPIAN_COMPLETION_INDEX_GET_PRIVATE (self);
+  Xapian::Database *db = xapian_database_get_internal (priv->database);
+  std::string data;
+
+  try
+    {
+      data = build_index (*db, priv->prefix, priv->top_k,
+                          xapian_database_get_revisions (priv->database));
+    }
+  catch (const Xapian::Error &err)
+    {
+      GError *internal_error = NULL;
+
+      xapian_error_to_gerror (err, &internal_error);
+      g_propagate_error (error, internal_error);
+
+      return NULL;
+    }
+
+  GBytes *res;
+
+  if (priv->path == NULL)
+    res = g_bytes_new (data.data (), data.size ());
+  else
+    {
+      if (!g_file_set_contents (priv->path, data.data (), data.size (), error))
+        return NULL;
+
+      GMappedFile *mapped_file = g_mapped_file_new (priv->path, FALSE, error);
+      if (mapped_file == NULL)
+        return NULL;
+
+      res = g_mapped_file_get_bytes (mapped_file);
+      g_mapped_file_unref (mapped_file);
+    }
+
+  /* The file may have been replaced behind our back */
+  if (!completion_index_layout_init (layout, res))
+    {
+      g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_INVAL,
+                   "Invalid completion index at '%s'",
+                   priv->path);
+      g_bytes_unref (res);
+      return NULL;
+    }
+
+  return res;
+}
+
+static void
+replace_index (XapianCompletionIndex       *self,
+               GBytes                      *index,
+               const CompletionIndexLayout &layout)
+{
+  XapianCompletionIndexPrivate *priv = XAPIAN_COMPLETION_INDEX_GET_PRIVATE (self);
+  GBytes *old_index;
+
+  g_mutex_lock (&priv->lock);
+  old_index = priv->index;
+  priv->index = index;
+  priv->layout = layout;
+  g_mutex_unlock (&priv->lock);
+
+  if (old_index != NULL)
+    g_bytes_unref (old_index);
+}
+
+static gboolean
+xapian_completion_index_init_internal (GInitable    *self,
+                                       GCancellable *cancellable,
+                                       GError      **error)
+{
+  XapianCompletionIndexPrivate *priv = XAPIAN_COMPLETION_INDEX_GET_PRIVATE (self);
+
+  if (priv->database == NULL)
+    {
+      g_set_error_literal (error, XAPIAN_ERROR,
+                           XAPIAN_ERROR_INVALID_ARGUMENT,
+                           "A database is required to build the completion index");
+      return FALSE;
+    }
+
+  XapianCompletionIndex *index = XAPIAN_COMPLETION_INDEX (self);
+  CompletionIndexLayout layout;
+  GBytes *bytes = load_index (index, &layout);
+
+  if (bytes == NULL)
+    bytes = rebuild_index (index, &layout, error);
+
+  if (bytes == NULL)
+    return FALSE;
+
+  replace_index (index, bytes, layout);
+
+  return TRUE;
+}
+
+static void
+initable_iface_init (GInitableIface *iface)
+{
+  iface->init = xapian_completion_index_init_internal;
+}
+
+static void
+xapian_completion_index_dispose (GObject *gobject)
+{
+  XapianCompletionIndexPrivate *priv = XAPIAN_COMPLETION_INDEX_GET_PRIVATE (gobject);
+
+  g_clear_object (&priv->database);
+
+  G_OBJECT_CLASS (xapian_completion_index_parent_class)->dispose (gobject);
+}
+
+static void
+xapian_completion_index_finalize (GObject *gobject)
+{
+  XapianCompletionIndexPrivate *priv = XAPIAN_COMPLETION_INDEX_GET_PRIVATE (gobject);
+
+  g_clear_pointer (&priv->index, g_bytes_unref);
+  g_mutex_clear (&priv->lock);
+
+  g_free (priv->path);
+  g_free (priv->prefix);
+
+  G_OBJECT_CLASS (xapian_completion_index_parent_class)->finalize (gobject);
+}
+
+static void
+xapian_completion_index_set_property (GObject      *gobject,
+                                      guint         prop_id,
+                                      const GValue *value,
+                                      GParamSpec   *pspec)
+{
+  XapianCompletionIndexPrivate *priv = XAPIAN_COMPLETION_INDEX_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_DATABASE:
+      priv->database = static_cast<XapianDatabase *> (g_value_dup_object (value));
+      break;
+
+    case PROP_PATH:
+      g_free (priv->path);
+      priv->path = g_value_dup_string (value);
+      break;
+
+    case PROP_PREFIX:
+      g_free (priv->prefix);
+      priv->prefix = g_strdup (g_value_get_string (value) != NULL ? g_value_get_string (value) : "");
+      break;
+
+    case PROP_TOP_K:
+      priv->top_k = g_value_get_uint (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_completion_index_get_property (GObject    *gobject,
+                                      guint       prop_id,
+                                      GValue     *value,
+                                      GParamSpec *pspec)
+{
+  XapianCompletionIndexPrivate *priv = XAPIAN_COMPLETION_INDEX_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_DATABASE:
+      g_value_set_object (value, priv->database);
+      break;
+
+    case PROP_PATH:
+      g_value_set_string (value, priv->path);
+      break;
+
+    case PROP_PREFIX:
+      g_value_set_string (value, priv->prefix);
+      break;
+
+    case PROP_TOP_K:
+      g_value_set_uint (value, priv->top_k);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_completion_index_class_init (XapianCompletionIndexClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  /**
+   * XapianCompletionIndex:database:
+   *
+   * The #XapianDatabase containing the terms to complete.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_DATABASE] =
+    g_param_spec_object ("database",
+                         "Database",
+                         "The database containing the terms",
+                         XAPIAN_TYPE_DATABASE,
+                         (GParamFlags) (G_PARAM_READWRITE |
+                                        G_PARAM_CONSTRUCT_ONLY |
+                                        G_PARAM_STATIC_STRINGS));
+
+  /**
+   * XapianCompletionIndex:path:
+   *
+   * The path of the file storing the index, or %NULL to keep the
+   * index in memory.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_PATH] =
+    g_param_spec_string ("path",
+                         "Path",
+                         "The path of the index file",
+                         NULL,
+                         (GParamFlags) (G_PARAM_READWRITE |
+                                        G_PARAM_CONSTRUCT_ONLY |
+                                        G_PARAM_STATIC_STRINGS));
+
+  /**
+   * XapianCompletionIndex:prefix:
+   *
+   * The prefix of the indexed terms; the prefix is not part of
+   * the completions.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_PREFIX] =
+    g_param_spec_string ("prefix",
+                         "Prefix",
+                         "The prefix of the indexed terms",
+                         "",
+                         (GParamFlags) (G_PARAM_READWRITE |
+                                        G_PARAM_CONSTRUCT_ONLY |
+                                        G_PARAM_STATIC_STRINGS));
+
+  /**
+   * XapianCompletionIndex:top-k:
+   *
+   * The number of most frequent completions stored for each prefix;
+   * this is the maximum number of results returned by
+   * xapian_completion_index_complete().
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_TOP_K] =
+    g_param_spec_uint ("top-k",
+                       "Top K",
+                       "The number of completions stored for each prefix",
+                       1, G_MAXUINT32,
+                       DEFAULT_TOP_K,
+                       (GParamFlags) (G_PARAM_READWRITE |
+                                      G_PARAM_CONSTRUCT_ONLY |
+                                      G_PARAM_STATIC_STRINGS));
+
+  gobject_class->set_property = xapian_completion_index_set_property;
+  gobject_class->get_property = xapian_completion_index_get_property;
+  gobject_class->dispose = xapian_completion_index_dispose;
+  gobject_class->finalize = xapian_completion_index_finalize;
+
+  g_object_class_install_properties (gobject_class, LAST_PROP, obj_props);
+}
+
+static void
+xapian_completion_index_init (XapianCompletionIndex *self)
+{
+  XapianCompletionIndexPrivate *priv = XAPIAN_COMPLETION_INDEX_GET_PRIVATE (self);
+
+  priv->prefix = g_strdup ("");
+  priv->top_k = DEFAULT_TOP_K;
+
+  g_mutex_init (&priv->lock);
+}
+
+/**
+ * xapian_completion_index_new:
+ * @database: a #XapianDatabase
+ * @path: (type filename) (nullable): the path of the index file, or %NULL
+ * @prefix: (nullable): the prefix of the terms to index, or %NULL
+ * @top_k: the number of completions stored for each prefix
+ * @error: return location for a #GError, or %NULL
+ *
+ * Creates and initializes a new #XapianCompletionIndex for the terms
+ * of @database starting with @prefix.
+ *
+ * If @path is not %NULL, the index is loaded from the file at @path,
+ * if it exists and it is up to date with @database; otherwise, the
+ * index is built and saved at @path. If @path is %NULL, the index is
+ * built and kept in memory.
+ *
+ * If the initialization was not successful, @error is set.
+ *
+ * Returns: (transfer full): the newly created #XapianCompletionIndex
+ *   instance, or %NULL if the initialization failed
+ *
+ * Since: 2.0
+ */
+XapianCompletionIndex *
+xapian_completion_index_new (XapianDatabase  *database,
+                             const char      *path,
+                             const char      *prefix,
+                             unsigned int     top_k,
+                             GError         **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_DATABASE (database), NULL);
+  g_return_val_if_fail (top_k > 0, NULL);
+
+  return static_cast<XapianCompletionIndex *> (g_initable_new (XAPIAN_TYPE_COMPLETION_INDEX,
+                                                               NULL, error,
+                                                               "database", database,
+                                                               "path", path,
+                                                               "prefix", prefix,
+                                                               "top-k", top_k,
+                                                               NULL));
+}
+
+/**
+ * xapian_completion_index_complete:
+ * @index: a #XapianCompletionIndex
+ * @text: the text to complete
+ * @max_results: the maximum number of completions to return
+ * @freqs: (out) (optional) (array length=n_results) (transfer full):
+ *   return location for the frequencies of the completions
+ * @n_results: (out) (optional): return location for the number
+ *   of completions
+ *
+ * Retrieves the most frequent terms starting with @text, in
+ * decreasing order of frequency.
+ *
+ * The returned terms do not include the prefix of the index.
+ *
+ * At most #XapianCompletionIndex:top-k completions are returned,
+ * regardless of the value of @max_results.
+ *
+ * Returns: (transfer full) (array zero-terminated=1): the completions
+ *   of @text; use g_strfreev() to free the returned array
+ *
+ * Since: 2.0
+ */
+char **
+xapian_completion_index_complete (XapianCompletionIndex  *index,
+                                  const char             *text,
+                                  unsigned int            max_results,
+                                  guint32               **freqs,
+                                  gsize                  *n_results)
+{
+  g_return_val_if_fail (XAPIAN_IS_COMPLETION_INDEX (index), NULL);
+  g_return_val_if_fail (text != NULL, NULL);
+
+  XapianCompletionIndexPrivate *priv = XAPIAN_COMPLETION_INDEX_GET_PRIVATE (index);
+  GBytes *bytes = NULL;
+  CompletionIndexLayout layout;
+
+  /* The reference keeps the memory of the layout alive */
+  g_mutex_lock (&priv->lock);
+  if (priv->index != NULL)
+    {
+      bytes = g_bytes_ref (priv->index);
+      layout = priv->layout;
+    }
+  g_mutex_unlock (&priv->lock);
+
+  GPtrArray *res = g_ptr_array_new ();
+  GArray *res_freqs = g_array_new (FALSE, FALSE, sizeof (guint32));
+
+  if (bytes != NULL)
+    {
+      const CompletionIndexHeader *header = layout.header;
+      const CompletionIndexNode *node = &layout.nodes[header->root];
+
+      /* Walk down the trie following the bytes of @text */
+      for (const char *p = text; *p != '\0' && node != NULL; p++)
+        {
+          guint8 label = static_cast<guint8> (*p);
+          guint32 lo = node->first_child;
+          guint32 hi = lo + node->n_children;
+
+          node = NULL;
+
+          while (lo < hi)
+            {
+              guint32 mid = lo + (hi - lo) / 2;
+
+              if (layout.nodes[mid].label < label)
+                lo = mid + 1;
+              else if (layout.nodes[mid].label > label)
+                hi = mid;
+              else
+                {
+                  node = &layout.nodes[mid];
+                  break;
+                }
+            }
+        }
+
+      if (node != NULL)
+        {
+          guint32 n_top = MIN (node->n_top, max_results);
+
+          for (guint32 i = 0; i < n_top; i++)
+            {
+              guint32 term = layout.top[node->top_start + i];
+              guint32 start = layout.offsets[term];
+              guint32 end = layout.offsets[term + 1];
+
+              g_ptr_array_add (res, g_strndup (layout.strings + start, end - start));
+              g_array_append_val (res_freqs, layout.freqs[term]);
+            }
+        }
+    }
+
+  if (bytes != NULL)
+    g_bytes_unref (bytes);
+
+  if (n_results != NULL)
+    *n_results = res->len;
+
+  if (freqs != NULL)
+    *freqs = reinterpret_cast<guint32 *> (g_array_free (res_freqs, FALSE));
+  else
+    g_array_free (res_freqs, TRUE);
+
+  g_ptr_array_add (res, NULL);
+
+  return reinterpret_cast<char **> (g_ptr_array_free (res, FALSE));
+}
+
+/**
+ * xapian_completion_index_refresh:
+ * @index: a #XapianCompletionIndex
+ * @error: return location for a #GError, or %NULL
+ *
+ * Rebuilds the @index if the #XapianDatabase changed since the last
+ * time the index was built.
+ *
+ * The index is rebuilt from all the terms of the database, so the cost
+ * of a refresh does not depend on the size of the changes.
+ *
+ * The @index is never refreshed automatically; you should call this
+ * function after calling xapian_database_reopen() on the
+ * #XapianCompletionIndex:database. The current contents of the @index
+ * remain available until the new index has been built.
+ *
+ * Returns: %TRUE if the index is up to date, and %FALSE otherwise
+ *
+ * Since: 2.0
+ */
+gboolean
+xapian_completion_index_refresh (XapianCompletionIndex  *index,
+                                 GError                **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_COMPLETION_INDEX (index), FALSE);
+
+  XapianCompletionIndexPrivate *priv = XAPIAN_COMPLETION_INDEX_GET_PRIVATE (index);
+  GBytes *bytes = NULL;
+  CompletionIndexLayout layout;
+
+  g_mutex_lock (&priv->lock);
+  if (priv->index != NULL)
+    {
+      bytes = g_bytes_ref (priv->index);
+      layout = priv->layout;
+    }
+  g_mutex_unlock (&priv->lock);
+
+  gboolean is_current = FALSE;
+
+  if (bytes != NULL)
+    {
+      try
+        {
+          is_current = is_index_current (index, layout,
+                                         *xapian_database_get_internal (priv->database));
+        }
+      catch (const Xapian::Error &err)
+        {
+          is_current = FALSE;
+        }
+
+      g_bytes_unref (bytes);
+    }
+
+  if (is_current)
+    return TRUE;
+
+  bytes = rebuild_index (index, &layout, error);
+  if (bytes == NULL)
+    return FALSE;
+
+  replace_index (index, bytes, layout);
+
+  return TRUE;
+}
@@ -0,0 +1,60 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __XAPIAN_GLIB_COMPLETION_INDEX_H__
+#define __XAPIAN_GLIB_COMPLETION_INDEX_H__
+
+#if !defined(XAPIAN_GLIB_H_INSIDE) && !defined(XAPIAN_GLIB_COMPILATION)
+#error "Only <xapian-glib.h> can be included directly."
+#endif
+
+#include "xapian-glib-types.h"
+#include "xapian-database.h"
+
+G_BEGIN_DECLS
+
+#define XAPIAN_TYPE_COMPLETION_INDEX    (xapian_completion_index_get_type())
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+G_DECLARE_DERIVABLE_TYPE (XapianCompletionIndex, xapian_completion_index, XAPIAN, COMPLETION_INDEX, GObject)
+
+struct _XapianCompletionIndexClass
+{
+  /*< private >*/
+  GObjectClass parent_instance;
+};
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianCompletionIndex * xapian_completion_index_new             (XapianDatabase         *database,
+                                                                 const char             *path,
+                                                                 const char             *prefix,
+                                                                 unsigned int            top_k,
+                                                                 GError                **error);
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+char **                 xapian_completion_index_complete        (XapianCompletionIndex  *index,
+                                                                 const char             *text,
+                                                                 unsigned int            max_results,
+                                                                 guint32               **freqs,
+                                                                 gsize                  *n_results);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+gboolean                xapian_completion_index_refresh         (XapianCompletionIndex  *index,
+                                                                 GError                **error);
+
+G_END_DECLS
+
+#endif /* __XAPIAN_GLIB_COMPLETION_INDEX_H__ */
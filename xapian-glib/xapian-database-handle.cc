@@ -0,0 +1,538 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-database-handle
+ * @Title: XapianDatabaseHandle
+ * @short_description: Hot-swappable database snapshots
+ *
+ * xapian_database_reopen() updates a #XapianDatabase in place, so it
+ * cannot be called while other threads are using the same database.
+ *
+ * #XapianDatabaseHandle gives access to the latest revision of the
+ * database at a given path without this limitation: each reader
+ * acquires its own #XapianDatabase at the current revision using
+ * xapian_database_handle_acquire(), and uses it for as long as it
+ * needs; xapian_database_handle_reopen() publishes the latest revision
+ * of the database for the readers that come after it.
+ *
+ * Readers give their database back using xapian_database_handle_release();
+ * databases at the current revision are kept by the handle and lent
+ * again to the next readers, while the databases at older revisions
+ * are closed.
+ *
+ * |[<!-- language="C" -->
+ *   // In each reader thread
+ *   XapianDatabase *db = xapian_database_handle_acquire (handle, &error);
+ *   XapianEnquire *enquire = xapian_enquire_new (db, &error);
+ *
+ *   // ...
+ *
+ *   g_object_unref (enquire);
+ *   xapian_database_handle_release (handle, db);
+ *
+ *   // In the thread watching for updates
+ *   xapian_database_handle_reopen (handle, &error);
+ * ]|
+ */
+
+#include "config.h"
+
+#include <vector>
+
+#include "xapian-database-handle.h"
+
+#include "xapian-database-private.h"
+#include "xapian-enums.h"
+
+#define XAPIAN_DATABASE_HANDLE_GET_PRIVATE(obj) \
+  ((XapianDatabaseHandlePrivate *) xapian_database_handle_get_instance_private ((XapianDatabaseHandle *) (obj)))
+
+typedef struct {
+  char *path;
+
+  /* Protects the idle databases and the generation, and serializes
+   * reopens
+   */
+  GMutex lock;
+  GMutex reopen_lock;
+
+  /* The databases at the current revision not used by any reader */
+  std::vector<XapianDatabase *> *mIdle;
+
+  /* Incremented each time a new revision is published */
+  guint generation;
+  guint64 revision;
+} XapianDatabaseHandlePrivate;
+
+enum {
+  PROP_0,
+
+  PROP_PATH,
+
+  LAST_PROP
+};
+
+static GParamSpec *obj_props[LAST_PROP] = { NULL, };
+
+static void initable_iface_init (GInitableIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (XapianDatabaseHandle, xapian_database_handle, G_TYPE_OBJECT,
+                         G_ADD_PRIVATE (XapianDatabaseHandle)
+                         G_IMPLEMENT_INTERFACE (G_TYPE_INITABLE, initable_iface_init))
+
+/* The generation a database was lent for, stored on the database */
+G_DEFINE_QUARK (xapian-database-handle-generation, database_generation)
+
+static void
+set_database_generation (XapianDatabase *database,
+                         guint           generation)
+{
+  g_object_set_qdata (G_OBJECT (database), database_generation_quark (),
+                      GUINT_TO_POINTER (generation));
+}
+
+static guint
+get_database_generation (XapianDatabase *database)
+{
+  return GPOINTER_TO_UINT (g_object_get_qdata (G_OBJECT (database),
+                                               database_generation_quark ()));
+}
+
+/* Adds @database, at @revision, to the idle databases; if @revision is
+ * newer than the current one, it is published, and the idle databases
+ * of the previous generation are moved to @stale, so that they can be
+ * released without holding the lock.
+ *
+ * Databases at an older revision are dropped.
+ *
+ * Must be called with the lock held.
+ */
+static void
+add_idle_database (XapianDatabaseHandlePrivate   *priv,
+                   XapianDatabase                *database,
+                   guint64                        revision,
+                   std::vector<XapianDatabase *> &stale)
+{
+  /* Databases combining multiple shards have no revision, so we
+   * cannot tell whether they changed
+   */
+  if (revision == 0 || revision > priv->revision)
+    {
+      stale.swap (*priv->mIdle);
+      priv->generation += 1;
+      priv->revision = revision;
+    }
+  else if (revision < priv->revision)
+    {
+      stale.push_back (database);
+      return;
+    }
+
+  set_database_generation (database, priv->generation);
+  priv->mIdle->push_back (database);
+}
+
+static void
+release_databases (std::vector<XapianDatabase *> &databases)
+{
+  for (XapianDatabase *database : databases)
+    g_object_unref (database);
+
+  databases.clear ();
+}
+
+static gboolean
+xapian_database_handle_init_internal (GInitable    *self,
+                                      GCancellable *cancellable,
+                                      GError      **error)
+{
+  XapianDatabaseHandlePrivate *priv = XAPIAN_DATABASE_HANDLE_GET_PRIVATE (self);
+
+  if (priv->path == NULL)
+    {
+      g_set_error_literal (error, XAPIAN_ERROR,
+                           XAPIAN_ERROR_INVALID_ARGUMENT,
+                           "A database path is required to create a database handle");
+      return FALSE;
+    }
+
+  XapianDatabase *database = xapian_database_new_with_path (priv->path, error);
+  if (database == NULL)
+    return FALSE;
+
+  priv->generation = 1;
+  priv->revision = xapian_database_get_revision (database);
+
+  set_database_generation (database, priv->generation);
+  priv->mIdle->push_back (database);
+
+  return TRUE;
+}
+
+static void
+initable_iface_init (GInitableIface *iface)
+{
+  iface->init = xapian_database_handle_init_internal;
+}
+
+static void
+xapian_database_handle_dispose (GObject *gobject)
+{
+  XapianDatabaseHandlePrivate *priv = XAPIAN_DATABASE_HANDLE_GET_PRIVATE (gobject);
+
+  release_databases (*priv->mIdle);
+
+  G_OBJECT_CLASS (xapian_database_handle_parent_class)->dispose (gobject);
+}
+
+static void
+xapian_database_handle_finalize (GObject *gobject)
+{
+  XapianDatabaseHandlePrivate *priv = XAPIAN_DATABASE_HANDLE_GET_PRIVATE (gobject);
+
+  g_mutex_clear (&priv->lock);
+  g_mutex_clear (&priv->reopen_lock);
+
+  delete priv->mIdle;
+
+  g_free (priv->path);
+
+  G_OBJECT_CLASS (xapian_database_handle_parent_class)->finalize (gobject);
+}
+
+static void
+xapian_database_handle_set_property (GObject      *gobject,
+                                     guint         prop_id,
+                                     const GValue *value,
+                                     GParamSpec   *pspec)
+{
+  XapianDatabaseHandlePrivate *priv = XAPIAN_DATABASE_HANDLE_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_PATH:
+      g_free (priv->path);
+      priv->path = g_value_dup_string (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_database_handle_get_property (GObject    *gobject,
+                                     guint       prop_id,
+                                     GValue     *value,
+                                     GParamSpec *pspec)
+{
+  XapianDatabaseHandlePrivate *priv = XAPIAN_DATABASE_HANDLE_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_PATH:
+      g_value_set_string (value, priv->path);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_database_handle_class_init (XapianDatabaseHandleClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  /**
+   * XapianDatabaseHandle:path:
+   *
+   * The path of the database.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_PATH] =
+    g_param_spec_string ("path",
+                         "Path",
+                         "The path of the database",
+                         NULL,
+                         (GParamFlags) (G_PARAM_READWRITE |
+                                        G_PARAM_CONSTRUCT_ONLY |
+                                        G_PARAM_STATIC_STRINGS));
+
+  gobject_class->set_property = xapian_database_handle_set_property;
+  gobject_class->get_property = xapian_database_handle_get_property;
+  gobject_class->dispose = xapian_database_handle_dispose;
+  gobject_class->finalize = xapian_database_handle_finalize;
+
+  g_object_class_install_properties (gobject_class, LAST_PROP, obj_props);
+}
+
+static void
+xapian_database_handle_init (XapianDatabaseHandle *self)
+{
+  XapianDatabaseHandlePrivate *priv = XAPIAN_DATABASE_HANDLE_GET_PRIVATE (self);
+
+  g_mutex_init (&priv->lock);
+  g_mutex_init (&priv->reopen_lock);
+
+  priv->mIdle = new std::vector<XapianDatabase *> ();
+}
+
+/**
+ * xapian_database_handle_new:
+ * @path: the path of the database
+ * @error: return location for a #GError, or %NULL
+ *
+ * Creates and initializes a new #XapianDatabaseHandle, opening the
+ * database at @path.
+ *
+ * If the initialization was not successful, @error is set.
+ *
+ * Returns: (transfer full): the newly created #XapianDatabaseHandle
+ *   instance, or %NULL if the initialization failed
+ *
+ * Since: 2.0
+ */
+XapianDatabaseHandle *
+xapian_database_handle_new (const char  *path,
+                            GError     **error)
+{
+  g_return_val_if_fail (path != NULL, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  return static_cast<XapianDatabaseHandle *> (g_initable_new (XAPIAN_TYPE_DATABASE_HANDLE,
+                                                              NULL, error,
+                                                              "path", path,
+                                                              NULL));
+}
+
+/**
+ * xapian_database_handle_acquire:
+ * @handle: a #XapianDatabaseHandle
+ * @error: return location for a #GError, or %NULL
+ *
+ * Acquires a #XapianDatabase at the current revision of the database.
+ *
+ * The returned database is not shared with other readers, so it can
+ * be used from any thread, one thread at a time; it is not affected by
+ * calls to xapian_database_handle_reopen(), and it should be given back
+ * using xapian_database_handle_release() once the reader is done.
+ *
+ * If no database at the current revision is available, a new one is
+ * opened; if the database was modified after the current revision was
+ * published, the new database sees the latest revision, which becomes
+ * the current one.
+ *
+ * Returns: (transfer full): a #XapianDatabase, or %NULL if the
+ *   database could not be opened
+ *
+ * Since: 2.0
+ */
+XapianDatabase *
+xapian_database_handle_acquire (XapianDatabaseHandle  *handle,
+                                GError               **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_DATABASE_HANDLE (handle), NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  XapianDatabaseHandlePrivate *priv = XAPIAN_DATABASE_HANDLE_GET_PRIVATE (handle);
+  XapianDatabase *res = NULL;
+
+  g_mutex_lock (&priv->lock);
+  if (!priv->mIdle->empty ())
+    {
+      res = priv->mIdle->back ();
+      priv->mIdle->pop_back ();
+    }
+  g_mutex_unlock (&priv->lock);
+
+  if (res != NULL)
+    return res;
+
+  /* Opening the database happens without blocking the other readers */
+  res = xapian_database_new_with_path (priv->path, error);
+  if (res == NULL)
+    return NULL;
+
+  guint64 revision = xapian_database_get_revision (res);
+  std::vector<XapianDatabase *> stale;
+
+  g_mutex_lock (&priv->lock);
+
+  if (revision == priv->revision)
+    set_database_generation (res, priv->generation);
+  else if (revision > priv->revision)
+    {
+      /* Publish the new revision, and lend the new database */
+      add_idle_database (priv, res, revision, stale);
+      priv->mIdle->pop_back ();
+    }
+  else
+    set_database_generation (res, 0);
+
+  g_mutex_unlock (&priv->lock);
+
+  release_databases (stale);
+
+  return res;
+}
+
+/**
+ * xapian_database_handle_release:
+ * @handle: a #XapianDatabaseHandle
+ * @database: (transfer full): a #XapianDatabase returned by
+ *   xapian_database_handle_acquire()
+ *
+ * Gives back a #XapianDatabase acquired from the @handle.
+ *
+ * If @database is at the current revision, the @handle keeps it for
+ * the next readers; otherwise, @database is closed once its last
+ * reference is released.
+ *
+ * Neither @database nor the objects created from it, like #XapianEnquire,
+ * should be used after calling this function.
+ *
+ * Since: 2.0
+ */
+void
+xapian_database_handle_release (XapianDatabaseHandle *handle,
+                                XapianDatabase       *database)
+{
+  g_return_if_fail (XAPIAN_IS_DATABASE_HANDLE (handle));
+  g_return_if_fail (XAPIAN_IS_DATABASE (database));
+
+  XapianDatabaseHandlePrivate *priv = XAPIAN_DATABASE_HANDLE_GET_PRIVATE (handle);
+  guint generation = get_database_generation (database);
+
+  g_mutex_lock (&priv->lock);
+  if (generation == priv->generation)
+    {
+      priv->mIdle->push_back (database);
+      database = NULL;
+    }
+  g_mutex_unlock (&priv->lock);
+
+  /* Drop the database outside of the lock, as this may close it */
+  g_clear_object (&database);
+}
+
+/**
+ * xapian_database_handle_reopen:
+ * @handle: a #XapianDatabaseHandle
+ * @error: return location for a #GError, or %NULL
+ *
+ * Checks the latest revision of the database and, if it differs from
+ * the current revision, publishes it as the new current revision.
+ *
+ * The check reopens one of the idle databases of the @handle, if any,
+ * instead of opening the database again.
+ *
+ * Readers holding a database at the previous revision are not
+ * affected; their database is closed once it is released.
+ *
+ * Returns: %TRUE if the reopen was successful, and %FALSE otherwise
+ *
+ * Since: 2.0
+ */
+gboolean
+xapian_database_handle_reopen (XapianDatabaseHandle  *handle,
+                               GError               **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_DATABASE_HANDLE (handle), FALSE);
+  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  XapianDatabaseHandlePrivate *priv = XAPIAN_DATABASE_HANDLE_GET_PRIVATE (handle);
+  XapianDatabase *database = NULL;
+
+  /* Reopening the database is the expensive part, and it happens without
+   * blocking the readers; we only need to avoid concurrent reopens
+   */
+  g_mutex_lock (&priv->reopen_lock);
+
+  g_mutex_lock (&priv->lock);
+  if (!priv->mIdle->empty ())
+    {
+      database = priv->mIdle->back ();
+      priv->mIdle->pop_back ();
+    }
+  g_mutex_unlock (&priv->lock);
+
+  if (database != NULL)
+    {
+      /* Nobody else is using the idle database, so it can be reopened
+       * in place
+       */
+      try
+        {
+          xapian_database_get_internal (database)->reopen ();
+        }
+      catch (const Xapian::Error &err)
+        {
+          xapian_database_error_to_gerror (database, err, error);
+          g_mutex_unlock (&priv->reopen_lock);
+          g_object_unref (database);
+          return FALSE;
+        }
+    }
+  else
+    {
+      database = xapian_database_new_with_path (priv->path, error);
+      if (database == NULL)
+        {
+          g_mutex_unlock (&priv->reopen_lock);
+          return FALSE;
+        }
+    }
+
+  guint64 revision = xapian_database_get_revision (database);
+  std::vector<XapianDatabase *> stale;
+
+  g_mutex_lock (&priv->lock);
+  add_idle_database (priv, database, revision, stale);
+  g_mutex_unlock (&priv->lock);
+
+  g_mutex_unlock (&priv->reopen_lock);
+
+  /* Drop the databases at the previous revision outside of the locks,
+   * as this may close them
+   */
+  release_databases (stale);
+
+  return TRUE;
+}
+
+/**
+ * xapian_database_handle_get_path:
+ * @handle: a #XapianDatabaseHandle
+ *
+ * Retrieves the value of the #XapianDatabaseHandle:path property.
+ *
+ * Returns: (transfer none): the path of the database
+ *
+ * Since: 2.0
+ */
+const char *
+xapian_database_handle_get_path (XapianDatabaseHandle *handle)
+{
+  g_return_val_if_fail (XAPIAN_IS_DATABASE_HANDLE (handle), NULL);
+
+  XapianDatabaseHandlePrivate *priv = XAPIAN_DATABASE_HANDLE_GET_PRIVATE (handle);
+
+  return priv->path;
+}
@@ -0,0 +1,60 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __XAPIAN_GLIB_DATABASE_HANDLE_H__
+#define __XAPIAN_GLIB_DATABASE_HANDLE_H__
+
+#if !defined(XAPIAN_GLIB_H_INSIDE) && !defined(XAPIAN_GLIB_COMPILATION)
+#error "Only <xapian-glib.h> can be included directly."
+#endif
+
+#include "xapian-glib-types.h"
+#include "xapian-database.h"
+
+G_BEGIN_DECLS
+
+#define XAPIAN_TYPE_DATABASE_HANDLE     (xapian_database_handle_get_type())
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+G_DECLARE_DERIVABLE_TYPE (XapianDatabaseHandle, xapian_database_handle, XAPIAN, DATABASE_HANDLE, GObject)
+
+struct _XapianDatabaseHandleClass
+{
+  /*< private >*/
+  GObjectClass parent_instance;
+};
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianDatabaseHandle *  xapian_database_handle_new              (const char            *path,
+                                                                 GError               **error);
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianDatabase *        xapian_database_handle_acquire          (XapianDatabaseHandle  *handle,
+                                                                 GError               **error);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+void                    xapian_database_handle_release          (XapianDatabaseHandle  *handle,
+                                                                 XapianDatabase        *database);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+gboolean                xapian_database_handle_reopen           (XapianDatabaseHandle  *handle,
+                                                                 GError               **error);
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+const char *            xapian_database_handle_get_path         (XapianDatabaseHandle  *handle);
+
+G_END_DECLS
+
+#endif /* __XAPIAN_GLIB_DATABASE_HANDLE_H__ */
@@ -17,6 +17,8 @@
 #ifndef __XAPIAN_GLIB_DATABASE_PRIVATE_H__
 #define __XAPIAN_GLIB_DATABASE_PRIVATE_H__
 
+#include <vector>
+
 #include <xapian.h>
 #include <glib.h>
 #include "xapian-database.h"
@@ -29,5 +31,18 @@ void			xapian_database_set_is_writable	(XapianDatabase   *self,
 gboolean                xapian_database_get_is_writable (XapianDatabase   *self);
 const char *            xapian_database_get_path        (XapianDatabase   *self);
 int                     xapian_database_get_flags       (XapianDatabase   *self);
+XapianDatabase *        xapian_database_new_from_database (const Xapian::Database &aDB);
+void                    xapian_database_set_is_pinned   (XapianDatabase   *self,
+                                                         gboolean          is_pinned);
+std::vector<guint64>    xapian_database_get_revisions   (XapianDatabase   *self);
+void                    xapian_database_error_to_gerror (XapianDatabase       *self,
+                                                         const Xapian::Error  &err,
+                                                         GError              **error);
+gboolean                xapian_database_maybe_reopen    (XapianDatabase       *self,
+                                                         const Xapian::Error  &err,
+                                                         unsigned int         *n_retries,
+                                                         GError              **error);
+XapianDocument *        xapian_database_wrap_document   (XapianDatabase         *self,
+                                                         const Xapian::Document &aDoc);
 
 #endif /* __XAPIAN_GLIB_DATABASE_PRIVATE_H__ */
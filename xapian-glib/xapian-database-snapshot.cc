@@ -0,0 +1,82 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-database-snapshot
+ * @Title: XapianDatabaseSnapshot
+ * @short_description: A database pinned to a single revision
+ *
+ * #XapianDatabaseSnapshot is a #XapianDatabase sub-class that stays
+ * on the revision that was current when it was opened; it can be
+ * used with #XapianEnquire to paginate through results, or to export
+ * documents, while seeing the same revision of the database across
+ * all calls.
+ *
+ * The revision seen by the snapshot can be retrieved using
+ * xapian_database_get_revision().
+ *
+ * A snapshot does not block writers; once a writer has committed
+ * enough times for the revision to be recycled, operations on the
+ * snapshot fail with %XAPIAN_ERROR_REVISION_UNAVAILABLE, and a new
+ * snapshot must be opened to restart the operation.
+ */
+
+#include "config.h"
+
+#include "xapian-database-snapshot.h"
+#include "xapian-database-private.h"
+
+G_DEFINE_TYPE (XapianDatabaseSnapshot, xapian_database_snapshot, XAPIAN_TYPE_DATABASE)
+
+static void
+xapian_database_snapshot_class_init (XapianDatabaseSnapshotClass *klass)
+{
+}
+
+static void
+xapian_database_snapshot_init (XapianDatabaseSnapshot *self)
+{
+  xapian_database_set_is_pinned (XAPIAN_DATABASE (self), TRUE);
+}
+
+/**
+ * xapian_database_snapshot_new:
+ * @path: (not nullable): the path of the database
+ * @error: return location for a #GError, or %NULL
+ *
+ * Creates and initializes a #XapianDatabaseSnapshot pinned to the
+ * current revision of the database at @path.
+ *
+ * If the initialization was not successful, this function
+ * returns %NULL and sets @error.
+ *
+ * Returns: (transfer full): the newly created #XapianDatabaseSnapshot
+ *   instance
+ *
+ * Since: 2.0
+ */
+XapianDatabaseSnapshot *
+xapian_database_snapshot_new (const char  *path,
+                              GError     **error)
+{
+  g_return_val_if_fail (path != NULL, NULL);
+
+  return static_cast<XapianDatabaseSnapshot *> (g_initable_new (XAPIAN_TYPE_DATABASE_SNAPSHOT,
+                                                                NULL, error,
+                                                                "path", path,
+                                                                NULL));
+}
@@ -25,6 +25,18 @@
  *
  * Typically, you will use #XapianDatabase to open a database for
  * querying, by using the #XapianEnquire class.
+ *
+ * A database opened for reading sees the revision that was current
+ * when it was opened, or last reopened; if a writer commits too many
+ * times while a query is running, the query fails with
+ * %XAPIAN_ERROR_DATABASE_MODIFIED. Setting the
+ * #XapianDatabase:max-reopen-retries property makes #XapianDatabase and
+ * #XapianEnquire reopen the database and retry the operation instead.
+ *
+ * Applications can also use xapian_database_start_monitor() to be
+ * notified through the #XapianDatabase::revision-changed signal when
+ * a new revision of the database is committed, and refresh their
+ * caches before a query fails.
  */
 
 #include "config.h"
@@ -44,6 +56,9 @@
 #define XAPIAN_DATABASE_GET_PRIVATE(obj) \
   ((XapianDatabasePrivate *) xapian_database_get_instance_private ((XapianDatabase *) (obj)))
 
+/* The interval used to coalesce the changes to a monitored database */
+#define MONITOR_DEBOUNCE_MSEC   200
+
 typedef struct _XapianDatabasePrivate   XapianDatabasePrivate;
 
 struct _XapianDatabasePrivate
@@ -55,6 +70,16 @@ struct _XapianDatabasePrivate
 
   Xapian::Database *mDB;
 
+  /* The databases added with xapian_database_add_database() */
+  std::vector<Xapian::Database> *mShards;
+
+  guint max_reopen_retries;
+  guint is_pinned : 1;
+
+  GFileMonitor *monitor;
+  GSource *monitor_timeout;
+  guint64 monitored_revision;
+
   guint is_writable : 1;
 };
 
@@ -66,12 +91,22 @@ enum
   PROP_OFFSET,
   PROP_FLAGS,
   PROP_BACKEND,
+  PROP_MAX_REOPEN_RETRIES,
 
   LAST_PROP
 };
 
 static GParamSpec *obj_props[LAST_PROP] = { NULL, };
 
+enum
+{
+  REVISION_CHANGED,
+
+  LAST_SIGNAL
+};
+
+static guint obj_signals[LAST_SIGNAL] = { 0, };
+
 static void initable_iface_init (GInitableIface *iface);
 
 G_DEFINE_TYPE_WITH_CODE (XapianDatabase, xapian_database, G_TYPE_OBJECT,
@@ -193,8 +228,10 @@ xapian_database_set_internal (XapianDatabase   *self,
   XapianDatabasePrivate *priv = XAPIAN_DATABASE_GET_PRIVATE (self);
 
   delete priv->mDB;
+  delete priv->mShards;
 
   priv->mDB = aDB;
+  priv->mShards = NULL;
 }
 
 /*< private >
@@ -251,6 +288,201 @@ xapian_database_get_path (XapianDatabase *self)
   return priv->path;
 }
 
+/*< private >
+ * xapian_database_new_from_database:
+ * @aDB: a `Xapian::Database` instance
+ *
+ * Creates a new #XapianDatabase wrapping a copy of @aDB.
+ *
+ * Returns: (transfer full): the newly created #XapianDatabase
+ */
+XapianDatabase *
+xapian_database_new_from_database (const Xapian::Database &aDB)
+{
+  XapianDatabase *res = static_cast<XapianDatabase *> (g_object_new (XAPIAN_TYPE_DATABASE, NULL));
+
+  xapian_database_set_internal (res, new Xapian::Database (aDB));
+
+  return res;
+}
+
+/*< private >
+ * xapian_database_set_is_pinned:
+ * @self: a #XapianDatabase
+ * @is_pinned: whether the database must stay on the same revision
+ *
+ * Sets the pinned bit on the #XapianDatabase wrapper; pinned
+ * databases are never reopened, and report the recycling of
+ * their revision with %XAPIAN_ERROR_REVISION_UNAVAILABLE.
+ */
+void
+xapian_database_set_is_pinned (XapianDatabase *self,
+                               gboolean        is_pinned)
+{
+  XapianDatabasePrivate *priv = XAPIAN_DATABASE_GET_PRIVATE (self);
+
+  priv->is_pinned = !!is_pinned;
+}
+
+static guint64
+get_database_revision (const Xapian::Database &aDB)
+{
+  try
+    {
+      return aDB.get_revision ();
+    }
+  catch (const Xapian::Error &err)
+    {
+      /* Databases combining multiple shards do not have a revision */
+      return 0;
+    }
+}
+
+/*< private >
+ * xapian_database_get_revisions:
+ * @self: a #XapianDatabase
+ *
+ * Retrieves the revision of each shard of @self; unlike
+ * xapian_database_get_revision(), this also works for databases
+ * combining multiple shards.
+ *
+ * Shards without revisions, like in-memory databases, have a
+ * revision of 0.
+ *
+ * Returns: the revisions of the shards, or an empty vector if
+ *   they are not known
+ */
+std::vector<guint64>
+xapian_database_get_revisions (XapianDatabase *self)
+{
+  XapianDatabasePrivate *priv = XAPIAN_DATABASE_GET_PRIVATE (self);
+  std::vector<guint64> res;
+
+  if (priv->mShards == NULL)
+    {
+      if (priv->mDB->size () == 1)
+        res.push_back (get_database_revision (*priv->mDB));
+
+      return res;
+    }
+
+  /* The shards were not all added through xapian_database_add_database() */
+  if (priv->mShards->size () != priv->mDB->size ())
+    return res;
+
+  for (const Xapian::Database &shard : *priv->mShards)
+    res.push_back (get_database_revision (shard));
+
+  return res;
+}
+
+/*< private >
+ * xapian_database_error_to_gerror:
+ * @self: (nullable): the #XapianDatabase that threw @err, or %NULL
+ * @err: the error thrown by an operation on @self
+ * @error: return location for a #GError, or %NULL
+ *
+ * Translates @err into @error; if @self is pinned to a revision, the
+ * recycling of that revision is reported using
+ * %XAPIAN_ERROR_REVISION_UNAVAILABLE.
+ *
+ * This function should be used by all the operations that read from
+ * a #XapianDatabase, including the objects created from it, like
+ * #XapianMSet and #XapianTermIterator.
+ */
+void
+xapian_database_error_to_gerror (XapianDatabase       *self,
+                                 const Xapian::Error  &err,
+                                 GError              **error)
+{
+  if (self != NULL &&
+      XAPIAN_DATABASE_GET_PRIVATE (self)->is_pinned &&
+      g_str_equal (err.get_type (), "DatabaseModifiedError"))
+    {
+      g_set_error (error, XAPIAN_ERROR, XAPIAN_ERROR_REVISION_UNAVAILABLE,
+                   "Revision %" G_GUINT64_FORMAT " of the database is no "
+                   "longer available",
+                   get_database_revision (*xapian_database_get_internal (self)));
+      return;
+    }
+
+  GError *internal_error = NULL;
+
+  xapian_error_to_gerror (err, &internal_error);
+  g_propagate_error (error, internal_error);
+}
+
+/*< private >
+ * xapian_database_maybe_reopen:
+ * @self: a #XapianDatabase
+ * @err: the error thrown by an operation on @self
+ * @n_retries: (inout): the number of times the operation was retried
+ * @error: return location for a #GError, or %NULL
+ *
+ * Checks whether the operation that threw @err should be retried,
+ * according to the #XapianDatabase:max-reopen-retries property; if
+ * that's the case, @self is reopened and @n_retries is incremented.
+ *
+ * Otherwise, @err is translated into @error using
+ * xapian_database_error_to_gerror().
+ *
+ * Returns: %TRUE if the operation should be retried
+ */
+gboolean
+xapian_database_maybe_reopen (XapianDatabase       *self,
+                              const Xapian::Error  &err,
+                              unsigned int         *n_retries,
+                              GError              **error)
+{
+  XapianDatabasePrivate *priv = XAPIAN_DATABASE_GET_PRIVATE (self);
+  gboolean is_modified = g_str_equal (err.get_type (), "DatabaseModifiedError");
+
+  if (is_modified && !priv->is_pinned && *n_retries < priv->max_reopen_retries)
+    {
+      try
+        {
+          priv->mDB->reopen ();
+
+          *n_retries += 1;
+
+          return TRUE;
+        }
+      catch (const Xapian::Error &reopen_err)
+        {
+        }
+    }
+
+  xapian_database_error_to_gerror (self, err, error);
+
+  return FALSE;
+}
+
+/*< private >
+ * xapian_database_wrap_document:
+ * @self: (nullable): the #XapianDatabase containing @aDoc, or %NULL
+ * @aDoc: a document read from @self
+ *
+ * Creates a #XapianDocument for @aDoc.
+ *
+ * The data of a document is only read from the database when it is
+ * first accessed, and xapian_document_get_data() cannot report an
+ * error; if @self is pinned to a revision, the data is read now, so
+ * that the recycling of the revision is reported by the caller.
+ *
+ * This function can throw a `Xapian::Error`.
+ *
+ * Returns: (transfer full): the newly created #XapianDocument
+ */
+XapianDocument *
+xapian_database_wrap_document (XapianDatabase         *self,
+                               const Xapian::Document &aDoc)
+{
+  if (self != NULL && XAPIAN_DATABASE_GET_PRIVATE (self)->is_pinned)
+    aDoc.get_data ();
+
+  return xapian_document_new_from_document (aDoc);
+}
+
 static Xapian::Database *
 open_database (XapianDatabase *self)
 {
@@ -317,12 +549,21 @@ initable_iface_init (GInitableIface *iface)
   iface->init = xapian_database_init_internal;
 }
 
+static void
+xapian_database_dispose (GObject *self)
+{
+  xapian_database_stop_monitor (XAPIAN_DATABASE (self));
+
+  G_OBJECT_CLASS (xapian_database_parent_class)->dispose (self);
+}
+
 static void
 xapian_database_finalize (GObject *self)
 {
   XapianDatabasePrivate *priv = XAPIAN_DATABASE_GET_PRIVATE (self);
 
   delete priv->mDB;
+  delete priv->mShards;
 
   g_free (priv->path);
 
@@ -356,6 +597,10 @@ xapian_database_set_property (GObject      *gobject,
       priv->backend = (XapianDatabaseBackend) g_value_get_enum (value);
       break;
 
+    case PROP_MAX_REOPEN_RETRIES:
+      priv->max_reopen_retries = g_value_get_uint (value);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -387,6 +632,10 @@ xapian_database_get_property (GObject    *gobject,
       g_value_set_enum (value, (int) priv->backend);
       break;
 
+    case PROP_MAX_REOPEN_RETRIES:
+      g_value_set_uint (value, priv->max_reopen_retries);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -399,6 +648,7 @@ xapian_database_class_init (XapianDatabaseClass *klass)
 
   gobject_class->set_property = xapian_database_set_property;
   gobject_class->get_property = xapian_database_get_property;
+  gobject_class->dispose = xapian_database_dispose;
   gobject_class->finalize = xapian_database_finalize;
 
   /**
@@ -458,7 +708,54 @@ xapian_database_class_init (XapianDatabaseClass *klass)
                                       G_PARAM_CONSTRUCT_ONLY |
                                       G_PARAM_STATIC_STRINGS));
 
+  /**
+   * XapianDatabase:max-reopen-retries:
+   *
+   * The maximum number of times an operation failing with
+   * %XAPIAN_ERROR_DATABASE_MODIFIED is retried after reopening
+   * the database.
+   *
+   * Reopening the database updates it in place, so this property
+   * should only be set on databases that are not shared between
+   * threads.
+   *
+   * The default value of 0 disables retries. A #XapianDatabaseSnapshot
+   * is never reopened, regardless of the value of this property.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_MAX_REOPEN_RETRIES] =
+    g_param_spec_uint ("max-reopen-retries", "", "",
+                       0, G_MAXUINT, 0,
+                       (GParamFlags) (G_PARAM_READWRITE |
+                                      G_PARAM_EXPLICIT_NOTIFY |
+                                      G_PARAM_STATIC_STRINGS));
+
   g_object_class_install_properties (gobject_class, LAST_PROP, obj_props);
+
+  /**
+   * XapianDatabase::revision-changed:
+   * @db: the #XapianDatabase that emitted the signal
+   * @revision: the revision of the database on disk
+   *
+   * Emitted when a new revision of a database monitored using
+   * xapian_database_start_monitor() is committed.
+   *
+   * The @db itself is not reopened; handlers can use
+   * xapian_database_reopen(), or xapian_database_handle_reopen(),
+   * to start using the new revision.
+   *
+   * Since: 2.0
+   */
+  obj_signals[REVISION_CHANGED] =
+    g_signal_new ("revision-changed",
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST,
+                  0,
+                  NULL, NULL,
+                  NULL,
+                  G_TYPE_NONE, 1,
+                  G_TYPE_UINT64);
 }
 
 static void
@@ -533,12 +830,19 @@ xapian_database_close (XapianDatabase *db)
  *
  * Reopens a #XapianDatabase.
  *
+ * The database is updated in place, so this function must not be called
+ * while other threads are using @db; see #XapianDatabaseHandle for a way
+ * to switch to newer revisions of a database under concurrent readers.
+ *
+ * A #XapianDatabaseSnapshot cannot be reopened.
+ *
  * Since: 2.0
  */
 void
 xapian_database_reopen (XapianDatabase *db)
 {
   g_return_if_fail (XAPIAN_IS_DATABASE (db));
+  g_return_if_fail (!XAPIAN_DATABASE_GET_PRIVATE (db)->is_pinned);
 
   xapian_database_get_internal (db)->reopen ();
 }
@@ -603,23 +907,50 @@ xapian_database_get_metadata (XapianDatabase  *db,
   g_return_val_if_fail (XAPIAN_IS_DATABASE (db), NULL);
   g_return_val_if_fail (key != NULL, NULL);
 
-  try
-    {
-      std::string str = xapian_database_get_internal (db)->get_metadata (std::string (key));
+  unsigned int n_retries = 0;
 
-      return g_strdup (str.c_str ());
-    }
-  catch (const Xapian::Error &err)
+  while (true)
     {
-      GError *internal_error = NULL;
+      try
+        {
+          std::string str = xapian_database_get_internal (db)->get_metadata (std::string (key));
 
-      xapian_error_to_gerror (err, &internal_error);
-      g_propagate_error (error, internal_error);
+          return g_strdup (str.c_str ());
+        }
+      catch (const Xapian::Error &err)
+        {
+          if (xapian_database_maybe_reopen (db, err, &n_retries, error))
+            continue;
 
-      return NULL;
+          return NULL;
+        }
     }
 }
 
+/**
+ * xapian_database_get_revision:
+ * @db: a #XapianDatabase
+ *
+ * Retrieves the revision of the database seen by @db.
+ *
+ * Each commit creates a new revision of the database; the revision
+ * seen by @db changes only when @db is reopened.
+ *
+ * Databases without a single revision, like databases combining
+ * other databases using xapian_database_add_database(), return 0.
+ *
+ * Returns: the revision of the database
+ *
+ * Since: 2.0
+ */
+guint64
+xapian_database_get_revision (XapianDatabase *db)
+{
+  g_return_val_if_fail (XAPIAN_IS_DATABASE (db), 0);
+
+  return get_database_revision (*xapian_database_get_internal (db));
+}
+
 /**
  * xapian_database_get_doc_count:
  * @db: a #XapianDatabase
@@ -692,20 +1023,23 @@ xapian_database_get_document (XapianDatabase  *db,
   g_return_val_if_fail (XAPIAN_IS_DATABASE (db), NULL);
   g_return_val_if_fail (docid > 0, NULL);
 
-  try
-    {
-      Xapian::Document doc = xapian_database_get_internal (db)->get_document (docid);
+  unsigned int n_retries = 0;
 
-      return xapian_document_new_from_document (doc);
-    }
-  catch (const Xapian::Error &err)
+  while (true)
     {
-      GError *internal_error = NULL;
+      try
+        {
+          Xapian::Document doc = xapian_database_get_internal (db)->get_document (docid);
 
-      xapian_error_to_gerror (err, &internal_error);
-      g_propagate_error (error, internal_error);
+          return xapian_database_wrap_document (db, doc);
+        }
+      catch (const Xapian::Error &err)
+        {
+          if (xapian_database_maybe_reopen (db, err, &n_retries, error))
+            continue;
 
-      return NULL;
+          return NULL;
+        }
     }
 }
 
@@ -768,8 +1102,29 @@ xapian_database_add_database (XapianDatabase *db,
   g_return_if_fail (XAPIAN_IS_DATABASE (db));
   g_return_if_fail (XAPIAN_IS_DATABASE (new_db));
 
+  XapianDatabasePrivate *priv = XAPIAN_DATABASE_GET_PRIVATE (db);
+  XapianDatabasePrivate *new_priv = XAPIAN_DATABASE_GET_PRIVATE (new_db);
   Xapian::Database *real_db = xapian_database_get_internal (db);
 
+  /* Xapian::Database does not give access to its shards, so we keep
+   * our own copies to query their revisions; the copies share the
+   * state of the shards, and are reopened along with @db
+   */
+  if (priv->mShards == NULL)
+    {
+      priv->mShards = new std::vector<Xapian::Database>;
+
+      if (real_db->size () == 1)
+        priv->mShards->push_back (*real_db);
+    }
+
+  if (new_priv->mShards != NULL)
+    priv->mShards->insert (priv->mShards->end (),
+                           new_priv->mShards->begin (),
+                           new_priv->mShards->end ());
+  else if (new_priv->mDB->size () == 1)
+    priv->mShards->push_back (*new_priv->mDB);
+
   real_db->add_database (*xapian_database_get_internal (new_db));
 }
 
@@ -904,5 +1259,209 @@ xapian_database_enumerate_all_terms (XapianDatabase *self,
   XapianDatabasePrivate *priv = XAPIAN_DATABASE_GET_PRIVATE (self);
 
   std::string string_prefix (prefix ? prefix : "");
-  return xapian_term_iterator_new (priv->mDB->allterms_begin (string_prefix));
+  return xapian_term_iterator_new (priv->mDB->allterms_begin (string_prefix), self);
+}
+
+/**
+ * xapian_database_set_max_reopen_retries:
+ * @db: a #XapianDatabase
+ * @max_retries: the maximum number of retries
+ *
+ * Sets the value of the #XapianDatabase:max-reopen-retries property.
+ *
+ * Since: 2.0
+ */
+void
+xapian_database_set_max_reopen_retries (XapianDatabase *db,
+                                        unsigned int    max_retries)
+{
+  g_return_if_fail (XAPIAN_IS_DATABASE (db));
+
+  XapianDatabasePrivate *priv = XAPIAN_DATABASE_GET_PRIVATE (db);
+
+  if (priv->max_reopen_retries == max_retries)
+    return;
+
+  priv->max_reopen_retries = max_retries;
+
+  g_object_notify_by_pspec (G_OBJECT (db), obj_props[PROP_MAX_REOPEN_RETRIES]);
+}
+
+/**
+ * xapian_database_get_max_reopen_retries:
+ * @db: a #XapianDatabase
+ *
+ * Retrieves the value of the #XapianDatabase:max-reopen-retries property.
+ *
+ * Returns: the maximum number of retries
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_database_get_max_reopen_retries (XapianDatabase *db)
+{
+  g_return_val_if_fail (XAPIAN_IS_DATABASE (db), 0);
+
+  XapianDatabasePrivate *priv = XAPIAN_DATABASE_GET_PRIVATE (db);
+
+  return priv->max_reopen_retries;
+}
+
+static gboolean
+check_monitored_revision (gpointer user_data)
+{
+  XapianDatabase *self = static_cast<XapianDatabase *> (user_data);
+  XapianDatabasePrivate *priv = XAPIAN_DATABASE_GET_PRIVATE (self);
+
+  g_clear_pointer (&priv->monitor_timeout, g_source_unref);
+
+  /* We only notify when the revision visible to a new reader changes;
+   * if the database cannot be opened in the middle of a commit, a later
+   * event will pick up the change
+   */
+  guint64 revision;
+
+  try
+    {
+      Xapian::Database aDB (priv->path, xapian_database_get_flags (self));
+
+      revision = get_database_revision (aDB);
+    }
+  catch (const Xapian::Error &err)
+    {
+      return G_SOURCE_REMOVE;
+    }
+
+  if (revision != priv->monitored_revision)
+    {
+      priv->monitored_revision = revision;
+
+      g_signal_emit (self, obj_signals[REVISION_CHANGED], 0, revision);
+    }
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+on_monitor_changed (GFileMonitor      *monitor,
+                    GFile             *file,
+                    GFile             *other_file,
+                    GFileMonitorEvent  event_type,
+                    gpointer           user_data)
+{
+  XapianDatabase *self = static_cast<XapianDatabase *> (user_data);
+  XapianDatabasePrivate *priv = XAPIAN_DATABASE_GET_PRIVATE (self);
+
+  switch (event_type)
+    {
+    case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+    case G_FILE_MONITOR_EVENT_CREATED:
+    case G_FILE_MONITOR_EVENT_RENAMED:
+    case G_FILE_MONITOR_EVENT_MOVED_IN:
+      break;
+
+    default:
+      return;
+    }
+
+  /* Commits touch multiple files, so the events received within a
+   * short interval are coalesced, and the database is opened only
+   * once to check its revision
+   */
+  if (priv->monitor_timeout != NULL)
+    return;
+
+  priv->monitor_timeout = g_timeout_source_new (MONITOR_DEBOUNCE_MSEC);
+  g_source_set_callback (priv->monitor_timeout, check_monitored_revision, self, NULL);
+  g_source_attach (priv->monitor_timeout, g_main_context_get_thread_default ());
+}
+
+/**
+ * xapian_database_start_monitor:
+ * @db: a #XapianDatabase
+ * @error: return location for a #GError, or %NULL
+ *
+ * Starts monitoring the database directory for new revisions; the
+ * #XapianDatabase::revision-changed signal is emitted each time a
+ * writer commits a new revision.
+ *
+ * The signal is emitted inside the thread-default main context of
+ * the caller of this function, shortly after the commit; the changes
+ * to the files of the database are coalesced, so a single emission
+ * may cover more than one new revision.
+ *
+ * Only databases opened using a directory path can be monitored.
+ *
+ * Returns: %TRUE if the monitor was started, and %FALSE otherwise
+ *
+ * Since: 2.0
+ */
+gboolean
+xapian_database_start_monitor (XapianDatabase  *db,
+                               GError         **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_DATABASE (db), FALSE);
+  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  XapianDatabasePrivate *priv = XAPIAN_DATABASE_GET_PRIVATE (db);
+
+  if (priv->monitor != NULL)
+    return TRUE;
+
+  if (priv->path == NULL || priv->path[0] == '\0' || priv->offset != 0)
+    {
+      g_set_error_literal (error, XAPIAN_ERROR,
+                           XAPIAN_ERROR_INVALID_OPERATION,
+                           "Only databases opened using a directory path "
+                           "can be monitored");
+      return FALSE;
+    }
+
+  GFile *dir = g_file_new_for_path (priv->path);
+  GFileMonitor *monitor = g_file_monitor_directory (dir, G_FILE_MONITOR_WATCH_MOVES,
+                                                    NULL, error);
+
+  g_object_unref (dir);
+
+  if (monitor == NULL)
+    return FALSE;
+
+  priv->monitor = monitor;
+  priv->monitored_revision = get_database_revision (*xapian_database_get_internal (db));
+
+  g_signal_connect (priv->monitor, "changed", G_CALLBACK (on_monitor_changed), db);
+
+  return TRUE;
+}
+
+/**
+ * xapian_database_stop_monitor:
+ * @db: a #XapianDatabase
+ *
+ * Stops monitoring the database for new revisions, if
+ * xapian_database_start_monitor() was called.
+ *
+ * Since: 2.0
+ */
+void
+xapian_database_stop_monitor (XapianDatabase *db)
+{
+  g_return_if_fail (XAPIAN_IS_DATABASE (db));
+
+  XapianDatabasePrivate *priv = XAPIAN_DATABASE_GET_PRIVATE (db);
+
+  if (priv->monitor == NULL)
+    return;
+
+  g_signal_handlers_disconnect_by_func (priv->monitor,
+                                        (gpointer) on_monitor_changed,
+                                        db);
+  g_file_monitor_cancel (priv->monitor);
+  g_clear_object (&priv->monitor);
+
+  if (priv->monitor_timeout != NULL)
+    {
+      g_source_destroy (priv->monitor_timeout);
+      g_clear_pointer (&priv->monitor_timeout, g_source_unref);
+    }
 }
@@ -58,6 +58,8 @@ char *                  xapian_database_get_metadata    (XapianDatabase *db,
                                                          const char     *key,
                                                          GError        **error);
 XAPIAN_GLIB_AVAILABLE_IN_2_0
+guint64                 xapian_database_get_revision    (XapianDatabase *db);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
 unsigned int            xapian_database_get_doc_count   (XapianDatabase *db);
 XAPIAN_GLIB_AVAILABLE_IN_2_0
 unsigned int            xapian_database_get_last_doc_id (XapianDatabase *db);
@@ -102,6 +104,18 @@ XAPIAN_GLIB_AVAILABLE_IN_2_0
 XapianTermIterator *    xapian_database_enumerate_all_terms (XapianDatabase *self,
                                                              const char     *prefix);
 
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+void                    xapian_database_set_max_reopen_retries  (XapianDatabase *db,
+                                                                 unsigned int    max_retries);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+unsigned int            xapian_database_get_max_reopen_retries  (XapianDatabase *db);
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+gboolean                xapian_database_start_monitor   (XapianDatabase *db,
+                                                         GError        **error);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+void                    xapian_database_stop_monitor    (XapianDatabase *db);
+
 G_END_DECLS
 
 #endif /* __XAPIAN_GLIB_DATABASE_H__ */
@@ -0,0 +1,201 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-date-range-processor
+ * @Title: XapianDateRangeProcessor
+ * @short_description: Parse ranges of dates
+ *
+ * #XapianDateRangeProcessor is a #XapianRangeProcessor for ranges of
+ * dates, like `2024-01-01..2024-06-30` or `01/01/2024..30/06/2024`.
+ *
+ * The dates must be stored in the value slot as strings in the
+ * `YYYYMMDD` format.
+ *
+ * Years with two digits are interpreted using the
+ * #XapianDateRangeProcessor:epoch-year: they are assumed to be between
+ * the epoch year and 99 years after it.
+ */
+
+#include "config.h"
+
+#include <xapian.h>
+
+#include "xapian-date-range-processor.h"
+
+#include "xapian-range-processor-private.h"
+
+#define XAPIAN_DATE_RANGE_PROCESSOR_GET_PRIVATE(obj) \
+  ((XapianDateRangeProcessorPrivate *) xapian_date_range_processor_get_instance_private ((XapianDateRangeProcessor *) (obj)))
+
+#define DEFAULT_EPOCH_YEAR      1970
+
+typedef struct {
+  int epoch_year;
+} XapianDateRangeProcessorPrivate;
+
+enum {
+  PROP_0,
+
+  PROP_EPOCH_YEAR,
+
+  LAST_PROP
+};
+
+static GParamSpec *obj_props[LAST_PROP] = { NULL, };
+
+G_DEFINE_TYPE_WITH_PRIVATE (XapianDateRangeProcessor, xapian_date_range_processor, XAPIAN_TYPE_RANGE_PROCESSOR)
+
+static void
+xapian_date_range_processor_constructed (GObject *gobject)
+{
+  XapianDateRangeProcessorPrivate *priv = XAPIAN_DATE_RANGE_PROCESSOR_GET_PRIVATE (gobject);
+  XapianRangeProcessor *self = XAPIAN_RANGE_PROCESSOR (gobject);
+  const char *marker = xapian_range_processor_get_marker (self);
+  XapianRangeProcessorFlags flags = xapian_range_processor_get_flags (self);
+
+  Xapian::RangeProcessor *aRangeProcessor =
+    new Xapian::DateRangeProcessor (xapian_range_processor_get_slot (self),
+                                    marker != NULL ? marker : "",
+                                    xapian_range_processor_flags_internal (flags),
+                                    priv->epoch_year);
+
+  xapian_range_processor_set_internal (self, aRangeProcessor);
+
+  G_OBJECT_CLASS (xapian_date_range_processor_parent_class)->constructed (gobject);
+}
+
+static void
+xapian_date_range_processor_set_property (GObject      *gobject,
+                                          guint         prop_id,
+                                          const GValue *value,
+                                          GParamSpec   *pspec)
+{
+  XapianDateRangeProcessorPrivate *priv = XAPIAN_DATE_RANGE_PROCESSOR_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_EPOCH_YEAR:
+      priv->epoch_year = g_value_get_int (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_date_range_processor_get_property (GObject    *gobject,
+                                          guint       prop_id,
+                                          GValue     *value,
+                                          GParamSpec *pspec)
+{
+  XapianDateRangeProcessorPrivate *priv = XAPIAN_DATE_RANGE_PROCESSOR_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_EPOCH_YEAR:
+      g_value_set_int (value, priv->epoch_year);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_date_range_processor_class_init (XapianDateRangeProcessorClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  /**
+   * XapianDateRangeProcessor:epoch-year:
+   *
+   * The first year used to interpret years with two digits.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_EPOCH_YEAR] =
+    g_param_spec_int ("epoch-year",
+                      "Epoch Year",
+                      "The first year of two digits years",
+                      G_MININT, G_MAXINT, DEFAULT_EPOCH_YEAR,
+                      (GParamFlags) (G_PARAM_READWRITE |
+                                     G_PARAM_CONSTRUCT_ONLY |
+                                     G_PARAM_STATIC_STRINGS));
+
+  gobject_class->constructed = xapian_date_range_processor_constructed;
+  gobject_class->set_property = xapian_date_range_processor_set_property;
+  gobject_class->get_property = xapian_date_range_processor_get_property;
+
+  g_object_class_install_properties (gobject_class, LAST_PROP, obj_props);
+}
+
+static void
+xapian_date_range_processor_init (XapianDateRangeProcessor *self)
+{
+  XapianDateRangeProcessorPrivate *priv = XAPIAN_DATE_RANGE_PROCESSOR_GET_PRIVATE (self);
+
+  priv->epoch_year = DEFAULT_EPOCH_YEAR;
+}
+
+/**
+ * xapian_date_range_processor_new:
+ * @slot: the value slot of the ranges
+ * @marker: (nullable): the prefix, or suffix, of the ranges
+ * @flags: a bitwise OR of #XapianRangeProcessorFlags values
+ * @epoch_year: the first year used to interpret years with two digits
+ *
+ * Creates a new #XapianDateRangeProcessor.
+ *
+ * Returns: (transfer full): the newly created #XapianDateRangeProcessor instance
+ *
+ * Since: 2.0
+ */
+XapianDateRangeProcessor *
+xapian_date_range_processor_new (unsigned int               slot,
+                                 const char                *marker,
+                                 XapianRangeProcessorFlags  flags,
+                                 int                        epoch_year)
+{
+  return static_cast<XapianDateRangeProcessor *> (g_object_new (XAPIAN_TYPE_DATE_RANGE_PROCESSOR,
+                                                                "slot", slot,
+                                                                "marker", marker,
+                                                                "flags", flags,
+                                                                "epoch-year", epoch_year,
+                                                                NULL));
+}
+
+/**
+ * xapian_date_range_processor_get_epoch_year:
+ * @self: a #XapianDateRangeProcessor
+ *
+ * Retrieves the value of the #XapianDateRangeProcessor:epoch-year property.
+ *
+ * Returns: the epoch year
+ *
+ * Since: 2.0
+ */
+int
+xapian_date_range_processor_get_epoch_year (XapianDateRangeProcessor *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_DATE_RANGE_PROCESSOR (self), DEFAULT_EPOCH_YEAR);
+
+  XapianDateRangeProcessorPrivate *priv = XAPIAN_DATE_RANGE_PROCESSOR_GET_PRIVATE (self);
+
+  return priv->epoch_year;
+}
@@ -0,0 +1,52 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __XAPIAN_GLIB_DATE_RANGE_PROCESSOR_H__
+#define __XAPIAN_GLIB_DATE_RANGE_PROCESSOR_H__
+
+#if !defined(XAPIAN_GLIB_H_INSIDE) && !defined(XAPIAN_GLIB_COMPILATION)
+#error "Only <xapian-glib.h> can be included directly."
+#endif
+
+#include "xapian-glib-types.h"
+#include "xapian-range-processor.h"
+
+G_BEGIN_DECLS
+
+#define XAPIAN_TYPE_DATE_RANGE_PROCESSOR        (xapian_date_range_processor_get_type())
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+G_DECLARE_DERIVABLE_TYPE (XapianDateRangeProcessor, xapian_date_range_processor, XAPIAN, DATE_RANGE_PROCESSOR, XapianRangeProcessor)
+
+struct _XapianDateRangeProcessorClass
+{
+  /*< private >*/
+  XapianRangeProcessorClass parent_instance;
+};
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianDateRangeProcessor *      xapian_date_range_processor_new                 (unsigned int               slot,
+                                                                                 const char                *marker,
+                                                                                 XapianRangeProcessorFlags  flags,
+                                                                                 int                        epoch_year);
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+int                             xapian_date_range_processor_get_epoch_year      (XapianDateRangeProcessor  *self);
+
+G_END_DECLS
+
+#endif /* __XAPIAN_GLIB_DATE_RANGE_PROCESSOR_H__ */
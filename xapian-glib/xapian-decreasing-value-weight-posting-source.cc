@@ -0,0 +1,283 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-decreasing-value-weight-posting-source
+ * @Title: XapianDecreasingValueWeightPostingSource
+ * @short_description: Posting source for decreasing value weights
+ *
+ * #XapianDecreasingValueWeightPostingSource is a posting source which,
+ * like #XapianValueWeightPostingSource, reads weights from a value
+ * slot, using xapian_sortable_unserialise().
+ *
+ * The posting source assumes that the weights of the documents with
+ * identifiers between #XapianDecreasingValueWeightPostingSource:range-start
+ * and #XapianDecreasingValueWeightPostingSource:range-end are stored in
+ * decreasing order, for instance because the documents were indexed
+ * after sorting them by weight. Inside that range, the matcher can stop
+ * looking at documents as soon as their weight becomes too low to be
+ * part of the results, which makes queries much faster.
+ *
+ * Documents outside of the range are handled like they are by
+ * #XapianValueWeightPostingSource.
+ */
+
+#include "config.h"
+#include "xapian-posting-source-private.h"
+#include "xapian-decreasing-value-weight-posting-source.h"
+#include "xapian-error-private.h"
+
+#define XAPIAN_DECREASING_VALUE_WEIGHT_POSTING_SOURCE_GET_PRIVATE(obj) \
+  ((XapianDecreasingValueWeightPostingSourcePrivate *) xapian_decreasing_value_weight_posting_source_get_instance_private ((XapianDecreasingValueWeightPostingSource *) (obj)))
+
+typedef struct {
+  unsigned int range_start;
+  unsigned int range_end;
+} XapianDecreasingValueWeightPostingSourcePrivate;
+
+enum
+{
+  PROP_0,
+
+  PROP_RANGE_START,
+  PROP_RANGE_END,
+
+  LAST_PROP
+};
+
+static GParamSpec *obj_props[LAST_PROP] = { NULL, };
+
+static void initable_iface_init (GInitableIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (XapianDecreasingValueWeightPostingSource, xapian_decreasing_value_weight_posting_source,
+                         XAPIAN_TYPE_VALUE_WEIGHT_POSTING_SOURCE,
+                         G_ADD_PRIVATE (XapianDecreasingValueWeightPostingSource)
+                         G_IMPLEMENT_INTERFACE (G_TYPE_INITABLE, initable_iface_init))
+
+static gboolean
+xapian_decreasing_value_weight_posting_source_init_internal (GInitable    *self,
+                                                             GCancellable *cancellable,
+                                                             GError      **error)
+{
+  XapianPostingSource *pSource = XAPIAN_POSTING_SOURCE (self);
+  XapianDecreasingValueWeightPostingSourcePrivate *priv = XAPIAN_DECREASING_VALUE_WEIGHT_POSTING_SOURCE_GET_PRIVATE (self);
+  Xapian::DecreasingValueWeightPostingSource *mDecreasingPostingSource;
+
+  if (priv->range_end != 0 && priv->range_end < priv->range_start)
+    {
+      g_set_error_literal (error, XAPIAN_ERROR,
+                           XAPIAN_ERROR_INVALID_ARGUMENT,
+                           "The end of the range must not be lower than its start");
+      return FALSE;
+    }
+
+  try
+    {
+      guint slot = xapian_value_posting_source_get_slot (XAPIAN_VALUE_POSTING_SOURCE (self));
+      mDecreasingPostingSource = new Xapian::DecreasingValueWeightPostingSource (slot,
+                                                                                 priv->range_start,
+                                                                                 priv->range_end);
+      xapian_posting_source_set_internal (pSource, (Xapian::PostingSource *) mDecreasingPostingSource);
+
+      return TRUE;
+    }
+  catch (const Xapian::Error &err)
+    {
+      GError *internal_error = NULL;
+
+      xapian_error_to_gerror (err, &internal_error);
+      g_propagate_error (error, internal_error);
+
+      return FALSE;
+    }
+}
+
+static void
+initable_iface_init (GInitableIface *iface)
+{
+  iface->init = xapian_decreasing_value_weight_posting_source_init_internal;
+}
+
+static void
+xapian_decreasing_value_weight_posting_source_init (XapianDecreasingValueWeightPostingSource *self)
+{
+}
+
+static void
+xapian_decreasing_value_weight_posting_source_set_property (GObject      *gobject,
+                                                            guint         prop_id,
+                                                            const GValue *value,
+                                                            GParamSpec   *pspec)
+{
+  XapianDecreasingValueWeightPostingSourcePrivate *priv = XAPIAN_DECREASING_VALUE_WEIGHT_POSTING_SOURCE_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_RANGE_START:
+      priv->range_start = g_value_get_uint (value);
+      break;
+
+    case PROP_RANGE_END:
+      priv->range_end = g_value_get_uint (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_decreasing_value_weight_posting_source_get_property (GObject    *gobject,
+                                                            guint       prop_id,
+                                                            GValue     *value,
+                                                            GParamSpec *pspec)
+{
+  XapianDecreasingValueWeightPostingSourcePrivate *priv = XAPIAN_DECREASING_VALUE_WEIGHT_POSTING_SOURCE_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_RANGE_START:
+      g_value_set_uint (value, priv->range_start);
+      break;
+
+    case PROP_RANGE_END:
+      g_value_set_uint (value, priv->range_end);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_decreasing_value_weight_posting_source_class_init (XapianDecreasingValueWeightPostingSourceClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->set_property = xapian_decreasing_value_weight_posting_source_set_property;
+  gobject_class->get_property = xapian_decreasing_value_weight_posting_source_get_property;
+
+  /**
+   * XapianDecreasingValueWeightPostingSource:range-start:
+   *
+   * The first document identifier of the range of documents whose
+   * weights are in decreasing order, or 0 to start from the first
+   * document.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_RANGE_START] =
+    g_param_spec_uint ("range-start",
+                       "Range Start",
+                       "The start of the range of decreasing weights",
+                       0, G_MAXUINT32, 0,
+                       (GParamFlags) (G_PARAM_READWRITE |
+                                      G_PARAM_CONSTRUCT_ONLY |
+                                      G_PARAM_STATIC_STRINGS));
+
+  /**
+   * XapianDecreasingValueWeightPostingSource:range-end:
+   *
+   * The last document identifier of the range of documents whose
+   * weights are in decreasing order, or 0 to end at the last
+   * document.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_RANGE_END] =
+    g_param_spec_uint ("range-end",
+                       "Range End",
+                       "The end of the range of decreasing weights",
+                       0, G_MAXUINT32, 0,
+                       (GParamFlags) (G_PARAM_READWRITE |
+                                      G_PARAM_CONSTRUCT_ONLY |
+                                      G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_properties (gobject_class, LAST_PROP, obj_props);
+}
+
+/**
+ * xapian_decreasing_value_weight_posting_source_new:
+ * @slot: slot in the database entries to use for source
+ * @range_start: the first document identifier of the range with
+ *   decreasing weights, or 0
+ * @range_end: the last document identifier of the range with
+ *   decreasing weights, or 0
+ * @error: return location for a #GError, or %NULL
+ *
+ * If the initializion failed, @error is set, and this function
+ * will return %NULL.
+ *
+ * Returns: (transfer full): the newly created #XapianDecreasingValueWeightPostingSource instance
+ *
+ * Since: 2.0
+ */
+XapianDecreasingValueWeightPostingSource *
+xapian_decreasing_value_weight_posting_source_new (unsigned int   slot,
+                                                   unsigned int   range_start,
+                                                   unsigned int   range_end,
+                                                   GError       **error)
+{
+  return static_cast<XapianDecreasingValueWeightPostingSource *> (g_initable_new (XAPIAN_TYPE_DECREASING_VALUE_WEIGHT_POSTING_SOURCE,
+                                                                                  NULL, error,
+                                                                                  "slot", slot,
+                                                                                  "range-start", range_start,
+                                                                                  "range-end", range_end,
+                                                                                  NULL));
+}
+
+/**
+ * xapian_decreasing_value_weight_posting_source_get_range_start:
+ * @self: a #XapianDecreasingValueWeightPostingSource
+ *
+ * Retrieves the value of the #XapianDecreasingValueWeightPostingSource:range-start
+ * property.
+ *
+ * Returns: the first document identifier of the range
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_decreasing_value_weight_posting_source_get_range_start (XapianDecreasingValueWeightPostingSource *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_DECREASING_VALUE_WEIGHT_POSTING_SOURCE (self), 0);
+
+  XapianDecreasingValueWeightPostingSourcePrivate *priv = XAPIAN_DECREASING_VALUE_WEIGHT_POSTING_SOURCE_GET_PRIVATE (self);
+
+  return priv->range_start;
+}
+
+/**
+ * xapian_decreasing_value_weight_posting_source_get_range_end:
+ * @self: a #XapianDecreasingValueWeightPostingSource
+ *
+ * Retrieves the value of the #XapianDecreasingValueWeightPostingSource:range-end
+ * property.
+ *
+ * Returns: the last document identifier of the range
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_decreasing_value_weight_posting_source_get_range_end (XapianDecreasingValueWeightPostingSource *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_DECREASING_VALUE_WEIGHT_POSTING_SOURCE (self), 0);
+
+  XapianDecreasingValueWeightPostingSourcePrivate *priv = XAPIAN_DECREASING_VALUE_WEIGHT_POSTING_SOURCE_GET_PRIVATE (self);
+
+  return priv->range_end;
+}
@@ -28,6 +28,7 @@
 #include "xapian-document-private.h"
 
 #include "xapian-error-private.h"
+#include "xapian-lat-long-coords-private.h"
 
 #define XAPIAN_DOCUMENT_GET_PRIVATE(obj) \
   ((XapianDocumentPrivate *) xapian_document_get_instance_private ((XapianDocument *) (obj)))
@@ -185,6 +186,34 @@ xapian_document_add_numeric_value (XapianDocument *document,
   xapian_document_get_internal (document)->add_value (slot, serialised_value);
 }
 
+/**
+ * xapian_document_add_lat_long_coords:
+ * @document: a #XapianDocument
+ * @slot: a slot number
+ * @coords: the coordinates to associate to the @slot number
+ *
+ * Sets (or replaces) the coordinates at the given @slot number
+ * inside the @document.
+ *
+ * The coordinates can be used to rank or sort documents by distance,
+ * using #XapianLatLongDistancePostingSource or
+ * #XapianLatLongDistanceKeyMaker.
+ *
+ * Since: 2.0
+ */
+void
+xapian_document_add_lat_long_coords (XapianDocument      *document,
+                                     unsigned int         slot,
+                                     XapianLatLongCoords *coords)
+{
+  g_return_if_fail (XAPIAN_IS_DOCUMENT (document));
+  g_return_if_fail (XAPIAN_IS_LAT_LONG_COORDS (coords));
+
+  std::string serialised_value = xapian_lat_long_coords_get_internal (coords)->serialise ();
+
+  xapian_document_get_internal (document)->add_value (slot, serialised_value);
+}
+
 /**
  * xapian_document_add_value:
  * @document: a #XapianDocument
@@ -22,6 +22,7 @@
 #endif
 
 #include "xapian-glib-types.h"
+#include "xapian-lat-long-coords.h"
 
 G_BEGIN_DECLS
 
@@ -55,6 +56,10 @@ void                    xapian_document_add_numeric_value       (XapianDocument
                                                                  unsigned int    slot,
                                                                  double          value);
 XAPIAN_GLIB_AVAILABLE_IN_2_0
+void                    xapian_document_add_lat_long_coords     (XapianDocument      *document,
+                                                                 unsigned int         slot,
+                                                                 XapianLatLongCoords *coords);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
 void                    xapian_document_remove_value            (XapianDocument *document,
                                                                  unsigned int    slot);
 XAPIAN_GLIB_AVAILABLE_IN_2_0
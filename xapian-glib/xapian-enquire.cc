@@ -33,8 +33,11 @@
 
 #include "xapian-database-private.h"
 #include "xapian-error-private.h"
+#include "xapian-eset-private.h"
+#include "xapian-key-maker-private.h"
 #include "xapian-mset-private.h"
 #include "xapian-query-private.h"
+#include "xapian-rset-private.h"
 
 #define XAPIAN_ENQUIRE_GET_PRIVATE(obj) \
   ((XapianEnquirePrivate *) xapian_enquire_get_instance_private ((XapianEnquire *) (obj)))
@@ -45,6 +48,8 @@ typedef struct {
   XapianDatabase *database;
 
   XapianQuery *query;
+
+  XapianKeyMaker *sorter;
 } XapianEnquirePrivate;
 
 enum {
@@ -171,6 +176,7 @@ xapian_enquire_dispose (GObject *gobject)
 
   g_clear_object (&priv->database);
   g_clear_object (&priv->query);
+  g_clear_object (&priv->sorter);
 
   G_OBJECT_CLASS (xapian_enquire_parent_class)->dispose (gobject);
 }
@@ -380,6 +386,60 @@ xapian_enquire_set_sort_by_value (XapianEnquire *enquire,
     }
 
   priv->mEnquire->set_sort_by_value (sort_key, reverse);
+
+  g_clear_object (&priv->sorter);
+}
+
+/**
+ * xapian_enquire_set_sort_by_key:
+ * @enquire: a #XapianEnquire
+ * @sorter: a #XapianKeyMaker
+ * @reverse: If true, reverses the sort order.
+ *
+ * Set the sorting to be by the keys built by @sorter for each document,
+ * ignoring the relevance of the documents.
+ *
+ * The keys are compared as strings, in ascending order unless @reverse
+ * is set.
+ *
+ * The @enquire instance acquires a reference on @sorter.
+ *
+ * Since: 2.0
+ */
+void
+xapian_enquire_set_sort_by_key (XapianEnquire  *enquire,
+                                XapianKeyMaker *sorter,
+                                gboolean        reverse)
+{
+  g_return_if_fail (XAPIAN_IS_ENQUIRE (enquire));
+  g_return_if_fail (XAPIAN_IS_KEY_MAKER (sorter));
+
+  XapianEnquirePrivate *priv = XAPIAN_ENQUIRE_GET_PRIVATE (enquire);
+
+#ifdef XAPIAN_GLIB_ENABLE_DEBUG
+  if (G_UNLIKELY (priv->mEnquire == NULL))
+    {
+      g_critical ("XapianEnquire must be initialized. Use g_initable_init() "
+                  "before calling any XapianEnquire method.");
+      return;
+    }
+#endif
+
+  Xapian::KeyMaker *aKeyMaker = xapian_key_maker_get_internal (sorter);
+
+  if (aKeyMaker == NULL)
+    {
+      g_critical ("The XapianKeyMaker instance %p does not have a key maker",
+                  sorter);
+      return;
+    }
+
+  /* The Xapian::Enquire does not own the key maker, so we need to keep
+   * the wrapper alive for as long as it's used
+   */
+  g_set_object (&priv->sorter, sorter);
+
+  priv->mEnquire->set_sort_by_key (aKeyMaker, reverse);
 }
 
 /**
@@ -476,11 +536,257 @@ xapian_enquire_get_mset (XapianEnquire *enquire,
     }
 #endif
 
+  unsigned int n_retries = 0;
+
+  while (true)
+    {
+      try
+        {
+          Xapian::MSet mset = priv->mEnquire->get_mset (first, max_items);
+          XapianMSet *res = xapian_mset_new (mset);
+
+          xapian_mset_set_origin (res, priv->mEnquire->get_query (), priv->database);
+
+          return res;
+        }
+      catch (const Xapian::Error &err)
+        {
+          if (xapian_database_maybe_reopen (priv->database, err, &n_retries, error))
+            continue;
+
+          return NULL;
+        }
+    }
+}
+
+/**
+ * xapian_enquire_get_eset:
+ * @enquire: a #XapianEnquire
+ * @max_items: the maximum number of terms to return
+ * @rset: a #XapianRSet with the documents known to be relevant
+ * @flags: flags controlling the expansion
+ * @error: return location for a #GError
+ *
+ * Retrieves the @max_items terms that are most useful for expanding
+ * the query, based on the documents marked as relevant inside @rset.
+ *
+ * The returned #XapianESet can be used to build a new query, for
+ * instance using xapian_eset_get_terms() and xapian_query_new_for_terms();
+ * see also xapian_enquire_get_related_mset().
+ *
+ * In case of error, @error will be set, and this function will
+ * return %NULL.
+ *
+ * Returns: (transfer full): a #XapianESet containing the expansion terms
+ *
+ * Since: 2.0
+ */
+XapianESet *
+xapian_enquire_get_eset (XapianEnquire     *enquire,
+                         unsigned int       max_items,
+                         XapianRSet        *rset,
+                         XapianExpandFlags  flags,
+                         GError           **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_ENQUIRE (enquire), NULL);
+  g_return_val_if_fail (XAPIAN_IS_RSET (rset), NULL);
+
+  XapianEnquirePrivate *priv = XAPIAN_ENQUIRE_GET_PRIVATE (enquire);
+
+#ifdef XAPIAN_GLIB_ENABLE_DEBUG
+  if (G_UNLIKELY (priv->mEnquire == NULL))
+    {
+      g_critical ("XapianEnquire must be initialized. Use g_initable_init() "
+                  "before calling any XapianEnquire method.");
+      return NULL;
+    }
+#endif
+
+  int eset_flags = 0;
+
+  if ((flags & XAPIAN_EXPAND_FLAGS_INCLUDE_QUERY_TERMS) != 0)
+    eset_flags |= Xapian::Enquire::INCLUDE_QUERY_TERMS;
+  if ((flags & XAPIAN_EXPAND_FLAGS_USE_EXACT_TERMFREQ) != 0)
+    eset_flags |= Xapian::Enquire::USE_EXACT_TERMFREQ;
+
+  unsigned int n_retries = 0;
+
+  while (true)
+    {
+      try
+        {
+          Xapian::ESet eset = priv->mEnquire->get_eset (max_items,
+                                                        *xapian_rset_get_internal (rset),
+                                                        eset_flags);
+
+          return xapian_eset_new (eset);
+        }
+      catch (const Xapian::Error &err)
+        {
+          if (xapian_database_maybe_reopen (priv->database, err, &n_retries, error))
+            continue;
+
+          return NULL;
+        }
+    }
+}
+
+/**
+ * xapian_enquire_get_related_mset:
+ * @enquire: a #XapianEnquire
+ * @rset: a #XapianRSet with the documents known to be relevant
+ * @n_terms: the number of expansion terms to use
+ * @op: the operator used to combine the expansion terms; either
+ *   %XAPIAN_QUERY_OP_OR or %XAPIAN_QUERY_OP_ELITE_SET
+ * @first: the first item in the result set
+ * @max_items: the maximum number of results to return
+ * @error: return location for a #GError
+ *
+ * Retrieves the documents that are similar to the ones inside @rset.
+ *
+ * This function retrieves the best @n_terms expansion terms for @rset,
+ * like xapian_enquire_get_eset() does; then combines them using @op,
+ * and retrieves the matching documents, like xapian_enquire_get_mset()
+ * does. When using %XAPIAN_QUERY_OP_ELITE_SET, the query is built
+ * without an explicit set size, so Xapian keeps its default of the
+ * 10 most informative of the @n_terms expansion terms; the terms are
+ * picked once for the whole query, using the statistics of the
+ * database, and not for each document.
+ *
+ * The #XapianQuery set on @enquire is not used, nor modified, by
+ * this function. The documents in @rset may be part of the result.
+ *
+ * In case of error, @error will be set, and this function will
+ * return %NULL.
+ *
+ * Returns: (transfer full): a #XapianMSet containing the related
+ *   documents
+ *
+ * Since: 2.0
+ */
+XapianMSet *
+xapian_enquire_get_related_mset (XapianEnquire *enquire,
+                                 XapianRSet    *rset,
+                                 unsigned int   n_terms,
+                                 XapianQueryOp  op,
+                                 unsigned int   first,
+                                 unsigned int   max_items,
+                                 GError       **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_ENQUIRE (enquire), NULL);
+  g_return_val_if_fail (XAPIAN_IS_RSET (rset), NULL);
+
+  XapianEnquirePrivate *priv = XAPIAN_ENQUIRE_GET_PRIVATE (enquire);
+
+#ifdef XAPIAN_GLIB_ENABLE_DEBUG
+  if (G_UNLIKELY (priv->mEnquire == NULL))
+    {
+      g_critical ("XapianEnquire must be initialized. Use g_initable_init() "
+                  "before calling any XapianEnquire method.");
+      return NULL;
+    }
+#endif
+
+  if (op != XAPIAN_QUERY_OP_OR && op != XAPIAN_QUERY_OP_ELITE_SET)
+    {
+      g_set_error_literal (error, XAPIAN_ERROR,
+                           XAPIAN_ERROR_INVALID_ARGUMENT,
+                           "Related documents can only be retrieved using "
+                           "the OR and ELITE_SET operators");
+      return NULL;
+    }
+
+  unsigned int n_retries = 0;
+
+  while (true)
+    {
+      try
+        {
+          const Xapian::RSet &aRSet = *xapian_rset_get_internal (rset);
+          Xapian::ESet eset = priv->mEnquire->get_eset (n_terms, aRSet);
+          Xapian::Query query (xapian_query_op_internal (op),
+                               eset.begin (), eset.end ());
+
+          /* We use a separate Enquire, so that the query set by the
+           * caller is left untouched
+           */
+          Xapian::Enquire related (*xapian_database_get_internal (priv->database));
+          related.set_query (query);
+
+          Xapian::MSet mset = related.get_mset (first, max_items, 0, &aRSet);
+          XapianMSet *res = xapian_mset_new (mset);
+
+          xapian_mset_set_origin (res, query, priv->database);
+
+          return res;
+        }
+      catch (const Xapian::Error &err)
+        {
+          if (xapian_database_maybe_reopen (priv->database, err, &n_retries, error))
+            continue;
+
+          return NULL;
+        }
+    }
+}
+
+/**
+ * xapian_enquire_get_matching_terms:
+ * @enquire: a #XapianEnquire
+ * @docid: the identifier of a document
+ * @error: return location for a #GError
+ *
+ * Retrieves the terms of the #XapianQuery used with the @enquire
+ * instance that match the document with the given @docid.
+ *
+ * The terms are returned in the same order as they appear in
+ * the query; each term is only returned once.
+ *
+ * In case of error, @error will be set, and this function will
+ * return %NULL.
+ *
+ * Returns: (transfer full) (array zero-terminated=1): the matching
+ *   terms; use g_strfreev() to free the returned array
+ *
+ * Since: 2.0
+ */
+char **
+xapian_enquire_get_matching_terms (XapianEnquire *enquire,
+                                   unsigned int   docid,
+                                   GError       **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_ENQUIRE (enquire), NULL);
+  g_return_val_if_fail (docid != 0, NULL);
+
+  XapianEnquirePrivate *priv = XAPIAN_ENQUIRE_GET_PRIVATE (enquire);
+
+#ifdef XAPIAN_GLIB_ENABLE_DEBUG
+  if (G_UNLIKELY (priv->mEnquire == NULL))
+    {
+      g_critical ("XapianEnquire must be initialized. Use g_initable_init() "
+                  "before calling any XapianEnquire method.");
+      return NULL;
+    }
+#endif
+
+  GPtrArray *res = g_ptr_array_new_with_free_func (g_free);
+
   try
     {
-      Xapian::MSet mset = priv->mEnquire->get_mset (first, max_items);
+      Xapian::TermIterator end = priv->mEnquire->get_matching_terms_end (docid);
+      for (Xapian::TermIterator it = priv->mEnquire->get_matching_terms_begin (docid);
+           it != end;
+           ++it)
+        {
+          const std::string &term = *it;
 
-      return xapian_mset_new (mset);
+          g_ptr_array_add (res, g_strdup (term.c_str ()));
+        }
+
+      g_ptr_array_add (res, NULL);
+      g_ptr_array_set_free_func (res, NULL);
+
+      return reinterpret_cast<char **> (g_ptr_array_free (res, FALSE));
     }
   catch (const Xapian::Error &err)
     {
@@ -489,6 +795,97 @@ xapian_enquire_get_mset (XapianEnquire *enquire,
       xapian_error_to_gerror (err, &internal_error);
       g_propagate_error (error, internal_error);
 
+      g_ptr_array_unref (res);
+
+      return NULL;
+    }
+}
+
+/**
+ * xapian_enquire_get_matching_terms_for_mset:
+ * @enquire: a #XapianEnquire
+ * @mset: a #XapianMSet returned by xapian_enquire_get_mset()
+ * @error: return location for a #GError
+ *
+ * Retrieves the terms of the #XapianQuery used with the @enquire
+ * instance that match each document inside @mset.
+ *
+ * This function is equivalent to calling
+ * xapian_enquire_get_matching_terms() on every document of @mset,
+ * but it returns all the results at once, as a #GVariant of type
+ * `a(uas)`; each element of the array contains the identifier of
+ * a document and the terms matching it, in the same order as the
+ * documents inside @mset.
+ *
+ * The @mset must have been generated by @enquire, and the query
+ * of @enquire must not have been changed in the meantime.
+ *
+ * In case of error, @error will be set, and this function will
+ * return %NULL.
+ *
+ * Returns: (transfer full): a #GVariant with the matching terms
+ *   of each document; use g_variant_unref() to free the returned
+ *   value
+ *
+ * Since: 2.0
+ */
+GVariant *
+xapian_enquire_get_matching_terms_for_mset (XapianEnquire *enquire,
+                                            XapianMSet    *mset,
+                                            GError       **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_ENQUIRE (enquire), NULL);
+  g_return_val_if_fail (XAPIAN_IS_MSET (mset), NULL);
+
+  XapianEnquirePrivate *priv = XAPIAN_ENQUIRE_GET_PRIVATE (enquire);
+
+#ifdef XAPIAN_GLIB_ENABLE_DEBUG
+  if (G_UNLIKELY (priv->mEnquire == NULL))
+    {
+      g_critical ("XapianEnquire must be initialized. Use g_initable_init() "
+                  "before calling any XapianEnquire method.");
+      return NULL;
+    }
+#endif
+
+  Xapian::MSet *aMSet = xapian_mset_get_internal (mset);
+  GVariantBuilder builder;
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(uas)"));
+
+  try
+    {
+      for (Xapian::MSetIterator it = aMSet->begin (); it != aMSet->end (); ++it)
+        {
+          g_variant_builder_open (&builder, G_VARIANT_TYPE ("(uas)"));
+          g_variant_builder_add (&builder, "u", *it);
+          g_variant_builder_open (&builder, G_VARIANT_TYPE ("as"));
+
+          Xapian::TermIterator end = priv->mEnquire->get_matching_terms_end (it);
+          for (Xapian::TermIterator term = priv->mEnquire->get_matching_terms_begin (it);
+               term != end;
+               ++term)
+            {
+              const std::string &str = *term;
+
+              g_variant_builder_add (&builder, "s", str.c_str ());
+            }
+
+          g_variant_builder_close (&builder);
+          g_variant_builder_close (&builder);
+        }
+
+      return g_variant_ref_sink (g_variant_builder_end (&builder));
+    }
+  catch (const Xapian::Error &err)
+    {
+      GError *internal_error = NULL;
+
+      g_variant_builder_clear (&builder);
+
+      xapian_error_to_gerror (err, &internal_error);
+      g_propagate_error (error, internal_error);
+
       return NULL;
     }
 }
@@ -25,6 +25,9 @@
 #include "xapian-database.h"
 #include "xapian-query.h"
 #include "xapian-mset.h"
+#include "xapian-eset.h"
+#include "xapian-key-maker.h"
+#include "xapian-rset.h"
 
 G_BEGIN_DECLS
 
@@ -63,6 +66,10 @@ XAPIAN_GLIB_AVAILABLE_IN_2_0
 void            xapian_enquire_set_sort_by_value      (XapianEnquire *enquire,
                                                        unsigned int   sort_key,
                                                        gboolean       reverse);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+void            xapian_enquire_set_sort_by_key        (XapianEnquire  *enquire,
+                                                       XapianKeyMaker *sorter,
+                                                       gboolean        reverse);
 
 XAPIAN_GLIB_AVAILABLE_IN_2_0
 void            xapian_enquire_set_query              (XapianEnquire *enquire,
@@ -77,6 +84,30 @@ XapianMSet *    xapian_enquire_get_mset               (XapianEnquire *enquire,
                                                        unsigned int   max_items,
                                                        GError       **error);
 
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianESet *    xapian_enquire_get_eset               (XapianEnquire     *enquire,
+                                                       unsigned int       max_items,
+                                                       XapianRSet        *rset,
+                                                       XapianExpandFlags  flags,
+                                                       GError           **error);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianMSet *    xapian_enquire_get_related_mset       (XapianEnquire *enquire,
+                                                       XapianRSet    *rset,
+                                                       unsigned int   n_terms,
+                                                       XapianQueryOp  op,
+                                                       unsigned int   first,
+                                                       unsigned int   max_items,
+                                                       GError       **error);
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+char **         xapian_enquire_get_matching_terms     (XapianEnquire *enquire,
+                                                       unsigned int   docid,
+                                                       GError       **error);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+GVariant *      xapian_enquire_get_matching_terms_for_mset (XapianEnquire *enquire,
+                                                            XapianMSet    *mset,
+                                                            GError       **error);
+
 G_END_DECLS
 
 #endif /* __XAPIAN_GLIB_ENQUIRE_H__ */
@@ -82,6 +82,8 @@ XAPIAN_GLIB_DEFINE_ENUM_TYPE (XapianError, xapian_error,
   XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_ERROR_QUERY_PARSER, "query-parser")
   XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_ERROR_SERIALISATION, "serialisation")
   XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_ERROR_RANGE, "range")
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_ERROR_WILDCARD, "wildcard")
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_ERROR_REVISION_UNAVAILABLE, "revision-unavailable")
   XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_ERROR_LAST, "type-last"))
 
 XAPIAN_GLIB_DEFINE_ENUM_TYPE (XapianQueryOp, xapian_query_op,
@@ -105,7 +107,9 @@ XAPIAN_GLIB_DEFINE_ENUM_TYPE (XapianQueryOp, xapian_query_op,
 
 XAPIAN_GLIB_DEFINE_FLAGS_TYPE (XapianTermGeneratorFeature, xapian_term_generator_feature,
   XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_TERM_GENERATOR_FEATURE_NONE, "none")
-  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_TERM_GENERATOR_FEATURE_SPELLING, "spelling"))
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_TERM_GENERATOR_FEATURE_SPELLING, "spelling")
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_TERM_GENERATOR_FEATURE_CJK_NGRAM, "cjk-ngram")
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_TERM_GENERATOR_FEATURE_CJK_WORDS, "cjk-words"))
 
 XAPIAN_GLIB_DEFINE_FLAGS_TYPE (XapianQueryParserFeature, xapian_query_parser_feature,
   XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_QUERY_PARSER_FEATURE_BOOLEAN, "boolean")
@@ -120,6 +124,7 @@ XAPIAN_GLIB_DEFINE_FLAGS_TYPE (XapianQueryParserFeature, xapian_query_parser_fea
   XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_QUERY_PARSER_FEATURE_AUTO_SYNONYMS, "auto-synonyms")
   XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_QUERY_PARSER_FEATURE_AUTO_MULTIWORD_SYNONYMS, "auto-multiword-synonyms")
   XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_QUERY_PARSER_FEATURE_CJK_NGRAM, "cjk-ngram")
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_QUERY_PARSER_FEATURE_CJK_WORDS, "cjk-words")
   XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_QUERY_PARSER_FEATURE_DEFAULT, "default"))
 
 XAPIAN_GLIB_DEFINE_ENUM_TYPE (XapianStemStrategy, xapian_stem_strategy,
@@ -152,3 +157,31 @@ XAPIAN_GLIB_DEFINE_ENUM_TYPE (XapianDatabaseCompactLevel, xapian_database_compac
   XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_DATABASE_COMPACT_LEVEL_STANDARD, "standard")
   XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_DATABASE_COMPACT_LEVEL_FULL, "full")
   XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_DATABASE_COMPACT_LEVEL_FULLER, "fuller"))
+
+XAPIAN_GLIB_DEFINE_FLAGS_TYPE (XapianExpandFlags, xapian_expand_flags,
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_EXPAND_FLAGS_NONE, "none")
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_EXPAND_FLAGS_INCLUDE_QUERY_TERMS, "include-query-terms")
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_EXPAND_FLAGS_USE_EXACT_TERMFREQ, "use-exact-termfreq"))
+
+XAPIAN_GLIB_DEFINE_FLAGS_TYPE (XapianSnippetFlags, xapian_snippet_flags,
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_SNIPPET_FLAGS_NONE, "none")
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_SNIPPET_FLAGS_BACKGROUND_MODEL, "background-model")
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_SNIPPET_FLAGS_EXHAUSTIVE, "exhaustive")
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_SNIPPET_FLAGS_EMPTY_WITHOUT_MATCH, "empty-without-match")
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_SNIPPET_FLAGS_CJK_NGRAM, "cjk-ngram")
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_SNIPPET_FLAGS_DEFAULT, "default"))
+
+XAPIAN_GLIB_DEFINE_ENUM_TYPE (XapianWildcardLimit, xapian_wildcard_limit,
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_WILDCARD_LIMIT_ERROR, "error")
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_WILDCARD_LIMIT_FIRST, "first")
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_WILDCARD_LIMIT_MOST_FREQUENT, "most-frequent"))
+
+XAPIAN_GLIB_DEFINE_ENUM_TYPE (XapianDecayFunction, xapian_decay_function,
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_DECAY_FUNCTION_EXPONENTIAL, "exponential")
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_DECAY_FUNCTION_LINEAR, "linear"))
+
+XAPIAN_GLIB_DEFINE_FLAGS_TYPE (XapianRangeProcessorFlags, xapian_range_processor_flags,
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_RANGE_PROCESSOR_FLAGS_NONE, "none")
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_RANGE_PROCESSOR_FLAGS_SUFFIX, "suffix")
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_RANGE_PROCESSOR_FLAGS_REPEATED, "repeated")
+  XAPIAN_GLIB_DEFINE_ENUM_VALUE (XAPIAN_RANGE_PROCESSOR_FLAGS_DATE_PREFER_MDY, "date-prefer-mdy"))
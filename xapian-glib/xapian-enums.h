@@ -78,6 +78,9 @@ GType xapian_database_action_get_type (void);
  * @XAPIAN_ERROR_QUERY_PARSER: Error when parsing a query string
  * @XAPIAN_ERROR_SERIALISATION: Error when serialising or deserialising data
  * @XAPIAN_ERROR_RANGE: Out of bounds access
+ * @XAPIAN_ERROR_WILDCARD: Too many terms when expanding a wildcard
+ * @XAPIAN_ERROR_REVISION_UNAVAILABLE: The revision of a #XapianDatabaseSnapshot
+ *   is no longer available
  *
  * Error codes for the %XAPIAN_ERROR error domain.
  *
@@ -103,6 +106,8 @@ typedef enum {
   XAPIAN_ERROR_QUERY_PARSER,
   XAPIAN_ERROR_SERIALISATION,
   XAPIAN_ERROR_RANGE,
+  XAPIAN_ERROR_WILDCARD,
+  XAPIAN_ERROR_REVISION_UNAVAILABLE,
 
   /*< private >*/
   XAPIAN_ERROR_LAST
@@ -203,6 +208,8 @@ GType xapian_query_op_get_type (void);
  *   use of synonyms for single terms and groups of terms
  * @XAPIAN_QUERY_PARSER_FEATURE_CJK_NGRAM: enable generation of n-grams from
  *   CJK text
+ * @XAPIAN_QUERY_PARSER_FEATURE_CJK_WORDS: enable word segmentation of CJK
+ *   text; this requires Xapian to be built with ICU support
  * @XAPIAN_QUERY_PARSER_FEATURE_DEFAULT: default flags
  *
  * Flags for xapian_query_parser_parse_query_full().
@@ -222,6 +229,7 @@ typedef enum {
   XAPIAN_QUERY_PARSER_FEATURE_AUTO_SYNONYMS = 1 << 9,
   XAPIAN_QUERY_PARSER_FEATURE_AUTO_MULTIWORD_SYNONYMS = 1 << 10 | XAPIAN_QUERY_PARSER_FEATURE_AUTO_SYNONYMS,
   XAPIAN_QUERY_PARSER_FEATURE_CJK_NGRAM = 1 << 11,
+  XAPIAN_QUERY_PARSER_FEATURE_CJK_WORDS = 1 << 12,
   XAPIAN_QUERY_PARSER_FEATURE_DEFAULT = XAPIAN_QUERY_PARSER_FEATURE_BOOLEAN |
                                         XAPIAN_QUERY_PARSER_FEATURE_PHRASE |
                                         XAPIAN_QUERY_PARSER_FEATURE_LOVEHATE
@@ -259,6 +267,12 @@ GType xapian_stem_strategy_get_type (void);
  * XapianTermGeneratorFeature:
  * @XAPIAN_TERM_GENERATOR_FEATURE_NONE: No features
  * @XAPIAN_TERM_GENERATOR_FEATURE_SPELLING: Index data required for spelling correction
+ * @XAPIAN_TERM_GENERATOR_FEATURE_CJK_NGRAM: Index CJK text as unigrams and
+ *   bigrams, matching %XAPIAN_QUERY_PARSER_FEATURE_CJK_NGRAM
+ * @XAPIAN_TERM_GENERATOR_FEATURE_CJK_WORDS: Index CJK text as words found
+ *   by a word segmentation algorithm, matching
+ *   %XAPIAN_QUERY_PARSER_FEATURE_CJK_WORDS; this requires Xapian to be
+ *   built with ICU support
  *
  * TermGenerator flags
  *
@@ -266,7 +280,9 @@ GType xapian_stem_strategy_get_type (void);
  */
 typedef enum {
   XAPIAN_TERM_GENERATOR_FEATURE_NONE,
-  XAPIAN_TERM_GENERATOR_FEATURE_SPELLING = 1
+  XAPIAN_TERM_GENERATOR_FEATURE_SPELLING = 1,
+  XAPIAN_TERM_GENERATOR_FEATURE_CJK_NGRAM = 1 << 1,
+  XAPIAN_TERM_GENERATOR_FEATURE_CJK_WORDS = 1 << 2
 } XapianTermGeneratorFeature;
 
 XAPIAN_GLIB_AVAILABLE_IN_2_0
@@ -356,6 +372,137 @@ typedef enum {
 XAPIAN_GLIB_AVAILABLE_IN_2_0
 GType xapian_database_compact_level_get_type (void);
 
+#define XAPIAN_TYPE_EXPAND_FLAGS                (xapian_expand_flags_get_type ())
+
+/**
+ * XapianExpandFlags:
+ * @XAPIAN_EXPAND_FLAGS_NONE: No flags
+ * @XAPIAN_EXPAND_FLAGS_INCLUDE_QUERY_TERMS: Allow terms which are already
+ *   in the query to be returned
+ * @XAPIAN_EXPAND_FLAGS_USE_EXACT_TERMFREQ: Use the exact term frequency
+ *   of the terms when combining multiple databases, instead of an
+ *   approximation
+ *
+ * Flags for xapian_enquire_get_eset().
+ *
+ * Since: 2.0
+ */
+typedef enum {
+  XAPIAN_EXPAND_FLAGS_NONE                      = 0,
+  XAPIAN_EXPAND_FLAGS_INCLUDE_QUERY_TERMS       = 1 << 0,
+  XAPIAN_EXPAND_FLAGS_USE_EXACT_TERMFREQ        = 1 << 1
+} XapianExpandFlags;
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+GType xapian_expand_flags_get_type (void);
+
+#define XAPIAN_TYPE_SNIPPET_FLAGS               (xapian_snippet_flags_get_type ())
+
+/**
+ * XapianSnippetFlags:
+ * @XAPIAN_SNIPPET_FLAGS_NONE: No flags
+ * @XAPIAN_SNIPPET_FLAGS_BACKGROUND_MODEL: Model the relevancy of
+ *   non-query terms when selecting the snippet
+ * @XAPIAN_SNIPPET_FLAGS_EXHAUSTIVE: Exhaustively evaluate all the
+ *   candidate snippets
+ * @XAPIAN_SNIPPET_FLAGS_EMPTY_WITHOUT_MATCH: Return an empty string
+ *   if no term in the query is found in the text
+ * @XAPIAN_SNIPPET_FLAGS_CJK_NGRAM: Enable generation of n-grams from
+ *   CJK text, matching %XAPIAN_QUERY_PARSER_FEATURE_CJK_NGRAM
+ * @XAPIAN_SNIPPET_FLAGS_DEFAULT: Default flags
+ *
+ * Flags for xapian_mset_get_snippet().
+ *
+ * Since: 2.0
+ */
+typedef enum {
+  XAPIAN_SNIPPET_FLAGS_NONE                     = 0,
+  XAPIAN_SNIPPET_FLAGS_BACKGROUND_MODEL         = 1 << 0,
+  XAPIAN_SNIPPET_FLAGS_EXHAUSTIVE               = 1 << 1,
+  XAPIAN_SNIPPET_FLAGS_EMPTY_WITHOUT_MATCH      = 1 << 2,
+  XAPIAN_SNIPPET_FLAGS_CJK_NGRAM                = 1 << 3,
+  XAPIAN_SNIPPET_FLAGS_DEFAULT = XAPIAN_SNIPPET_FLAGS_BACKGROUND_MODEL |
+                                 XAPIAN_SNIPPET_FLAGS_EXHAUSTIVE
+} XapianSnippetFlags;
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+GType xapian_snippet_flags_get_type (void);
+
+#define XAPIAN_TYPE_WILDCARD_LIMIT                (xapian_wildcard_limit_get_type ())
+
+/**
+ * XapianWildcardLimit:
+ * @XAPIAN_WILDCARD_LIMIT_ERROR: Fail with %XAPIAN_ERROR_WILDCARD if
+ *   the expansion exceeds the limit
+ * @XAPIAN_WILDCARD_LIMIT_FIRST: Expand to the first terms, in
+ *   lexicographic order, up to the limit
+ * @XAPIAN_WILDCARD_LIMIT_MOST_FREQUENT: Expand to the terms with the
+ *   highest frequency, up to the limit
+ *
+ * How to handle wildcard and partial expansions that would produce
+ * more terms than the allowed limit; see
+ * xapian_query_parser_set_max_expansion() and
+ * xapian_query_new_wildcard_full().
+ *
+ * Since: 2.0
+ */
+typedef enum {
+  XAPIAN_WILDCARD_LIMIT_ERROR,
+  XAPIAN_WILDCARD_LIMIT_FIRST,
+  XAPIAN_WILDCARD_LIMIT_MOST_FREQUENT
+} XapianWildcardLimit;
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+GType xapian_wildcard_limit_get_type (void);
+
+#define XAPIAN_TYPE_DECAY_FUNCTION                (xapian_decay_function_get_type ())
+
+/**
+ * XapianDecayFunction:
+ * @XAPIAN_DECAY_FUNCTION_EXPONENTIAL: The weight halves every half-life
+ * @XAPIAN_DECAY_FUNCTION_LINEAR: The weight decreases linearly, reaching
+ *   half of its maximum after one half-life, and zero after two
+ *
+ * The function used by #XapianRecencyPostingSource to compute the
+ * weight of a document from its age.
+ *
+ * Since: 2.0
+ */
+typedef enum {
+  XAPIAN_DECAY_FUNCTION_EXPONENTIAL,
+  XAPIAN_DECAY_FUNCTION_LINEAR
+} XapianDecayFunction;
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+GType xapian_decay_function_get_type (void);
+
+#define XAPIAN_TYPE_RANGE_PROCESSOR_FLAGS       (xapian_range_processor_flags_get_type ())
+
+/**
+ * XapianRangeProcessorFlags:
+ * @XAPIAN_RANGE_PROCESSOR_FLAGS_NONE: No flags
+ * @XAPIAN_RANGE_PROCESSOR_FLAGS_SUFFIX: The string of the range
+ *   processor is a suffix instead of a prefix
+ * @XAPIAN_RANGE_PROCESSOR_FLAGS_REPEATED: The string of the range
+ *   processor can be used on both ends of the range
+ * @XAPIAN_RANGE_PROCESSOR_FLAGS_DATE_PREFER_MDY: Interpret ambiguous
+ *   dates as month/day/year instead of day/month/year; only used by
+ *   #XapianDateRangeProcessor
+ *
+ * Flags for #XapianRangeProcessor.
+ *
+ * Since: 2.0
+ */
+typedef enum {
+  XAPIAN_RANGE_PROCESSOR_FLAGS_NONE             = 0,
+  XAPIAN_RANGE_PROCESSOR_FLAGS_SUFFIX           = 1 << 0,
+  XAPIAN_RANGE_PROCESSOR_FLAGS_REPEATED         = 1 << 1,
+  XAPIAN_RANGE_PROCESSOR_FLAGS_DATE_PREFER_MDY  = 1 << 2
+} XapianRangeProcessorFlags;
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+GType xapian_range_processor_flags_get_type (void);
+
 G_END_DECLS
 
 #endif /* __XAPIAN_ENUMS_H__ */
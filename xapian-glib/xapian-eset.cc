@@ -0,0 +1,296 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:xapian-eset
+ * @Title: XapianESet
+ * @short_description: Set of query expansion terms
+ *
+ * #XapianESet represents a ranked list of terms that can be used to
+ * expand a query, as returned by xapian_enquire_get_eset().
+ *
+ * The terms are sorted by decreasing weight; the whole list can be
+ * retrieved at once using xapian_eset_get_terms() and
+ * xapian_eset_get_weights().
+ */
+
+#include "config.h"
+
+#include <xapian.h>
+
+#include "xapian-eset-private.h"
+
+#define XAPIAN_ESET_GET_PRIVATE(obj) \
+  ((XapianESetPrivate *) xapian_eset_get_instance_private ((XapianESet *) (obj)))
+
+typedef struct {
+  Xapian::ESet *mESet;
+} XapianESetPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (XapianESet, xapian_eset, G_TYPE_OBJECT)
+
+static void
+xapian_eset_finalize (GObject *gobject)
+{
+  XapianESetPrivate *priv = XAPIAN_ESET_GET_PRIVATE (gobject);
+
+  delete priv->mESet;
+
+  G_OBJECT_CLASS (xapian_eset_parent_class)->finalize (gobject);
+}
+
+static void
+xapian_eset_class_init (XapianESetClass *klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = xapian_eset_finalize;
+}
+
+static void
+xapian_eset_init (XapianESet *self)
+{
+}
+
+/*< private >
+ * xapian_eset_new:
+ * @aESet: a Xapian::ESet
+ *
+ * Creates a new #XapianESet for the given `Xapian::ESet` instance.
+ *
+ * Returns: (transfer full): the newly created #XapianESet
+ */
+XapianESet *
+xapian_eset_new (const Xapian::ESet &aESet)
+{
+  XapianESet *res = static_cast<XapianESet *> (g_object_new (XAPIAN_TYPE_ESET, NULL));
+
+  XapianESetPrivate *priv = XAPIAN_ESET_GET_PRIVATE (res);
+  priv->mESet = new Xapian::ESet (aESet);
+
+  return res;
+}
+
+/*< private >
+ * xapian_eset_get_internal:
+ * @eset: a #XapianESet
+ *
+ * Retrieves the internal `Xapian::ESet` instance.
+ *
+ * Returns: (transfer none): a pointer to the internal instance
+ */
+Xapian::ESet *
+xapian_eset_get_internal (XapianESet *eset)
+{
+  XapianESetPrivate *priv = XAPIAN_ESET_GET_PRIVATE (eset);
+
+  if (!priv->mESet)
+    priv->mESet = new Xapian::ESet ();
+
+  return priv->mESet;
+}
+
+/**
+ * xapian_eset_get_size:
+ * @eset: a #XapianESet
+ *
+ * Retrieves the number of terms in the @eset.
+ *
+ * Returns: the number of terms
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_eset_get_size (XapianESet *eset)
+{
+  g_return_val_if_fail (XAPIAN_IS_ESET (eset), 0);
+
+  return xapian_eset_get_internal (eset)->size ();
+}
+
+/**
+ * xapian_eset_is_empty:
+ * @eset: a #XapianESet
+ *
+ * Checks whether the @eset is empty.
+ *
+ * Returns: %TRUE if the set is empty, and %FALSE otherwise
+ *
+ * Since: 2.0
+ */
+gboolean
+xapian_eset_is_empty (XapianESet *eset)
+{
+  g_return_val_if_fail (XAPIAN_IS_ESET (eset), TRUE);
+
+  return xapian_eset_get_internal (eset)->empty ();
+}
+
+/**
+ * xapian_eset_get_ebound:
+ * @eset: a #XapianESet
+ *
+ * Retrieves an upper bound on the number of terms that could have
+ * been returned if the maximum number of items requested had been
+ * unlimited.
+ *
+ * Returns: an upper bound of candidate terms
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_eset_get_ebound (XapianESet *eset)
+{
+  g_return_val_if_fail (XAPIAN_IS_ESET (eset), 0);
+
+  return xapian_eset_get_internal (eset)->get_ebound ();
+}
+
+/**
+ * xapian_eset_get_term:
+ * @eset: a #XapianESet
+ * @index_: the position of the term in the @eset
+ *
+ * Retrieves the term at the given position in the @eset.
+ *
+ * Returns: (transfer full) (nullable): the term, or %NULL if @index_
+ *   is out of range
+ *
+ * Since: 2.0
+ */
+char *
+xapian_eset_get_term (XapianESet   *eset,
+                      unsigned int  index_)
+{
+  g_return_val_if_fail (XAPIAN_IS_ESET (eset), NULL);
+
+  Xapian::ESet *aESet = xapian_eset_get_internal (eset);
+
+  if (index_ >= aESet->size ())
+    return NULL;
+
+  std::string term = *((*aESet)[index_]);
+
+  return g_strdup (term.c_str ());
+}
+
+/**
+ * xapian_eset_get_weight:
+ * @eset: a #XapianESet
+ * @index_: the position of the term in the @eset
+ *
+ * Retrieves the weight of the term at the given position in the @eset.
+ *
+ * Returns: the weight of the term, or 0 if @index_ is out of range
+ *
+ * Since: 2.0
+ */
+double
+xapian_eset_get_weight (XapianESet   *eset,
+                        unsigned int  index_)
+{
+  g_return_val_if_fail (XAPIAN_IS_ESET (eset), 0);
+
+  Xapian::ESet *aESet = xapian_eset_get_internal (eset);
+
+  if (index_ >= aESet->size ())
+    return 0;
+
+  return (*aESet)[index_].get_weight ();
+}
+
+/**
+ * xapian_eset_get_terms:
+ * @eset: a #XapianESet
+ *
+ * Retrieves all the terms in the @eset, in decreasing order of weight.
+ *
+ * Returns: (transfer full) (array zero-terminated=1): the terms in
+ *   the set; use g_strfreev() to free the returned array
+ *
+ * Since: 2.0
+ */
+char **
+xapian_eset_get_terms (XapianESet *eset)
+{
+  g_return_val_if_fail (XAPIAN_IS_ESET (eset), NULL);
+
+  Xapian::ESet *aESet = xapian_eset_get_internal (eset);
+  char **res = g_new (char *, aESet->size () + 1);
+  unsigned int i = 0;
+
+  for (Xapian::ESetIterator it = aESet->begin (); it != aESet->end (); ++it)
+    {
+      const std::string &term = *it;
+
+      res[i++] = g_strdup (term.c_str ());
+    }
+
+  res[i] = NULL;
+
+  return res;
+}
+
+/**
+ * xapian_eset_get_weights:
+ * @eset: a #XapianESet
+ * @n_weights: (out): return location for the number of weights
+ *
+ * Retrieves the weights of all the terms in the @eset; the order
+ * matches the one of xapian_eset_get_terms().
+ *
+ * Returns: (transfer full) (array length=n_weights): the weights
+ *   of the terms; use g_free() to free the returned array
+ *
+ * Since: 2.0
+ */
+double *
+xapian_eset_get_weights (XapianESet *eset,
+                         gsize      *n_weights)
+{
+  g_return_val_if_fail (XAPIAN_IS_ESET (eset), NULL);
+  g_return_val_if_fail (n_weights != NULL, NULL);
+
+  Xapian::ESet *aESet = xapian_eset_get_internal (eset);
+  double *res = g_new (double, aESet->size () + 1);
+  gsize i = 0;
+
+  for (Xapian::ESetIterator it = aESet->begin (); it != aESet->end (); ++it)
+    res[i++] = it.get_weight ();
+
+  *n_weights = i;
+
+  return res;
+}
+
+/**
+ * xapian_eset_get_description:
+ * @eset: a #XapianESet
+ *
+ * Retrieves a description of the @eset, typically used for
+ * debugging.
+ *
+ * Returns: (transfer full): a description of the set
+ *
+ * Since: 2.0
+ */
+char *
+xapian_eset_get_description (XapianESet *eset)
+{
+  g_return_val_if_fail (XAPIAN_IS_ESET (eset), NULL);
+
+  std::string desc = xapian_eset_get_internal (eset)->get_description ();
+
+  return g_strdup (desc.c_str ());
+}
@@ -0,0 +1,61 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __XAPIAN_GLIB_ESET_H__
+#define __XAPIAN_GLIB_ESET_H__
+
+#if !defined(XAPIAN_GLIB_H_INSIDE) && !defined(XAPIAN_GLIB_COMPILATION)
+#error "Only <xapian-glib.h> can be included directly."
+#endif
+
+#include "xapian-glib-types.h"
+
+G_BEGIN_DECLS
+
+#define XAPIAN_TYPE_ESET        (xapian_eset_get_type())
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+G_DECLARE_DERIVABLE_TYPE (XapianESet, xapian_eset, XAPIAN, ESET, GObject)
+
+struct _XapianESetClass
+{
+  /*< private >*/
+  GObjectClass parent_instance;
+};
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+unsigned int    xapian_eset_get_size            (XapianESet   *eset);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+gboolean        xapian_eset_is_empty            (XapianESet   *eset);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+unsigned int    xapian_eset_get_ebound          (XapianESet   *eset);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+char *          xapian_eset_get_term            (XapianESet   *eset,
+                                                 unsigned int  index_);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+double          xapian_eset_get_weight          (XapianESet   *eset,
+                                                 unsigned int  index_);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+char **         xapian_eset_get_terms           (XapianESet   *eset);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+double *        xapian_eset_get_weights         (XapianESet   *eset,
+                                                 gsize        *n_weights);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+char *          xapian_eset_get_description     (XapianESet   *eset);
+
+G_END_DECLS
+
+#endif /* __XAPIAN_GLIB_ESET_H__ */
@@ -0,0 +1,212 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-field-processor
+ * @Title: XapianFieldProcessor
+ * @short_description: Custom handling of query fields
+ *
+ * #XapianFieldProcessor is used by #XapianQueryParser to turn the
+ * value of a field in a query string, like `author:orwell`, into a
+ * #XapianQuery; see xapian_query_parser_add_field_processor().
+ *
+ * The common cases are handled natively, without calling back into
+ * the application, by #XapianTermFieldProcessor and
+ * #XapianNumberFieldProcessor.
+ *
+ * Custom field processors can be implemented by subclassing
+ * #XapianFieldProcessor and overriding the
+ * #XapianFieldProcessorClass.process() virtual function.
+ */
+
+#include "config.h"
+
+#include <xapian.h>
+
+#include "xapian-field-processor-private.h"
+
+#include "xapian-error-private.h"
+#include "xapian-query-private.h"
+
+#define XAPIAN_FIELD_PROCESSOR_GET_PRIVATE(obj) \
+  ((XapianFieldProcessorPrivate *) xapian_field_processor_get_instance_private ((XapianFieldProcessor *) (obj)))
+
+typedef struct {
+  Xapian::FieldProcessor *mFieldProcessor;
+} XapianFieldProcessorPrivate;
+
+class GenericFieldProcessor : public Xapian::FieldProcessor {
+  public:
+    GenericFieldProcessor (XapianFieldProcessor *aWrapper)
+      : mWrapper (aWrapper) {}
+
+    virtual Xapian::Query operator() (const std::string &value) {
+      XapianFieldProcessorClass *klass = XAPIAN_FIELD_PROCESSOR_GET_CLASS (mWrapper);
+      GError *error = NULL;
+
+      XapianQuery *query = klass->process (mWrapper, value.c_str (), &error);
+
+      /* Errors make the query parser fail, like the native processors */
+      if (error != NULL)
+        {
+          std::string msg (error->message);
+
+          g_error_free (error);
+          g_clear_object (&query);
+
+          throw Xapian::QueryParserError (msg);
+        }
+
+      if (query == NULL)
+        return Xapian::Query::MatchNothing;
+
+      Xapian::Query res (*xapian_query_get_internal (query));
+
+      g_object_unref (query);
+
+      return res;
+    }
+
+  private:
+    XapianFieldProcessor *mWrapper;
+};
+
+G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (XapianFieldProcessor, xapian_field_processor, G_TYPE_OBJECT)
+
+static void
+xapian_field_processor_finalize (GObject *gobject)
+{
+  XapianFieldProcessorPrivate *priv = XAPIAN_FIELD_PROCESSOR_GET_PRIVATE (gobject);
+
+  delete priv->mFieldProcessor;
+
+  G_OBJECT_CLASS (xapian_field_processor_parent_class)->finalize (gobject);
+}
+
+static void
+xapian_field_processor_constructed (GObject *gobject)
+{
+  XapianFieldProcessor *self = XAPIAN_FIELD_PROCESSOR (gobject);
+  XapianFieldProcessorPrivate *priv = XAPIAN_FIELD_PROCESSOR_GET_PRIVATE (self);
+
+  /* Native sub-classes set their own instance before chaining up */
+  if (priv->mFieldProcessor == NULL)
+    priv->mFieldProcessor = new GenericFieldProcessor (self);
+
+  G_OBJECT_CLASS (xapian_field_processor_parent_class)->constructed (gobject);
+}
+
+static XapianQuery *
+xapian_field_processor_real_process (XapianFieldProcessor  *self,
+                                     const char            *value,
+                                     GError               **error)
+{
+  return NULL;
+}
+
+static void
+xapian_field_processor_class_init (XapianFieldProcessorClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->constructed = xapian_field_processor_constructed;
+  gobject_class->finalize = xapian_field_processor_finalize;
+
+  klass->process = xapian_field_processor_real_process;
+}
+
+static void
+xapian_field_processor_init (XapianFieldProcessor *self)
+{
+}
+
+/*< private >
+ * xapian_field_processor_get_internal:
+ * @self: a #XapianFieldProcessor
+ *
+ * Retrieves the `Xapian::FieldProcessor` used by @self.
+ *
+ * Returns: (transfer none): a pointer to the internal instance
+ */
+Xapian::FieldProcessor *
+xapian_field_processor_get_internal (XapianFieldProcessor *self)
+{
+  XapianFieldProcessorPrivate *priv = XAPIAN_FIELD_PROCESSOR_GET_PRIVATE (self);
+
+  return priv->mFieldProcessor;
+}
+
+/*< private >
+ * xapian_field_processor_set_internal:
+ * @self: a #XapianFieldProcessor
+ * @aFieldProcessor: a `Xapian::FieldProcessor` instance
+ *
+ * Sets the internal field processor instance wrapped by @self, clearing
+ * any existing instance if needed.
+ */
+void
+xapian_field_processor_set_internal (XapianFieldProcessor   *self,
+                                     Xapian::FieldProcessor *aFieldProcessor)
+{
+  XapianFieldProcessorPrivate *priv = XAPIAN_FIELD_PROCESSOR_GET_PRIVATE (self);
+
+  delete priv->mFieldProcessor;
+
+  priv->mFieldProcessor = aFieldProcessor;
+}
+
+/**
+ * xapian_field_processor_process:
+ * @self: a #XapianFieldProcessor
+ * @value: the value of the field
+ * @error: return location for a #GError, or %NULL
+ *
+ * Converts the @value of a field into a #XapianQuery, in the same way
+ * the #XapianQueryParser does.
+ *
+ * Returns: (transfer full) (nullable): the newly created #XapianQuery
+ *   instance, or %NULL if @error is set
+ *
+ * Since: 2.0
+ */
+XapianQuery *
+xapian_field_processor_process (XapianFieldProcessor *self,
+                                const char           *value,
+                                GError              **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_FIELD_PROCESSOR (self), NULL);
+  g_return_val_if_fail (value != NULL, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  Xapian::FieldProcessor *aFieldProcessor = xapian_field_processor_get_internal (self);
+
+  try
+    {
+      Xapian::Query query = (*aFieldProcessor) (std::string (value));
+
+      return xapian_query_new_from_query (query);
+    }
+  catch (const Xapian::Error &err)
+    {
+      GError *internal_error = NULL;
+
+      xapian_error_to_gerror (err, &internal_error);
+      g_propagate_error (error, internal_error);
+
+      return NULL;
+    }
+}
@@ -0,0 +1,82 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __XAPIAN_GLIB_FIELD_PROCESSOR_H__
+#define __XAPIAN_GLIB_FIELD_PROCESSOR_H__
+
+#if !defined(XAPIAN_GLIB_H_INSIDE) && !defined(XAPIAN_GLIB_COMPILATION)
+#error "Only <xapian-glib.h> can be included directly."
+#endif
+
+#include "xapian-glib-types.h"
+#include "xapian-query.h"
+
+G_BEGIN_DECLS
+
+#define XAPIAN_TYPE_FIELD_PROCESSOR     (xapian_field_processor_get_type())
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+G_DECLARE_DERIVABLE_TYPE (XapianFieldProcessor, xapian_field_processor, XAPIAN, FIELD_PROCESSOR, GObject)
+
+/**
+ * XapianFieldProcessorClass::process:
+ * @self: a #XapianFieldProcessor
+ * @value: the value of the field in the query string
+ * @error: return location for a #GError
+ *
+ * Converts the @value of a field into a #XapianQuery.
+ *
+ * Returns: (transfer full) (nullable): the query for @value, or %NULL
+ *
+ * Since: 2.0
+ */
+
+/**
+ * XapianFieldProcessorClass:
+ * @process: virtual function for converting the value of a field
+ *   into a #XapianQuery; implementations should set the #GError and
+ *   return %NULL if the value is not valid, which makes the parsing of
+ *   the query string fail with %XAPIAN_ERROR_QUERY_PARSER. Returning
+ *   %NULL without setting the #GError matches no documents
+ *
+ * The virtual functions of #XapianFieldProcessor, which can be
+ * overridden to implement a field processor.
+ *
+ * Since: 2.0
+ */
+struct _XapianFieldProcessorClass
+{
+  /*< private >*/
+  GObjectClass parent_instance;
+
+  /*< public >*/
+  XapianQuery * (* process) (XapianFieldProcessor *self,
+                             const char           *value,
+                             GError              **error);
+
+  /*< private >*/
+  gpointer _padding[8];
+};
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianQuery *   xapian_field_processor_process  (XapianFieldProcessor *self,
+                                                 const char           *value,
+                                                 GError              **error);
+
+G_END_DECLS
+
+#endif /* __XAPIAN_GLIB_FIELD_PROCESSOR_H__ */
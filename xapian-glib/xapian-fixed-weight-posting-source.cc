@@ -0,0 +1,204 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-fixed-weight-posting-source
+ * @Title: XapianFixedWeightPostingSource
+ * @short_description: Posting source with a fixed weight
+ *
+ * #XapianFixedWeightPostingSource is a posting source which returns
+ * every document in the database, all with the same weight.
+ *
+ * This is useful to give a constant weight to the documents matching
+ * a filter, by combining it with the filter using
+ * %XAPIAN_QUERY_OP_FILTER.
+ */
+
+#include "config.h"
+#include "xapian-posting-source-private.h"
+#include "xapian-fixed-weight-posting-source.h"
+#include "xapian-error-private.h"
+
+#define XAPIAN_FIXED_WEIGHT_POSTING_SOURCE_GET_PRIVATE(obj) \
+  ((XapianFixedWeightPostingSourcePrivate *) xapian_fixed_weight_posting_source_get_instance_private ((XapianFixedWeightPostingSource *) (obj)))
+
+typedef struct {
+  double weight;
+} XapianFixedWeightPostingSourcePrivate;
+
+enum
+{
+  PROP_0,
+
+  PROP_WEIGHT,
+
+  LAST_PROP
+};
+
+static GParamSpec *obj_props[LAST_PROP] = { NULL, };
+
+static void initable_iface_init (GInitableIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (XapianFixedWeightPostingSource, xapian_fixed_weight_posting_source,
+                         XAPIAN_TYPE_POSTING_SOURCE,
+                         G_ADD_PRIVATE (XapianFixedWeightPostingSource)
+                         G_IMPLEMENT_INTERFACE (G_TYPE_INITABLE, initable_iface_init))
+
+static gboolean
+xapian_fixed_weight_posting_source_init_internal (GInitable    *self,
+                                                  GCancellable *cancellable,
+                                                  GError      **error)
+{
+  XapianPostingSource *pSource = XAPIAN_POSTING_SOURCE (self);
+  XapianFixedWeightPostingSourcePrivate *priv = XAPIAN_FIXED_WEIGHT_POSTING_SOURCE_GET_PRIVATE (self);
+  Xapian::FixedWeightPostingSource *mFixedWeightPostingSource;
+
+  try
+    {
+      mFixedWeightPostingSource = new Xapian::FixedWeightPostingSource (priv->weight);
+      xapian_posting_source_set_internal (pSource, (Xapian::PostingSource *) mFixedWeightPostingSource);
+
+      return TRUE;
+    }
+  catch (const Xapian::Error &err)
+    {
+      GError *internal_error = NULL;
+
+      xapian_error_to_gerror (err, &internal_error);
+      g_propagate_error (error, internal_error);
+
+      return FALSE;
+    }
+}
+
+static void
+initable_iface_init (GInitableIface *iface)
+{
+  iface->init = xapian_fixed_weight_posting_source_init_internal;
+}
+
+static void
+xapian_fixed_weight_posting_source_init (XapianFixedWeightPostingSource *self)
+{
+}
+
+static void
+xapian_fixed_weight_posting_source_set_property (GObject      *gobject,
+                                                 guint         prop_id,
+                                                 const GValue *value,
+                                                 GParamSpec   *pspec)
+{
+  XapianFixedWeightPostingSourcePrivate *priv = XAPIAN_FIXED_WEIGHT_POSTING_SOURCE_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_WEIGHT:
+      priv->weight = g_value_get_double (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_fixed_weight_posting_source_get_property (GObject    *gobject,
+                                                 guint       prop_id,
+                                                 GValue     *value,
+                                                 GParamSpec *pspec)
+{
+  XapianFixedWeightPostingSourcePrivate *priv = XAPIAN_FIXED_WEIGHT_POSTING_SOURCE_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_WEIGHT:
+      g_value_set_double (value, priv->weight);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_fixed_weight_posting_source_class_init (XapianFixedWeightPostingSourceClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->set_property = xapian_fixed_weight_posting_source_set_property;
+  gobject_class->get_property = xapian_fixed_weight_posting_source_get_property;
+
+  /**
+   * XapianFixedWeightPostingSource:weight:
+   *
+   * The weight of every document returned by the posting source.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_WEIGHT] =
+    g_param_spec_double ("weight",
+                         "Weight",
+                         "The weight of the documents",
+                         0, G_MAXDOUBLE, 0,
+                         (GParamFlags) (G_PARAM_READWRITE |
+                                        G_PARAM_CONSTRUCT_ONLY |
+                                        G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_properties (gobject_class, LAST_PROP, obj_props);
+}
+
+/**
+ * xapian_fixed_weight_posting_source_new:
+ * @weight: the weight of the documents
+ * @error: return location for a #GError, or %NULL
+ *
+ * If the initializion failed, @error is set, and this function
+ * will return %NULL.
+ *
+ * Returns: (transfer full): the newly created #XapianFixedWeightPostingSource instance
+ *
+ * Since: 2.0
+ */
+XapianFixedWeightPostingSource *
+xapian_fixed_weight_posting_source_new (double   weight,
+                                        GError **error)
+{
+  return static_cast<XapianFixedWeightPostingSource *> (g_initable_new (XAPIAN_TYPE_FIXED_WEIGHT_POSTING_SOURCE,
+                                                                        NULL, error,
+                                                                        "weight", weight,
+                                                                        NULL));
+}
+
+/**
+ * xapian_fixed_weight_posting_source_get_weight:
+ * @self: a #XapianFixedWeightPostingSource
+ *
+ * Retrieves the value of the #XapianFixedWeightPostingSource:weight property.
+ *
+ * Returns: the weight of the documents
+ *
+ * Since: 2.0
+ */
+double
+xapian_fixed_weight_posting_source_get_weight (XapianFixedWeightPostingSource *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_FIXED_WEIGHT_POSTING_SOURCE (self), 0);
+
+  XapianFixedWeightPostingSourcePrivate *priv = XAPIAN_FIXED_WEIGHT_POSTING_SOURCE_GET_PRIVATE (self);
+
+  return priv->weight;
+}
@@ -24,20 +24,44 @@
 #include "xapian-glib-version.h"
 #include "xapian-glib-macros.h"
 
+#include "xapian-completion-index.h"
+#include "xapian-database-handle.h"
+#include "xapian-database-snapshot.h"
 #include "xapian-database.h"
+#include "xapian-date-range-processor.h"
+#include "xapian-decreasing-value-weight-posting-source.h"
 #include "xapian-document.h"
 #include "xapian-enquire.h"
 #include "xapian-enums.h"
+#include "xapian-eset.h"
+#include "xapian-field-processor.h"
+#include "xapian-fixed-weight-posting-source.h"
+#include "xapian-key-maker.h"
+#include "xapian-lat-long-coords.h"
+#include "xapian-lat-long-distance-key-maker.h"
+#include "xapian-lat-long-distance-posting-source.h"
 #include "xapian-mset.h"
+#include "xapian-number-field-processor.h"
+#include "xapian-number-range-processor.h"
 #include "xapian-posting-source.h"
 #include "xapian-query.h"
 #include "xapian-query-parser.h"
+#include "xapian-range-processor.h"
+#include "xapian-recency-posting-source.h"
+#include "xapian-registry.h"
+#include "xapian-rset.h"
+#include "xapian-searcher-pool.h"
+#include "xapian-searcher.h"
 #include "xapian-simple-stopper.h"
+#include "xapian-snippet-cache.h"
+#include "xapian-static-weight-posting-source.h"
 #include "xapian-stem.h"
 #include "xapian-stopper.h"
+#include "xapian-term-field-processor.h"
 #include "xapian-term-generator.h"
 #include "xapian-term-iterator.h"
 #include "xapian-utils.h"
+#include "xapian-value-map-posting-source.h"
 #include "xapian-value-posting-source.h"
 #include "xapian-value-weight-posting-source.h"
 #include "xapian-writable-database.h"
@@ -0,0 +1,96 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-key-maker
+ * @Title: XapianKeyMaker
+ * @short_description: Base class for sort keys
+ *
+ * #XapianKeyMaker is the base class for objects building the keys used
+ * to sort the results of a search; see xapian_enquire_set_sort_by_key().
+ */
+
+#include "config.h"
+
+#include <xapian.h>
+
+#include "xapian-key-maker-private.h"
+
+#define XAPIAN_KEY_MAKER_GET_PRIVATE(obj) \
+  ((XapianKeyMakerPrivate *) xapian_key_maker_get_instance_private ((XapianKeyMaker *) (obj)))
+
+typedef struct {
+  Xapian::KeyMaker *mKeyMaker;
+} XapianKeyMakerPrivate;
+
+G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (XapianKeyMaker, xapian_key_maker, G_TYPE_OBJECT)
+
+static void
+xapian_key_maker_finalize (GObject *gobject)
+{
+  XapianKeyMakerPrivate *priv = XAPIAN_KEY_MAKER_GET_PRIVATE (gobject);
+
+  delete priv->mKeyMaker;
+
+  G_OBJECT_CLASS (xapian_key_maker_parent_class)->finalize (gobject);
+}
+
+static void
+xapian_key_maker_class_init (XapianKeyMakerClass *klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = xapian_key_maker_finalize;
+}
+
+static void
+xapian_key_maker_init (XapianKeyMaker *self)
+{
+}
+
+/*< private >
+ * xapian_key_maker_get_internal:
+ * @self: a #XapianKeyMaker
+ *
+ * Retrieves the `Xapian::KeyMaker` used by @self.
+ *
+ * Returns: (transfer none): a pointer to the internal instance
+ */
+Xapian::KeyMaker *
+xapian_key_maker_get_internal (XapianKeyMaker *self)
+{
+  XapianKeyMakerPrivate *priv = XAPIAN_KEY_MAKER_GET_PRIVATE (self);
+
+  return priv->mKeyMaker;
+}
+
+/*< private >
+ * xapian_key_maker_set_internal:
+ * @self: a #XapianKeyMaker
+ * @aKeyMaker: a `Xapian::KeyMaker` instance
+ *
+ * Sets the internal key maker instance wrapped by @self, clearing
+ * any existing instance if needed.
+ */
+void
+xapian_key_maker_set_internal (XapianKeyMaker   *self,
+                               Xapian::KeyMaker *aKeyMaker)
+{
+  XapianKeyMakerPrivate *priv = XAPIAN_KEY_MAKER_GET_PRIVATE (self);
+
+  delete priv->mKeyMaker;
+
+  priv->mKeyMaker = aKeyMaker;
+}
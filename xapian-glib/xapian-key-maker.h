@@ -0,0 +1,44 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __XAPIAN_GLIB_KEY_MAKER_H__
+#define __XAPIAN_GLIB_KEY_MAKER_H__
+
+#if !defined(XAPIAN_GLIB_H_INSIDE) && !defined(XAPIAN_GLIB_COMPILATION)
+#error "Only <xapian-glib.h> can be included directly."
+#endif
+
+#include "xapian-glib-types.h"
+
+G_BEGIN_DECLS
+
+#define XAPIAN_TYPE_KEY_MAKER   (xapian_key_maker_get_type())
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+G_DECLARE_DERIVABLE_TYPE (XapianKeyMaker, xapian_key_maker, XAPIAN, KEY_MAKER, GObject)
+
+struct _XapianKeyMakerClass
+{
+  /*< private >*/
+  GObjectClass parent_instance;
+
+  gpointer _padding[8];
+};
+
+G_END_DECLS
+
+#endif /* __XAPIAN_GLIB_KEY_MAKER_H__ */
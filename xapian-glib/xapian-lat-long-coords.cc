@@ -0,0 +1,244 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-lat-long-coords
+ * @Title: XapianLatLongCoords
+ * @short_description: A list of geographical coordinates
+ *
+ * #XapianLatLongCoords represents a list of coordinates on the surface
+ * of the Earth, each one made of a latitude and a longitude in degrees.
+ *
+ * The coordinates of a document can be stored inside a value slot using
+ * xapian_document_add_lat_long_coords(); the documents can then be
+ * ranked by their distance from a point using a
+ * #XapianLatLongDistancePostingSource, or sorted by distance using a
+ * #XapianLatLongDistanceKeyMaker.
+ */
+
+#include "config.h"
+
+#include <xapian.h>
+
+#include "xapian-lat-long-coords-private.h"
+
+#define XAPIAN_LAT_LONG_COORDS_GET_PRIVATE(obj) \
+  ((XapianLatLongCoordsPrivate *) xapian_lat_long_coords_get_instance_private ((XapianLatLongCoords *) (obj)))
+
+typedef struct {
+  Xapian::LatLongCoords *mCoords;
+} XapianLatLongCoordsPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (XapianLatLongCoords, xapian_lat_long_coords, G_TYPE_OBJECT)
+
+static void
+xapian_lat_long_coords_finalize (GObject *gobject)
+{
+  XapianLatLongCoordsPrivate *priv = XAPIAN_LAT_LONG_COORDS_GET_PRIVATE (gobject);
+
+  delete priv->mCoords;
+
+  G_OBJECT_CLASS (xapian_lat_long_coords_parent_class)->finalize (gobject);
+}
+
+static void
+xapian_lat_long_coords_class_init (XapianLatLongCoordsClass *klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = xapian_lat_long_coords_finalize;
+}
+
+static void
+xapian_lat_long_coords_init (XapianLatLongCoords *self)
+{
+  XapianLatLongCoordsPrivate *priv = XAPIAN_LAT_LONG_COORDS_GET_PRIVATE (self);
+
+  priv->mCoords = new Xapian::LatLongCoords ();
+}
+
+/*< private >
+ * xapian_lat_long_coords_get_internal:
+ * @coords: a #XapianLatLongCoords
+ *
+ * Retrieves the internal `Xapian::LatLongCoords` instance.
+ *
+ * Returns: (transfer none): a pointer to the internal instance
+ */
+Xapian::LatLongCoords *
+xapian_lat_long_coords_get_internal (XapianLatLongCoords *coords)
+{
+  XapianLatLongCoordsPrivate *priv = XAPIAN_LAT_LONG_COORDS_GET_PRIVATE (coords);
+
+  return priv->mCoords;
+}
+
+/**
+ * xapian_lat_long_coords_new:
+ *
+ * Creates a new, empty #XapianLatLongCoords.
+ *
+ * Returns: (transfer full): the newly created #XapianLatLongCoords instance
+ *
+ * Since: 2.0
+ */
+XapianLatLongCoords *
+xapian_lat_long_coords_new (void)
+{
+  return static_cast<XapianLatLongCoords *> (g_object_new (XAPIAN_TYPE_LAT_LONG_COORDS, NULL));
+}
+
+/**
+ * xapian_lat_long_coords_new_for_coord:
+ * @latitude: the latitude, in degrees, between -90 and 90
+ * @longitude: the longitude, in degrees
+ *
+ * Creates a new #XapianLatLongCoords containing a single coordinate.
+ *
+ * Returns: (transfer full): the newly created #XapianLatLongCoords instance
+ *
+ * Since: 2.0
+ */
+XapianLatLongCoords *
+xapian_lat_long_coords_new_for_coord (double latitude,
+                                      double longitude)
+{
+  g_return_val_if_fail (latitude >= -90 && latitude <= 90, NULL);
+
+  XapianLatLongCoords *res = xapian_lat_long_coords_new ();
+
+  xapian_lat_long_coords_append (res, latitude, longitude);
+
+  return res;
+}
+
+/**
+ * xapian_lat_long_coords_append:
+ * @coords: a #XapianLatLongCoords
+ * @latitude: the latitude, in degrees, between -90 and 90
+ * @longitude: the longitude, in degrees
+ *
+ * Appends a coordinate to @coords.
+ *
+ * The @longitude is normalised to be between 0 and 360 degrees.
+ *
+ * Since: 2.0
+ */
+void
+xapian_lat_long_coords_append (XapianLatLongCoords *coords,
+                               double               latitude,
+                               double               longitude)
+{
+  g_return_if_fail (XAPIAN_IS_LAT_LONG_COORDS (coords));
+  g_return_if_fail (latitude >= -90 && latitude <= 90);
+
+  xapian_lat_long_coords_get_internal (coords)->append (Xapian::LatLongCoord (latitude, longitude));
+}
+
+/**
+ * xapian_lat_long_coords_get_size:
+ * @coords: a #XapianLatLongCoords
+ *
+ * Retrieves the number of coordinates in @coords.
+ *
+ * Returns: the number of coordinates
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_lat_long_coords_get_size (XapianLatLongCoords *coords)
+{
+  g_return_val_if_fail (XAPIAN_IS_LAT_LONG_COORDS (coords), 0);
+
+  return xapian_lat_long_coords_get_internal (coords)->size ();
+}
+
+/**
+ * xapian_lat_long_coords_is_empty:
+ * @coords: a #XapianLatLongCoords
+ *
+ * Checks whether @coords is empty.
+ *
+ * Returns: %TRUE if there are no coordinates, and %FALSE otherwise
+ *
+ * Since: 2.0
+ */
+gboolean
+xapian_lat_long_coords_is_empty (XapianLatLongCoords *coords)
+{
+  g_return_val_if_fail (XAPIAN_IS_LAT_LONG_COORDS (coords), TRUE);
+
+  return xapian_lat_long_coords_get_internal (coords)->empty ();
+}
+
+/**
+ * xapian_lat_long_coords_get_coord:
+ * @coords: a #XapianLatLongCoords
+ * @index_: the position of the coordinate
+ * @latitude: (out) (optional): return location for the latitude
+ * @longitude: (out) (optional): return location for the longitude
+ *
+ * Retrieves the coordinate at the given position in @coords.
+ *
+ * Returns: %TRUE if @index_ is valid, and %FALSE otherwise
+ *
+ * Since: 2.0
+ */
+gboolean
+xapian_lat_long_coords_get_coord (XapianLatLongCoords *coords,
+                                  unsigned int         index_,
+                                  double              *latitude,
+                                  double              *longitude)
+{
+  g_return_val_if_fail (XAPIAN_IS_LAT_LONG_COORDS (coords), FALSE);
+
+  Xapian::LatLongCoords *aCoords = xapian_lat_long_coords_get_internal (coords);
+
+  if (index_ >= aCoords->size ())
+    return FALSE;
+
+  Xapian::LatLongCoordsIterator it = aCoords->begin ();
+  for (unsigned int i = 0; i < index_; i++)
+    ++it;
+
+  const Xapian::LatLongCoord &coord = *it;
+
+  if (latitude != NULL)
+    *latitude = coord.latitude;
+  if (longitude != NULL)
+    *longitude = coord.longitude;
+
+  return TRUE;
+}
+
+/**
+ * xapian_lat_long_coords_get_description:
+ * @coords: a #XapianLatLongCoords
+ *
+ * Retrieves a description of @coords, typically used for debugging.
+ *
+ * Returns: (transfer full): a description of the coordinates
+ *
+ * Since: 2.0
+ */
+char *
+xapian_lat_long_coords_get_description (XapianLatLongCoords *coords)
+{
+  g_return_val_if_fail (XAPIAN_IS_LAT_LONG_COORDS (coords), NULL);
+
+  std::string desc = xapian_lat_long_coords_get_internal (coords)->get_description ();
+
+  return g_strdup (desc.c_str ());
+}
@@ -0,0 +1,64 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __XAPIAN_GLIB_LAT_LONG_COORDS_H__
+#define __XAPIAN_GLIB_LAT_LONG_COORDS_H__
+
+#if !defined(XAPIAN_GLIB_H_INSIDE) && !defined(XAPIAN_GLIB_COMPILATION)
+#error "Only <xapian-glib.h> can be included directly."
+#endif
+
+#include "xapian-glib-types.h"
+
+G_BEGIN_DECLS
+
+#define XAPIAN_TYPE_LAT_LONG_COORDS     (xapian_lat_long_coords_get_type())
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+G_DECLARE_DERIVABLE_TYPE (XapianLatLongCoords, xapian_lat_long_coords, XAPIAN, LAT_LONG_COORDS, GObject)
+
+struct _XapianLatLongCoordsClass
+{
+  /*< private >*/
+  GObjectClass parent_instance;
+};
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianLatLongCoords *   xapian_lat_long_coords_new              (void);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianLatLongCoords *   xapian_lat_long_coords_new_for_coord    (double               latitude,
+                                                                 double               longitude);
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+void                    xapian_lat_long_coords_append           (XapianLatLongCoords *coords,
+                                                                 double               latitude,
+                                                                 double               longitude);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+unsigned int            xapian_lat_long_coords_get_size         (XapianLatLongCoords *coords);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+gboolean                xapian_lat_long_coords_is_empty         (XapianLatLongCoords *coords);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+gboolean                xapian_lat_long_coords_get_coord        (XapianLatLongCoords *coords,
+                                                                 unsigned int         index_,
+                                                                 double              *latitude,
+                                                                 double              *longitude);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+char *                  xapian_lat_long_coords_get_description  (XapianLatLongCoords *coords);
+
+G_END_DECLS
+
+#endif /* __XAPIAN_GLIB_LAT_LONG_COORDS_H__ */
@@ -0,0 +1,318 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-lat-long-distance-key-maker
+ * @Title: XapianLatLongDistanceKeyMaker
+ * @short_description: Sort results by distance
+ *
+ * #XapianLatLongDistanceKeyMaker is a #XapianKeyMaker which sorts the
+ * results of a search by the great-circle distance between the
+ * coordinates stored in a value slot of each document, using
+ * xapian_document_add_lat_long_coords(), and a centre.
+ *
+ * If a document has multiple coordinates, the closest one is used;
+ * documents without coordinates are sorted as if their distance was
+ * #XapianLatLongDistanceKeyMaker:default-distance.
+ *
+ * |[<!-- language="C" -->
+ *   XapianLatLongCoords *centre =
+ *     xapian_lat_long_coords_new_for_coord (51.5, -0.12);
+ *   XapianLatLongDistanceKeyMaker *sorter =
+ *     xapian_lat_long_distance_key_maker_new (COORDS_SLOT, centre, G_MAXDOUBLE);
+ *
+ *   xapian_enquire_set_sort_by_key (enquire, XAPIAN_KEY_MAKER (sorter), FALSE);
+ * ]|
+ */
+
+#include "config.h"
+
+#include <xapian.h>
+
+#include "xapian-lat-long-distance-key-maker.h"
+
+#include "xapian-key-maker-private.h"
+#include "xapian-lat-long-coords-private.h"
+
+#define XAPIAN_LAT_LONG_DISTANCE_KEY_MAKER_GET_PRIVATE(obj) \
+  ((XapianLatLongDistanceKeyMakerPrivate *) xapian_lat_long_distance_key_maker_get_instance_private ((XapianLatLongDistanceKeyMaker *) (obj)))
+
+typedef struct {
+  unsigned int slot;
+  XapianLatLongCoords *centre;
+  double default_distance;
+} XapianLatLongDistanceKeyMakerPrivate;
+
+enum {
+  PROP_0,
+
+  PROP_SLOT,
+  PROP_CENTRE,
+  PROP_DEFAULT_DISTANCE,
+
+  LAST_PROP
+};
+
+static GParamSpec *obj_props[LAST_PROP] = { NULL, };
+
+G_DEFINE_TYPE_WITH_PRIVATE (XapianLatLongDistanceKeyMaker, xapian_lat_long_distance_key_maker,
+                            XAPIAN_TYPE_KEY_MAKER)
+
+static void
+xapian_lat_long_distance_key_maker_constructed (GObject *gobject)
+{
+  XapianLatLongDistanceKeyMakerPrivate *priv = XAPIAN_LAT_LONG_DISTANCE_KEY_MAKER_GET_PRIVATE (gobject);
+  Xapian::LatLongCoords centre;
+
+  if (priv->centre != NULL)
+    centre = *xapian_lat_long_coords_get_internal (priv->centre);
+
+  Xapian::LatLongDistanceKeyMaker *aKeyMaker =
+    new Xapian::LatLongDistanceKeyMaker (priv->slot, centre,
+                                         Xapian::GreatCircleMetric (),
+                                         priv->default_distance);
+
+  xapian_key_maker_set_internal (XAPIAN_KEY_MAKER (gobject), aKeyMaker);
+
+  G_OBJECT_CLASS (xapian_lat_long_distance_key_maker_parent_class)->constructed (gobject);
+}
+
+static void
+xapian_lat_long_distance_key_maker_dispose (GObject *gobject)
+{
+  XapianLatLongDistanceKeyMakerPrivate *priv = XAPIAN_LAT_LONG_DISTANCE_KEY_MAKER_GET_PRIVATE (gobject);
+
+  g_clear_object (&priv->centre);
+
+  G_OBJECT_CLASS (xapian_lat_long_distance_key_maker_parent_class)->dispose (gobject);
+}
+
+static void
+xapian_lat_long_distance_key_maker_set_property (GObject      *gobject,
+                                                 guint         prop_id,
+                                                 const GValue *value,
+                                                 GParamSpec   *pspec)
+{
+  XapianLatLongDistanceKeyMakerPrivate *priv = XAPIAN_LAT_LONG_DISTANCE_KEY_MAKER_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_SLOT:
+      priv->slot = g_value_get_uint (value);
+      break;
+
+    case PROP_CENTRE:
+      g_clear_object (&priv->centre);
+      priv->centre = static_cast<XapianLatLongCoords *> (g_value_dup_object (value));
+      break;
+
+    case PROP_DEFAULT_DISTANCE:
+      priv->default_distance = g_value_get_double (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_lat_long_distance_key_maker_get_property (GObject    *gobject,
+                                                 guint       prop_id,
+                                                 GValue     *value,
+                                                 GParamSpec *pspec)
+{
+  XapianLatLongDistanceKeyMakerPrivate *priv = XAPIAN_LAT_LONG_DISTANCE_KEY_MAKER_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_SLOT:
+      g_value_set_uint (value, priv->slot);
+      break;
+
+    case PROP_CENTRE:
+      g_value_set_object (value, priv->centre);
+      break;
+
+    case PROP_DEFAULT_DISTANCE:
+      g_value_set_double (value, priv->default_distance);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_lat_long_distance_key_maker_class_init (XapianLatLongDistanceKeyMakerClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  /**
+   * XapianLatLongDistanceKeyMaker:slot:
+   *
+   * The value slot containing the coordinates of the documents.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_SLOT] =
+    g_param_spec_uint ("slot",
+                       "Slot",
+                       "The slot containing the coordinates",
+                       0, G_MAXUINT32, 0,
+                       (GParamFlags) (G_PARAM_READWRITE |
+                                      G_PARAM_CONSTRUCT_ONLY |
+                                      G_PARAM_STATIC_STRINGS));
+
+  /**
+   * XapianLatLongDistanceKeyMaker:centre:
+   *
+   * The coordinates from which the distances are computed.
+   *
+   * The coordinates are copied when the key maker is created, so
+   * later changes to them are not taken into account.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_CENTRE] =
+    g_param_spec_object ("centre",
+                         "Centre",
+                         "The coordinates from which distances are computed",
+                         XAPIAN_TYPE_LAT_LONG_COORDS,
+                         (GParamFlags) (G_PARAM_READWRITE |
+                                        G_PARAM_CONSTRUCT_ONLY |
+                                        G_PARAM_STATIC_STRINGS));
+
+  /**
+   * XapianLatLongDistanceKeyMaker:default-distance:
+   *
+   * The distance, in metres, used for documents without coordinates.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_DEFAULT_DISTANCE] =
+    g_param_spec_double ("default-distance",
+                         "Default Distance",
+                         "The distance of documents without coordinates",
+                         0, G_MAXDOUBLE, G_MAXDOUBLE,
+                         (GParamFlags) (G_PARAM_READWRITE |
+                                        G_PARAM_CONSTRUCT_ONLY |
+                                        G_PARAM_STATIC_STRINGS));
+
+  gobject_class->constructed = xapian_lat_long_distance_key_maker_constructed;
+  gobject_class->set_property = xapian_lat_long_distance_key_maker_set_property;
+  gobject_class->get_property = xapian_lat_long_distance_key_maker_get_property;
+  gobject_class->dispose = xapian_lat_long_distance_key_maker_dispose;
+
+  g_object_class_install_properties (gobject_class, LAST_PROP, obj_props);
+}
+
+static void
+xapian_lat_long_distance_key_maker_init (XapianLatLongDistanceKeyMaker *self)
+{
+  XapianLatLongDistanceKeyMakerPrivate *priv = XAPIAN_LAT_LONG_DISTANCE_KEY_MAKER_GET_PRIVATE (self);
+
+  priv->default_distance = G_MAXDOUBLE;
+}
+
+/**
+ * xapian_lat_long_distance_key_maker_new:
+ * @slot: the value slot containing the coordinates of the documents
+ * @centre: the coordinates from which the distances are computed
+ * @default_distance: the distance, in metres, used for documents
+ *   without coordinates
+ *
+ * Creates a new #XapianLatLongDistanceKeyMaker.
+ *
+ * Returns: (transfer full): the newly created #XapianLatLongDistanceKeyMaker instance
+ *
+ * Since: 2.0
+ */
+XapianLatLongDistanceKeyMaker *
+xapian_lat_long_distance_key_maker_new (unsigned int         slot,
+                                        XapianLatLongCoords *centre,
+                                        double               default_distance)
+{
+  g_return_val_if_fail (XAPIAN_IS_LAT_LONG_COORDS (centre), NULL);
+  g_return_val_if_fail (default_distance >= 0, NULL);
+
+  return static_cast<XapianLatLongDistanceKeyMaker *> (g_object_new (XAPIAN_TYPE_LAT_LONG_DISTANCE_KEY_MAKER,
+                                                                     "slot", slot,
+                                                                     "centre", centre,
+                                                                     "default-distance", default_distance,
+                                                                     NULL));
+}
+
+/**
+ * xapian_lat_long_distance_key_maker_get_slot:
+ * @self: a #XapianLatLongDistanceKeyMaker
+ *
+ * Retrieves the value of the #XapianLatLongDistanceKeyMaker:slot property.
+ *
+ * Returns: the value slot containing the coordinates
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_lat_long_distance_key_maker_get_slot (XapianLatLongDistanceKeyMaker *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_LAT_LONG_DISTANCE_KEY_MAKER (self), 0);
+
+  XapianLatLongDistanceKeyMakerPrivate *priv = XAPIAN_LAT_LONG_DISTANCE_KEY_MAKER_GET_PRIVATE (self);
+
+  return priv->slot;
+}
+
+/**
+ * xapian_lat_long_distance_key_maker_get_centre:
+ * @self: a #XapianLatLongDistanceKeyMaker
+ *
+ * Retrieves the value of the #XapianLatLongDistanceKeyMaker:centre property.
+ *
+ * Returns: (transfer none): the coordinates of the centre
+ *
+ * Since: 2.0
+ */
+XapianLatLongCoords *
+xapian_lat_long_distance_key_maker_get_centre (XapianLatLongDistanceKeyMaker *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_LAT_LONG_DISTANCE_KEY_MAKER (self), NULL);
+
+  XapianLatLongDistanceKeyMakerPrivate *priv = XAPIAN_LAT_LONG_DISTANCE_KEY_MAKER_GET_PRIVATE (self);
+
+  return priv->centre;
+}
+
+/**
+ * xapian_lat_long_distance_key_maker_get_default_distance:
+ * @self: a #XapianLatLongDistanceKeyMaker
+ *
+ * Retrieves the value of the #XapianLatLongDistanceKeyMaker:default-distance
+ * property.
+ *
+ * Returns: the distance used for documents without coordinates
+ *
+ * Since: 2.0
+ */
+double
+xapian_lat_long_distance_key_maker_get_default_distance (XapianLatLongDistanceKeyMaker *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_LAT_LONG_DISTANCE_KEY_MAKER (self), 0);
+
+  XapianLatLongDistanceKeyMakerPrivate *priv = XAPIAN_LAT_LONG_DISTANCE_KEY_MAKER_GET_PRIVATE (self);
+
+  return priv->default_distance;
+}
@@ -0,0 +1,57 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __XAPIAN_GLIB_LAT_LONG_DISTANCE_KEY_MAKER_H__
+#define __XAPIAN_GLIB_LAT_LONG_DISTANCE_KEY_MAKER_H__
+
+#if !defined(XAPIAN_GLIB_H_INSIDE) && !defined(XAPIAN_GLIB_COMPILATION)
+#error "Only <xapian-glib.h> can be included directly."
+#endif
+
+#include "xapian-glib-types.h"
+#include "xapian-key-maker.h"
+#include "xapian-lat-long-coords.h"
+
+G_BEGIN_DECLS
+
+#define XAPIAN_TYPE_LAT_LONG_DISTANCE_KEY_MAKER (xapian_lat_long_distance_key_maker_get_type())
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+G_DECLARE_DERIVABLE_TYPE (XapianLatLongDistanceKeyMaker, xapian_lat_long_distance_key_maker,
+                          XAPIAN, LAT_LONG_DISTANCE_KEY_MAKER,
+                          XapianKeyMaker)
+
+struct _XapianLatLongDistanceKeyMakerClass
+{
+  XapianKeyMakerClass parent_instance;
+};
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianLatLongDistanceKeyMaker * xapian_lat_long_distance_key_maker_new (unsigned int         slot,
+                                                                        XapianLatLongCoords *centre,
+                                                                        double               default_distance);
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+unsigned int            xapian_lat_long_distance_key_maker_get_slot             (XapianLatLongDistanceKeyMaker *self);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianLatLongCoords *   xapian_lat_long_distance_key_maker_get_centre           (XapianLatLongDistanceKeyMaker *self);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+double                  xapian_lat_long_distance_key_maker_get_default_distance (XapianLatLongDistanceKeyMaker *self);
+
+G_END_DECLS
+
+#endif /* __XAPIAN_GLIB_LAT_LONG_DISTANCE_KEY_MAKER_H__ */
@@ -0,0 +1,377 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-lat-long-distance-posting-source
+ * @Title: XapianLatLongDistancePostingSource
+ * @short_description: Posting source weighting documents by distance
+ *
+ * #XapianLatLongDistancePostingSource is a posting source which
+ * returns the documents with coordinates stored in a value slot, using
+ * xapian_document_add_lat_long_coords(), weighted by their great-circle
+ * distance from a centre: the closer the document, the higher the
+ * weight.
+ *
+ * The weight of a document at distance `d`, in metres, is computed as
+ * `k1 * pow (d + k1, -k2)`, using the values of the
+ * #XapianLatLongDistancePostingSource:k1 and
+ * #XapianLatLongDistancePostingSource:k2 properties.
+ *
+ * If #XapianLatLongDistancePostingSource:max-range is set, documents
+ * further than that distance from the centre are skipped by the
+ * matcher, so the posting source can also be used to filter the
+ * results of a query by distance, using %XAPIAN_QUERY_OP_FILTER.
+ *
+ * |[<!-- language="C" -->
+ *   XapianLatLongCoords *centre =
+ *     xapian_lat_long_coords_new_for_coord (51.5, -0.12);
+ *
+ *   // Only documents within 5km of the centre
+ *   XapianLatLongDistancePostingSource *source =
+ *     xapian_lat_long_distance_posting_source_new (COORDS_SLOT, centre, 5000, &error);
+ * ]|
+ */
+
+#include "config.h"
+
+#include <xapian.h>
+
+#include "xapian-lat-long-distance-posting-source.h"
+
+#include "xapian-error-private.h"
+#include "xapian-lat-long-coords-private.h"
+#include "xapian-posting-source-private.h"
+
+#define DEFAULT_K1      1000.0
+#define DEFAULT_K2      1.0
+
+#define XAPIAN_LAT_LONG_DISTANCE_POSTING_SOURCE_GET_PRIVATE(obj) \
+  ((XapianLatLongDistancePostingSourcePrivate *) xapian_lat_long_distance_posting_source_get_instance_private ((XapianLatLongDistancePostingSource *) (obj)))
+
+typedef struct {
+  XapianLatLongCoords *centre;
+  double max_range;
+  double k1;
+  double k2;
+} XapianLatLongDistancePostingSourcePrivate;
+
+enum
+{
+  PROP_0,
+
+  PROP_CENTRE,
+  PROP_MAX_RANGE,
+  PROP_K1,
+  PROP_K2,
+
+  LAST_PROP
+};
+
+static GParamSpec *obj_props[LAST_PROP] = { NULL, };
+
+static void initable_iface_init (GInitableIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (XapianLatLongDistancePostingSource, xapian_lat_long_distance_posting_source,
+                         XAPIAN_TYPE_VALUE_POSTING_SOURCE,
+                         G_ADD_PRIVATE (XapianLatLongDistancePostingSource)
+                         G_IMPLEMENT_INTERFACE (G_TYPE_INITABLE, initable_iface_init))
+
+static gboolean
+xapian_lat_long_distance_posting_source_init_internal (GInitable    *self,
+                                                       GCancellable *cancellable,
+                                                       GError      **error)
+{
+  XapianPostingSource *pSource = XAPIAN_POSTING_SOURCE (self);
+  XapianLatLongDistancePostingSourcePrivate *priv = XAPIAN_LAT_LONG_DISTANCE_POSTING_SOURCE_GET_PRIVATE (self);
+  Xapian::LatLongDistancePostingSource *mDistancePostingSource;
+
+  if (priv->centre == NULL || xapian_lat_long_coords_is_empty (priv->centre))
+    {
+      g_set_error_literal (error, XAPIAN_ERROR,
+                           XAPIAN_ERROR_INVALID_ARGUMENT,
+                           "The centre must contain at least one coordinate");
+      return FALSE;
+    }
+
+  try
+    {
+      guint slot = xapian_value_posting_source_get_slot (XAPIAN_VALUE_POSTING_SOURCE (self));
+      mDistancePostingSource =
+        new Xapian::LatLongDistancePostingSource (slot,
+                                                  *xapian_lat_long_coords_get_internal (priv->centre),
+                                                  Xapian::GreatCircleMetric (),
+                                                  priv->max_range,
+                                                  priv->k1,
+                                                  priv->k2);
+      xapian_posting_source_set_internal (pSource, (Xapian::PostingSource *) mDistancePostingSource);
+
+      return TRUE;
+    }
+  catch (const Xapian::Error &err)
+    {
+      GError *internal_error = NULL;
+
+      xapian_error_to_gerror (err, &internal_error);
+      g_propagate_error (error, internal_error);
+
+      return FALSE;
+    }
+}
+
+static void
+initable_iface_init (GInitableIface *iface)
+{
+  iface->init = xapian_lat_long_distance_posting_source_init_internal;
+}
+
+static void
+xapian_lat_long_distance_posting_source_dispose (GObject *gobject)
+{
+  XapianLatLongDistancePostingSourcePrivate *priv = XAPIAN_LAT_LONG_DISTANCE_POSTING_SOURCE_GET_PRIVATE (gobject);
+
+  g_clear_object (&priv->centre);
+
+  G_OBJECT_CLASS (xapian_lat_long_distance_posting_source_parent_class)->dispose (gobject);
+}
+
+static void
+xapian_lat_long_distance_posting_source_set_property (GObject      *gobject,
+                                                      guint         prop_id,
+                                                      const GValue *value,
+                                                      GParamSpec   *pspec)
+{
+  XapianLatLongDistancePostingSourcePrivate *priv = XAPIAN_LAT_LONG_DISTANCE_POSTING_SOURCE_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_CENTRE:
+      g_clear_object (&priv->centre);
+      priv->centre = static_cast<XapianLatLongCoords *> (g_value_dup_object (value));
+      break;
+
+    case PROP_MAX_RANGE:
+      priv->max_range = g_value_get_double (value);
+      break;
+
+    case PROP_K1:
+      priv->k1 = g_value_get_double (value);
+      break;
+
+    case PROP_K2:
+      priv->k2 = g_value_get_double (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_lat_long_distance_posting_source_get_property (GObject    *gobject,
+                                                      guint       prop_id,
+                                                      GValue     *value,
+                                                      GParamSpec *pspec)
+{
+  XapianLatLongDistancePostingSourcePrivate *priv = XAPIAN_LAT_LONG_DISTANCE_POSTING_SOURCE_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_CENTRE:
+      g_value_set_object (value, priv->centre);
+      break;
+
+    case PROP_MAX_RANGE:
+      g_value_set_double (value, priv->max_range);
+      break;
+
+    case PROP_K1:
+      g_value_set_double (value, priv->k1);
+      break;
+
+    case PROP_K2:
+      g_value_set_double (value, priv->k2);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_lat_long_distance_posting_source_class_init (XapianLatLongDistancePostingSourceClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->set_property = xapian_lat_long_distance_posting_source_set_property;
+  gobject_class->get_property = xapian_lat_long_distance_posting_source_get_property;
+  gobject_class->dispose = xapian_lat_long_distance_posting_source_dispose;
+
+  /**
+   * XapianLatLongDistancePostingSource:centre:
+   *
+   * The coordinates from which the distances are computed.
+   *
+   * The coordinates are copied when the posting source is initialized,
+   * so later changes to them are not taken into account.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_CENTRE] =
+    g_param_spec_object ("centre",
+                         "Centre",
+                         "The coordinates from which distances are computed",
+                         XAPIAN_TYPE_LAT_LONG_COORDS,
+                         (GParamFlags) (G_PARAM_READWRITE |
+                                        G_PARAM_CONSTRUCT_ONLY |
+                                        G_PARAM_STATIC_STRINGS));
+
+  /**
+   * XapianLatLongDistancePostingSource:max-range:
+   *
+   * The maximum distance, in metres, of the documents returned by the
+   * posting source, or 0 for no limit.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_MAX_RANGE] =
+    g_param_spec_double ("max-range",
+                         "Max Range",
+                         "The maximum distance of the documents",
+                         0, G_MAXDOUBLE, 0,
+                         (GParamFlags) (G_PARAM_READWRITE |
+                                        G_PARAM_CONSTRUCT_ONLY |
+                                        G_PARAM_STATIC_STRINGS));
+
+  /**
+   * XapianLatLongDistancePostingSource:k1:
+   *
+   * The k1 constant used to compute the weights; it must be greater
+   * than zero.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_K1] =
+    g_param_spec_double ("k1",
+                         "K1",
+                         "The k1 constant of the weight function",
+                         G_MINDOUBLE, G_MAXDOUBLE, DEFAULT_K1,
+                         (GParamFlags) (G_PARAM_READWRITE |
+                                        G_PARAM_CONSTRUCT_ONLY |
+                                        G_PARAM_STATIC_STRINGS));
+
+  /**
+   * XapianLatLongDistancePostingSource:k2:
+   *
+   * The k2 constant used to compute the weights; it must be greater
+   * than zero.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_K2] =
+    g_param_spec_double ("k2",
+                         "K2",
+                         "The k2 constant of the weight function",
+                         G_MINDOUBLE, G_MAXDOUBLE, DEFAULT_K2,
+                         (GParamFlags) (G_PARAM_READWRITE |
+                                        G_PARAM_CONSTRUCT_ONLY |
+                                        G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_properties (gobject_class, LAST_PROP, obj_props);
+}
+
+static void
+xapian_lat_long_distance_posting_source_init (XapianLatLongDistancePostingSource *self)
+{
+  XapianLatLongDistancePostingSourcePrivate *priv = XAPIAN_LAT_LONG_DISTANCE_POSTING_SOURCE_GET_PRIVATE (self);
+
+  priv->k1 = DEFAULT_K1;
+  priv->k2 = DEFAULT_K2;
+}
+
+/**
+ * xapian_lat_long_distance_posting_source_new:
+ * @slot: slot in the database entries containing the coordinates
+ * @centre: the coordinates from which the distances are computed
+ * @max_range: the maximum distance, in metres, of the documents, or
+ *   0 for no limit
+ * @error: return location for a #GError, or %NULL
+ *
+ * If the initializion failed, @error is set, and this function
+ * will return %NULL.
+ *
+ * Returns: (transfer full): the newly created #XapianLatLongDistancePostingSource instance
+ *
+ * Since: 2.0
+ */
+XapianLatLongDistancePostingSource *
+xapian_lat_long_distance_posting_source_new (unsigned int          slot,
+                                             XapianLatLongCoords  *centre,
+                                             double                max_range,
+                                             GError              **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_LAT_LONG_COORDS (centre), NULL);
+  g_return_val_if_fail (max_range >= 0, NULL);
+
+  return static_cast<XapianLatLongDistancePostingSource *> (g_initable_new (XAPIAN_TYPE_LAT_LONG_DISTANCE_POSTING_SOURCE,
+                                                                            NULL, error,
+                                                                            "slot", slot,
+                                                                            "centre", centre,
+                                                                            "max-range", max_range,
+                                                                            NULL));
+}
+
+/**
+ * xapian_lat_long_distance_posting_source_get_centre:
+ * @self: a #XapianLatLongDistancePostingSource
+ *
+ * Retrieves the value of the #XapianLatLongDistancePostingSource:centre
+ * property.
+ *
+ * Returns: (transfer none): the coordinates of the centre
+ *
+ * Since: 2.0
+ */
+XapianLatLongCoords *
+xapian_lat_long_distance_posting_source_get_centre (XapianLatLongDistancePostingSource *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_LAT_LONG_DISTANCE_POSTING_SOURCE (self), NULL);
+
+  XapianLatLongDistancePostingSourcePrivate *priv = XAPIAN_LAT_LONG_DISTANCE_POSTING_SOURCE_GET_PRIVATE (self);
+
+  return priv->centre;
+}
+
+/**
+ * xapian_lat_long_distance_posting_source_get_max_range:
+ * @self: a #XapianLatLongDistancePostingSource
+ *
+ * Retrieves the value of the #XapianLatLongDistancePostingSource:max-range
+ * property.
+ *
+ * Returns: the maximum distance, in metres, or 0 for no limit
+ *
+ * Since: 2.0
+ */
+double
+xapian_lat_long_distance_posting_source_get_max_range (XapianLatLongDistancePostingSource *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_LAT_LONG_DISTANCE_POSTING_SOURCE (self), 0);
+
+  XapianLatLongDistancePostingSourcePrivate *priv = XAPIAN_LAT_LONG_DISTANCE_POSTING_SOURCE_GET_PRIVATE (self);
+
+  return priv->max_range;
+}
@@ -17,8 +17,8 @@
 #include <config.h>
 
 #include "xapian-mset-private.h"
+#include "xapian-database-private.h"
 #include "xapian-document-private.h"
-#include "xapian-error-private.h"
 
 #include <xapian/iterator.h>
 
@@ -181,18 +181,17 @@ class IteratorData {
        * wrapping the same Xapian::Document. the field is cleared when the
        * iterator is advanced, or when it's cleared.
        */
+      XapianDatabase *database = xapian_mset_get_database (mMSet);
+
       try
         {
           Xapian::Document realDoc = mCurrent.get_document ();
 
-          mDocument = xapian_document_new_from_document (realDoc);
+          mDocument = xapian_database_wrap_document (database, realDoc);
         }
       catch (const Xapian::Error &err)
         {
-          GError *internal_error = NULL;
-
-          xapian_error_to_gerror (err, &internal_error);
-          g_propagate_error (error, internal_error);
+          xapian_database_error_to_gerror (database, err, error);
 
           mDocument = NULL;
         }
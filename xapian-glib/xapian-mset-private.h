@@ -18,10 +18,15 @@
 #define __XAPIAN_GLIB_MSET_PRIVATE_H__
 
 #include <xapian.h>
+#include "xapian-database.h"
 #include "xapian-mset.h"
 
 XapianMSet *    	xapian_mset_new                 (const Xapian::MSet &aMSet);
 Xapian::MSet *  	xapian_mset_get_internal        (XapianMSet         *mset);
+void                    xapian_mset_set_origin          (XapianMSet             *mset,
+                                                         const Xapian::Query    &aQuery,
+                                                         XapianDatabase         *database);
+XapianDatabase *        xapian_mset_get_database        (XapianMSet             *mset);
 
 XapianMSetIterator *	xapian_mset_iterator_new	(XapianMSet         *mset);
 
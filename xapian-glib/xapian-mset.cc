@@ -17,8 +17,10 @@
 #include <config.h>
 
 #include "xapian-mset-private.h"
+#include "xapian-database-private.h"
 #include "xapian-document-private.h"
-#include "xapian-error-private.h"
+#include "xapian-snippet-cache-private.h"
+#include "xapian-stem-private.h"
 
 /**
  * SECTION:xapian-mset
@@ -39,6 +41,15 @@
 
 typedef struct {
   Xapian::MSet *mSet;
+
+  /* The database used to generate the MSet */
+  XapianDatabase *database;
+
+  /* Identifies the query and the database revision that generated
+   * the MSet, used to key cached snippets; NULL if the snippets
+   * cannot be cached
+   */
+  std::string *mCacheKey;
 } XapianMSetPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (XapianMSet, xapian_mset, G_TYPE_OBJECT)
@@ -49,6 +60,9 @@ xapian_mset_class_finalize (GObject *gobject)
   XapianMSetPrivate *priv = XAPIAN_MSET_GET_PRIVATE (gobject);
 
   delete priv->mSet;
+  delete priv->mCacheKey;
+
+  g_clear_object (&priv->database);
 
   G_OBJECT_CLASS (xapian_mset_parent_class)->finalize (gobject);
 }
@@ -102,6 +116,93 @@ xapian_mset_get_internal (XapianMSet *mset)
   return priv->mSet;
 }
 
+/* Appends @field to @key, prefixed by its length, so that fields
+ * containing arbitrary bytes cannot be confused with each other
+ */
+static void
+append_key_field (std::string       &key,
+                  const std::string &field)
+{
+  char len[32];
+
+  g_snprintf (len, sizeof (len), "%" G_GSIZE_FORMAT ":", field.size ());
+
+  key += len;
+  key += field;
+}
+
+/*< private >
+ * xapian_mset_set_origin:
+ * @mset: a #XapianMSet
+ * @aQuery: the Xapian::Query used to generate @mset
+ * @database: the #XapianDatabase used to generate @mset
+ *
+ * Records the query and the database used to generate the @mset;
+ * the query and the revision of the database are used to identify
+ * the snippets stored inside a #XapianSnippetCache, and the errors
+ * thrown while reading the documents of @mset are reported using
+ * xapian_database_error_to_gerror().
+ *
+ * Snippets are not cached if the query cannot be serialised, or if
+ * the database does not have a revision.
+ */
+void
+xapian_mset_set_origin (XapianMSet             *mset,
+                        const Xapian::Query    &aQuery,
+                        XapianDatabase         *database)
+{
+  XapianMSetPrivate *priv = XAPIAN_MSET_GET_PRIVATE (mset);
+
+  g_set_object (&priv->database, database);
+
+  delete priv->mCacheKey;
+  priv->mCacheKey = NULL;
+
+  const Xapian::Database &aDB = *xapian_database_get_internal (database);
+
+  try
+    {
+      Xapian::rev revision = aDB.get_revision ();
+
+      /* Databases without revisions can change under the same key */
+      if (revision == 0)
+        return;
+
+      char rev[32];
+      g_snprintf (rev, sizeof (rev), "%" G_GUINT64_FORMAT, (guint64) revision);
+
+      std::string key;
+
+      append_key_field (key, aDB.get_uuid ());
+      append_key_field (key, rev);
+      append_key_field (key, aQuery.serialise ());
+
+      priv->mCacheKey = new std::string (key);
+    }
+  catch (const Xapian::Error &err)
+    {
+      /* Some posting sources cannot be serialised, and databases
+       * combining multiple shards do not have a revision
+       */
+    }
+}
+
+/*< private >
+ * xapian_mset_get_database:
+ * @mset: a #XapianMSet
+ *
+ * Retrieves the #XapianDatabase used to generate @mset.
+ *
+ * Returns: (transfer none) (nullable): the database, or %NULL
+ */
+XapianDatabase *
+xapian_mset_get_database (XapianMSet *mset)
+{
+  XapianMSetPrivate *priv = XAPIAN_MSET_GET_PRIVATE (mset);
+
+  return priv->database;
+}
+
 /**
  * xapian_mset_get_termfreq:
  * @mset: a #XapianMSet
@@ -420,3 +521,238 @@ xapian_mset_get_end (XapianMSet *mset)
 
   return xapian_mset_iterator_new (mset);
 }
+
+static unsigned
+snippet_flags_internal (XapianSnippetFlags flags)
+{
+  unsigned res = 0;
+
+  if ((flags & XAPIAN_SNIPPET_FLAGS_BACKGROUND_MODEL) != 0)
+    res |= Xapian::MSet::SNIPPET_BACKGROUND_MODEL;
+  if ((flags & XAPIAN_SNIPPET_FLAGS_EXHAUSTIVE) != 0)
+    res |= Xapian::MSet::SNIPPET_EXHAUSTIVE;
+  if ((flags & XAPIAN_SNIPPET_FLAGS_EMPTY_WITHOUT_MATCH) != 0)
+    res |= Xapian::MSet::SNIPPET_EMPTY_WITHOUT_MATCH;
+  if ((flags & XAPIAN_SNIPPET_FLAGS_CJK_NGRAM) != 0)
+    res |= Xapian::MSet::SNIPPET_CJK_NGRAM;
+
+  return res;
+}
+
+/**
+ * xapian_mset_get_snippet:
+ * @mset: a #XapianMSet
+ * @text: the text to extract the snippet from
+ * @length: the maximum length of the snippet, in bytes
+ * @stemmer: (nullable): the #XapianStem used to build the query,
+ *   or %NULL
+ * @flags: flags controlling the generation of the snippet
+ * @hi_start: (nullable): the markup inserted before each matching
+ *   term, or %NULL for `<b>`
+ * @hi_end: (nullable): the markup inserted after each matching term,
+ *   or %NULL for `</b>`
+ * @omit: (nullable): the string used to mark omitted text at the
+ *   beginning or at the end of the snippet, or %NULL for `...`
+ * @error: return location for a #GError
+ *
+ * Generates a snippet of @text, of at most @length bytes, which
+ * best matches the query that generated the @mset.
+ *
+ * The terms of the query found in the snippet are wrapped between
+ * @hi_start and @hi_end; if the query was parsed using a stemmer,
+ * you should pass the same stemmer as @stemmer, so that the stemmed
+ * forms of the words in @text are also highlighted.
+ *
+ * Note that @text is not escaped, so if you are generating markup
+ * you should escape it beforehand.
+ *
+ * Returns: (transfer full): the snippet; use g_free() to free the
+ *   returned string
+ *
+ * Since: 2.0
+ */
+char *
+xapian_mset_get_snippet (XapianMSet          *mset,
+                         const char          *text,
+                         gsize                length,
+                         XapianStem          *stemmer,
+                         XapianSnippetFlags   flags,
+                         const char          *hi_start,
+                         const char          *hi_end,
+                         const char          *omit,
+                         GError             **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_MSET (mset), NULL);
+  g_return_val_if_fail (text != NULL, NULL);
+  g_return_val_if_fail (stemmer == NULL || XAPIAN_IS_STEM (stemmer), NULL);
+
+  try
+    {
+      Xapian::Stem stem;
+
+      if (stemmer != NULL)
+        stem = *xapian_stem_get_internal (stemmer);
+
+      std::string res =
+        xapian_mset_get_internal (mset)->snippet (std::string (text),
+                                                  length,
+                                                  stem,
+                                                  snippet_flags_internal (flags),
+                                                  std::string (hi_start != NULL ? hi_start : "<b>"),
+                                                  std::string (hi_end != NULL ? hi_end : "</b>"),
+                                                  std::string (omit != NULL ? omit : "..."));
+
+      return g_strdup (res.c_str ());
+    }
+  catch (const Xapian::Error &err)
+    {
+      xapian_database_error_to_gerror (xapian_mset_get_database (mset), err, error);
+
+      return NULL;
+    }
+}
+
+/**
+ * xapian_mset_get_snippets:
+ * @mset: a #XapianMSet
+ * @length: the maximum length of each snippet, in bytes
+ * @stemmer: (nullable): the #XapianStem used to build the query,
+ *   or %NULL
+ * @flags: flags controlling the generation of the snippets
+ * @hi_start: (nullable): the markup inserted before each matching
+ *   term, or %NULL for `<b>`
+ * @hi_end: (nullable): the markup inserted after each matching term,
+ *   or %NULL for `</b>`
+ * @omit: (nullable): the string used to mark omitted text, or %NULL
+ *   for `...`
+ * @cache: (nullable): a #XapianSnippetCache, or %NULL
+ * @error: return location for a #GError
+ *
+ * Generates a snippet for each document inside the @mset, using the
+ * data of each document as the text; see xapian_mset_get_snippet()
+ * for the meaning of the arguments.
+ *
+ * If @cache is not %NULL, the snippets are looked up inside it before
+ * being generated, and newly generated snippets are stored inside it;
+ * the snippets are identified by the document, the query that
+ * generated the @mset, the revision of the database, and the other
+ * arguments of this function. Sharing a #XapianSnippetCache while
+ * paginating through the results of the same query avoids generating
+ * the same snippets multiple times.
+ *
+ * The snippets are not cached if the query cannot be serialised, for
+ * instance because it uses a posting source that does not support
+ * serialisation, or if the database does not have a revision, like
+ * in-memory databases and databases combining multiple databases.
+ *
+ * Returns: (transfer full) (array zero-terminated=1): the snippets,
+ *   in the same order as the documents inside @mset; use g_strfreev()
+ *   to free the returned array
+ *
+ * Since: 2.0
+ */
+char **
+xapian_mset_get_snippets (XapianMSet          *mset,
+                          gsize                length,
+                          XapianStem          *stemmer,
+                          XapianSnippetFlags   flags,
+                          const char          *hi_start,
+                          const char          *hi_end,
+                          const char          *omit,
+                          XapianSnippetCache  *cache,
+                          GError             **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_MSET (mset), NULL);
+  g_return_val_if_fail (stemmer == NULL || XAPIAN_IS_STEM (stemmer), NULL);
+  g_return_val_if_fail (cache == NULL || XAPIAN_IS_SNIPPET_CACHE (cache), NULL);
+
+  XapianMSetPrivate *priv = XAPIAN_MSET_GET_PRIVATE (mset);
+  Xapian::MSet *aMSet = xapian_mset_get_internal (mset);
+  char **res = g_new0 (char *, aMSet->size () + 1);
+
+  try
+    {
+      Xapian::Stem stem;
+
+      if (stemmer != NULL)
+        stem = *xapian_stem_get_internal (stemmer);
+
+      std::string start (hi_start != NULL ? hi_start : "<b>");
+      std::string end (hi_end != NULL ? hi_end : "</b>");
+      std::string omitted (omit != NULL ? omit : "...");
+      unsigned snippet_flags = snippet_flags_internal (flags);
+
+      if (priv->mCacheKey == NULL)
+        cache = NULL;
+
+      /* The common part of the cache keys */
+      std::string key_prefix;
+
+      if (cache != NULL)
+        {
+          char *params = g_strdup_printf ("%" G_GSIZE_FORMAT ":%u",
+                                          length,
+                                          snippet_flags);
+
+          key_prefix = *priv->mCacheKey;
+          append_key_field (key_prefix, params);
+          append_key_field (key_prefix, stem.get_description ());
+          append_key_field (key_prefix, start);
+          append_key_field (key_prefix, end);
+          append_key_field (key_prefix, omitted);
+
+          g_free (params);
+        }
+      else
+        {
+          /* Without a cache we are going to need every document */
+          aMSet->fetch ();
+        }
+
+      unsigned int i = 0;
+
+      for (Xapian::MSetIterator it = aMSet->begin (); it != aMSet->end (); ++it)
+        {
+          std::string snippet;
+          std::string key;
+
+          if (cache != NULL)
+            {
+              char docid[16];
+
+              g_snprintf (docid, sizeof (docid), "%u", *it);
+              key = key_prefix;
+              append_key_field (key, docid);
+
+              if (xapian_snippet_cache_lookup (cache, key, snippet))
+                {
+                  res[i++] = g_strdup (snippet.c_str ());
+                  continue;
+                }
+            }
+
+          snippet = aMSet->snippet (it.get_document ().get_data (),
+                                    length,
+                                    stem,
+                                    snippet_flags,
+                                    start,
+                                    end,
+                                    omitted);
+
+          if (cache != NULL)
+            xapian_snippet_cache_insert (cache, key, snippet);
+
+          res[i++] = g_strdup (snippet.c_str ());
+        }
+
+      return res;
+    }
+  catch (const Xapian::Error &err)
+    {
+      xapian_database_error_to_gerror (xapian_mset_get_database (mset), err, error);
+
+      g_strfreev (res);
+
+      return NULL;
+    }
+}
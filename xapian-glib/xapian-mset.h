@@ -23,6 +23,8 @@
 
 #include "xapian-glib-types.h"
 #include "xapian-document.h"
+#include "xapian-snippet-cache.h"
+#include "xapian-stem.h"
 
 G_BEGIN_DECLS
 
@@ -79,6 +81,27 @@ XapianMSetIterator *    xapian_mset_get_begin
 XAPIAN_GLIB_AVAILABLE_IN_2_0
 XapianMSetIterator *    xapian_mset_get_end                                     (XapianMSet *mset);
 
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+char *                  xapian_mset_get_snippet                                 (XapianMSet          *mset,
+                                                                                 const char          *text,
+                                                                                 gsize                length,
+                                                                                 XapianStem          *stemmer,
+                                                                                 XapianSnippetFlags   flags,
+                                                                                 const char          *hi_start,
+                                                                                 const char          *hi_end,
+                                                                                 const char          *omit,
+                                                                                 GError             **error);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+char **                 xapian_mset_get_snippets                                (XapianMSet          *mset,
+                                                                                 gsize                length,
+                                                                                 XapianStem          *stemmer,
+                                                                                 XapianSnippetFlags   flags,
+                                                                                 const char          *hi_start,
+                                                                                 const char          *hi_end,
+                                                                                 const char          *omit,
+                                                                                 XapianSnippetCache  *cache,
+                                                                                 GError             **error);
+
 /* Iterator */
 
 struct _XapianMSetIteratorClass
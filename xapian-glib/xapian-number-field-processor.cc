@@ -0,0 +1,239 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-number-field-processor
+ * @Title: XapianNumberFieldProcessor
+ * @short_description: Map a field to a range of numbers
+ *
+ * #XapianNumberFieldProcessor is a #XapianFieldProcessor which turns
+ * the value of a field into a query on the numbers stored in a value
+ * slot using xapian_document_add_numeric_value().
+ *
+ * The value of the field can be a single number, like `year:1984`, or
+ * a range, like `year:1980..1989`; either end of the range can be
+ * omitted, for instance `year:..1989`. Values that are not decimal
+ * numbers, including hexadecimal numbers, infinities and NaN, make
+ * the parsing fail with %XAPIAN_ERROR_QUERY_PARSER.
+ */
+
+#include "config.h"
+
+#include <math.h>
+
+#include <string>
+
+#include <xapian.h>
+
+#include "xapian-number-field-processor.h"
+
+#include "xapian-field-processor-private.h"
+
+#define XAPIAN_NUMBER_FIELD_PROCESSOR_GET_PRIVATE(obj) \
+  ((XapianNumberFieldProcessorPrivate *) xapian_number_field_processor_get_instance_private ((XapianNumberFieldProcessor *) (obj)))
+
+class NumberFieldProcessor : public Xapian::FieldProcessor {
+    Xapian::valueno mSlot;
+
+    static std::string parse_number (const std::string &value) {
+      /* g_ascii_strtod() also accepts leading white space, hexadecimal
+       * numbers, infinities and NaN, none of which is a number we want
+       * to find in a query string
+       */
+      if (value.empty () ||
+          value.find_first_not_of ("0123456789+-.eE") != std::string::npos)
+        throw Xapian::QueryParserError ("Invalid number: " + value);
+
+      char *end = NULL;
+      double number = g_ascii_strtod (value.c_str (), &end);
+
+      if (end == NULL || *end != '\0' || !isfinite (number))
+        throw Xapian::QueryParserError ("Invalid number: " + value);
+
+      return Xapian::sortable_serialise (number);
+    }
+
+  public:
+    NumberFieldProcessor (Xapian::valueno aSlot)
+      : mSlot (aSlot)
+    {
+    }
+
+    virtual Xapian::Query operator() (const std::string &value) {
+      std::string::size_type sep = value.find ("..");
+
+      if (sep == std::string::npos)
+        {
+          std::string number = parse_number (value);
+
+          return Xapian::Query (Xapian::Query::OP_VALUE_RANGE, mSlot, number, number);
+        }
+
+      std::string begin = value.substr (0, sep);
+      std::string end = value.substr (sep + 2);
+
+      if (begin.empty () && end.empty ())
+        throw Xapian::QueryParserError ("Invalid range: " + value);
+
+      if (begin.empty ())
+        return Xapian::Query (Xapian::Query::OP_VALUE_LE, mSlot, parse_number (end));
+
+      if (end.empty ())
+        return Xapian::Query (Xapian::Query::OP_VALUE_GE, mSlot, parse_number (begin));
+
+      return Xapian::Query (Xapian::Query::OP_VALUE_RANGE, mSlot,
+                            parse_number (begin),
+                            parse_number (end));
+    }
+};
+
+typedef struct {
+  unsigned int slot;
+} XapianNumberFieldProcessorPrivate;
+
+enum {
+  PROP_0,
+
+  PROP_SLOT,
+
+  LAST_PROP
+};
+
+static GParamSpec *obj_props[LAST_PROP] = { NULL, };
+
+G_DEFINE_TYPE_WITH_PRIVATE (XapianNumberFieldProcessor, xapian_number_field_processor,
+                            XAPIAN_TYPE_FIELD_PROCESSOR)
+
+static void
+xapian_number_field_processor_constructed (GObject *gobject)
+{
+  XapianNumberFieldProcessorPrivate *priv = XAPIAN_NUMBER_FIELD_PROCESSOR_GET_PRIVATE (gobject);
+
+  xapian_field_processor_set_internal (XAPIAN_FIELD_PROCESSOR (gobject),
+                                       new NumberFieldProcessor (priv->slot));
+
+  G_OBJECT_CLASS (xapian_number_field_processor_parent_class)->constructed (gobject);
+}
+
+static void
+xapian_number_field_processor_set_property (GObject      *gobject,
+                                            guint         prop_id,
+                                            const GValue *value,
+                                            GParamSpec   *pspec)
+{
+  XapianNumberFieldProcessorPrivate *priv = XAPIAN_NUMBER_FIELD_PROCESSOR_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_SLOT:
+      priv->slot = g_value_get_uint (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_number_field_processor_get_property (GObject    *gobject,
+                                            guint       prop_id,
+                                            GValue     *value,
+                                            GParamSpec *pspec)
+{
+  XapianNumberFieldProcessorPrivate *priv = XAPIAN_NUMBER_FIELD_PROCESSOR_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_SLOT:
+      g_value_set_uint (value, priv->slot);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_number_field_processor_class_init (XapianNumberFieldProcessorClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  /**
+   * XapianNumberFieldProcessor:slot:
+   *
+   * The value slot containing the numbers.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_SLOT] =
+    g_param_spec_uint ("slot",
+                       "Slot",
+                       "The value slot containing the numbers",
+                       0, G_MAXUINT32, 0,
+                       (GParamFlags) (G_PARAM_READWRITE |
+                                      G_PARAM_CONSTRUCT_ONLY |
+                                      G_PARAM_STATIC_STRINGS));
+
+  gobject_class->constructed = xapian_number_field_processor_constructed;
+  gobject_class->set_property = xapian_number_field_processor_set_property;
+  gobject_class->get_property = xapian_number_field_processor_get_property;
+
+  g_object_class_install_properties (gobject_class, LAST_PROP, obj_props);
+}
+
+static void
+xapian_number_field_processor_init (XapianNumberFieldProcessor *self)
+{
+}
+
+/**
+ * xapian_number_field_processor_new:
+ * @slot: the value slot containing the numbers
+ *
+ * Creates a new #XapianNumberFieldProcessor.
+ *
+ * Returns: (transfer full): the newly created #XapianNumberFieldProcessor instance
+ *
+ * Since: 2.0
+ */
+XapianNumberFieldProcessor *
+xapian_number_field_processor_new (unsigned int slot)
+{
+  return static_cast<XapianNumberFieldProcessor *> (g_object_new (XAPIAN_TYPE_NUMBER_FIELD_PROCESSOR,
+                                                                  "slot", slot,
+                                                                  NULL));
+}
+
+/**
+ * xapian_number_field_processor_get_slot:
+ * @self: a #XapianNumberFieldProcessor
+ *
+ * Retrieves the value of the #XapianNumberFieldProcessor:slot property.
+ *
+ * Returns: the value slot containing the numbers
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_number_field_processor_get_slot (XapianNumberFieldProcessor *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_NUMBER_FIELD_PROCESSOR (self), 0);
+
+  XapianNumberFieldProcessorPrivate *priv = XAPIAN_NUMBER_FIELD_PROCESSOR_GET_PRIVATE (self);
+
+  return priv->slot;
+}
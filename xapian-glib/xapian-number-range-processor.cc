@@ -0,0 +1,91 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-number-range-processor
+ * @Title: XapianNumberRangeProcessor
+ * @short_description: Parse ranges of numbers
+ *
+ * #XapianNumberRangeProcessor is a #XapianRangeProcessor for ranges of
+ * numbers, like `10..50`, matched against the values stored using
+ * xapian_document_add_numeric_value().
+ *
+ * Either end of the range can be omitted, for instance `..50` matches
+ * all the values up to 50.
+ */
+
+#include "config.h"
+
+#include <xapian.h>
+
+#include "xapian-number-range-processor.h"
+
+#include "xapian-range-processor-private.h"
+
+G_DEFINE_TYPE (XapianNumberRangeProcessor, xapian_number_range_processor, XAPIAN_TYPE_RANGE_PROCESSOR)
+
+static void
+xapian_number_range_processor_constructed (GObject *gobject)
+{
+  XapianRangeProcessor *self = XAPIAN_RANGE_PROCESSOR (gobject);
+  const char *marker = xapian_range_processor_get_marker (self);
+  XapianRangeProcessorFlags flags = xapian_range_processor_get_flags (self);
+
+  Xapian::RangeProcessor *aRangeProcessor =
+    new Xapian::NumberRangeProcessor (xapian_range_processor_get_slot (self),
+                                      marker != NULL ? marker : "",
+                                      xapian_range_processor_flags_internal (flags));
+
+  xapian_range_processor_set_internal (self, aRangeProcessor);
+
+  G_OBJECT_CLASS (xapian_number_range_processor_parent_class)->constructed (gobject);
+}
+
+static void
+xapian_number_range_processor_class_init (XapianNumberRangeProcessorClass *klass)
+{
+  G_OBJECT_CLASS (klass)->constructed = xapian_number_range_processor_constructed;
+}
+
+static void
+xapian_number_range_processor_init (XapianNumberRangeProcessor *self)
+{
+}
+
+/**
+ * xapian_number_range_processor_new:
+ * @slot: the value slot of the ranges
+ * @marker: (nullable): the prefix, or suffix, of the ranges
+ * @flags: a bitwise OR of #XapianRangeProcessorFlags values
+ *
+ * Creates a new #XapianNumberRangeProcessor.
+ *
+ * Returns: (transfer full): the newly created #XapianNumberRangeProcessor instance
+ *
+ * Since: 2.0
+ */
+XapianNumberRangeProcessor *
+xapian_number_range_processor_new (unsigned int               slot,
+                                   const char                *marker,
+                                   XapianRangeProcessorFlags  flags)
+{
+  return static_cast<XapianNumberRangeProcessor *> (g_object_new (XAPIAN_TYPE_NUMBER_RANGE_PROCESSOR,
+                                                                  "slot", slot,
+                                                                  "marker", marker,
+                                                                  "flags", flags,
+                                                                  NULL));
+}
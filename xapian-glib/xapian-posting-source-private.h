@@ -17,6 +17,8 @@
 #ifndef __XAPIAN_GLIB_POSTING_SOURCE_PRIVATE_H__
 #define __XAPIAN_GLIB_POSTING_SOURCE_PRIVATE_H__
 
+#include <string>
+
 #include <xapian.h>
 #include <glib.h>
 #include "xapian-posting-source.h"
@@ -26,7 +28,17 @@ Xapian::PostingSource *      xapian_posting_source_get_internal    (XapianPostin
 void                         xapian_posting_source_set_internal    (XapianPostingSource   *self,
                                                                     Xapian::PostingSource *aPostingSource);
 
-void                         xapian_posting_source_set_max_weight  (XapianPostingSource   *self,
-                                                                    double                 max_weight);
+void                         xapian_posting_source_pack_uint       (std::string           &buf,
+                                                                    guint64                value);
+void                         xapian_posting_source_pack_double     (std::string           &buf,
+                                                                    double                 value);
+void                         xapian_posting_source_pack_string     (std::string           &buf,
+                                                                    const std::string     &value);
+guint64                      xapian_posting_source_unpack_uint     (const char           **pos,
+                                                                    const char            *end);
+double                       xapian_posting_source_unpack_double   (const char           **pos,
+                                                                    const char            *end);
+std::string                  xapian_posting_source_unpack_string   (const char           **pos,
+                                                                    const char            *end);
 
 #endif /* __XAPIAN_GLIB_POSTING_SOURCE_PRIVATE_H__ */
@@ -24,11 +24,34 @@
  *
  * See #XapianValuePostingSource or #XapianValueWeightPostingSource
  * for examples of that.
+ *
+ * It is possible to implement a posting source by subclassing
+ * #XapianPostingSource and overriding its virtual functions; the
+ * #XapianPostingSourceClass.next(), #XapianPostingSourceClass.at_end()
+ * and #XapianPostingSourceClass.get_docid() virtual functions must
+ * be implemented, and the #XapianPostingSourceClass.get_weight()
+ * virtual function must be implemented to contribute to the weight
+ * of the matching documents.
+ *
+ * Alternatively, a posting source can implement the
+ * #XapianPostingSourceClass.next_block() virtual function, and return
+ * blocks of documents and their weights at once, instead of one document
+ * at a time. This is especially useful for posting sources implemented
+ * in languages with an expensive function call from C, like JavaScript.
+ *
+ * Posting sources implemented by subclassing #XapianPostingSource keep
+ * their state inside the instance, so the same instance cannot be used
+ * by multiple searches at the same time.
  */
 
 #include "config.h"
 
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
 #include "xapian-posting-source-private.h"
+#include "xapian-database-private.h"
 #include "xapian-error-private.h"
 
 #define XAPIAN_POSTING_SOURCE_GET_PRIVATE(obj) \
@@ -45,41 +68,221 @@ G_DEFINE_ABSTRACT_TYPE_WITH_CODE (XapianPostingSource, xapian_posting_source,
                                   G_TYPE_OBJECT,
                                   G_ADD_PRIVATE (XapianPostingSource))
 
-  /* Dummy posting source class with unimplemented functions.
-   * Used in xapian_posting_source_constructed. */
+/* The number of postings requested at once from the
+ * XapianPostingSourceClass.next_block() virtual function
+ */
+#define POSTING_BLOCK_SIZE      256
+
+/* Posting source class forwarding to the virtual functions of the
+ * XapianPostingSource wrapper; used in xapian_posting_source_constructed.
+ */
 class GenericPostingSource : public Xapian::PostingSource {
   public:
     GenericPostingSource (XapianPostingSource *aWrapper)
-      : mWrapper(aWrapper) {}
+      : mWrapper(aWrapper), mDatabase(NULL), mLastDocid(0), mPos(0), mAtEnd(false) {}
+
+    virtual ~GenericPostingSource() {
+        g_clear_object (&mDatabase);
+    }
 
     virtual Xapian::doccount get_termfreq_min() const {
-        return -1;
+        unsigned int min = 0, est = 0, max = 0;
+
+        get_termfreqs (&min, &est, &max);
+
+        return min;
     }
 
     virtual Xapian::doccount get_termfreq_est() const {
-        return -1;
+        unsigned int min = 0, est = 0, max = 0;
+
+        get_termfreqs (&min, &est, &max);
+
+        return est;
     }
 
     virtual Xapian::doccount get_termfreq_max() const {
-        return -1;
+        unsigned int min = 0, est = 0, max = 0;
+
+        get_termfreqs (&min, &est, &max);
+
+        return max;
     }
 
     virtual Xapian::docid get_docid() const {
-        return -1;
+        if (is_batched ())
+          return mDocids[mPos];
+
+        XapianPostingSourceClass *klass = get_class ();
+        if (klass->get_docid != NULL)
+          return klass->get_docid (mWrapper);
+
+        return 0;
+    }
+
+    virtual double get_weight() const {
+        if (is_batched ())
+          return mWeights[mPos];
+
+        XapianPostingSourceClass *klass = get_class ();
+        if (klass->get_weight != NULL)
+          return klass->get_weight (mWrapper);
+
+        return 0;
     }
 
     virtual void next(double min_wt) {
+        if (is_batched ())
+          {
+            if (mAtEnd)
+              return;
+
+            if (mPos + 1 < mDocids.size ())
+              mPos++;
+            else
+              fill_block (mLastDocid + 1, min_wt);
+
+            return;
+          }
+
+        XapianPostingSourceClass *klass = get_class ();
+        if (klass->next != NULL)
+          klass->next (mWrapper, min_wt);
+    }
+
+    virtual void skip_to(Xapian::docid did, double min_wt) {
+        if (is_batched ())
+          {
+            if (mAtEnd)
+              return;
+
+            /* The documents inside a block are sorted */
+            auto it = std::lower_bound (mDocids.begin () + mPos, mDocids.end (), did);
+            if (it != mDocids.end ())
+              mPos = it - mDocids.begin ();
+            else
+              fill_block (MAX (did, mLastDocid + 1), min_wt);
+
+            return;
+          }
+
+        XapianPostingSourceClass *klass = get_class ();
+        if (klass->skip_to != NULL)
+          klass->skip_to (mWrapper, did, min_wt);
+        else
+          Xapian::PostingSource::skip_to (did, min_wt);
+    }
+
+    virtual bool check(Xapian::docid did, double min_wt) {
+        if (is_batched ())
+          return Xapian::PostingSource::check (did, min_wt);
+
+        XapianPostingSourceClass *klass = get_class ();
+        if (klass->check != NULL)
+          return klass->check (mWrapper, did, min_wt);
+
+        return Xapian::PostingSource::check (did, min_wt);
     }
 
     virtual bool at_end() const {
-        return false;
+        if (is_batched ())
+          return mAtEnd;
+
+        XapianPostingSourceClass *klass = get_class ();
+        if (klass->at_end != NULL)
+          return klass->at_end (mWrapper);
+
+        return true;
     }
 
     virtual void init(const Xapian::Database& db) {
+        mDB = db;
+
+        mDocids.clear ();
+        mWeights.clear ();
+        mLastDocid = 0;
+        mPos = 0;
+        mAtEnd = false;
+
+        XapianPostingSourceClass *klass = get_class ();
+        if (klass->init != NULL)
+          {
+            /* The posting source is initialized for every search, so
+             * we reuse the same wrapper instead of creating a new one
+             */
+            if (mDatabase == NULL)
+              mDatabase = xapian_database_new_from_database (db);
+            else
+              xapian_database_set_internal (mDatabase, new Xapian::Database (db));
+
+            klass->init (mWrapper, mDatabase);
+          }
     }
 
   private:
+    XapianPostingSourceClass *get_class () const {
+        return XAPIAN_POSTING_SOURCE_GET_CLASS (mWrapper);
+    }
+
+    bool is_batched () const {
+        return get_class ()->next_block != NULL;
+    }
+
+    void get_termfreqs (unsigned int *min,
+                        unsigned int *est,
+                        unsigned int *max) const {
+        XapianPostingSourceClass *klass = get_class ();
+
+        *min = 0;
+        *est = *max = mDB.get_doccount ();
+
+        if (klass->get_termfreqs != NULL)
+          klass->get_termfreqs (mWrapper, min, est, max);
+    }
+
+    void fill_block (Xapian::docid first, double min_wt) {
+        mDocids.resize (POSTING_BLOCK_SIZE);
+        mWeights.resize (POSTING_BLOCK_SIZE);
+
+        gsize n = get_class ()->next_block (mWrapper, first, min_wt,
+                                            mDocids.data (), mWeights.data (),
+                                            POSTING_BLOCK_SIZE);
+        n = MIN (n, POSTING_BLOCK_SIZE);
+
+        /* Drop anything out of order, as the matcher relies on it */
+        for (gsize i = 0; i < n; i++)
+          {
+            if (mDocids[i] < first || (i > 0 && mDocids[i] <= mDocids[i - 1]))
+              {
+                g_critical ("XapianPostingSource returned documents out of "
+                            "order; the posting list is truncated.");
+                n = i;
+                break;
+              }
+          }
+
+        mDocids.resize (n);
+        mWeights.resize (n);
+        mPos = 0;
+
+        if (n == 0)
+          mAtEnd = true;
+        else
+          mLastDocid = mDocids[n - 1];
+    }
+
     XapianPostingSource *mWrapper;
+    Xapian::Database mDB;
+
+    /* The wrapper of mDB passed to the init() virtual function */
+    XapianDatabase *mDatabase;
+
+    /* The current block, used with next_block() */
+    std::vector<guint32> mDocids;
+    std::vector<double> mWeights;
+    Xapian::docid mLastDocid;
+    size_t mPos;
+    bool mAtEnd;
 };
 
 /*< private >
@@ -119,6 +322,154 @@ xapian_posting_source_set_internal (XapianPostingSource   *self,
   priv->mPostingSource = aPostingSource;
 }
 
+/*< private >
+ * xapian_posting_source_pack_uint:
+ * @buf: the buffer to append to
+ * @value: the value to append
+ *
+ * Appends @value to @buf, using a variable length encoding with seven
+ * bits for each byte.
+ *
+ * This function, and the other pack and unpack functions, are used by
+ * the posting sources implemented in this library to serialise their
+ * parameters.
+ */
+void
+xapian_posting_source_pack_uint (std::string &buf,
+                                 guint64      value)
+{
+  while (value >= 0x80)
+    {
+      buf += static_cast<char> ((value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+
+  buf += static_cast<char> (value);
+}
+
+/*< private >
+ * xapian_posting_source_pack_double:
+ * @buf: the buffer to append to
+ * @value: the value to append
+ *
+ * Appends @value to @buf, as 8 bytes in little endian order.
+ */
+void
+xapian_posting_source_pack_double (std::string &buf,
+                                   double       value)
+{
+  guint64 bits;
+
+  memcpy (&bits, &value, sizeof (bits));
+
+  for (int i = 0; i < 8; i++)
+    buf += static_cast<char> ((bits >> (i * 8)) & 0xff);
+}
+
+/*< private >
+ * xapian_posting_source_pack_string:
+ * @buf: the buffer to append to
+ * @value: the value to append
+ *
+ * Appends the length of @value, followed by its contents, to @buf.
+ */
+void
+xapian_posting_source_pack_string (std::string       &buf,
+                                   const std::string &value)
+{
+  xapian_posting_source_pack_uint (buf, value.size ());
+  buf += value;
+}
+
+/*< private >
+ * xapian_posting_source_unpack_uint:
+ * @pos: the position to read from, updated to point past the value
+ * @end: the end of the buffer
+ *
+ * Reads a value appended by xapian_posting_source_pack_uint().
+ *
+ * Throws `Xapian::SerialisationError` if the buffer is too short.
+ *
+ * Returns: the value
+ */
+guint64
+xapian_posting_source_unpack_uint (const char **pos,
+                                   const char  *end)
+{
+  guint64 value = 0;
+  unsigned int shift = 0;
+
+  while (true)
+    {
+      if (*pos == end || shift > 63)
+        throw Xapian::SerialisationError ("Bad encoded unsigned integer");
+
+      guchar byte = static_cast<guchar> (*(*pos)++);
+
+      value |= static_cast<guint64> (byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+        return value;
+
+      shift += 7;
+    }
+}
+
+/*< private >
+ * xapian_posting_source_unpack_double:
+ * @pos: the position to read from, updated to point past the value
+ * @end: the end of the buffer
+ *
+ * Reads a value appended by xapian_posting_source_pack_double().
+ *
+ * Throws `Xapian::SerialisationError` if the buffer is too short.
+ *
+ * Returns: the value
+ */
+double
+xapian_posting_source_unpack_double (const char **pos,
+                                     const char  *end)
+{
+  if (end - *pos < 8)
+    throw Xapian::SerialisationError ("Bad encoded double");
+
+  guint64 bits = 0;
+  for (int i = 0; i < 8; i++)
+    bits |= static_cast<guint64> (static_cast<guchar> ((*pos)[i])) << (i * 8);
+
+  *pos += 8;
+
+  double value;
+  memcpy (&value, &bits, sizeof (value));
+
+  return value;
+}
+
+/*< private >
+ * xapian_posting_source_unpack_string:
+ * @pos: the position to read from, updated to point past the value
+ * @end: the end of the buffer
+ *
+ * Reads a value appended by xapian_posting_source_pack_string().
+ *
+ * Throws `Xapian::SerialisationError` if the buffer is too short.
+ *
+ * Returns: the value
+ */
+std::string
+xapian_posting_source_unpack_string (const char **pos,
+                                     const char  *end)
+{
+  guint64 len = xapian_posting_source_unpack_uint (pos, end);
+
+  if (len > static_cast<guint64> (end - *pos))
+    throw Xapian::SerialisationError ("Bad encoded string");
+
+  std::string value (*pos, len);
+  *pos += len;
+
+  return value;
+}
+
 /**
  * xapian_posting_source_get_description:
  * @self: a #XapianPostingSource
@@ -176,3 +527,52 @@ static void
 xapian_posting_source_init (XapianPostingSource *posting_source)
 {
 }
+
+/**
+ * xapian_posting_source_set_max_weight:
+ * @self: a #XapianPostingSource
+ * @max_weight: the upper bound on the weights
+ *
+ * Sets an upper bound on the weights returned by the posting source
+ * from now on.
+ *
+ * The matcher uses the upper bound to skip documents that cannot
+ * make it into the results, so the bound should be as tight as
+ * possible; a posting source can lower the bound while being
+ * iterated, but it should never raise it. Subclasses typically
+ * call this function from the #XapianPostingSourceClass.init()
+ * virtual function.
+ *
+ * Since: 2.0
+ */
+void
+xapian_posting_source_set_max_weight (XapianPostingSource *self,
+                                      double               max_weight)
+{
+  g_return_if_fail (XAPIAN_IS_POSTING_SOURCE (self));
+
+  XapianPostingSourcePrivate *priv = XAPIAN_POSTING_SOURCE_GET_PRIVATE (self);
+
+  priv->mPostingSource->set_maxweight (max_weight);
+}
+
+/**
+ * xapian_posting_source_get_max_weight:
+ * @self: a #XapianPostingSource
+ *
+ * Retrieves the upper bound on the weights returned by the posting
+ * source, as set by xapian_posting_source_set_max_weight().
+ *
+ * Returns: the upper bound on the weights
+ *
+ * Since: 2.0
+ */
+double
+xapian_posting_source_get_max_weight (XapianPostingSource *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_POSTING_SOURCE (self), 0);
+
+  XapianPostingSourcePrivate *priv = XAPIAN_POSTING_SOURCE_GET_PRIVATE (self);
+
+  return priv->mPostingSource->get_maxweight ();
+}
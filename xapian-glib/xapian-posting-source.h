@@ -22,6 +22,7 @@
 #endif
 
 #include "xapian-glib-types.h"
+#include "xapian-database.h"
 
 G_BEGIN_DECLS
 
@@ -30,14 +31,130 @@ G_BEGIN_DECLS
 XAPIAN_GLIB_AVAILABLE_IN_2_0
 G_DECLARE_DERIVABLE_TYPE (XapianPostingSource, xapian_posting_source, XAPIAN, POSTING_SOURCE, GObject)
 
+/**
+ * XapianPostingSourceClass::get_termfreqs:
+ * @self: a #XapianPostingSource
+ * @termfreq_min: (out caller-allocates): the lower bound on the number
+ *   of documents
+ * @termfreq_est: (out caller-allocates): the estimated number of documents
+ * @termfreq_max: (out caller-allocates): the upper bound on the number
+ *   of documents
+ *
+ * Retrieves the bounds on the number of documents in the posting source.
+ *
+ * The arguments are set to the default values before the virtual
+ * function is called, so implementations only need to set the ones
+ * they know about.
+ *
+ * Since: 2.0
+ */
+
+/**
+ * XapianPostingSourceClass::next_block:
+ * @self: a #XapianPostingSource
+ * @first_docid: the lowest document identifier to return
+ * @min_weight: the minimum weight of the documents the matcher is
+ *   interested in
+ * @docids: (out caller-allocates) (array length=max_entries): the
+ *   buffer to fill with the identifiers of the documents
+ * @weights: (out caller-allocates) (array length=max_entries): the
+ *   buffer to fill with the weights of the documents
+ * @max_entries: the size of the @docids and @weights buffers
+ *
+ * Retrieves up to @max_entries documents with an identifier of at
+ * least @first_docid, in ascending order of identifier.
+ *
+ * Returns: the number of documents stored in @docids and @weights,
+ *   or 0 at the end of the posting source
+ *
+ * Since: 2.0
+ */
+
+/**
+ * XapianPostingSourceClass:
+ * @init: virtual function called before the posting source is used
+ *   to search @database; implementations should reset their state.
+ *   The same #XapianDatabase instance may be passed to every call, and
+ *   it only reflects the database of the latest search
+ * @next: virtual function for advancing to the next document with a
+ *   weight of at least @min_weight; the first call positions the source
+ *   on the first document
+ * @skip_to: virtual function for advancing to the first document with
+ *   an identifier of at least @docid; the default implementation calls
+ *   the #XapianPostingSourceClass.next() virtual function
+ * @check: virtual function for checking whether @docid is in the
+ *   posting source; the default implementation calls the
+ *   #XapianPostingSourceClass.skip_to() virtual function, and returns
+ *   %TRUE
+ * @at_end: virtual function for checking whether the posting source
+ *   has no more documents
+ * @get_docid: virtual function for retrieving the identifier of the
+ *   current document
+ * @get_weight: virtual function for retrieving the weight of the
+ *   current document; the default implementation returns 0
+ * @get_termfreqs: virtual function for retrieving the bounds on the
+ *   number of documents in the posting source; the default implementation
+ *   uses 0 as the lower bound and the number of documents in the
+ *   database as the estimate and the upper bound
+ * @next_block: virtual function for retrieving, at once, up to
+ *   @max_entries documents with an identifier of at least @first_docid,
+ *   in ascending order of identifier, and their weights; returning 0
+ *   marks the end of the posting source. If this virtual function is
+ *   implemented, the @next, @skip_to, @check, @at_end, @get_docid and
+ *   @get_weight virtual functions are not used
+ *
+ * The virtual functions of #XapianPostingSource, which can be overridden
+ * to implement a posting source.
+ *
+ * Since: 2.0
+ */
 struct _XapianPostingSourceClass
 {
+  /*< private >*/
   GObjectClass parent_instance;
+
+  /*< public >*/
+  void          (* init)          (XapianPostingSource *self,
+                                   XapianDatabase      *database);
+
+  void          (* next)          (XapianPostingSource *self,
+                                   double               min_weight);
+  void          (* skip_to)       (XapianPostingSource *self,
+                                   unsigned int         docid,
+                                   double               min_weight);
+  gboolean      (* check)         (XapianPostingSource *self,
+                                   unsigned int         docid,
+                                   double               min_weight);
+  gboolean      (* at_end)        (XapianPostingSource *self);
+
+  unsigned int  (* get_docid)     (XapianPostingSource *self);
+  double        (* get_weight)    (XapianPostingSource *self);
+
+  void          (* get_termfreqs) (XapianPostingSource *self,
+                                   unsigned int        *termfreq_min,
+                                   unsigned int        *termfreq_est,
+                                   unsigned int        *termfreq_max);
+
+  gsize         (* next_block)    (XapianPostingSource *self,
+                                   unsigned int         first_docid,
+                                   double               min_weight,
+                                   guint32             *docids,
+                                   double              *weights,
+                                   gsize                max_entries);
+
+  /*< private >*/
+  gpointer _padding[8];
 };
 
 XAPIAN_GLIB_AVAILABLE_IN_2_0
 char *xapian_posting_source_get_description (XapianPostingSource *self);
 
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+void xapian_posting_source_set_max_weight (XapianPostingSource *self,
+                                           double               max_weight);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+double xapian_posting_source_get_max_weight (XapianPostingSource *self);
+
 G_END_DECLS
 
 #endif /* __XAPIAN_GLIB_POSTING_SOURCE_H__ */
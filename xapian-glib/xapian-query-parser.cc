@@ -37,7 +37,9 @@
 #include "xapian-stopper-private.h"
 #include "xapian-enums.h"
 #include "xapian-error-private.h"
+#include "xapian-field-processor-private.h"
 #include "xapian-query-private.h"
+#include "xapian-range-processor-private.h"
 #include "xapian-stem-private.h"
 
 #define XAPIAN_QUERY_PARSER_GET_PRIVATE(obj) \
@@ -54,6 +56,12 @@ typedef struct {
   XapianStopper *stopper;
 
   XapianQueryOp default_op;
+
+  /* A reference on each range and field processor added to the parser;
+   * Xapian::QueryParser only points to their internal objects, so they
+   * must be kept alive as long as the parser
+   */
+  GPtrArray *processors;
 } XapianQueryParserPrivate;
 
 enum {
@@ -79,6 +87,8 @@ xapian_query_parser_finalize (GObject *gobject)
 
   delete priv->mQueryParser;
 
+  g_ptr_array_unref (priv->processors);
+
   G_OBJECT_CLASS (xapian_query_parser_parent_class)->finalize (gobject);
 }
 
@@ -254,6 +264,42 @@ xapian_query_parser_init (XapianQueryParser *self)
   XapianQueryParserPrivate *priv = XAPIAN_QUERY_PARSER_GET_PRIVATE (self);
 
   priv->mQueryParser = new Xapian::QueryParser ();
+  priv->processors = g_ptr_array_new_with_free_func (g_object_unref);
+}
+
+static unsigned int
+query_parser_feature_internal (XapianQueryParserFeature flags)
+{
+  unsigned int real_flags = 0;
+
+  if (flags & XAPIAN_QUERY_PARSER_FEATURE_BOOLEAN)
+    real_flags |= Xapian::QueryParser::FLAG_BOOLEAN;
+  if (flags & XAPIAN_QUERY_PARSER_FEATURE_PHRASE)
+    real_flags |= Xapian::QueryParser::FLAG_PHRASE;
+  if (flags & XAPIAN_QUERY_PARSER_FEATURE_LOVEHATE)
+    real_flags |= Xapian::QueryParser::FLAG_LOVEHATE;
+  if (flags & XAPIAN_QUERY_PARSER_FEATURE_BOOLEAN_ANY_CASE)
+    real_flags |= Xapian::QueryParser::FLAG_BOOLEAN_ANY_CASE;
+  if (flags & XAPIAN_QUERY_PARSER_FEATURE_WILDCARD)
+    real_flags |= Xapian::QueryParser::FLAG_WILDCARD;
+  if (flags & XAPIAN_QUERY_PARSER_FEATURE_PURE_NOT)
+    real_flags |= Xapian::QueryParser::FLAG_PURE_NOT;
+  if (flags & XAPIAN_QUERY_PARSER_FEATURE_PARTIAL)
+    real_flags |= Xapian::QueryParser::FLAG_PARTIAL;
+  if (flags & XAPIAN_QUERY_PARSER_FEATURE_SPELLING_CORRECTION)
+    real_flags |= Xapian::QueryParser::FLAG_SPELLING_CORRECTION;
+  if (flags & XAPIAN_QUERY_PARSER_FEATURE_SYNONYM)
+    real_flags |= Xapian::QueryParser::FLAG_SYNONYM;
+  if (flags & XAPIAN_QUERY_PARSER_FEATURE_AUTO_SYNONYMS)
+    real_flags |= Xapian::QueryParser::FLAG_AUTO_SYNONYMS;
+  if (flags & XAPIAN_QUERY_PARSER_FEATURE_AUTO_MULTIWORD_SYNONYMS)
+    real_flags |= Xapian::QueryParser::FLAG_AUTO_MULTIWORD_SYNONYMS;
+  if (flags & XAPIAN_QUERY_PARSER_FEATURE_CJK_NGRAM)
+    real_flags |= Xapian::QueryParser::FLAG_CJK_NGRAM;
+  if (flags & XAPIAN_QUERY_PARSER_FEATURE_CJK_WORDS)
+    real_flags |= Xapian::QueryParser::FLAG_CJK_WORDS;
+
+  return real_flags;
 }
 
 /**
@@ -431,6 +477,45 @@ xapian_query_parser_set_default_op (XapianQueryParser *parser,
   g_object_notify_by_pspec (G_OBJECT (parser), obj_props[PROP_DEFAULT_OP]);
 }
 
+/**
+ * xapian_query_parser_set_max_expansion:
+ * @parser: a #XapianQueryParser
+ * @max_expansion: the maximum number of terms to expand to, or 0 for
+ *   no limit
+ * @limit: how to handle an expansion exceeding @max_expansion
+ * @flags: the features affected by the limit; a bitwise OR of
+ *   %XAPIAN_QUERY_PARSER_FEATURE_WILDCARD and
+ *   %XAPIAN_QUERY_PARSER_FEATURE_PARTIAL
+ *
+ * Limits the number of terms that wildcards and partial terms are
+ * expanded to, when parsing queries with the features in @flags.
+ *
+ * A short wildcard like `a*` can potentially expand to a very large
+ * number of terms, which makes running the query very expensive.
+ *
+ * If @limit is %XAPIAN_WILDCARD_LIMIT_ERROR, running a query that
+ * expands to more than @max_expansion terms will fail with
+ * %XAPIAN_ERROR_WILDCARD. Partial terms always behave as if @limit
+ * was %XAPIAN_WILDCARD_LIMIT_MOST_FREQUENT when set to
+ * %XAPIAN_WILDCARD_LIMIT_ERROR.
+ *
+ * Since: 2.0
+ */
+void
+xapian_query_parser_set_max_expansion (XapianQueryParser        *parser,
+                                       unsigned int              max_expansion,
+                                       XapianWildcardLimit       limit,
+                                       XapianQueryParserFeature  flags)
+{
+  g_return_if_fail (XAPIAN_IS_QUERY_PARSER (parser));
+
+  XapianQueryParserPrivate *priv = XAPIAN_QUERY_PARSER_GET_PRIVATE (parser);
+
+  priv->mQueryParser->set_max_expansion (max_expansion,
+                                         xapian_wildcard_limit_internal (limit),
+                                         query_parser_feature_internal (flags));
+}
+
 /**
  * xapian_query_parser_add_prefix:
  * @parser: a #XapianQueryParser
@@ -510,6 +595,110 @@ xapian_query_parser_add_boolean_prefix (XapianQueryParser *parser,
     }
 }
 
+/**
+ * xapian_query_parser_add_range_processor:
+ * @parser: a #XapianQueryParser
+ * @processor: a #XapianRangeProcessor
+ * @grouping: (nullable): the grouping of the ranges handled by
+ *   @processor, or %NULL
+ *
+ * Adds a range processor to the @parser, which turns ranges like
+ * `price:10..50` in the query string into value range queries.
+ *
+ * Range processors are tried in the order in which they were added,
+ * and the first one handling a range is used.
+ *
+ * By default, ranges for the same #XapianRangeProcessor:slot are
+ * combined with %XAPIAN_QUERY_OP_OR, and ranges for different slots
+ * are combined with %XAPIAN_QUERY_OP_AND. If @grouping is not %NULL,
+ * ranges handled by processors with the same @grouping are combined
+ * with %XAPIAN_QUERY_OP_OR instead.
+ *
+ * The @parser acquires a reference on the @processor.
+ *
+ * Since: 2.0
+ */
+void
+xapian_query_parser_add_range_processor (XapianQueryParser    *parser,
+                                         XapianRangeProcessor *processor,
+                                         const char           *grouping)
+{
+  g_return_if_fail (XAPIAN_IS_QUERY_PARSER (parser));
+  g_return_if_fail (XAPIAN_IS_RANGE_PROCESSOR (processor));
+
+  XapianQueryParserPrivate *priv = XAPIAN_QUERY_PARSER_GET_PRIVATE (parser);
+
+  g_ptr_array_add (priv->processors, g_object_ref (processor));
+
+  Xapian::RangeProcessor *aRangeProcessor = xapian_range_processor_get_internal (processor);
+
+  if (grouping != NULL)
+    {
+      std::string aGrouping (grouping);
+
+      priv->mQueryParser->add_rangeprocessor (aRangeProcessor, &aGrouping);
+    }
+  else
+    priv->mQueryParser->add_rangeprocessor (aRangeProcessor);
+}
+
+/**
+ * xapian_query_parser_add_field_processor:
+ * @parser: a #XapianQueryParser
+ * @field: the user visible field name
+ * @processor: a #XapianFieldProcessor
+ * @is_boolean: whether the queries generated by @processor are
+ *   boolean filters
+ *
+ * Adds a field processor to the @parser, which converts the value of
+ * @field in the query string into a #XapianQuery; for instance, after
+ * calling:
+ *
+ * |[<!-- language="C" -->
+ *   xapian_query_parser_add_field_processor (parser, "tag", processor, TRUE);
+ * ]|
+ *
+ * the query string `tag:Fiction` is handled by @processor.
+ *
+ * If @is_boolean is %TRUE, the field is handled like the ones added
+ * by xapian_query_parser_add_boolean_prefix(), and the query is used
+ * as a filter; otherwise, it's handled like the ones added by
+ * xapian_query_parser_add_prefix().
+ *
+ * The @parser acquires a reference on the @processor.
+ *
+ * Since: 2.0
+ */
+void
+xapian_query_parser_add_field_processor (XapianQueryParser    *parser,
+                                         const char           *field,
+                                         XapianFieldProcessor *processor,
+                                         gboolean              is_boolean)
+{
+  g_return_if_fail (XAPIAN_IS_QUERY_PARSER (parser));
+  g_return_if_fail (field != NULL);
+  g_return_if_fail (XAPIAN_IS_FIELD_PROCESSOR (processor));
+
+  XapianQueryParserPrivate *priv = XAPIAN_QUERY_PARSER_GET_PRIVATE (parser);
+  Xapian::FieldProcessor *aFieldProcessor = xapian_field_processor_get_internal (processor);
+
+  try
+    {
+      if (is_boolean)
+        priv->mQueryParser->add_boolean_prefix (std::string (field), aFieldProcessor);
+      else
+        priv->mQueryParser->add_prefix (std::string (field), aFieldProcessor);
+
+      g_ptr_array_add (priv->processors, g_object_ref (processor));
+    }
+  catch (const Xapian::InvalidOperationError &err)
+    {
+      std::string desc = err.get_msg ();
+
+      g_critical ("add_field_processor: %s", desc.c_str ());
+    }
+}
+
 /**
  * xapian_query_parser_parse_query:
  * @parser: a #XapianQueryParser
@@ -559,32 +748,7 @@ xapian_query_parser_parse_query_full (XapianQueryParser        *parser,
 
   try
     {
-      unsigned int real_flags = 0;
-
-      if (flags & XAPIAN_QUERY_PARSER_FEATURE_BOOLEAN)
-        real_flags |= Xapian::QueryParser::FLAG_BOOLEAN;
-      if (flags & XAPIAN_QUERY_PARSER_FEATURE_PHRASE)
-        real_flags |= Xapian::QueryParser::FLAG_PHRASE;
-      if (flags & XAPIAN_QUERY_PARSER_FEATURE_LOVEHATE)
-        real_flags |= Xapian::QueryParser::FLAG_LOVEHATE;
-      if (flags & XAPIAN_QUERY_PARSER_FEATURE_BOOLEAN_ANY_CASE)
-        real_flags |= Xapian::QueryParser::FLAG_BOOLEAN_ANY_CASE;
-      if (flags & XAPIAN_QUERY_PARSER_FEATURE_WILDCARD)
-        real_flags |= Xapian::QueryParser::FLAG_WILDCARD;
-      if (flags & XAPIAN_QUERY_PARSER_FEATURE_PURE_NOT)
-        real_flags |= Xapian::QueryParser::FLAG_PURE_NOT;
-      if (flags & XAPIAN_QUERY_PARSER_FEATURE_PARTIAL)
-        real_flags |= Xapian::QueryParser::FLAG_PARTIAL;
-      if (flags & XAPIAN_QUERY_PARSER_FEATURE_SPELLING_CORRECTION)
-        real_flags |= Xapian::QueryParser::FLAG_SPELLING_CORRECTION;
-      if (flags & XAPIAN_QUERY_PARSER_FEATURE_SYNONYM)
-        real_flags |= Xapian::QueryParser::FLAG_SYNONYM;
-      if (flags & XAPIAN_QUERY_PARSER_FEATURE_AUTO_SYNONYMS)
-        real_flags |= Xapian::QueryParser::FLAG_AUTO_SYNONYMS;
-      if (flags & XAPIAN_QUERY_PARSER_FEATURE_AUTO_MULTIWORD_SYNONYMS)
-        real_flags |= Xapian::QueryParser::FLAG_AUTO_MULTIWORD_SYNONYMS;
-      if (flags & XAPIAN_QUERY_PARSER_FEATURE_CJK_NGRAM)
-        real_flags |= Xapian::QueryParser::FLAG_CJK_NGRAM;
+      unsigned int real_flags = query_parser_feature_internal (flags);
 
       Xapian::Query query = priv->mQueryParser->parse_query (std::string (query_string),
                                                              real_flags,
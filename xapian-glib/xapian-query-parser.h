@@ -23,7 +23,9 @@
 
 #include "xapian-glib-types.h"
 #include "xapian-database.h"
+#include "xapian-field-processor.h"
 #include "xapian-query.h"
+#include "xapian-range-processor.h"
 #include "xapian-stem.h"
 #include "xapian-stopper.h"
 
@@ -57,6 +59,11 @@ void                    xapian_query_parser_set_database                (XapianQ
 XAPIAN_GLIB_AVAILABLE_IN_2_0
 void                    xapian_query_parser_set_default_op              (XapianQueryParser        *parser,
                                                                          XapianQueryOp             op);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+void                    xapian_query_parser_set_max_expansion           (XapianQueryParser        *parser,
+                                                                         unsigned int              max_expansion,
+                                                                         XapianWildcardLimit       limit,
+                                                                         XapianQueryParserFeature  flags);
 
 XAPIAN_GLIB_AVAILABLE_IN_2_0
 void                    xapian_query_parser_add_prefix                  (XapianQueryParser        *parser,
@@ -67,6 +74,15 @@ void                    xapian_query_parser_add_boolean_prefix          (XapianQ
                                                                          const char               *field,
                                                                          const char               *prefix,
                                                                          gboolean                  exclusive);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+void                    xapian_query_parser_add_range_processor         (XapianQueryParser        *parser,
+                                                                         XapianRangeProcessor     *processor,
+                                                                         const char               *grouping);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+void                    xapian_query_parser_add_field_processor         (XapianQueryParser        *parser,
+                                                                         const char               *field,
+                                                                         XapianFieldProcessor     *processor,
+                                                                         gboolean                  is_boolean);
 
 XAPIAN_GLIB_AVAILABLE_IN_2_0
 XapianQuery *           xapian_query_parser_parse_query                 (XapianQueryParser        *parser,
@@ -23,5 +23,7 @@
 Xapian::Query * xapian_query_get_internal       (XapianQuery         *self);
 XapianQuery *   xapian_query_new_from_query     (const Xapian::Query &aQuery);
 Xapian::Query::op xapian_query_op_internal      (XapianQueryOp        op);
+int             xapian_wildcard_limit_internal  (XapianWildcardLimit  limit);
+void            xapian_query_register_posting_sources (Xapian::Registry &aRegistry);
 
 #endif /* __XAPIAN_GLIB_QUERY_PRIVATE_H__ */
@@ -29,13 +29,555 @@
 
 #include "config.h"
 
+#include <algorithm>
+#include <memory>
+#include <unordered_set>
 #include <vector>
 
 #include "xapian-query-private.h"
 
+#include "xapian-database-private.h"
 #include "xapian-enums.h"
 #include "xapian-error-private.h"
 #include "xapian-posting-source-private.h"
+#include "xapian-registry-private.h"
+
+#define DOCID_SET_WORD_BITS     (GLIB_SIZEOF_LONG * 8)
+#define DOCID_SET_CHUNK_SIZE    65536
+#define DOCID_SET_CHUNK_WORDS   (DOCID_SET_CHUNK_SIZE / DOCID_SET_WORD_BITS)
+
+/* Chunks with more identifiers than this use a bitmap, which takes
+ * the same space as an array of this size
+ */
+#define DOCID_SET_MAX_ARRAY     (DOCID_SET_CHUNK_SIZE / 16)
+
+/* A set of document identifiers, stored as a compressed bitmap: the
+ * identifiers are split in chunks sharing the same upper 16 bits, and
+ * each chunk stores the lower 16 bits either in a sorted array, if it
+ * is sparse, or in a bitmap, if it is dense; the memory used depends
+ * on the number of identifiers, and not on their values.
+ */
+class DocidSet {
+    DocidSet (const DocidSet &aSet);
+
+    void operator= (const DocidSet &aSet);
+
+    struct Chunk {
+      guint16 key;
+
+      /* Only one of the two is used */
+      std::vector<guint16> values;
+      std::vector<gulong> words;
+    };
+
+    std::vector<Chunk> mChunks;
+    Xapian::docid mMaxDocid;
+    Xapian::doccount mSize;
+
+    static bool chunk_before (const Chunk &chunk, guint16 key) {
+      return chunk.key < key;
+    }
+
+    std::vector<Chunk>::const_iterator find_chunk (guint16 key) const {
+      return std::lower_bound (mChunks.begin (), mChunks.end (), key, chunk_before);
+    }
+
+    /* Stores the first value in @chunk not lower than @low in @res */
+    static bool chunk_next (const Chunk &chunk,
+                            guint32      low,
+                            guint32     *res) {
+      if (chunk.words.empty ())
+        {
+          auto it = std::lower_bound (chunk.values.begin (), chunk.values.end (), low);
+
+          if (it == chunk.values.end ())
+            return false;
+
+          *res = *it;
+          return true;
+        }
+
+      gsize word = low / DOCID_SET_WORD_BITS;
+      gint bit = g_bit_nth_lsf (chunk.words[word], (gint) (low % DOCID_SET_WORD_BITS) - 1);
+
+      while (bit < 0)
+        {
+          word += 1;
+          if (word >= DOCID_SET_CHUNK_WORDS)
+            return false;
+
+          bit = g_bit_nth_lsf (chunk.words[word], -1);
+        }
+
+      *res = word * DOCID_SET_WORD_BITS + bit;
+      return true;
+    }
+
+    void add_chunk (std::vector<guint32>::const_iterator first,
+                    std::vector<guint32>::const_iterator last) {
+      Chunk chunk;
+
+      chunk.key = *first >> 16;
+
+      if (last - first > DOCID_SET_MAX_ARRAY)
+        {
+          chunk.words.assign (DOCID_SET_CHUNK_WORDS, 0);
+
+          for (auto it = first; it != last; ++it)
+            {
+              guint32 low = *it & 0xffff;
+
+              chunk.words[low / DOCID_SET_WORD_BITS] |= 1UL << (low % DOCID_SET_WORD_BITS);
+            }
+        }
+      else
+        {
+          chunk.values.reserve (last - first);
+
+          for (auto it = first; it != last; ++it)
+            chunk.values.push_back (*it & 0xffff);
+        }
+
+      mChunks.push_back (std::move (chunk));
+    }
+
+  public:
+    DocidSet (const guint32 *docids,
+              gsize          n_docids)
+      : mMaxDocid (0),
+        mSize (0)
+    {
+      std::vector<guint32> sorted;
+
+      sorted.reserve (n_docids);
+      for (gsize i = 0; i < n_docids; i++)
+        {
+          if (docids[i] != 0)
+            sorted.push_back (docids[i]);
+        }
+
+      std::sort (sorted.begin (), sorted.end ());
+      sorted.erase (std::unique (sorted.begin (), sorted.end ()), sorted.end ());
+
+      if (sorted.empty ())
+        return;
+
+      mSize = sorted.size ();
+      mMaxDocid = sorted.back ();
+
+      auto first = sorted.cbegin ();
+      for (auto it = sorted.cbegin (); it != sorted.cend (); ++it)
+        {
+          if ((*it >> 16) != (*first >> 16))
+            {
+              add_chunk (first, it);
+              first = it;
+            }
+        }
+
+      add_chunk (first, sorted.cend ());
+    }
+
+    bool contains (Xapian::docid did) const {
+      if (did > mMaxDocid)
+        return false;
+
+      auto chunk = find_chunk (did >> 16);
+      if (chunk == mChunks.end () || chunk->key != (did >> 16))
+        return false;
+
+      guint16 low = did & 0xffff;
+
+      if (chunk->words.empty ())
+        return std::binary_search (chunk->values.begin (), chunk->values.end (), low);
+
+      return (chunk->words[low / DOCID_SET_WORD_BITS] >> (low % DOCID_SET_WORD_BITS)) & 1;
+    }
+
+    /* Returns the first identifier in the set not lower than @did,
+     * or 0 if there are none.
+     */
+    Xapian::docid next (Xapian::docid did) const {
+      if (did > mMaxDocid)
+        return 0;
+
+      for (auto chunk = find_chunk (did >> 16); chunk != mChunks.end (); ++chunk)
+        {
+          guint32 low = chunk->key == (did >> 16) ? (did & 0xffff) : 0;
+          guint32 res;
+
+          if (chunk_next (*chunk, low, &res))
+            return ((Xapian::docid) chunk->key << 16) | res;
+        }
+
+      return 0;
+    }
+
+    Xapian::docid get_max_docid () const {
+      return mMaxDocid;
+    }
+
+    Xapian::doccount size () const {
+      return mSize;
+    }
+};
+
+/* A posting source returning the documents in a DocidSet, with no
+ * weight; it's meant to be used as a filter.
+ */
+class DocidSetPostingSource : public Xapian::PostingSource {
+    std::shared_ptr<const DocidSet> mSet;
+
+    Xapian::docid mDocid;
+    Xapian::docid mLastDocid;
+    Xapian::doccount mDocCount;
+    bool mAtEnd;
+
+    /* If the database has holes in its identifiers, the identifiers
+     * in the set are matched against the list of all documents
+     */
+    bool mCheckExists;
+    Xapian::PostingIterator mAllDocs;
+    Xapian::PostingIterator mAllDocsEnd;
+
+    void move_to (Xapian::docid did) {
+      while (true)
+        {
+          did = mSet->next (did);
+
+          if (did == 0 || did > mLastDocid)
+            break;
+
+          if (!mCheckExists)
+            {
+              mDocid = did;
+              return;
+            }
+
+          mAllDocs.skip_to (did);
+          if (mAllDocs == mAllDocsEnd)
+            break;
+
+          if (*mAllDocs == did)
+            {
+              mDocid = did;
+              return;
+            }
+
+          did = *mAllDocs;
+        }
+
+      mAtEnd = true;
+    }
+
+  public:
+    DocidSetPostingSource (std::shared_ptr<const DocidSet> aSet)
+      : mSet (aSet),
+        mDocid (0),
+        mLastDocid (0),
+        mDocCount (0),
+        mAtEnd (false),
+        mCheckExists (false)
+    {
+    }
+
+    virtual Xapian::PostingSource *clone () const {
+      return new DocidSetPostingSource (mSet);
+    }
+
+    virtual std::string name () const {
+      return "XapianGlib::DocidSetPostingSource";
+    }
+
+    /* The identifiers are stored in increasing order, as deltas */
+    virtual std::string serialise () const {
+      std::string res;
+      Xapian::docid prev = 0;
+      Xapian::docid did = mSet->next (1);
+
+      xapian_posting_source_pack_uint (res, mSet->size ());
+
+      while (did != 0)
+        {
+          xapian_posting_source_pack_uint (res, did - prev);
+          prev = did;
+
+          did = did < mSet->get_max_docid () ? mSet->next (did + 1) : 0;
+        }
+
+      return res;
+    }
+
+    virtual Xapian::PostingSource *unserialise (const std::string &data) const {
+      const char *pos = data.data ();
+      const char *end = pos + data.size ();
+
+      /* Each delta takes at least one byte */
+      guint64 n_docids = xapian_posting_source_unpack_uint (&pos, end);
+      if (n_docids > static_cast<guint64> (end - pos))
+        throw Xapian::SerialisationError ("Bad serialised DocidSetPostingSource");
+
+      std::vector<guint32> docids;
+      docids.reserve (n_docids);
+
+      guint64 did = 0;
+      for (guint64 i = 0; i < n_docids; i++)
+        {
+          guint64 delta = xapian_posting_source_unpack_uint (&pos, end);
+
+          /* The identifiers are unique, and stored in increasing order */
+          did += delta;
+          if (delta == 0 || did > G_MAXUINT32)
+            throw Xapian::SerialisationError ("Bad serialised DocidSetPostingSource");
+
+          docids.push_back (did);
+        }
+
+      if (pos != end)
+        throw Xapian::SerialisationError ("Junk at end of serialised DocidSetPostingSource");
+
+      return new DocidSetPostingSource (std::make_shared<DocidSet> (docids.data (), docids.size ()));
+    }
+
+    virtual void init (const Xapian::Database &db) {
+      Xapian::docid last_docid = db.get_lastdocid ();
+
+      mDocid = 0;
+      mLastDocid = MIN (mSet->get_max_docid (), last_docid);
+      mDocCount = db.get_doccount ();
+      mAtEnd = false;
+
+      mCheckExists = mDocCount < last_docid;
+      if (mCheckExists)
+        {
+          mAllDocs = db.postlist_begin (std::string ());
+          mAllDocsEnd = db.postlist_end (std::string ());
+        }
+
+      set_maxweight (0);
+    }
+
+    virtual Xapian::doccount get_termfreq_min () const {
+      if (!mCheckExists && mSet->get_max_docid () <= mLastDocid)
+        return mSet->size ();
+
+      return 0;
+    }
+
+    virtual Xapian::doccount get_termfreq_est () const {
+      return MIN (mSet->size (), mDocCount);
+    }
+
+    virtual Xapian::doccount get_termfreq_max () const {
+      return MIN (mSet->size (), mDocCount);
+    }
+
+    virtual void next (double min_wt) {
+      /* No document can reach a weight greater than zero */
+      if (min_wt > 0)
+        {
+          mAtEnd = true;
+          return;
+        }
+
+      move_to (mDocid + 1);
+    }
+
+    virtual void skip_to (Xapian::docid did, double min_wt) {
+      if (min_wt > 0)
+        {
+          mAtEnd = true;
+          return;
+        }
+
+      if (did > mDocid)
+        move_to (did);
+    }
+
+    virtual bool check (Xapian::docid did, double min_wt) {
+      if (did <= mDocid)
+        return true;
+
+      mDocid = did;
+
+      if (did > mLastDocid)
+        {
+          mAtEnd = true;
+          return true;
+        }
+
+      /* The caller guarantees that @did exists; if it's not in the set
+       * we are left at an indeterminate position, and the following
+       * call to next() moves past it.
+       */
+      return mSet->contains (did);
+    }
+
+    virtual bool at_end () const {
+      return mAtEnd;
+    }
+
+    virtual Xapian::docid get_docid () const {
+      return mDocid;
+    }
+
+    virtual double get_weight () const {
+      return 0;
+    }
+
+    virtual std::string get_description () const {
+      return "DocidSetPostingSource(size=" + std::to_string (mSet->size ()) + ")";
+    }
+};
+
+class QueryOptimizer {
+    const Xapian::Database *mDatabase;
+    Xapian::termcount mMaxDisjunction;
+
+    static bool is_associative (Xapian::Query::op op) {
+      switch (op)
+        {
+        case Xapian::Query::OP_AND:
+        case Xapian::Query::OP_OR:
+        case Xapian::Query::OP_XOR:
+        case Xapian::Query::OP_SYNONYM:
+        case Xapian::Query::OP_MAX:
+          return true;
+
+        default:
+          return false;
+        }
+    }
+
+    static bool is_rewritable (Xapian::Query::op op) {
+      return is_associative (op) ||
+             op == Xapian::Query::OP_AND_NOT ||
+             op == Xapian::Query::OP_AND_MAYBE ||
+             op == Xapian::Query::OP_FILTER;
+    }
+
+    bool matches_nothing (const Xapian::Query &aQuery) const {
+      Xapian::Query::op type = aQuery.get_type ();
+
+      if (type == Xapian::Query::LEAF_MATCH_NOTHING)
+        return true;
+
+      /* Terms that do not appear in the database cannot match */
+      if (type == Xapian::Query::LEAF_TERM && mDatabase != NULL)
+        return mDatabase->get_termfreq (*aQuery.get_terms_begin ()) == 0;
+
+      return false;
+    }
+
+    static bool get_key (const Xapian::Query &aQuery,
+                         std::string         &key) {
+      /* Posting sources that do not implement serialisation cannot
+       * be compared, so we just keep them around
+       */
+      try
+        {
+          key = aQuery.serialise ();
+          return true;
+        }
+      catch (const Xapian::Error &)
+        {
+          return false;
+        }
+    }
+
+  public:
+    QueryOptimizer (const Xapian::Database *aDatabase,
+                    Xapian::termcount       aMaxDisjunction)
+      : mDatabase (aDatabase), mMaxDisjunction (aMaxDisjunction)
+    {
+    }
+
+    Xapian::Query optimize (const Xapian::Query &aQuery) const {
+      Xapian::Query::op op = aQuery.get_type ();
+
+      /* We cannot rebuild operators with parameters, like OP_NEAR or
+       * OP_SCALE_WEIGHT, so we leave them untouched
+       */
+      if (!is_rewritable (op))
+        return aQuery;
+
+      bool assoc = is_associative (op);
+
+      /* Flatten nested operators; for the non-associative ones, only
+       * the left-most sub-query can be flattened
+       */
+      std::vector<Xapian::Query> subqueries;
+      for (size_t i = 0; i < aQuery.get_num_subqueries (); i++)
+        {
+          Xapian::Query sub = optimize (aQuery.get_subquery (i));
+
+          if (sub.get_type () == op && (assoc || i == 0))
+            {
+              for (size_t j = 0; j < sub.get_num_subqueries (); j++)
+                subqueries.push_back (sub.get_subquery (j));
+            }
+          else
+            subqueries.push_back (sub);
+        }
+
+      std::vector<Xapian::Query> res;
+      std::unordered_set<std::string> seen;
+
+      for (size_t i = 0; i < subqueries.size (); i++)
+        {
+          const Xapian::Query &sub = subqueries[i];
+          bool head = !assoc && i == 0;
+          bool required = head ||
+                          op == Xapian::Query::OP_AND ||
+                          op == Xapian::Query::OP_FILTER;
+
+          if (matches_nothing (sub))
+            {
+              if (required)
+                return Xapian::Query::MatchNothing;
+
+              continue;
+            }
+
+          if (head)
+            {
+              res.push_back (sub);
+              continue;
+            }
+
+          if (sub.get_type () == Xapian::Query::LEAF_MATCH_ALL &&
+              (op == Xapian::Query::OP_AND || op == Xapian::Query::OP_FILTER))
+            continue;
+
+          std::string key;
+          if (op != Xapian::Query::OP_XOR && get_key (sub, key))
+            {
+              if (!seen.insert (key).second)
+                continue;
+            }
+
+          res.push_back (sub);
+        }
+
+      if (res.empty ())
+        {
+          /* Only match-all sub-queries were dropped from OP_AND */
+          if (op == Xapian::Query::OP_AND)
+            return Xapian::Query::MatchAll;
+
+          return Xapian::Query::MatchNothing;
+        }
+
+      if (op == Xapian::Query::OP_OR &&
+          mMaxDisjunction > 0 &&
+          res.size () > mMaxDisjunction)
+        return Xapian::Query (Xapian::Query::OP_ELITE_SET,
+                              res.begin (), res.end (),
+                              mMaxDisjunction);
+
+      return Xapian::Query (op, res.begin (), res.end ());
+    }
+};
 
 #define XAPIAN_QUERY_GET_PRIVATE(obj) \
   ((XapianQueryPrivate *) xapian_query_get_instance_private ((XapianQuery *) (obj)))
@@ -176,6 +718,21 @@ xapian_query_new_from_query (const Xapian::Query &aQuery)
   return res;
 }
 
+/*< private >
+ * xapian_query_register_posting_sources:
+ * @aRegistry: a `Xapian::Registry`
+ *
+ * Registers the posting sources used internally by #XapianQuery
+ * inside @aRegistry, so that they can be unserialised.
+ */
+void
+xapian_query_register_posting_sources (Xapian::Registry &aRegistry)
+{
+  DocidSetPostingSource aPostingSource (std::make_shared<DocidSet> (nullptr, 0));
+
+  aRegistry.register_posting_source (aPostingSource);
+}
+
 /**
  * xapian_query_new:
  *
@@ -313,6 +870,67 @@ xapian_query_new_from_string (const char *data)
   return xapian_query_new_from_query (query);
 }
 
+/**
+ * xapian_query_new_from_bytes:
+ * @data: the serialised form of a query, as returned by
+ *   xapian_query_serialise_bytes()
+ * @registry: (nullable): a #XapianRegistry with the posting sources
+ *   used by the query, or %NULL to use a default registry
+ * @error: return location for a #GError, or %NULL
+ *
+ * Creates a new #XapianQuery from its serialised form.
+ *
+ * If @data is not a valid serialised query, or if it contains posting
+ * sources that are not in @registry, @error is set, and this function
+ * will return %NULL.
+ *
+ * Returns: (transfer full) (nullable): the newly created #XapianQuery
+ *   instance, or %NULL if @error is set
+ *
+ * Since: 2.0
+ */
+XapianQuery *
+xapian_query_new_from_bytes (GBytes         *data,
+                             XapianRegistry *registry,
+                             GError        **error)
+{
+  g_return_val_if_fail (data != NULL, NULL);
+  g_return_val_if_fail (registry == NULL || XAPIAN_IS_REGISTRY (registry), NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  gsize size = 0;
+  const char *bytes = static_cast<const char *> (g_bytes_get_data (data, &size));
+
+  try
+    {
+      std::string aData (bytes != NULL ? bytes : "", size);
+      Xapian::Query query;
+
+      if (registry != NULL)
+        {
+          query = Xapian::Query::unserialise (aData, *xapian_registry_get_internal (registry));
+        }
+      else
+        {
+          Xapian::Registry aRegistry;
+
+          xapian_query_register_posting_sources (aRegistry);
+          query = Xapian::Query::unserialise (aData, aRegistry);
+        }
+
+      return xapian_query_new_from_query (query);
+    }
+  catch (const Xapian::Error &err)
+    {
+      GError *internal_error = NULL;
+
+      xapian_error_to_gerror (err, &internal_error);
+      g_propagate_error (error, internal_error);
+
+      return NULL;
+    }
+}
+
 /**
  * xapian_query_new_from_posting_source:
  * @posting_source: a posting source
@@ -334,6 +952,51 @@ xapian_query_new_from_posting_source (XapianPostingSource *posting_source)
   return xapian_query_new_from_query (query);
 }
 
+/**
+ * xapian_query_new_for_docids:
+ * @docids: (array length=n_docids): the identifiers of the documents
+ * @n_docids: the number of elements in @docids
+ *
+ * Creates a new #XapianQuery matching the documents with the given
+ * identifiers, in any order.
+ *
+ * The identifiers are stored in a compressed bitmap, whose size
+ * depends on the number of identifiers and not on their values;
+ * checking whether a document is part of the set takes constant time
+ * for dense ranges of identifiers, and logarithmic time for sparse
+ * ones. This makes the query suitable to restrict the results of another query to a large
+ * set of documents, for instance the ones a user has access to, by
+ * combining the two with %XAPIAN_QUERY_OP_FILTER:
+ *
+ * |[<!-- language="C" -->
+ *   XapianQuery *allowed = xapian_query_new_for_docids (docids, n_docids);
+ *   XapianQuery *filtered =
+ *     xapian_query_new_for_pair (XAPIAN_QUERY_OP_FILTER, query, allowed);
+ * ]|
+ *
+ * The documents matched by the query have no weight.
+ *
+ * Returns: (transfer full): the newly created #XapianQuery instance
+ *
+ * Since: 2.0
+ */
+XapianQuery *
+xapian_query_new_for_docids (const guint32 *docids,
+                             gsize          n_docids)
+{
+  g_return_val_if_fail (docids != NULL || n_docids == 0, NULL);
+
+  std::shared_ptr<const DocidSet> set = std::make_shared<DocidSet> (docids, n_docids);
+
+  if (set->size () == 0)
+    return xapian_query_new_from_query (Xapian::Query::MatchNothing);
+
+  DocidSetPostingSource *aPostingSource = new DocidSetPostingSource (set);
+  Xapian::Query query = Xapian::Query (aPostingSource->release ());
+
+  return xapian_query_new_from_query (query);
+}
+
 /**
  * xapian_query_new_for_terms:
  * @op: a #XapianQueryOp value to combine the terms with
@@ -391,6 +1054,130 @@ xapian_query_new_for_queries (XapianQueryOp op,
   return xapian_query_new_from_query (query);
 }
 
+/**
+ * xapian_query_new_for_terms_full:
+ * @op: a #XapianQueryOp value to combine the terms with
+ * @terms: (array length=n_terms): an array of term strings
+ * @wqfs: (array length=n_terms) (nullable): the within-query frequency
+ *   of each term, or %NULL to use 1 for every term
+ * @positions: (array length=n_terms) (nullable): the position of each
+ *   term in the query, or %NULL to leave the positions unset
+ * @n_terms: the number of elements in @terms
+ *
+ * Construct a #XapianQuery object from an array of terms, with an
+ * optional within-query frequency and position for each term.
+ *
+ * Unlike xapian_query_new_for_queries(), this function does not need
+ * a #XapianQuery instance for each term, which makes it suitable for
+ * building queries with a large number of terms.
+ *
+ * Returns: (transfer full): the newly created #XapianQuery instance
+ *
+ * Since: 2.0
+ */
+XapianQuery *
+xapian_query_new_for_terms_full (XapianQueryOp        op,
+                                 const char * const  *terms,
+                                 const unsigned int  *wqfs,
+                                 const unsigned int  *positions,
+                                 gsize                n_terms)
+{
+  g_return_val_if_fail (terms != NULL || n_terms == 0, NULL);
+
+  std::vector<Xapian::Query> qlist;
+  qlist.reserve (n_terms);
+
+  for (gsize i = 0; i < n_terms; i++)
+    {
+      g_return_val_if_fail (terms[i] != NULL, NULL);
+
+      Xapian::termcount wqf = wqfs != NULL ? wqfs[i] : 1;
+      Xapian::termpos pos = positions != NULL ? positions[i] : 0;
+
+      qlist.emplace_back (std::string (terms[i]), wqf, pos);
+    }
+
+  Xapian::Query::op query_op = xapian_query_op_internal (op);
+  Xapian::Query query (query_op, qlist.begin (), qlist.end ());
+
+  return xapian_query_new_from_query (query);
+}
+
+/**
+ * xapian_query_new_for_query_array:
+ * @op: a #XapianQueryOp to combine the queries with
+ * @queries: (element-type XapianQuery): an array of #XapianQuery sub-queries
+ *
+ * Construct a #XapianQuery object from an array of other #XapianQuery
+ * objects.
+ *
+ * This function is equivalent to xapian_query_new_for_queries(), but
+ * it avoids building a #GSList out of an existing array.
+ *
+ * Returns: (transfer full): the newly created #XapianQuery instance
+ *
+ * Since: 2.0
+ */
+XapianQuery *
+xapian_query_new_for_query_array (XapianQueryOp  op,
+                                  GPtrArray     *queries)
+{
+  g_return_val_if_fail (queries != NULL, NULL);
+
+  std::vector<Xapian::Query *> qlist;
+  qlist.reserve (queries->len);
+
+  for (guint i = 0; i < queries->len; i++)
+    {
+      gpointer query = g_ptr_array_index (queries, i);
+
+      g_return_val_if_fail (XAPIAN_IS_QUERY (query), NULL);
+      qlist.push_back (xapian_query_get_internal (XAPIAN_QUERY (query)));
+    }
+
+  Xapian::Query::op query_op = xapian_query_op_internal (op);
+  Xapian::Query query (query_op, qlist.begin (), qlist.end ());
+
+  return xapian_query_new_from_query (query);
+}
+
+/**
+ * xapian_query_new_for_prefixed_terms:
+ * @op: a #XapianQueryOp value to combine the terms with, typically
+ *   %XAPIAN_QUERY_OP_OR or %XAPIAN_QUERY_OP_SYNONYM
+ * @prefix: (nullable): the prefix to prepend to each term
+ * @terms: (array zero-terminated=1): an array of term strings
+ *
+ * Construct a #XapianQuery object from a list of terms, prepending
+ * @prefix to each one of them.
+ *
+ * This function is meant to be used when expanding a single field
+ * into a large number of terms, for instance a list of synonyms or
+ * of tags.
+ *
+ * Returns: (transfer full): the newly created #XapianQuery instance
+ *
+ * Since: 2.0
+ */
+XapianQuery *
+xapian_query_new_for_prefixed_terms (XapianQueryOp        op,
+                                     const char          *prefix,
+                                     const char * const  *terms)
+{
+  g_return_val_if_fail (terms != NULL, NULL);
+
+  std::string aPrefix (prefix != NULL ? prefix : "");
+  std::vector<std::string> tlist;
+
+  for (const char * const *iter = terms; *iter != NULL; iter++)
+    tlist.push_back (aPrefix + *iter);
+
+  Xapian::Query::op query_op = xapian_query_op_internal (op);
+  Xapian::Query query (query_op, tlist.begin (), tlist.end ());
+
+  return xapian_query_new_from_query (query);
+}
+
 /**
  * xapian_query_new_wildcard:
  * @pattern: the wildcard pattern — currently this is just a string and the
@@ -414,6 +1201,70 @@ xapian_query_new_wildcard (const char *pattern)
   return xapian_query_new_from_query (query);
 }
 
+/*< private >
+ * xapian_wildcard_limit_internal:
+ * @limit: a #XapianWildcardLimit
+ *
+ * Converts a #XapianWildcardLimit into the corresponding
+ * `Xapian::Query` wildcard limit.
+ *
+ * Returns: the wildcard limit
+ */
+int
+xapian_wildcard_limit_internal (XapianWildcardLimit limit)
+{
+  switch (limit)
+    {
+    case XAPIAN_WILDCARD_LIMIT_ERROR:
+      return Xapian::Query::WILDCARD_LIMIT_ERROR;
+
+    case XAPIAN_WILDCARD_LIMIT_FIRST:
+      return Xapian::Query::WILDCARD_LIMIT_FIRST;
+
+    case XAPIAN_WILDCARD_LIMIT_MOST_FREQUENT:
+      return Xapian::Query::WILDCARD_LIMIT_MOST_FREQUENT;
+
+    default:
+      g_assert_not_reached ();
+    }
+
+  return Xapian::Query::WILDCARD_LIMIT_ERROR;
+}
+
+/**
+ * xapian_query_new_wildcard_full:
+ * @pattern: the wildcard pattern; the wildcard expands to terms which
+ *   start with exactly this string
+ * @max_expansion: the maximum number of terms to expand to, or 0 for
+ *   no limit
+ * @limit: how to handle an expansion exceeding @max_expansion
+ *
+ * Construct a #XapianQuery object for a #XAPIAN_QUERY_OP_WILDCARD query,
+ * like xapian_query_new_wildcard(), but with a limit on the number of
+ * terms the wildcard expands to.
+ *
+ * If @limit is %XAPIAN_WILDCARD_LIMIT_ERROR, running the query will
+ * fail with %XAPIAN_ERROR_WILDCARD if @pattern expands to more than
+ * @max_expansion terms.
+ *
+ * Returns: (transfer full): the newly created #XapianQuery instance
+ *
+ * Since: 2.0
+ */
+XapianQuery *
+xapian_query_new_wildcard_full (const char          *pattern,
+                                unsigned int         max_expansion,
+                                XapianWildcardLimit  limit)
+{
+  g_return_val_if_fail (pattern != NULL, NULL);
+
+  Xapian::Query query (Xapian::Query::OP_WILDCARD, pattern,
+                       max_expansion,
+                       xapian_wildcard_limit_internal (limit));
+
+  return xapian_query_new_from_query (query);
+}
+
 /**
  * xapian_query_new_match_all:
  *
@@ -430,6 +1281,71 @@ xapian_query_new_match_all (void)
   return xapian_query_new_from_query (Xapian::Query::MatchAll);
 }
 
+/**
+ * xapian_query_optimize:
+ * @query: a #XapianQuery
+ * @db: (nullable): a #XapianDatabase used to look up term frequencies
+ * @max_disjunction: the maximum number of sub-queries of a
+ *   %XAPIAN_QUERY_OP_OR query, or 0 for no limit
+ * @error: return location for a #GError, or %NULL
+ *
+ * Creates a new #XapianQuery equivalent to @query, but cheaper to
+ * evaluate.
+ *
+ * Nested operators of the same kind are flattened, duplicate
+ * sub-queries are removed, and match-all sub-queries of
+ * %XAPIAN_QUERY_OP_AND and %XAPIAN_QUERY_OP_FILTER queries are
+ * dropped.
+ *
+ * If @db is not %NULL, terms that do not appear in @db are removed
+ * from disjunctions, and conjunctions containing them are replaced
+ * by a query that matches nothing.
+ *
+ * If @max_disjunction is not 0, %XAPIAN_QUERY_OP_OR queries with more
+ * than @max_disjunction sub-queries are rewritten as
+ * %XAPIAN_QUERY_OP_ELITE_SET queries, which only use the
+ * @max_disjunction most informative sub-queries, according to the
+ * statistics of the database being searched.
+ *
+ * The set of matching documents is unchanged, except for the effect
+ * of @max_disjunction; the weights of the documents may differ, as
+ * duplicate sub-queries do not contribute to the weight any more.
+ *
+ * Returns: (transfer full) (nullable): the newly created #XapianQuery
+ *   instance, or %NULL if @error is set
+ *
+ * Since: 2.0
+ */
+XapianQuery *
+xapian_query_optimize (XapianQuery    *query,
+                       XapianDatabase *db,
+                       unsigned int    max_disjunction,
+                       GError        **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_QUERY (query), NULL);
+  g_return_val_if_fail (db == NULL || XAPIAN_IS_DATABASE (db), NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  const Xapian::Database *aDatabase = db != NULL ? xapian_database_get_internal (db) : NULL;
+
+  try
+    {
+      QueryOptimizer optimizer (aDatabase, max_disjunction);
+      Xapian::Query res = optimizer.optimize (*xapian_query_get_internal (query));
+
+      return xapian_query_new_from_query (res);
+    }
+  catch (const Xapian::Error &err)
+    {
+      GError *internal_error = NULL;
+
+      xapian_error_to_gerror (err, &internal_error);
+      g_propagate_error (error, internal_error);
+
+      return NULL;
+    }
+}
+
 /**
  * xapian_query_is_empty:
  * @query: a #XapianQuery
@@ -487,6 +1403,10 @@ xapian_query_get_length (XapianQuery *query)
  * Serialises @query into a normal form that can be used
  * with xapian_query_new_from_string().
  *
+ * The serialised form of a query can contain embedded nul characters,
+ * which are not preserved by this function; use
+ * xapian_query_serialise_bytes() instead.
+ *
  * Returns: (transfer full): the query in normal form
  */
 char *
@@ -498,3 +1418,47 @@ xapian_query_serialise (XapianQuery *query)
 
   return g_strdup (data.c_str ());
 }
+
+/**
+ * xapian_query_serialise_bytes:
+ * @query: a #XapianQuery
+ * @error: return location for a #GError, or %NULL
+ *
+ * Serialises @query into a binary form that can be used with
+ * xapian_query_new_from_bytes(), for instance to store the query
+ * in a cache shared by different processes.
+ *
+ * Unlike xapian_query_serialise(), the returned data can contain
+ * embedded nul characters.
+ *
+ * If @query contains a posting source that cannot be serialised,
+ * @error is set, and this function will return %NULL.
+ *
+ * Returns: (transfer full) (nullable): the serialised query, or %NULL
+ *   if @error is set
+ *
+ * Since: 2.0
+ */
+GBytes *
+xapian_query_serialise_bytes (XapianQuery  *query,
+                              GError      **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_QUERY (query), NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  try
+    {
+      std::string data = xapian_query_get_internal (query)->serialise ();
+
+      return g_bytes_new (data.data (), data.size ());
+    }
+  catch (const Xapian::Error &err)
+    {
+      GError *internal_error = NULL;
+
+      xapian_error_to_gerror (err, &internal_error);
+      g_propagate_error (error, internal_error);
+
+      return NULL;
+    }
+}
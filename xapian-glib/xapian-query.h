@@ -22,7 +22,9 @@
 #endif
 
 #include "xapian-glib-types.h"
+#include "xapian-database.h"
 #include "xapian-posting-source.h"
+#include "xapian-registry.h"
 
 G_BEGIN_DECLS
 
@@ -55,7 +57,14 @@ XapianQuery *   xapian_query_new_for_terms_pair (XapianQueryOp  op,
 XAPIAN_GLIB_AVAILABLE_IN_2_0
 XapianQuery *   xapian_query_new_from_string    (const char    *data);
 XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianQuery *   xapian_query_new_from_bytes     (GBytes         *data,
+                                                 XapianRegistry *registry,
+                                                 GError        **error);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
 XapianQuery *   xapian_query_new_from_posting_source (XapianPostingSource *posting_source);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianQuery *   xapian_query_new_for_docids     (const guint32 *docids,
+                                                 gsize          n_docids);
 
 XAPIAN_GLIB_AVAILABLE_IN_2_0
 XapianQuery *   xapian_query_new_for_terms      (XapianQueryOp  op,
@@ -63,13 +72,36 @@ XapianQuery *   xapian_query_new_for_terms      (XapianQueryOp  op,
 XAPIAN_GLIB_AVAILABLE_IN_2_0
 XapianQuery *   xapian_query_new_for_queries    (XapianQueryOp  op,
                                                  GSList        *queries);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianQuery *   xapian_query_new_for_terms_full (XapianQueryOp        op,
+                                                 const char * const  *terms,
+                                                 const unsigned int  *wqfs,
+                                                 const unsigned int  *positions,
+                                                 gsize                n_terms);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianQuery *   xapian_query_new_for_query_array (XapianQueryOp  op,
+                                                  GPtrArray     *queries);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianQuery *   xapian_query_new_for_prefixed_terms (XapianQueryOp        op,
+                                                     const char          *prefix,
+                                                     const char * const  *terms);
 
 XAPIAN_GLIB_AVAILABLE_IN_2_0
 XapianQuery *   xapian_query_new_wildcard       (const char    *pattern);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianQuery *   xapian_query_new_wildcard_full  (const char          *pattern,
+                                                 unsigned int         max_expansion,
+                                                 XapianWildcardLimit  limit);
 
 XAPIAN_GLIB_AVAILABLE_IN_2_0
 XapianQuery *   xapian_query_new_match_all      (void);
 
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianQuery *   xapian_query_optimize           (XapianQuery    *query,
+                                                 XapianDatabase *db,
+                                                 unsigned int    max_disjunction,
+                                                 GError        **error);
+
 XAPIAN_GLIB_AVAILABLE_IN_2_0
 gboolean        xapian_query_is_empty           (XapianQuery   *query);
 
@@ -80,6 +112,9 @@ XAPIAN_GLIB_AVAILABLE_IN_2_0
 char *          xapian_query_get_description    (XapianQuery   *query);
 XAPIAN_GLIB_AVAILABLE_IN_2_0
 char *          xapian_query_serialise          (XapianQuery   *query);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+GBytes *        xapian_query_serialise_bytes    (XapianQuery   *query,
+                                                 GError       **error);
 
 G_END_DECLS
 
@@ -0,0 +1,374 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-range-processor
+ * @Title: XapianRangeProcessor
+ * @short_description: Parse ranges of values
+ *
+ * #XapianRangeProcessor is used by #XapianQueryParser to turn a range
+ * in a query string, like `a..b`, into a %XAPIAN_QUERY_OP_VALUE_RANGE
+ * query on a value slot; the matcher then checks the range against the
+ * values of each document, without retrieving them.
+ *
+ * A range is handled by a #XapianRangeProcessor if it starts with the
+ * #XapianRangeProcessor:marker, or ends with it if the
+ * %XAPIAN_RANGE_PROCESSOR_FLAGS_SUFFIX flag is set. An empty marker
+ * matches every range, so the processor should be added last.
+ *
+ * #XapianRangeProcessor compares the values as strings; use
+ * #XapianNumberRangeProcessor for values stored as numbers with
+ * xapian_document_add_numeric_value(), and #XapianDateRangeProcessor
+ * for dates stored as strings in the `YYYYMMDD` format.
+ *
+ * |[<!-- language="C" -->
+ *   XapianRangeProcessor *processor =
+ *     XAPIAN_RANGE_PROCESSOR (xapian_number_range_processor_new (PRICE_SLOT,
+ *                                                                "price:",
+ *                                                                XAPIAN_RANGE_PROCESSOR_FLAGS_NONE));
+ *
+ *   xapian_query_parser_add_range_processor (parser, processor, NULL);
+ *
+ *   // "price:10..50" now matches the documents with a price between 10 and 50
+ * ]|
+ */
+
+#include "config.h"
+
+#include <xapian.h>
+
+#include "xapian-range-processor-private.h"
+
+#include "xapian-enums.h"
+
+#define XAPIAN_RANGE_PROCESSOR_GET_PRIVATE(obj) \
+  ((XapianRangeProcessorPrivate *) xapian_range_processor_get_instance_private ((XapianRangeProcessor *) (obj)))
+
+typedef struct {
+  Xapian::RangeProcessor *mRangeProcessor;
+
+  unsigned int slot;
+  char *marker;
+  XapianRangeProcessorFlags flags;
+} XapianRangeProcessorPrivate;
+
+enum {
+  PROP_0,
+
+  PROP_SLOT,
+  PROP_MARKER,
+  PROP_FLAGS,
+
+  LAST_PROP
+};
+
+static GParamSpec *obj_props[LAST_PROP] = { NULL, };
+
+G_DEFINE_TYPE_WITH_PRIVATE (XapianRangeProcessor, xapian_range_processor, G_TYPE_OBJECT)
+
+/*< private >
+ * xapian_range_processor_flags_internal:
+ * @flags: a bitwise OR of #XapianRangeProcessorFlags values
+ *
+ * Converts @flags into the corresponding `Xapian::RP_*` flags.
+ *
+ * Returns: the flags
+ */
+unsigned
+xapian_range_processor_flags_internal (XapianRangeProcessorFlags flags)
+{
+  unsigned res = 0;
+
+  if ((flags & XAPIAN_RANGE_PROCESSOR_FLAGS_SUFFIX) != 0)
+    res |= Xapian::RP_SUFFIX;
+  if ((flags & XAPIAN_RANGE_PROCESSOR_FLAGS_REPEATED) != 0)
+    res |= Xapian::RP_REPEATED;
+  if ((flags & XAPIAN_RANGE_PROCESSOR_FLAGS_DATE_PREFER_MDY) != 0)
+    res |= Xapian::RP_DATE_PREFER_MDY;
+
+  return res;
+}
+
+static void
+xapian_range_processor_constructed (GObject *gobject)
+{
+  XapianRangeProcessorPrivate *priv = XAPIAN_RANGE_PROCESSOR_GET_PRIVATE (gobject);
+
+  /* Sub-classes set their own instance before chaining up */
+  if (priv->mRangeProcessor == NULL)
+    priv->mRangeProcessor =
+      new Xapian::RangeProcessor (priv->slot,
+                                  priv->marker != NULL ? priv->marker : "",
+                                  xapian_range_processor_flags_internal (priv->flags));
+
+  G_OBJECT_CLASS (xapian_range_processor_parent_class)->constructed (gobject);
+}
+
+static void
+xapian_range_processor_finalize (GObject *gobject)
+{
+  XapianRangeProcessorPrivate *priv = XAPIAN_RANGE_PROCESSOR_GET_PRIVATE (gobject);
+
+  delete priv->mRangeProcessor;
+  g_free (priv->marker);
+
+  G_OBJECT_CLASS (xapian_range_processor_parent_class)->finalize (gobject);
+}
+
+static void
+xapian_range_processor_set_property (GObject      *gobject,
+                                     guint         prop_id,
+                                     const GValue *value,
+                                     GParamSpec   *pspec)
+{
+  XapianRangeProcessorPrivate *priv = XAPIAN_RANGE_PROCESSOR_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_SLOT:
+      priv->slot = g_value_get_uint (value);
+      break;
+
+    case PROP_MARKER:
+      g_free (priv->marker);
+      priv->marker = g_value_dup_string (value);
+      break;
+
+    case PROP_FLAGS:
+      priv->flags = (XapianRangeProcessorFlags) g_value_get_flags (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_range_processor_get_property (GObject    *gobject,
+                                     guint       prop_id,
+                                     GValue     *value,
+                                     GParamSpec *pspec)
+{
+  XapianRangeProcessorPrivate *priv = XAPIAN_RANGE_PROCESSOR_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_SLOT:
+      g_value_set_uint (value, priv->slot);
+      break;
+
+    case PROP_MARKER:
+      g_value_set_string (value, priv->marker);
+      break;
+
+    case PROP_FLAGS:
+      g_value_set_flags (value, priv->flags);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_range_processor_class_init (XapianRangeProcessorClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  /**
+   * XapianRangeProcessor:slot:
+   *
+   * The value slot used by the %XAPIAN_QUERY_OP_VALUE_RANGE queries.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_SLOT] =
+    g_param_spec_uint ("slot",
+                       "Slot",
+                       "The value slot of the ranges",
+                       0, G_MAXUINT32, 0,
+                       (GParamFlags) (G_PARAM_READWRITE |
+                                      G_PARAM_CONSTRUCT_ONLY |
+                                      G_PARAM_STATIC_STRINGS));
+
+  /**
+   * XapianRangeProcessor:marker:
+   *
+   * The prefix, or suffix, identifying the ranges handled by the
+   * processor, like `price:` or `kg`.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_MARKER] =
+    g_param_spec_string ("marker",
+                         "Marker",
+                         "The prefix or suffix of the ranges",
+                         NULL,
+                         (GParamFlags) (G_PARAM_READWRITE |
+                                        G_PARAM_CONSTRUCT_ONLY |
+                                        G_PARAM_STATIC_STRINGS));
+
+  /**
+   * XapianRangeProcessor:flags:
+   *
+   * The flags controlling how the #XapianRangeProcessor:marker is
+   * matched and how the ranges are parsed.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_FLAGS] =
+    g_param_spec_flags ("flags",
+                        "Flags",
+                        "The flags of the range processor",
+                        XAPIAN_TYPE_RANGE_PROCESSOR_FLAGS,
+                        XAPIAN_RANGE_PROCESSOR_FLAGS_NONE,
+                        (GParamFlags) (G_PARAM_READWRITE |
+                                       G_PARAM_CONSTRUCT_ONLY |
+                                       G_PARAM_STATIC_STRINGS));
+
+  gobject_class->constructed = xapian_range_processor_constructed;
+  gobject_class->set_property = xapian_range_processor_set_property;
+  gobject_class->get_property = xapian_range_processor_get_property;
+  gobject_class->finalize = xapian_range_processor_finalize;
+
+  g_object_class_install_properties (gobject_class, LAST_PROP, obj_props);
+}
+
+static void
+xapian_range_processor_init (XapianRangeProcessor *self)
+{
+}
+
+/*< private >
+ * xapian_range_processor_get_internal:
+ * @self: a #XapianRangeProcessor
+ *
+ * Retrieves the `Xapian::RangeProcessor` used by @self.
+ *
+ * Returns: (transfer none): a pointer to the internal instance
+ */
+Xapian::RangeProcessor *
+xapian_range_processor_get_internal (XapianRangeProcessor *self)
+{
+  XapianRangeProcessorPrivate *priv = XAPIAN_RANGE_PROCESSOR_GET_PRIVATE (self);
+
+  return priv->mRangeProcessor;
+}
+
+/*< private >
+ * xapian_range_processor_set_internal:
+ * @self: a #XapianRangeProcessor
+ * @aRangeProcessor: a `Xapian::RangeProcessor` instance
+ *
+ * Sets the internal range processor instance wrapped by @self, clearing
+ * any existing instance if needed.
+ */
+void
+xapian_range_processor_set_internal (XapianRangeProcessor   *self,
+                                     Xapian::RangeProcessor *aRangeProcessor)
+{
+  XapianRangeProcessorPrivate *priv = XAPIAN_RANGE_PROCESSOR_GET_PRIVATE (self);
+
+  delete priv->mRangeProcessor;
+
+  priv->mRangeProcessor = aRangeProcessor;
+}
+
+/**
+ * xapian_range_processor_new:
+ * @slot: the value slot of the ranges
+ * @marker: (nullable): the prefix, or suffix, of the ranges
+ * @flags: a bitwise OR of #XapianRangeProcessorFlags values
+ *
+ * Creates a new #XapianRangeProcessor, comparing the ends of the
+ * ranges with the values in @slot as strings.
+ *
+ * Returns: (transfer full): the newly created #XapianRangeProcessor instance
+ *
+ * Since: 2.0
+ */
+XapianRangeProcessor *
+xapian_range_processor_new (unsigned int               slot,
+                            const char                *marker,
+                            XapianRangeProcessorFlags  flags)
+{
+  return static_cast<XapianRangeProcessor *> (g_object_new (XAPIAN_TYPE_RANGE_PROCESSOR,
+                                                            "slot", slot,
+                                                            "marker", marker,
+                                                            "flags", flags,
+                                                            NULL));
+}
+
+/**
+ * xapian_range_processor_get_slot:
+ * @self: a #XapianRangeProcessor
+ *
+ * Retrieves the value of the #XapianRangeProcessor:slot property.
+ *
+ * Returns: the value slot of the ranges
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_range_processor_get_slot (XapianRangeProcessor *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_RANGE_PROCESSOR (self), 0);
+
+  XapianRangeProcessorPrivate *priv = XAPIAN_RANGE_PROCESSOR_GET_PRIVATE (self);
+
+  return priv->slot;
+}
+
+/**
+ * xapian_range_processor_get_marker:
+ * @self: a #XapianRangeProcessor
+ *
+ * Retrieves the value of the #XapianRangeProcessor:marker property.
+ *
+ * Returns: (transfer none) (nullable): the prefix, or suffix, of the ranges
+ *
+ * Since: 2.0
+ */
+const char *
+xapian_range_processor_get_marker (XapianRangeProcessor *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_RANGE_PROCESSOR (self), NULL);
+
+  XapianRangeProcessorPrivate *priv = XAPIAN_RANGE_PROCESSOR_GET_PRIVATE (self);
+
+  return priv->marker;
+}
+
+/**
+ * xapian_range_processor_get_flags:
+ * @self: a #XapianRangeProcessor
+ *
+ * Retrieves the value of the #XapianRangeProcessor:flags property.
+ *
+ * Returns: the flags of the range processor
+ *
+ * Since: 2.0
+ */
+XapianRangeProcessorFlags
+xapian_range_processor_get_flags (XapianRangeProcessor *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_RANGE_PROCESSOR (self), XAPIAN_RANGE_PROCESSOR_FLAGS_NONE);
+
+  XapianRangeProcessorPrivate *priv = XAPIAN_RANGE_PROCESSOR_GET_PRIVATE (self);
+
+  return priv->flags;
+}
@@ -0,0 +1,541 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-recency-posting-source
+ * @Title: XapianRecencyPostingSource
+ * @short_description: Posting source favouring recent documents
+ *
+ * #XapianRecencyPostingSource is a posting source which assigns a
+ * weight to each document according to its age, computed from a
+ * timestamp stored in a value slot.
+ *
+ * The timestamps are the number of seconds since the Unix epoch,
+ * stored using xapian_document_add_numeric_value(). The weight of a
+ * document is #XapianRecencyPostingSource:scale when its timestamp is
+ * not older than #XapianRecencyPostingSource:now, and then decreases
+ * with the age of the document, according to the
+ * #XapianRecencyPostingSource:decay-function and the
+ * #XapianRecencyPostingSource:half-life.
+ *
+ * The maximum weight reported to the matcher is computed from the
+ * most recent timestamp in the database, so combining the posting
+ * source with the relevance of a query, using %XAPIAN_QUERY_OP_AND_MAYBE,
+ * still allows the matcher to skip the documents that cannot make it
+ * into the results:
+ *
+ * |[<!-- language="C" -->
+ *   XapianRecencyPostingSource *source =
+ *     xapian_recency_posting_source_new (DATE_SLOT,
+ *                                        XAPIAN_DECAY_FUNCTION_EXPONENTIAL,
+ *                                        0,
+ *                                        7 * 24 * 60 * 60,
+ *                                        1.0,
+ *                                        &error);
+ *
+ *   XapianQuery *recency =
+ *     xapian_query_new_from_posting_source (XAPIAN_POSTING_SOURCE (source));
+ *   XapianQuery *boosted =
+ *     xapian_query_new_for_pair (XAPIAN_QUERY_OP_AND_MAYBE, query, recency);
+ * ]|
+ */
+
+#include "config.h"
+
+#include <math.h>
+
+#include <string>
+
+#include <xapian.h>
+
+#include "xapian-posting-source-private.h"
+#include "xapian-recency-posting-source.h"
+#include "xapian-error-private.h"
+
+#define DEFAULT_HALF_LIFE       (24.0 * 60.0 * 60.0)
+
+class RecencyPostingSource : public Xapian::ValuePostingSource {
+    XapianDecayFunction mDecayFunction;
+    double mNow;
+    double mHalfLife;
+    double mScale;
+
+    double weight_for_value (const std::string &value) const {
+      double age = mNow - Xapian::sortable_unserialise (value);
+
+      if (!(age > 0))
+        return mScale;
+
+      switch (mDecayFunction)
+        {
+        case XAPIAN_DECAY_FUNCTION_LINEAR:
+          return mScale * MAX (0.0, 1.0 - age / (2.0 * mHalfLife));
+
+        case XAPIAN_DECAY_FUNCTION_EXPONENTIAL:
+        default:
+          return mScale * exp2 (-age / mHalfLife);
+        }
+    }
+
+    /* The weight only depends on the timestamp, so documents older
+     * than the ones the matcher is interested in can be skipped
+     * without returning them.
+     */
+    void skip_low_weights (double min_wt) {
+      while (!Xapian::ValuePostingSource::at_end () && get_weight () < min_wt)
+        Xapian::ValuePostingSource::next (min_wt);
+    }
+
+  public:
+    RecencyPostingSource (Xapian::valueno      slot,
+                          XapianDecayFunction  decay_function,
+                          double               now,
+                          double               half_life,
+                          double               scale)
+      : Xapian::ValuePostingSource (slot),
+        mDecayFunction (decay_function),
+        mNow (now),
+        mHalfLife (half_life),
+        mScale (scale)
+    {
+      set_maxweight (mScale);
+    }
+
+    virtual RecencyPostingSource *clone () const {
+      return new RecencyPostingSource (get_slot (), mDecayFunction, mNow, mHalfLife, mScale);
+    }
+
+    virtual std::string name () const {
+      return "XapianGlib::RecencyPostingSource";
+    }
+
+    virtual std::string serialise () const {
+      std::string res;
+
+      xapian_posting_source_pack_uint (res, get_slot ());
+      xapian_posting_source_pack_uint (res, mDecayFunction);
+      xapian_posting_source_pack_double (res, mNow);
+      xapian_posting_source_pack_double (res, mHalfLife);
+      xapian_posting_source_pack_double (res, mScale);
+
+      return res;
+    }
+
+    virtual RecencyPostingSource *unserialise (const std::string &data) const {
+      const char *pos = data.data ();
+      const char *end = pos + data.size ();
+
+      guint64 slot = xapian_posting_source_unpack_uint (&pos, end);
+      guint64 decay_function = xapian_posting_source_unpack_uint (&pos, end);
+      double now = xapian_posting_source_unpack_double (&pos, end);
+      double half_life = xapian_posting_source_unpack_double (&pos, end);
+      double scale = xapian_posting_source_unpack_double (&pos, end);
+
+      if (pos != end)
+        throw Xapian::SerialisationError ("Junk at end of serialised RecencyPostingSource");
+
+      if (slot > G_MAXUINT32 ||
+          decay_function > XAPIAN_DECAY_FUNCTION_LINEAR ||
+          !(half_life > 0) ||
+          !(scale >= 0))
+        throw Xapian::SerialisationError ("Bad serialised RecencyPostingSource");
+
+      return new RecencyPostingSource (slot,
+                                       static_cast<XapianDecayFunction> (decay_function),
+                                       now, half_life, scale);
+    }
+
+    virtual void init (const Xapian::Database &db) {
+      Xapian::ValuePostingSource::init (db);
+
+      /* The most recent document has the highest weight; values are
+       * serialised in sortable form, so their upper bound is also the
+       * upper bound of the timestamps.
+       */
+      std::string upper_bound = db.get_value_upper_bound (get_slot ());
+
+      if (upper_bound.empty ())
+        set_maxweight (0.0);
+      else
+        set_maxweight (weight_for_value (upper_bound));
+    }
+
+    virtual void next (double min_wt) {
+      Xapian::ValuePostingSource::next (min_wt);
+      skip_low_weights (min_wt);
+    }
+
+    virtual void skip_to (Xapian::docid did, double min_wt) {
+      Xapian::ValuePostingSource::skip_to (did, min_wt);
+      skip_low_weights (min_wt);
+    }
+
+    virtual double get_weight () const {
+      return weight_for_value (get_value ());
+    }
+
+    virtual std::string get_description () const {
+      return "RecencyPostingSource(slot=" + std::to_string (get_slot ()) + ")";
+    }
+};
+
+#define XAPIAN_RECENCY_POSTING_SOURCE_GET_PRIVATE(obj) \
+  ((XapianRecencyPostingSourcePrivate *) xapian_recency_posting_source_get_instance_private ((XapianRecencyPostingSource *) (obj)))
+
+typedef struct {
+  XapianDecayFunction decay_function;
+  double now;
+  double half_life;
+  double scale;
+} XapianRecencyPostingSourcePrivate;
+
+enum
+{
+  PROP_0,
+
+  PROP_DECAY_FUNCTION,
+  PROP_NOW,
+  PROP_HALF_LIFE,
+  PROP_SCALE,
+
+  LAST_PROP
+};
+
+static GParamSpec *obj_props[LAST_PROP] = { NULL, };
+
+static void initable_iface_init (GInitableIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (XapianRecencyPostingSource, xapian_recency_posting_source,
+                         XAPIAN_TYPE_VALUE_POSTING_SOURCE,
+                         G_ADD_PRIVATE (XapianRecencyPostingSource)
+                         G_IMPLEMENT_INTERFACE (G_TYPE_INITABLE, initable_iface_init))
+
+static gboolean
+xapian_recency_posting_source_init_internal (GInitable    *self,
+                                             GCancellable *cancellable,
+                                             GError      **error)
+{
+  XapianPostingSource *pSource = XAPIAN_POSTING_SOURCE (self);
+  XapianRecencyPostingSourcePrivate *priv = XAPIAN_RECENCY_POSTING_SOURCE_GET_PRIVATE (self);
+  RecencyPostingSource *mRecencyPostingSource;
+
+  /* A timestamp of 0 means "the time the posting source is created" */
+  if (priv->now == 0)
+    priv->now = g_get_real_time () / (double) G_USEC_PER_SEC;
+
+  try
+    {
+      guint slot = xapian_value_posting_source_get_slot (XAPIAN_VALUE_POSTING_SOURCE (self));
+      mRecencyPostingSource = new RecencyPostingSource (slot,
+                                                        priv->decay_function,
+                                                        priv->now,
+                                                        priv->half_life,
+                                                        priv->scale);
+      xapian_posting_source_set_internal (pSource, (Xapian::PostingSource *) mRecencyPostingSource);
+
+      return TRUE;
+    }
+  catch (const Xapian::Error &err)
+    {
+      GError *internal_error = NULL;
+
+      xapian_error_to_gerror (err, &internal_error);
+      g_propagate_error (error, internal_error);
+
+      return FALSE;
+    }
+}
+
+static void
+initable_iface_init (GInitableIface *iface)
+{
+  iface->init = xapian_recency_posting_source_init_internal;
+}
+
+static void
+xapian_recency_posting_source_set_property (GObject      *gobject,
+                                            guint         prop_id,
+                                            const GValue *value,
+                                            GParamSpec   *pspec)
+{
+  XapianRecencyPostingSourcePrivate *priv = XAPIAN_RECENCY_POSTING_SOURCE_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_DECAY_FUNCTION:
+      priv->decay_function = (XapianDecayFunction) g_value_get_enum (value);
+      break;
+
+    case PROP_NOW:
+      priv->now = g_value_get_double (value);
+      break;
+
+    case PROP_HALF_LIFE:
+      priv->half_life = g_value_get_double (value);
+      break;
+
+    case PROP_SCALE:
+      priv->scale = g_value_get_double (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_recency_posting_source_get_property (GObject    *gobject,
+                                            guint       prop_id,
+                                            GValue     *value,
+                                            GParamSpec *pspec)
+{
+  XapianRecencyPostingSourcePrivate *priv = XAPIAN_RECENCY_POSTING_SOURCE_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_DECAY_FUNCTION:
+      g_value_set_enum (value, priv->decay_function);
+      break;
+
+    case PROP_NOW:
+      g_value_set_double (value, priv->now);
+      break;
+
+    case PROP_HALF_LIFE:
+      g_value_set_double (value, priv->half_life);
+      break;
+
+    case PROP_SCALE:
+      g_value_set_double (value, priv->scale);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_recency_posting_source_class_init (XapianRecencyPostingSourceClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->set_property = xapian_recency_posting_source_set_property;
+  gobject_class->get_property = xapian_recency_posting_source_get_property;
+
+  /**
+   * XapianRecencyPostingSource:decay-function:
+   *
+   * The function used to compute the weight of a document from its age.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_DECAY_FUNCTION] =
+    g_param_spec_enum ("decay-function",
+                       "Decay Function",
+                       "The function used to compute the weights",
+                       XAPIAN_TYPE_DECAY_FUNCTION,
+                       XAPIAN_DECAY_FUNCTION_EXPONENTIAL,
+                       (GParamFlags) (G_PARAM_READWRITE |
+                                      G_PARAM_CONSTRUCT_ONLY |
+                                      G_PARAM_STATIC_STRINGS));
+
+  /**
+   * XapianRecencyPostingSource:now:
+   *
+   * The reference time used to compute the age of the documents, in
+   * seconds since the Unix epoch.
+   *
+   * If set to 0, the time at which the posting source is initialized
+   * is used.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_NOW] =
+    g_param_spec_double ("now",
+                         "Now",
+                         "The reference time for the age of the documents",
+                         -G_MAXDOUBLE, G_MAXDOUBLE, 0,
+                         (GParamFlags) (G_PARAM_READWRITE |
+                                        G_PARAM_CONSTRUCT_ONLY |
+                                        G_PARAM_STATIC_STRINGS));
+
+  /**
+   * XapianRecencyPostingSource:half-life:
+   *
+   * The age, in seconds, at which the weight of a document is half
+   * of the #XapianRecencyPostingSource:scale.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_HALF_LIFE] =
+    g_param_spec_double ("half-life",
+                         "Half Life",
+                         "The age at which the weight halves",
+                         G_MINDOUBLE, G_MAXDOUBLE, DEFAULT_HALF_LIFE,
+                         (GParamFlags) (G_PARAM_READWRITE |
+                                        G_PARAM_CONSTRUCT_ONLY |
+                                        G_PARAM_STATIC_STRINGS));
+
+  /**
+   * XapianRecencyPostingSource:scale:
+   *
+   * The weight of the documents that are not older than
+   * #XapianRecencyPostingSource:now.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_SCALE] =
+    g_param_spec_double ("scale",
+                         "Scale",
+                         "The weight of the most recent documents",
+                         0, G_MAXDOUBLE, 1.0,
+                         (GParamFlags) (G_PARAM_READWRITE |
+                                        G_PARAM_CONSTRUCT_ONLY |
+                                        G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_properties (gobject_class, LAST_PROP, obj_props);
+}
+
+static void
+xapian_recency_posting_source_init (XapianRecencyPostingSource *self)
+{
+  XapianRecencyPostingSourcePrivate *priv = XAPIAN_RECENCY_POSTING_SOURCE_GET_PRIVATE (self);
+
+  priv->decay_function = XAPIAN_DECAY_FUNCTION_EXPONENTIAL;
+  priv->half_life = DEFAULT_HALF_LIFE;
+  priv->scale = 1.0;
+}
+
+/**
+ * xapian_recency_posting_source_new:
+ * @slot: slot in the database entries containing the timestamps
+ * @decay_function: the function used to compute the weights
+ * @now: the reference time, in seconds since the Unix epoch, or 0 to
+ *   use the current time
+ * @half_life: the age, in seconds, at which the weight halves
+ * @scale: the weight of the most recent documents
+ * @error: return location for a #GError, or %NULL
+ *
+ * If the initializion failed, @error is set, and this function
+ * will return %NULL.
+ *
+ * Returns: (transfer full): the newly created #XapianRecencyPostingSource instance
+ *
+ * Since: 2.0
+ */
+XapianRecencyPostingSource *
+xapian_recency_posting_source_new (unsigned int          slot,
+                                   XapianDecayFunction   decay_function,
+                                   double                now,
+                                   double                half_life,
+                                   double                scale,
+                                   GError              **error)
+{
+  g_return_val_if_fail (half_life > 0, NULL);
+  g_return_val_if_fail (scale >= 0, NULL);
+
+  return static_cast<XapianRecencyPostingSource *> (g_initable_new (XAPIAN_TYPE_RECENCY_POSTING_SOURCE,
+                                                                    NULL, error,
+                                                                    "slot", slot,
+                                                                    "decay-function", decay_function,
+                                                                    "now", now,
+                                                                    "half-life", half_life,
+                                                                    "scale", scale,
+                                                                    NULL));
+}
+
+/**
+ * xapian_recency_posting_source_get_decay_function:
+ * @self: a #XapianRecencyPostingSource
+ *
+ * Retrieves the value of the #XapianRecencyPostingSource:decay-function
+ * property.
+ *
+ * Returns: the decay function
+ *
+ * Since: 2.0
+ */
+XapianDecayFunction
+xapian_recency_posting_source_get_decay_function (XapianRecencyPostingSource *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_RECENCY_POSTING_SOURCE (self), XAPIAN_DECAY_FUNCTION_EXPONENTIAL);
+
+  XapianRecencyPostingSourcePrivate *priv = XAPIAN_RECENCY_POSTING_SOURCE_GET_PRIVATE (self);
+
+  return priv->decay_function;
+}
+
+/**
+ * xapian_recency_posting_source_get_now:
+ * @self: a #XapianRecencyPostingSource
+ *
+ * Retrieves the value of the #XapianRecencyPostingSource:now property.
+ *
+ * Returns: the reference time, in seconds since the Unix epoch
+ *
+ * Since: 2.0
+ */
+double
+xapian_recency_posting_source_get_now (XapianRecencyPostingSource *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_RECENCY_POSTING_SOURCE (self), 0);
+
+  XapianRecencyPostingSourcePrivate *priv = XAPIAN_RECENCY_POSTING_SOURCE_GET_PRIVATE (self);
+
+  return priv->now;
+}
+
+/**
+ * xapian_recency_posting_source_get_half_life:
+ * @self: a #XapianRecencyPostingSource
+ *
+ * Retrieves the value of the #XapianRecencyPostingSource:half-life
+ * property.
+ *
+ * Returns: the half-life, in seconds
+ *
+ * Since: 2.0
+ */
+double
+xapian_recency_posting_source_get_half_life (XapianRecencyPostingSource *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_RECENCY_POSTING_SOURCE (self), 0);
+
+  XapianRecencyPostingSourcePrivate *priv = XAPIAN_RECENCY_POSTING_SOURCE_GET_PRIVATE (self);
+
+  return priv->half_life;
+}
+
+/**
+ * xapian_recency_posting_source_get_scale:
+ * @self: a #XapianRecencyPostingSource
+ *
+ * Retrieves the value of the #XapianRecencyPostingSource:scale property.
+ *
+ * Returns: the weight of the most recent documents
+ *
+ * Since: 2.0
+ */
+double
+xapian_recency_posting_source_get_scale (XapianRecencyPostingSource *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_RECENCY_POSTING_SOURCE (self), 0);
+
+  XapianRecencyPostingSourcePrivate *priv = XAPIAN_RECENCY_POSTING_SOURCE_GET_PRIVATE (self);
+
+  return priv->scale;
+}
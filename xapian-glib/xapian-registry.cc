@@ -0,0 +1,147 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-registry
+ * @Title: XapianRegistry
+ * @short_description: Registry of user extensions
+ *
+ * #XapianRegistry keeps track of the posting sources that can be
+ * re-created when unserialising a #XapianQuery with
+ * xapian_query_new_from_bytes().
+ *
+ * The posting sources provided by Xapian, as well as the ones used
+ * internally by xapian_query_new_for_docids(), are always registered.
+ * Other posting sources, like #XapianRecencyPostingSource and
+ * #XapianStaticWeightPostingSource, need to be registered using
+ * xapian_registry_register_posting_source() before unserialising a
+ * query that contains them.
+ */
+
+#include "config.h"
+
+#include <xapian.h>
+
+#include "xapian-registry-private.h"
+
+#include "xapian-posting-source-private.h"
+#include "xapian-query-private.h"
+
+#define XAPIAN_REGISTRY_GET_PRIVATE(obj) \
+  ((XapianRegistryPrivate *) xapian_registry_get_instance_private ((XapianRegistry *) (obj)))
+
+typedef struct {
+  Xapian::Registry *mRegistry;
+} XapianRegistryPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (XapianRegistry, xapian_registry, G_TYPE_OBJECT)
+
+static void
+xapian_registry_finalize (GObject *gobject)
+{
+  XapianRegistryPrivate *priv = XAPIAN_REGISTRY_GET_PRIVATE (gobject);
+
+  delete priv->mRegistry;
+
+  G_OBJECT_CLASS (xapian_registry_parent_class)->finalize (gobject);
+}
+
+static void
+xapian_registry_class_init (XapianRegistryClass *klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = xapian_registry_finalize;
+}
+
+static void
+xapian_registry_init (XapianRegistry *self)
+{
+  XapianRegistryPrivate *priv = XAPIAN_REGISTRY_GET_PRIVATE (self);
+
+  priv->mRegistry = new Xapian::Registry ();
+
+  xapian_query_register_posting_sources (*priv->mRegistry);
+}
+
+/*< private >
+ * xapian_registry_get_internal:
+ * @registry: a #XapianRegistry
+ *
+ * Retrieves the internal `Xapian::Registry` instance.
+ *
+ * Returns: (transfer none): a pointer to the internal instance
+ */
+Xapian::Registry *
+xapian_registry_get_internal (XapianRegistry *registry)
+{
+  XapianRegistryPrivate *priv = XAPIAN_REGISTRY_GET_PRIVATE (registry);
+
+  return priv->mRegistry;
+}
+
+/**
+ * xapian_registry_new:
+ *
+ * Creates a new #XapianRegistry, containing the posting sources
+ * provided by Xapian.
+ *
+ * Returns: (transfer full): the newly created #XapianRegistry instance
+ *
+ * Since: 2.0
+ */
+XapianRegistry *
+xapian_registry_new (void)
+{
+  return static_cast<XapianRegistry *> (g_object_new (XAPIAN_TYPE_REGISTRY, NULL));
+}
+
+/**
+ * xapian_registry_register_posting_source:
+ * @registry: a #XapianRegistry
+ * @source: a #XapianPostingSource
+ *
+ * Registers the type of @source inside the @registry, so that queries
+ * containing posting sources of the same type can be unserialised.
+ *
+ * The parameters of @source are not relevant, as each posting source
+ * stores its own parameters when serialised.
+ *
+ * Posting sources implemented by subclassing #XapianPostingSource
+ * cannot be serialised, so they cannot be registered.
+ *
+ * Since: 2.0
+ */
+void
+xapian_registry_register_posting_source (XapianRegistry      *registry,
+                                         XapianPostingSource *source)
+{
+  g_return_if_fail (XAPIAN_IS_REGISTRY (registry));
+  g_return_if_fail (XAPIAN_IS_POSTING_SOURCE (source));
+
+  Xapian::PostingSource *aPostingSource = xapian_posting_source_get_internal (source);
+
+  g_return_if_fail (aPostingSource != NULL);
+
+  try
+    {
+      xapian_registry_get_internal (registry)->register_posting_source (*aPostingSource);
+    }
+  catch (const Xapian::Error &err)
+    {
+      g_critical ("Unable to register the posting source: %s",
+                  err.get_msg ().c_str ());
+    }
+}
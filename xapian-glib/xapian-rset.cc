@@ -0,0 +1,243 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:xapian-rset
+ * @Title: XapianRSet
+ * @short_description: A set of relevant documents
+ *
+ * #XapianRSet represents a set of documents that are known to be
+ * relevant to a search; it is typically filled with the identifiers
+ * of documents picked by the user, and then passed to
+ * xapian_enquire_get_eset() to find terms that can be used to expand
+ * the query, or to xapian_enquire_get_related_mset() to find other
+ * documents that are similar to the ones in the set.
+ */
+
+#include "config.h"
+
+#include <xapian.h>
+
+#include "xapian-rset-private.h"
+
+#define XAPIAN_RSET_GET_PRIVATE(obj) \
+  ((XapianRSetPrivate *) xapian_rset_get_instance_private ((XapianRSet *) (obj)))
+
+typedef struct {
+  Xapian::RSet *mRSet;
+} XapianRSetPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (XapianRSet, xapian_rset, G_TYPE_OBJECT)
+
+static void
+xapian_rset_finalize (GObject *gobject)
+{
+  XapianRSetPrivate *priv = XAPIAN_RSET_GET_PRIVATE (gobject);
+
+  delete priv->mRSet;
+
+  G_OBJECT_CLASS (xapian_rset_parent_class)->finalize (gobject);
+}
+
+static void
+xapian_rset_class_init (XapianRSetClass *klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = xapian_rset_finalize;
+}
+
+static void
+xapian_rset_init (XapianRSet *self)
+{
+  XapianRSetPrivate *priv = XAPIAN_RSET_GET_PRIVATE (self);
+
+  priv->mRSet = new Xapian::RSet ();
+}
+
+/*< private >
+ * xapian_rset_get_internal:
+ * @rset: a #XapianRSet
+ *
+ * Retrieves the internal `Xapian::RSet` instance.
+ *
+ * Returns: (transfer none): a pointer to the internal instance
+ */
+Xapian::RSet *
+xapian_rset_get_internal (XapianRSet *rset)
+{
+  XapianRSetPrivate *priv = XAPIAN_RSET_GET_PRIVATE (rset);
+
+  return priv->mRSet;
+}
+
+/**
+ * xapian_rset_new:
+ *
+ * Creates a new, empty #XapianRSet.
+ *
+ * Returns: (transfer full): the newly created #XapianRSet instance
+ *
+ * Since: 2.0
+ */
+XapianRSet *
+xapian_rset_new (void)
+{
+  return static_cast<XapianRSet *> (g_object_new (XAPIAN_TYPE_RSET, NULL));
+}
+
+/**
+ * xapian_rset_new_for_docids:
+ * @docids: (array length=n_docids): the identifiers of the relevant documents
+ * @n_docids: the number of elements in @docids
+ *
+ * Creates a new #XapianRSet containing all the documents in @docids.
+ *
+ * Document identifiers must be greater than zero.
+ *
+ * Returns: (transfer full): the newly created #XapianRSet instance
+ *
+ * Since: 2.0
+ */
+XapianRSet *
+xapian_rset_new_for_docids (const guint32 *docids,
+                            gsize          n_docids)
+{
+  g_return_val_if_fail (docids != NULL || n_docids == 0, NULL);
+
+  for (gsize i = 0; i < n_docids; i++)
+    g_return_val_if_fail (docids[i] != 0, NULL);
+
+  XapianRSet *res = xapian_rset_new ();
+  Xapian::RSet *rset = xapian_rset_get_internal (res);
+
+  for (gsize i = 0; i < n_docids; i++)
+    rset->add_document (docids[i]);
+
+  return res;
+}
+
+/**
+ * xapian_rset_add_document:
+ * @rset: a #XapianRSet
+ * @docid: the identifier of a relevant document
+ *
+ * Marks the document with the given @docid as relevant.
+ *
+ * Since: 2.0
+ */
+void
+xapian_rset_add_document (XapianRSet   *rset,
+                          unsigned int  docid)
+{
+  g_return_if_fail (XAPIAN_IS_RSET (rset));
+  g_return_if_fail (docid != 0);
+
+  xapian_rset_get_internal (rset)->add_document (docid);
+}
+
+/**
+ * xapian_rset_remove_document:
+ * @rset: a #XapianRSet
+ * @docid: the identifier of a document
+ *
+ * Removes the document with the given @docid from the @rset.
+ *
+ * Since: 2.0
+ */
+void
+xapian_rset_remove_document (XapianRSet   *rset,
+                             unsigned int  docid)
+{
+  g_return_if_fail (XAPIAN_IS_RSET (rset));
+
+  xapian_rset_get_internal (rset)->remove_document (docid);
+}
+
+/**
+ * xapian_rset_contains:
+ * @rset: a #XapianRSet
+ * @docid: the identifier of a document
+ *
+ * Checks whether the document with the given @docid is in the @rset.
+ *
+ * Returns: %TRUE if the document is marked as relevant
+ *
+ * Since: 2.0
+ */
+gboolean
+xapian_rset_contains (XapianRSet   *rset,
+                      unsigned int  docid)
+{
+  g_return_val_if_fail (XAPIAN_IS_RSET (rset), FALSE);
+
+  return xapian_rset_get_internal (rset)->contains (docid);
+}
+
+/**
+ * xapian_rset_get_size:
+ * @rset: a #XapianRSet
+ *
+ * Retrieves the number of documents in the @rset.
+ *
+ * Returns: the number of relevant documents
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_rset_get_size (XapianRSet *rset)
+{
+  g_return_val_if_fail (XAPIAN_IS_RSET (rset), 0);
+
+  return xapian_rset_get_internal (rset)->size ();
+}
+
+/**
+ * xapian_rset_is_empty:
+ * @rset: a #XapianRSet
+ *
+ * Checks whether the @rset is empty.
+ *
+ * Returns: %TRUE if the set is empty, and %FALSE otherwise
+ *
+ * Since: 2.0
+ */
+gboolean
+xapian_rset_is_empty (XapianRSet *rset)
+{
+  g_return_val_if_fail (XAPIAN_IS_RSET (rset), TRUE);
+
+  return xapian_rset_get_internal (rset)->empty ();
+}
+
+/**
+ * xapian_rset_get_description:
+ * @rset: a #XapianRSet
+ *
+ * Retrieves a description of the @rset, typically used for
+ * debugging.
+ *
+ * Returns: (transfer full): a description of the set
+ *
+ * Since: 2.0
+ */
+char *
+xapian_rset_get_description (XapianRSet *rset)
+{
+  g_return_val_if_fail (XAPIAN_IS_RSET (rset), NULL);
+
+  std::string desc = xapian_rset_get_internal (rset)->get_description ();
+
+  return g_strdup (desc.c_str ());
+}
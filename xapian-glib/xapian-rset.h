@@ -0,0 +1,63 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __XAPIAN_GLIB_RSET_H__
+#define __XAPIAN_GLIB_RSET_H__
+
+#if !defined(XAPIAN_GLIB_H_INSIDE) && !defined(XAPIAN_GLIB_COMPILATION)
+#error "Only <xapian-glib.h> can be included directly."
+#endif
+
+#include "xapian-glib-types.h"
+
+G_BEGIN_DECLS
+
+#define XAPIAN_TYPE_RSET        (xapian_rset_get_type())
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+G_DECLARE_DERIVABLE_TYPE (XapianRSet, xapian_rset, XAPIAN, RSET, GObject)
+
+struct _XapianRSetClass
+{
+  /*< private >*/
+  GObjectClass parent_instance;
+};
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianRSet *    xapian_rset_new                 (void);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianRSet *    xapian_rset_new_for_docids      (const guint32 *docids,
+                                                 gsize          n_docids);
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+void            xapian_rset_add_document        (XapianRSet    *rset,
+                                                 unsigned int   docid);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+void            xapian_rset_remove_document     (XapianRSet    *rset,
+                                                 unsigned int   docid);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+gboolean        xapian_rset_contains            (XapianRSet    *rset,
+                                                 unsigned int   docid);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+unsigned int    xapian_rset_get_size            (XapianRSet    *rset);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+gboolean        xapian_rset_is_empty            (XapianRSet    *rset);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+char *          xapian_rset_get_description     (XapianRSet    *rset);
+
+G_END_DECLS
+
+#endif /* __XAPIAN_GLIB_RSET_H__ */
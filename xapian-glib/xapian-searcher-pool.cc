@@ -0,0 +1,890 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-searcher-pool
+ * @Title: XapianSearcherPool
+ * @short_description: A pool of searchers for multi-threaded servers
+ *
+ * Xapian databases, enquires and query parsers must not be used by more
+ * than one thread at a time. #XapianSearcherPool keeps a fixed number
+ * of pre-opened #XapianDatabase instances for the same path, each with
+ * its own #XapianEnquire and #XapianQueryParser, and lends them to one
+ * thread at a time as #XapianSearcher instances.
+ *
+ * |[<!-- language="C" -->
+ *   XapianSearcherPool *pool = xapian_searcher_pool_new (path, 8, &error);
+ *
+ *   // In each worker thread
+ *   g_autoptr(XapianSearcher) searcher =
+ *     xapian_searcher_pool_acquire (pool, NULL, &error);
+ *
+ *   XapianEnquire *enquire = xapian_searcher_get_enquire (searcher);
+ * ]|
+ *
+ * When the database changes, for instance after a commit, calling
+ * xapian_searcher_pool_reopen() reopens the databases of the pool in a
+ * background thread, one at a time, without blocking the threads that
+ * are using or acquiring searchers; the databases currently lent are
+ * reopened once they are returned to the pool.
+ *
+ * Instead of calling xapian_searcher_pool_reopen() after each commit,
+ * applications can call xapian_searcher_pool_start_monitor() to have
+ * the pool reopened every time the #XapianDatabase::revision-changed
+ * signal of a monitored database is emitted; see
+ * xapian_database_start_monitor().
+ *
+ * It is safe to use a #XapianSearcherPool from multiple threads.
+ */
+
+#include "config.h"
+
+#include <vector>
+
+#include <xapian.h>
+
+#include "xapian-searcher-pool.h"
+
+#include "xapian-database-private.h"
+#include "xapian-enums.h"
+#include "xapian-searcher-private.h"
+
+#define DEFAULT_SIZE            4
+
+struct PoolMember {
+  XapianDatabase *database;
+  XapianEnquire *enquire;
+  XapianQueryParser *parser;
+
+  /* The generation of the pool the database was last reopened for */
+  guint generation;
+};
+
+#define XAPIAN_SEARCHER_POOL_GET_PRIVATE(obj) \
+  ((XapianSearcherPoolPrivate *) xapian_searcher_pool_get_instance_private ((XapianSearcherPool *) (obj)))
+
+typedef struct {
+  char *path;
+  guint size;
+
+  GMutex lock;
+  GCond cond;
+
+  std::vector<PoolMember *> *mMembers;
+  std::vector<PoolMember *> *mIdle;
+
+  /* Incremented by xapian_searcher_pool_reopen() */
+  guint generation;
+
+  GThreadPool *reopen_pool;
+  guint reopen_scheduled : 1;
+
+  /* Used by xapian_searcher_pool_start_monitor() */
+  XapianDatabase *monitor;
+
+  guint n_in_use;
+  guint peak_in_use;
+  guint64 n_acquired;
+  guint64 n_waited;
+} XapianSearcherPoolPrivate;
+
+enum {
+  PROP_0,
+
+  PROP_PATH,
+  PROP_SIZE,
+
+  LAST_PROP
+};
+
+static GParamSpec *obj_props[LAST_PROP] = { NULL, };
+
+static void initable_iface_init (GInitableIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (XapianSearcherPool, xapian_searcher_pool, G_TYPE_OBJECT,
+                         G_ADD_PRIVATE (XapianSearcherPool)
+                         G_IMPLEMENT_INTERFACE (G_TYPE_INITABLE, initable_iface_init))
+
+/* Runs a query matching everything, so that the first real query does
+ * not pay for loading the statistics and the root blocks of the tables
+ */
+static void
+pool_member_warm (PoolMember *member)
+{
+  Xapian::Database *db = xapian_database_get_internal (member->database);
+
+  try
+    {
+      Xapian::Enquire enquire (*db);
+
+      enquire.set_query (Xapian::Query::MatchAll);
+      enquire.get_mset (0, 1);
+    }
+  catch (const Xapian::Error &)
+    {
+      /* Errors will be reported to the users of the searcher */
+    }
+}
+
+static PoolMember *
+pool_member_new (const char  *path,
+                 guint        generation,
+                 GError     **error)
+{
+  XapianDatabase *database = xapian_database_new_with_path (path, error);
+  if (database == NULL)
+    return NULL;
+
+  XapianEnquire *enquire = xapian_enquire_new (database, error);
+  if (enquire == NULL)
+    {
+      g_object_unref (database);
+      return NULL;
+    }
+
+  PoolMember *member = new PoolMember ();
+
+  member->database = database;
+  member->enquire = enquire;
+  member->parser = xapian_query_parser_new ();
+  member->generation = generation;
+
+  xapian_query_parser_set_database (member->parser, database);
+
+  pool_member_warm (member);
+
+  return member;
+}
+
+static void
+pool_member_free (PoolMember *member)
+{
+  g_clear_object (&member->parser);
+  g_clear_object (&member->enquire);
+  g_clear_object (&member->database);
+
+  delete member;
+}
+
+/* Removes an idle member from the pool; members that are up to date
+ * are preferred, and the most recently used ones come first, as their
+ * caches are warmer.
+ *
+ * Must be called with the lock held.
+ */
+static PoolMember *
+take_idle_member (XapianSearcherPoolPrivate *priv,
+                  bool                       only_stale)
+{
+  std::vector<PoolMember *> &idle = *priv->mIdle;
+
+  for (size_t i = idle.size (); i > 0; i--)
+    {
+      PoolMember *member = idle[i - 1];
+      bool stale = member->generation != priv->generation;
+
+      if (stale == only_stale)
+        {
+          idle.erase (idle.begin () + (i - 1));
+          return member;
+        }
+    }
+
+  if (only_stale || idle.empty ())
+    return NULL;
+
+  PoolMember *member = idle.back ();
+  idle.pop_back ();
+
+  return member;
+}
+
+/* Must be called with the lock held */
+static void
+schedule_reopen (XapianSearcherPool *self)
+{
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (self);
+
+  if (priv->reopen_scheduled || priv->reopen_pool == NULL)
+    return;
+
+  priv->reopen_scheduled = TRUE;
+  g_thread_pool_push (priv->reopen_pool, self, NULL);
+}
+
+/* Runs in the reopen thread */
+static void
+reopen_stale_members (gpointer data,
+                      gpointer user_data)
+{
+  XapianSearcherPool *self = static_cast<XapianSearcherPool *> (data);
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (self);
+
+  g_mutex_lock (&priv->lock);
+
+  priv->reopen_scheduled = FALSE;
+
+  while (TRUE)
+    {
+      /* Only one member at a time is taken out of the pool */
+      PoolMember *member = take_idle_member (priv, true);
+      if (member == NULL)
+        break;
+
+      guint generation = priv->generation;
+
+      g_mutex_unlock (&priv->lock);
+
+      try
+        {
+          xapian_database_get_internal (member->database)->reopen ();
+        }
+      catch (const Xapian::Error &err)
+        {
+          g_warning ("Unable to reopen the database at '%s': %s",
+                     priv->path,
+                     err.get_msg ().c_str ());
+        }
+
+      pool_member_warm (member);
+
+      g_mutex_lock (&priv->lock);
+
+      member->generation = generation;
+      priv->mIdle->push_back (member);
+      g_cond_signal (&priv->cond);
+    }
+
+  g_mutex_unlock (&priv->lock);
+}
+
+static gboolean
+xapian_searcher_pool_init_internal (GInitable    *self,
+                                    GCancellable *cancellable,
+                                    GError      **error)
+{
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (self);
+
+  if (priv->path == NULL)
+    {
+      g_set_error_literal (error, XAPIAN_ERROR,
+                           XAPIAN_ERROR_INVALID_ARGUMENT,
+                           "A database path is required to create a searcher pool");
+      return FALSE;
+    }
+
+  for (guint i = 0; i < priv->size; i++)
+    {
+      PoolMember *member = pool_member_new (priv->path, priv->generation, error);
+      if (member == NULL)
+        return FALSE;
+
+      priv->mMembers->push_back (member);
+      priv->mIdle->push_back (member);
+    }
+
+  priv->reopen_pool = g_thread_pool_new (reopen_stale_members, NULL, 1, FALSE, error);
+  if (priv->reopen_pool == NULL)
+    return FALSE;
+
+  return TRUE;
+}
+
+static void
+initable_iface_init (GInitableIface *iface)
+{
+  iface->init = xapian_searcher_pool_init_internal;
+}
+
+static void
+xapian_searcher_pool_dispose (GObject *gobject)
+{
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (gobject);
+
+  xapian_searcher_pool_stop_monitor (XAPIAN_SEARCHER_POOL (gobject));
+
+  /* Wait for the pending reopens */
+  if (priv->reopen_pool != NULL)
+    {
+      g_thread_pool_free (priv->reopen_pool, FALSE, TRUE);
+      priv->reopen_pool = NULL;
+    }
+
+  G_OBJECT_CLASS (xapian_searcher_pool_parent_class)->dispose (gobject);
+}
+
+static void
+xapian_searcher_pool_finalize (GObject *gobject)
+{
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (gobject);
+
+  /* Searchers keep a reference on the pool, so all members are idle */
+  for (PoolMember *member : *priv->mMembers)
+    pool_member_free (member);
+
+  delete priv->mMembers;
+  delete priv->mIdle;
+
+  g_mutex_clear (&priv->lock);
+  g_cond_clear (&priv->cond);
+
+  g_free (priv->path);
+
+  G_OBJECT_CLASS (xapian_searcher_pool_parent_class)->finalize (gobject);
+}
+
+static void
+xapian_searcher_pool_set_property (GObject      *gobject,
+                                   guint         prop_id,
+                                   const GValue *value,
+                                   GParamSpec   *pspec)
+{
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_PATH:
+      g_free (priv->path);
+      priv->path = g_value_dup_string (value);
+      break;
+
+    case PROP_SIZE:
+      priv->size = g_value_get_uint (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_searcher_pool_get_property (GObject    *gobject,
+                                   guint       prop_id,
+                                   GValue     *value,
+                                   GParamSpec *pspec)
+{
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_PATH:
+      g_value_set_string (value, priv->path);
+      break;
+
+    case PROP_SIZE:
+      g_value_set_uint (value, priv->size);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_searcher_pool_class_init (XapianSearcherPoolClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  /**
+   * XapianSearcherPool:path:
+   *
+   * The path of the database opened by the searchers of the pool.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_PATH] =
+    g_param_spec_string ("path",
+                         "Path",
+                         "The path of the database",
+                         NULL,
+                         (GParamFlags) (G_PARAM_READWRITE |
+                                        G_PARAM_CONSTRUCT_ONLY |
+                                        G_PARAM_STATIC_STRINGS));
+
+  /**
+   * XapianSearcherPool:size:
+   *
+   * The number of searchers in the pool.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_SIZE] =
+    g_param_spec_uint ("size",
+                       "Size",
+                       "The number of searchers in the pool",
+                       1, G_MAXUINT16,
+                       DEFAULT_SIZE,
+                       (GParamFlags) (G_PARAM_READWRITE |
+                                      G_PARAM_CONSTRUCT_ONLY |
+                                      G_PARAM_STATIC_STRINGS));
+
+  gobject_class->set_property = xapian_searcher_pool_set_property;
+  gobject_class->get_property = xapian_searcher_pool_get_property;
+  gobject_class->dispose = xapian_searcher_pool_dispose;
+  gobject_class->finalize = xapian_searcher_pool_finalize;
+
+  g_object_class_install_properties (gobject_class, LAST_PROP, obj_props);
+}
+
+static void
+xapian_searcher_pool_init (XapianSearcherPool *self)
+{
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (self);
+
+  priv->size = DEFAULT_SIZE;
+  priv->mMembers = new std::vector<PoolMember *> ();
+  priv->mIdle = new std::vector<PoolMember *> ();
+
+  g_mutex_init (&priv->lock);
+  g_cond_init (&priv->cond);
+}
+
+/*< private >
+ * xapian_searcher_pool_release_member:
+ * @pool: a #XapianSearcherPool
+ * @member: a member of the @pool
+ *
+ * Returns a member lent by xapian_searcher_pool_acquire() to the @pool,
+ * scheduling a reopen of its database if needed.
+ *
+ * The query parser of @member is replaced, so that the prefixes,
+ * stopper and processors set by a borrower are not kept around.
+ */
+void
+xapian_searcher_pool_release_member (XapianSearcherPool *pool,
+                                     gpointer            member)
+{
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (pool);
+  PoolMember *aMember = static_cast<PoolMember *> (member);
+
+  g_clear_object (&aMember->parser);
+  aMember->parser = xapian_query_parser_new ();
+  xapian_query_parser_set_database (aMember->parser, aMember->database);
+
+  g_mutex_lock (&priv->lock);
+
+  priv->n_in_use -= 1;
+  priv->mIdle->push_back (aMember);
+
+  if (aMember->generation != priv->generation)
+    schedule_reopen (pool);
+
+  g_cond_signal (&priv->cond);
+
+  g_mutex_unlock (&priv->lock);
+}
+
+/* Must be called with the lock held */
+static XapianSearcher *
+lend_member (XapianSearcherPool *self,
+             PoolMember         *member)
+{
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (self);
+
+  priv->n_in_use += 1;
+  priv->n_acquired += 1;
+  priv->peak_in_use = MAX (priv->peak_in_use, priv->n_in_use);
+
+  return xapian_searcher_new (self, member,
+                              member->database,
+                              member->enquire,
+                              member->parser);
+}
+
+static void
+on_cancelled (GCancellable *cancellable,
+              gpointer      data)
+{
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (data);
+
+  g_mutex_lock (&priv->lock);
+  g_cond_broadcast (&priv->cond);
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * xapian_searcher_pool_new:
+ * @path: the path of the database
+ * @size: the number of searchers in the pool
+ * @error: return location for a #GError, or %NULL
+ *
+ * Creates and initializes a new #XapianSearcherPool, opening @size
+ * instances of the database at @path.
+ *
+ * If the initialization was not successful, @error is set.
+ *
+ * Returns: (transfer full): the newly created #XapianSearcherPool
+ *   instance, or %NULL if the initialization failed
+ *
+ * Since: 2.0
+ */
+XapianSearcherPool *
+xapian_searcher_pool_new (const char    *path,
+                          unsigned int   size,
+                          GError       **error)
+{
+  g_return_val_if_fail (path != NULL, NULL);
+  g_return_val_if_fail (size > 0 && size <= G_MAXUINT16, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  return static_cast<XapianSearcherPool *> (g_initable_new (XAPIAN_TYPE_SEARCHER_POOL,
+                                                            NULL, error,
+                                                            "path", path,
+                                                            "size", size,
+                                                            NULL));
+}
+
+/**
+ * xapian_searcher_pool_acquire:
+ * @pool: a #XapianSearcherPool
+ * @cancellable: (nullable): a #GCancellable, or %NULL
+ * @error: return location for a #GError, or %NULL
+ *
+ * Acquires a #XapianSearcher from the @pool, blocking until one is
+ * available or @cancellable is cancelled.
+ *
+ * The searcher is returned to the @pool when its last reference is
+ * released, or when xapian_searcher_release() is called.
+ *
+ * Returns: (transfer full): a #XapianSearcher, or %NULL if the
+ *   operation was cancelled
+ *
+ * Since: 2.0
+ */
+XapianSearcher *
+xapian_searcher_pool_acquire (XapianSearcherPool  *pool,
+                              GCancellable        *cancellable,
+                              GError             **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_SEARCHER_POOL (pool), NULL);
+  g_return_val_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable), NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (pool);
+  XapianSearcher *res = NULL;
+  gulong cancel_id = 0;
+
+  /* This must happen without holding the lock, as the callback is
+   * invoked immediately if @cancellable is already cancelled
+   */
+  if (cancellable != NULL)
+    cancel_id = g_cancellable_connect (cancellable, G_CALLBACK (on_cancelled), pool, NULL);
+
+  g_mutex_lock (&priv->lock);
+
+  if (priv->mIdle->empty () && !g_cancellable_is_cancelled (cancellable))
+    priv->n_waited += 1;
+
+  while (priv->mIdle->empty () && !g_cancellable_is_cancelled (cancellable))
+    g_cond_wait (&priv->cond, &priv->lock);
+
+  if (!g_cancellable_is_cancelled (cancellable))
+    res = lend_member (pool, take_idle_member (priv, false));
+
+  g_mutex_unlock (&priv->lock);
+
+  if (cancel_id != 0)
+    g_cancellable_disconnect (cancellable, cancel_id);
+
+  if (res == NULL)
+    g_cancellable_set_error_if_cancelled (cancellable, error);
+
+  return res;
+}
+
+/**
+ * xapian_searcher_pool_try_acquire:
+ * @pool: a #XapianSearcherPool
+ *
+ * Acquires a #XapianSearcher from the @pool, if one is available.
+ *
+ * Unlike xapian_searcher_pool_acquire(), this function never blocks.
+ *
+ * Returns: (transfer full) (nullable): a #XapianSearcher, or %NULL if
+ *   all the searchers are in use
+ *
+ * Since: 2.0
+ */
+XapianSearcher *
+xapian_searcher_pool_try_acquire (XapianSearcherPool *pool)
+{
+  g_return_val_if_fail (XAPIAN_IS_SEARCHER_POOL (pool), NULL);
+
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (pool);
+  XapianSearcher *res = NULL;
+
+  g_mutex_lock (&priv->lock);
+
+  if (!priv->mIdle->empty ())
+    res = lend_member (pool, take_idle_member (priv, false));
+
+  g_mutex_unlock (&priv->lock);
+
+  return res;
+}
+
+/**
+ * xapian_searcher_pool_reopen:
+ * @pool: a #XapianSearcherPool
+ *
+ * Reopens the databases of the @pool, typically after the database
+ * has been modified by a writer.
+ *
+ * The idle databases are reopened in a background thread, one at a
+ * time; the databases that are currently in use are reopened when
+ * they are returned to the @pool.
+ *
+ * Since: 2.0
+ */
+void
+xapian_searcher_pool_reopen (XapianSearcherPool *pool)
+{
+  g_return_if_fail (XAPIAN_IS_SEARCHER_POOL (pool));
+
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (pool);
+
+  g_mutex_lock (&priv->lock);
+
+  priv->generation += 1;
+  schedule_reopen (pool);
+
+  g_mutex_unlock (&priv->lock);
+}
+
+static void
+on_revision_changed (XapianDatabase *database,
+                     guint64         revision,
+                     gpointer        user_data)
+{
+  xapian_searcher_pool_reopen (static_cast<XapianSearcherPool *> (user_data));
+}
+
+/**
+ * xapian_searcher_pool_start_monitor:
+ * @pool: a #XapianSearcherPool
+ * @error: return location for a #GError, or %NULL
+ *
+ * Starts monitoring the database of the @pool for new revisions,
+ * calling xapian_searcher_pool_reopen() each time a writer commits
+ * a new revision.
+ *
+ * The databases are reopened from the thread-default main context
+ * of the caller of this function, which must be running.
+ *
+ * Returns: %TRUE if the monitor was started, and %FALSE otherwise
+ *
+ * Since: 2.0
+ */
+gboolean
+xapian_searcher_pool_start_monitor (XapianSearcherPool  *pool,
+                                    GError             **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_SEARCHER_POOL (pool), FALSE);
+  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (pool);
+
+  if (priv->monitor != NULL)
+    return TRUE;
+
+  /* The members of the pool are lent to other threads, so the pool
+   * uses its own database to watch for new revisions
+   */
+  XapianDatabase *monitor = xapian_database_new_with_path (priv->path, error);
+  if (monitor == NULL)
+    return FALSE;
+
+  if (!xapian_database_start_monitor (monitor, error))
+    {
+      g_object_unref (monitor);
+      return FALSE;
+    }
+
+  g_signal_connect (monitor, "revision-changed", G_CALLBACK (on_revision_changed), pool);
+
+  priv->monitor = monitor;
+
+  return TRUE;
+}
+
+/**
+ * xapian_searcher_pool_stop_monitor:
+ * @pool: a #XapianSearcherPool
+ *
+ * Stops monitoring the database of the @pool, if
+ * xapian_searcher_pool_start_monitor() was called.
+ *
+ * Since: 2.0
+ */
+void
+xapian_searcher_pool_stop_monitor (XapianSearcherPool *pool)
+{
+  g_return_if_fail (XAPIAN_IS_SEARCHER_POOL (pool));
+
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (pool);
+
+  if (priv->monitor == NULL)
+    return;
+
+  g_signal_handlers_disconnect_by_func (priv->monitor,
+                                        (gpointer) on_revision_changed,
+                                        pool);
+  xapian_database_stop_monitor (priv->monitor);
+  g_clear_object (&priv->monitor);
+}
+
+/**
+ * xapian_searcher_pool_get_path:
+ * @pool: a #XapianSearcherPool
+ *
+ * Retrieves the value of the #XapianSearcherPool:path property.
+ *
+ * Returns: (transfer none): the path of the database
+ *
+ * Since: 2.0
+ */
+const char *
+xapian_searcher_pool_get_path (XapianSearcherPool *pool)
+{
+  g_return_val_if_fail (XAPIAN_IS_SEARCHER_POOL (pool), NULL);
+
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (pool);
+
+  return priv->path;
+}
+
+/**
+ * xapian_searcher_pool_get_size:
+ * @pool: a #XapianSearcherPool
+ *
+ * Retrieves the value of the #XapianSearcherPool:size property.
+ *
+ * Returns: the number of searchers in the pool
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_searcher_pool_get_size (XapianSearcherPool *pool)
+{
+  g_return_val_if_fail (XAPIAN_IS_SEARCHER_POOL (pool), 0);
+
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (pool);
+
+  return priv->size;
+}
+
+/**
+ * xapian_searcher_pool_get_n_in_use:
+ * @pool: a #XapianSearcherPool
+ *
+ * Retrieves the number of searchers currently lent by the @pool.
+ *
+ * Returns: the number of searchers in use
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_searcher_pool_get_n_in_use (XapianSearcherPool *pool)
+{
+  g_return_val_if_fail (XAPIAN_IS_SEARCHER_POOL (pool), 0);
+
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (pool);
+
+  g_mutex_lock (&priv->lock);
+  unsigned int res = priv->n_in_use;
+  g_mutex_unlock (&priv->lock);
+
+  return res;
+}
+
+/**
+ * xapian_searcher_pool_get_peak_in_use:
+ * @pool: a #XapianSearcherPool
+ *
+ * Retrieves the highest number of searchers lent by the @pool at
+ * the same time.
+ *
+ * Returns: the peak number of searchers in use
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_searcher_pool_get_peak_in_use (XapianSearcherPool *pool)
+{
+  g_return_val_if_fail (XAPIAN_IS_SEARCHER_POOL (pool), 0);
+
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (pool);
+
+  g_mutex_lock (&priv->lock);
+  unsigned int res = priv->peak_in_use;
+  g_mutex_unlock (&priv->lock);
+
+  return res;
+}
+
+/**
+ * xapian_searcher_pool_get_n_acquired:
+ * @pool: a #XapianSearcherPool
+ *
+ * Retrieves the number of searchers lent by the @pool since it
+ * was created.
+ *
+ * Returns: the number of acquired searchers
+ *
+ * Since: 2.0
+ */
+guint64
+xapian_searcher_pool_get_n_acquired (XapianSearcherPool *pool)
+{
+  g_return_val_if_fail (XAPIAN_IS_SEARCHER_POOL (pool), 0);
+
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (pool);
+
+  g_mutex_lock (&priv->lock);
+  guint64 res = priv->n_acquired;
+  g_mutex_unlock (&priv->lock);
+
+  return res;
+}
+
+/**
+ * xapian_searcher_pool_get_n_waited:
+ * @pool: a #XapianSearcherPool
+ *
+ * Retrieves the number of calls to xapian_searcher_pool_acquire() that
+ * had to wait for a searcher to be available.
+ *
+ * A high ratio between this value and the one returned by
+ * xapian_searcher_pool_get_n_acquired() means the pool is too small.
+ *
+ * Returns: the number of calls that waited
+ *
+ * Since: 2.0
+ */
+guint64
+xapian_searcher_pool_get_n_waited (XapianSearcherPool *pool)
+{
+  g_return_val_if_fail (XAPIAN_IS_SEARCHER_POOL (pool), 0);
+
+  XapianSearcherPoolPrivate *priv = XAPIAN_SEARCHER_POOL_GET_PRIVATE (pool);
+
+  g_mutex_lock (&priv->lock);
+  guint64 res = priv->n_waited;
+  g_mutex_unlock (&priv->lock);
+
+  return res;
+}
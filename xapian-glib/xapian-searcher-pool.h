@@ -0,0 +1,75 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __XAPIAN_GLIB_SEARCHER_POOL_H__
+#define __XAPIAN_GLIB_SEARCHER_POOL_H__
+
+#if !defined(XAPIAN_GLIB_H_INSIDE) && !defined(XAPIAN_GLIB_COMPILATION)
+#error "Only <xapian-glib.h> can be included directly."
+#endif
+
+#include "xapian-glib-types.h"
+#include "xapian-searcher.h"
+
+G_BEGIN_DECLS
+
+#define XAPIAN_TYPE_SEARCHER_POOL       (xapian_searcher_pool_get_type())
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+G_DECLARE_DERIVABLE_TYPE (XapianSearcherPool, xapian_searcher_pool, XAPIAN, SEARCHER_POOL, GObject)
+
+struct _XapianSearcherPoolClass
+{
+  /*< private >*/
+  GObjectClass parent_instance;
+};
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianSearcherPool *    xapian_searcher_pool_new                (const char             *path,
+                                                                 unsigned int            size,
+                                                                 GError                **error);
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianSearcher *        xapian_searcher_pool_acquire            (XapianSearcherPool     *pool,
+                                                                 GCancellable           *cancellable,
+                                                                 GError                **error);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianSearcher *        xapian_searcher_pool_try_acquire        (XapianSearcherPool     *pool);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+void                    xapian_searcher_pool_reopen             (XapianSearcherPool     *pool);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+gboolean                xapian_searcher_pool_start_monitor      (XapianSearcherPool     *pool,
+                                                                 GError                **error);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+void                    xapian_searcher_pool_stop_monitor       (XapianSearcherPool     *pool);
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+const char *            xapian_searcher_pool_get_path           (XapianSearcherPool     *pool);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+unsigned int            xapian_searcher_pool_get_size           (XapianSearcherPool     *pool);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+unsigned int            xapian_searcher_pool_get_n_in_use       (XapianSearcherPool     *pool);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+unsigned int            xapian_searcher_pool_get_peak_in_use    (XapianSearcherPool     *pool);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+guint64                 xapian_searcher_pool_get_n_acquired     (XapianSearcherPool     *pool);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+guint64                 xapian_searcher_pool_get_n_waited       (XapianSearcherPool     *pool);
+
+G_END_DECLS
+
+#endif /* __XAPIAN_GLIB_SEARCHER_POOL_H__ */
@@ -0,0 +1,214 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-searcher
+ * @Title: XapianSearcher
+ * @short_description: A searcher lent by a XapianSearcherPool
+ *
+ * #XapianSearcher gives exclusive access to a #XapianDatabase, and to the
+ * #XapianEnquire and #XapianQueryParser using it, for as long as the
+ * searcher is alive.
+ *
+ * Searchers are obtained using xapian_searcher_pool_acquire(), and are
+ * returned to their #XapianSearcherPool when their last reference is
+ * released, or when xapian_searcher_release() is called; this makes
+ * them suitable for use with g_autoptr():
+ *
+ * |[<!-- language="C" -->
+ *   g_autoptr(XapianSearcher) searcher =
+ *     xapian_searcher_pool_acquire (pool, NULL, &error);
+ *
+ *   XapianEnquire *enquire = xapian_searcher_get_enquire (searcher);
+ * ]|
+ *
+ * The objects owned by a #XapianSearcher must not be used by other
+ * threads, or after the searcher has been released.
+ */
+
+#include "config.h"
+
+#include "xapian-searcher-private.h"
+
+#define XAPIAN_SEARCHER_GET_PRIVATE(obj) \
+  ((XapianSearcherPrivate *) xapian_searcher_get_instance_private ((XapianSearcher *) (obj)))
+
+typedef struct {
+  XapianSearcherPool *pool;
+  gpointer member;
+
+  /* Owned by the pool member */
+  XapianDatabase *database;
+  XapianEnquire *enquire;
+  XapianQueryParser *parser;
+} XapianSearcherPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (XapianSearcher, xapian_searcher, G_TYPE_OBJECT)
+
+static void
+xapian_searcher_dispose (GObject *gobject)
+{
+  xapian_searcher_release (XAPIAN_SEARCHER (gobject));
+
+  G_OBJECT_CLASS (xapian_searcher_parent_class)->dispose (gobject);
+}
+
+static void
+xapian_searcher_class_init (XapianSearcherClass *klass)
+{
+  G_OBJECT_CLASS (klass)->dispose = xapian_searcher_dispose;
+}
+
+static void
+xapian_searcher_init (XapianSearcher *self)
+{
+}
+
+/*< private >
+ * xapian_searcher_new:
+ * @pool: the #XapianSearcherPool lending the searcher
+ * @member: the pool member, passed back to the @pool on release
+ * @database: the #XapianDatabase of the pool member
+ * @enquire: the #XapianEnquire of the pool member
+ * @parser: the #XapianQueryParser of the pool member
+ *
+ * Creates a new #XapianSearcher for a member of @pool.
+ *
+ * Returns: (transfer full): the newly created #XapianSearcher
+ */
+XapianSearcher *
+xapian_searcher_new (XapianSearcherPool *pool,
+                     gpointer            member,
+                     XapianDatabase     *database,
+                     XapianEnquire      *enquire,
+                     XapianQueryParser  *parser)
+{
+  XapianSearcher *res = static_cast<XapianSearcher *> (g_object_new (XAPIAN_TYPE_SEARCHER, NULL));
+  XapianSearcherPrivate *priv = XAPIAN_SEARCHER_GET_PRIVATE (res);
+
+  priv->pool = static_cast<XapianSearcherPool *> (g_object_ref (pool));
+  priv->member = member;
+  priv->database = database;
+  priv->enquire = enquire;
+  priv->parser = parser;
+
+  return res;
+}
+
+/**
+ * xapian_searcher_get_database:
+ * @searcher: a #XapianSearcher
+ *
+ * Retrieves the #XapianDatabase lent by @searcher.
+ *
+ * Returns: (transfer none) (nullable): the database, or %NULL if the
+ *   @searcher has been released
+ *
+ * Since: 2.0
+ */
+XapianDatabase *
+xapian_searcher_get_database (XapianSearcher *searcher)
+{
+  g_return_val_if_fail (XAPIAN_IS_SEARCHER (searcher), NULL);
+
+  XapianSearcherPrivate *priv = XAPIAN_SEARCHER_GET_PRIVATE (searcher);
+
+  return priv->database;
+}
+
+/**
+ * xapian_searcher_get_enquire:
+ * @searcher: a #XapianSearcher
+ *
+ * Retrieves the #XapianEnquire lent by @searcher.
+ *
+ * The enquire keeps the settings of its previous users, so you should
+ * set the query and any other option you need before using it.
+ *
+ * Returns: (transfer none) (nullable): the enquire, or %NULL if the
+ *   @searcher has been released
+ *
+ * Since: 2.0
+ */
+XapianEnquire *
+xapian_searcher_get_enquire (XapianSearcher *searcher)
+{
+  g_return_val_if_fail (XAPIAN_IS_SEARCHER (searcher), NULL);
+
+  XapianSearcherPrivate *priv = XAPIAN_SEARCHER_GET_PRIVATE (searcher);
+
+  return priv->enquire;
+}
+
+/**
+ * xapian_searcher_get_query_parser:
+ * @searcher: a #XapianSearcher
+ *
+ * Retrieves the #XapianQueryParser lent by @searcher.
+ *
+ * Unlike the enquire returned by xapian_searcher_get_enquire(), the
+ * query parser is replaced when @searcher is released, so it always
+ * starts with the default settings; the prefixes, stopper, range and
+ * field processors set on it are not seen by the next users of the
+ * pool, and must be set again after each acquisition.
+ *
+ * Returns: (transfer none) (nullable): the query parser, or %NULL if
+ *   the @searcher has been released
+ *
+ * Since: 2.0
+ */
+XapianQueryParser *
+xapian_searcher_get_query_parser (XapianSearcher *searcher)
+{
+  g_return_val_if_fail (XAPIAN_IS_SEARCHER (searcher), NULL);
+
+  XapianSearcherPrivate *priv = XAPIAN_SEARCHER_GET_PRIVATE (searcher);
+
+  return priv->parser;
+}
+
+/**
+ * xapian_searcher_release:
+ * @searcher: a #XapianSearcher
+ *
+ * Returns the objects lent by @searcher to their #XapianSearcherPool.
+ *
+ * This function is called automatically when the last reference on
+ * @searcher is released; calling it explicitly is useful in garbage
+ * collected languages. It is safe to call this function multiple times.
+ *
+ * Since: 2.0
+ */
+void
+xapian_searcher_release (XapianSearcher *searcher)
+{
+  g_return_if_fail (XAPIAN_IS_SEARCHER (searcher));
+
+  XapianSearcherPrivate *priv = XAPIAN_SEARCHER_GET_PRIVATE (searcher);
+
+  if (priv->pool == NULL)
+    return;
+
+  priv->database = NULL;
+  priv->enquire = NULL;
+  priv->parser = NULL;
+
+  xapian_searcher_pool_release_member (priv->pool, priv->member);
+  priv->member = NULL;
+
+  g_clear_object (&priv->pool);
+}
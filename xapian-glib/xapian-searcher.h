@@ -0,0 +1,54 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __XAPIAN_GLIB_SEARCHER_H__
+#define __XAPIAN_GLIB_SEARCHER_H__
+
+#if !defined(XAPIAN_GLIB_H_INSIDE) && !defined(XAPIAN_GLIB_COMPILATION)
+#error "Only <xapian-glib.h> can be included directly."
+#endif
+
+#include "xapian-glib-types.h"
+#include "xapian-database.h"
+#include "xapian-enquire.h"
+#include "xapian-query-parser.h"
+
+G_BEGIN_DECLS
+
+#define XAPIAN_TYPE_SEARCHER    (xapian_searcher_get_type())
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+G_DECLARE_DERIVABLE_TYPE (XapianSearcher, xapian_searcher, XAPIAN, SEARCHER, GObject)
+
+struct _XapianSearcherClass
+{
+  /*< private >*/
+  GObjectClass parent_instance;
+};
+
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianDatabase *        xapian_searcher_get_database            (XapianSearcher *searcher);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianEnquire *         xapian_searcher_get_enquire             (XapianSearcher *searcher);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+XapianQueryParser *     xapian_searcher_get_query_parser        (XapianSearcher *searcher);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+void                    xapian_searcher_release                 (XapianSearcher *searcher);
+
+G_END_DECLS
+
+#endif /* __XAPIAN_GLIB_SEARCHER_H__ */
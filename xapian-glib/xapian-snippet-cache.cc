@@ -0,0 +1,345 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:xapian-snippet-cache
+ * @Title: XapianSnippetCache
+ * @short_description: Cache for result snippets
+ *
+ * #XapianSnippetCache stores the snippets generated by
+ * xapian_mset_get_snippets(), keyed by the document identifier, the
+ * query that produced the #XapianMSet, and the parameters used to
+ * generate the snippet.
+ *
+ * Re-using the same #XapianSnippetCache when paginating through the
+ * results of a query avoids generating the same snippets multiple
+ * times.
+ *
+ * Once the cache is full, the least recently used snippets are
+ * discarded. It is safe to share a #XapianSnippetCache between
+ * multiple threads.
+ */
+
+#include "config.h"
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "xapian-snippet-cache-private.h"
+
+#define DEFAULT_MAX_SIZE        256
+
+class SnippetCacheData {
+    SnippetCacheData (const SnippetCacheData &aData);
+
+    void operator= (const SnippetCacheData &aData);
+
+    typedef std::list<std::pair<std::string, std::string> > Entries;
+
+    Entries mEntries;
+    std::unordered_map<std::string, Entries::iterator> mIndex;
+
+  public:
+    SnippetCacheData ()
+    {
+    }
+
+    bool lookup (const std::string &key,
+                 std::string       &snippet) {
+      auto it = mIndex.find (key);
+      if (it == mIndex.end ())
+        return false;
+
+      /* Move the entry to the front of the list */
+      mEntries.splice (mEntries.begin (), mEntries, it->second);
+      snippet = it->second->second;
+
+      return true;
+    }
+
+    void insert (const std::string &key,
+                 const std::string &snippet,
+                 size_t             max_size) {
+      auto it = mIndex.find (key);
+      if (it != mIndex.end ())
+        {
+          it->second->second = snippet;
+          mEntries.splice (mEntries.begin (), mEntries, it->second);
+          return;
+        }
+
+      while (!mEntries.empty () && mEntries.size () >= max_size)
+        {
+          mIndex.erase (mEntries.back ().first);
+          mEntries.pop_back ();
+        }
+
+      mEntries.emplace_front (key, snippet);
+      mIndex[key] = mEntries.begin ();
+    }
+
+    size_t size () const {
+      return mEntries.size ();
+    }
+
+    void clear () {
+      mIndex.clear ();
+      mEntries.clear ();
+    }
+};
+
+#define XAPIAN_SNIPPET_CACHE_GET_PRIVATE(obj) \
+  ((XapianSnippetCachePrivate *) xapian_snippet_cache_get_instance_private ((XapianSnippetCache *) (obj)))
+
+typedef struct {
+  SnippetCacheData *mData;
+
+  GMutex lock;
+
+  guint max_size;
+} XapianSnippetCachePrivate;
+
+enum {
+  PROP_0,
+
+  PROP_MAX_SIZE,
+
+  LAST_PROP
+};
+
+static GParamSpec *obj_props[LAST_PROP] = { NULL, };
+
+G_DEFINE_TYPE_WITH_PRIVATE (XapianSnippetCache, xapian_snippet_cache, G_TYPE_OBJECT)
+
+static void
+xapian_snippet_cache_finalize (GObject *gobject)
+{
+  XapianSnippetCachePrivate *priv = XAPIAN_SNIPPET_CACHE_GET_PRIVATE (gobject);
+
+  delete priv->mData;
+  g_mutex_clear (&priv->lock);
+
+  G_OBJECT_CLASS (xapian_snippet_cache_parent_class)->finalize (gobject);
+}
+
+static void
+xapian_snippet_cache_set_property (GObject      *gobject,
+                                   guint         prop_id,
+                                   const GValue *value,
+                                   GParamSpec   *pspec)
+{
+  XapianSnippetCachePrivate *priv = XAPIAN_SNIPPET_CACHE_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_MAX_SIZE:
+      priv->max_size = g_value_get_uint (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_snippet_cache_get_property (GObject    *gobject,
+                                   guint       prop_id,
+                                   GValue     *value,
+                                   GParamSpec *pspec)
+{
+  XapianSnippetCachePrivate *priv = XAPIAN_SNIPPET_CACHE_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_MAX_SIZE:
+      g_value_set_uint (value, priv->max_size);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_snippet_cache_class_init (XapianSnippetCacheClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  /**
+   * XapianSnippetCache:max-size:
+   *
+   * The maximum number of snippets stored inside the cache.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_MAX_SIZE] =
+    g_param_spec_uint ("max-size",
+                       "Max Size",
+                       "The maximum number of snippets in the cache",
+                       1, G_MAXUINT,
+                       DEFAULT_MAX_SIZE,
+                       (GParamFlags) (G_PARAM_READWRITE |
+                                      G_PARAM_CONSTRUCT_ONLY |
+                                      G_PARAM_STATIC_STRINGS));
+
+  gobject_class->set_property = xapian_snippet_cache_set_property;
+  gobject_class->get_property = xapian_snippet_cache_get_property;
+  gobject_class->finalize = xapian_snippet_cache_finalize;
+
+  g_object_class_install_properties (gobject_class, LAST_PROP, obj_props);
+}
+
+static void
+xapian_snippet_cache_init (XapianSnippetCache *self)
+{
+  XapianSnippetCachePrivate *priv = XAPIAN_SNIPPET_CACHE_GET_PRIVATE (self);
+
+  priv->mData = new SnippetCacheData ();
+  priv->max_size = DEFAULT_MAX_SIZE;
+
+  g_mutex_init (&priv->lock);
+}
+
+/*< private >
+ * xapian_snippet_cache_lookup:
+ * @cache: a #XapianSnippetCache
+ * @key: the key of the snippet
+ * @snippet: return location for the snippet
+ *
+ * Looks up the snippet for the given @key.
+ *
+ * Returns: %TRUE if the snippet was found
+ */
+gboolean
+xapian_snippet_cache_lookup (XapianSnippetCache *cache,
+                             const std::string  &key,
+                             std::string        &snippet)
+{
+  XapianSnippetCachePrivate *priv = XAPIAN_SNIPPET_CACHE_GET_PRIVATE (cache);
+
+  g_mutex_lock (&priv->lock);
+  bool res = priv->mData->lookup (key, snippet);
+  g_mutex_unlock (&priv->lock);
+
+  return res;
+}
+
+/*< private >
+ * xapian_snippet_cache_insert:
+ * @cache: a #XapianSnippetCache
+ * @key: the key of the snippet
+ * @snippet: the snippet
+ *
+ * Stores @snippet inside the @cache, discarding the least
+ * recently used snippet if the cache is full.
+ */
+void
+xapian_snippet_cache_insert (XapianSnippetCache *cache,
+                             const std::string  &key,
+                             const std::string  &snippet)
+{
+  XapianSnippetCachePrivate *priv = XAPIAN_SNIPPET_CACHE_GET_PRIVATE (cache);
+
+  g_mutex_lock (&priv->lock);
+  priv->mData->insert (key, snippet, priv->max_size);
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * xapian_snippet_cache_new:
+ * @max_size: the maximum number of snippets to store
+ *
+ * Creates a new #XapianSnippetCache.
+ *
+ * Returns: (transfer full): the newly created #XapianSnippetCache instance
+ *
+ * Since: 2.0
+ */
+XapianSnippetCache *
+xapian_snippet_cache_new (unsigned int max_size)
+{
+  g_return_val_if_fail (max_size > 0, NULL);
+
+  return static_cast<XapianSnippetCache *> (g_object_new (XAPIAN_TYPE_SNIPPET_CACHE,
+                                                          "max-size", max_size,
+                                                          NULL));
+}
+
+/**
+ * xapian_snippet_cache_get_max_size:
+ * @cache: a #XapianSnippetCache
+ *
+ * Retrieves the value of the #XapianSnippetCache:max-size property.
+ *
+ * Returns: the maximum number of snippets in the cache
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_snippet_cache_get_max_size (XapianSnippetCache *cache)
+{
+  g_return_val_if_fail (XAPIAN_IS_SNIPPET_CACHE (cache), 0);
+
+  XapianSnippetCachePrivate *priv = XAPIAN_SNIPPET_CACHE_GET_PRIVATE (cache);
+
+  return priv->max_size;
+}
+
+/**
+ * xapian_snippet_cache_get_size:
+ * @cache: a #XapianSnippetCache
+ *
+ * Retrieves the number of snippets currently stored in the @cache.
+ *
+ * Returns: the number of snippets
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_snippet_cache_get_size (XapianSnippetCache *cache)
+{
+  g_return_val_if_fail (XAPIAN_IS_SNIPPET_CACHE (cache), 0);
+
+  XapianSnippetCachePrivate *priv = XAPIAN_SNIPPET_CACHE_GET_PRIVATE (cache);
+
+  g_mutex_lock (&priv->lock);
+  unsigned int res = priv->mData->size ();
+  g_mutex_unlock (&priv->lock);
+
+  return res;
+}
+
+/**
+ * xapian_snippet_cache_clear:
+ * @cache: a #XapianSnippetCache
+ *
+ * Removes all the snippets from the @cache.
+ *
+ * Since: 2.0
+ */
+void
+xapian_snippet_cache_clear (XapianSnippetCache *cache)
+{
+  g_return_if_fail (XAPIAN_IS_SNIPPET_CACHE (cache));
+
+  XapianSnippetCachePrivate *priv = XAPIAN_SNIPPET_CACHE_GET_PRIVATE (cache);
+
+  g_mutex_lock (&priv->lock);
+  priv->mData->clear ();
+  g_mutex_unlock (&priv->lock);
+}
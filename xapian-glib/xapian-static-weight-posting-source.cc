@@ -0,0 +1,622 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-static-weight-posting-source
+ * @Title: XapianStaticWeightPostingSource
+ * @short_description: Posting source reading weights from a file
+ *
+ * #XapianStaticWeightPostingSource is a posting source which reads a
+ * query-independent weight for each document, like a PageRank-style
+ * score, from a memory mapped file.
+ *
+ * The file contains a dense array of weights indexed by document
+ * identifier, so looking up the weight of a document costs a single
+ * array access, instead of reading and unserialising a value from
+ * the database like #XapianValueWeightPostingSource does. The file
+ * also stores the maximum weight, which allows the matcher to skip
+ * documents that cannot make it into the results.
+ *
+ * The file is created by xapian_static_weight_posting_source_build_from_slot(),
+ * using the weights stored in a value slot of a #XapianDatabase with
+ * xapian_document_add_numeric_value(). The file is not updated
+ * automatically: it should be rebuilt every time documents are
+ * modified in the database. Documents added after the file was
+ * built have no weight, and are not returned by the posting source;
+ * documents removed from the database are skipped, even if the file
+ * still contains their weight.
+ *
+ * When serialised, for instance to be used by a remote database, the
+ * posting source only stores the absolute path of the weights file,
+ * which is memory mapped again when unserialising; serialised posting
+ * sources can open any file readable by the process, so they must
+ * only be accepted from trusted sources.
+ *
+ * |[<!-- language="C" -->
+ *   xapian_static_weight_posting_source_build_from_slot (db, RANK_SLOT,
+ *                                                        "rank.weights",
+ *                                                        &error);
+ *
+ *   XapianStaticWeightPostingSource *source =
+ *     xapian_static_weight_posting_source_new ("rank.weights", &error);
+ * ]|
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <xapian.h>
+
+#include "xapian-static-weight-posting-source.h"
+
+#include "xapian-database-private.h"
+#include "xapian-enums.h"
+#include "xapian-error-private.h"
+#include "xapian-posting-source-private.h"
+
+#define STATIC_WEIGHT_MAGIC             "XGSWGT\0\1"
+#define STATIC_WEIGHT_MAGIC_LEN         8
+#define STATIC_WEIGHT_BYTE_ORDER        0x01020304
+
+/* The weights file is made of a header, followed by one float for
+ * each document identifier between 1 and n_weights; documents without
+ * a weight are stored as NaN.
+ *
+ * All numbers are stored in the native byte order.
+ */
+typedef struct {
+  char magic[STATIC_WEIGHT_MAGIC_LEN];
+  guint32 byte_order;
+  guint32 n_weights;
+  guint32 n_present;
+  guint32 padding;
+  double max_weight;
+} StaticWeightHeader;
+
+static const StaticWeightHeader *
+static_weight_header_check (GBytes *bytes)
+{
+  gsize size = 0;
+  const char *data = static_cast<const char *> (g_bytes_get_data (bytes, &size));
+
+  if (size < sizeof (StaticWeightHeader))
+    return NULL;
+
+  const StaticWeightHeader *header = reinterpret_cast<const StaticWeightHeader *> (data);
+
+  if (memcmp (header->magic, STATIC_WEIGHT_MAGIC, STATIC_WEIGHT_MAGIC_LEN) != 0 ||
+      header->byte_order != STATIC_WEIGHT_BYTE_ORDER)
+    return NULL;
+
+  /* Use 64 bits to avoid overflows with corrupted headers */
+  if (sizeof (StaticWeightHeader) + (guint64) header->n_weights * sizeof (float) > size)
+    return NULL;
+
+  if (header->n_present > header->n_weights ||
+      !(header->max_weight >= 0))
+    return NULL;
+
+  return header;
+}
+
+static GBytes *
+static_weight_load (const char  *path,
+                    GError     **error)
+{
+  GMappedFile *mapped_file = g_mapped_file_new (path, FALSE, error);
+  if (mapped_file == NULL)
+    return NULL;
+
+  GBytes *bytes = g_mapped_file_get_bytes (mapped_file);
+  g_mapped_file_unref (mapped_file);
+
+  if (static_weight_header_check (bytes) == NULL)
+    {
+      g_set_error (error, XAPIAN_ERROR,
+                   XAPIAN_ERROR_DATABASE_CORRUPT,
+                   "The file '%s' is not a valid weights file",
+                   path);
+      g_bytes_unref (bytes);
+      return NULL;
+    }
+
+  return bytes;
+}
+
+class StaticWeightPostingSource : public Xapian::PostingSource {
+    std::string mPath;
+    GBytes *mBytes;
+
+    const float *mWeights;
+    Xapian::docid mNWeights;
+    Xapian::doccount mNPresent;
+    double mMaxWeight;
+
+    Xapian::docid mDocid;
+    Xapian::docid mLastDocid;
+    Xapian::doccount mDocCount;
+
+    /* Used to skip the documents removed from the database, if any */
+    Xapian::Database mDB;
+    Xapian::PostingIterator mAllDocs;
+    bool mHasRemovedDocs;
+
+    /* Returns the first document in the database starting from @did */
+    Xapian::docid next_present (Xapian::docid did) {
+      if (!mHasRemovedDocs)
+        return did;
+
+      mAllDocs.skip_to (did);
+      if (mAllDocs == mDB.postlist_end (""))
+        return mLastDocid + 1;
+
+      return *mAllDocs;
+    }
+
+    /* Moves to the first document starting from @did with a weight of
+     * at least @min_wt; documents with a lower weight cannot contribute
+     * to the results, so the matcher does not need to see them.
+     */
+    void advance (Xapian::docid did, double min_wt) {
+      while (did <= mLastDocid)
+        {
+          float weight = mWeights[did - 1];
+
+          if (isnan (weight) || weight < min_wt)
+            {
+              did++;
+              continue;
+            }
+
+          Xapian::docid present = next_present (did);
+          if (present == did)
+            break;
+
+          did = present;
+        }
+
+      mDocid = did;
+    }
+
+  public:
+    StaticWeightPostingSource (const std::string &aPath,
+                               GBytes            *aBytes)
+      : mPath (aPath),
+        mBytes (g_bytes_ref (aBytes)),
+        mDocid (0),
+        mLastDocid (0),
+        mDocCount (0),
+        mHasRemovedDocs (false)
+    {
+      const StaticWeightHeader *header = static_weight_header_check (mBytes);
+
+      g_assert (header != NULL);
+
+      mWeights = reinterpret_cast<const float *> (header + 1);
+      mNWeights = header->n_weights;
+      mNPresent = header->n_present;
+      mMaxWeight = header->max_weight;
+
+      set_maxweight (mMaxWeight);
+    }
+
+    ~StaticWeightPostingSource () {
+      g_bytes_unref (mBytes);
+    }
+
+    /* The weights are read-only, so clones can share them */
+    virtual Xapian::PostingSource *clone () const {
+      return new StaticWeightPostingSource (mPath, mBytes);
+    }
+
+    virtual std::string name () const {
+      return "XapianGlib::StaticWeightPostingSource";
+    }
+
+    /* Only the path is serialised; the weights are loaded again when
+     * unserialising, so the file must be accessible to the receiver.
+     * The path is absolute, so it does not depend on the current
+     * directory of the receiver.
+     */
+    virtual std::string serialise () const {
+      return mPath;
+    }
+
+    virtual Xapian::PostingSource *unserialise (const std::string &data) const {
+      if (!g_path_is_absolute (data.c_str ()))
+        throw Xapian::SerialisationError ("Bad serialised StaticWeightPostingSource");
+
+      GError *error = NULL;
+      GBytes *bytes = static_weight_load (data.c_str (), &error);
+
+      if (bytes == NULL)
+        {
+          std::string msg (error->message);
+
+          g_error_free (error);
+
+          throw Xapian::SerialisationError (msg);
+        }
+
+      StaticWeightPostingSource *res = new StaticWeightPostingSource (data, bytes);
+
+      g_bytes_unref (bytes);
+
+      return res;
+    }
+
+    virtual void init (const Xapian::Database &db) {
+      mDocid = 0;
+      mDocCount = db.get_doccount ();
+      mLastDocid = MIN (mNWeights, db.get_lastdocid ());
+
+      /* Only walk the list of documents if there are gaps in it */
+      mDB = db;
+      mHasRemovedDocs = mDocCount != db.get_lastdocid ();
+      if (mHasRemovedDocs)
+        mAllDocs = db.postlist_begin ("");
+
+      set_maxweight (mMaxWeight);
+    }
+
+    virtual Xapian::doccount get_termfreq_min () const {
+      return 0;
+    }
+
+    virtual Xapian::doccount get_termfreq_est () const {
+      return MIN (mNPresent, mDocCount);
+    }
+
+    virtual Xapian::doccount get_termfreq_max () const {
+      return MIN (mNPresent, mDocCount);
+    }
+
+    virtual void next (double min_wt) {
+      advance (mDocid + 1, min_wt);
+    }
+
+    virtual void skip_to (Xapian::docid did, double min_wt) {
+      if (did <= mDocid)
+        return;
+
+      advance (did, min_wt);
+    }
+
+    virtual bool check (Xapian::docid did, double min_wt) {
+      if (did <= mDocid)
+        return true;
+
+      mDocid = did;
+
+      if (did > mLastDocid)
+        return true;
+
+      /* If @did has no weight we are left at an indeterminate position,
+       * and the following call to next() moves past it.
+       */
+      float weight = mWeights[did - 1];
+
+      return !isnan (weight) && weight >= min_wt && next_present (did) == did;
+    }
+
+    virtual bool at_end () const {
+      return mDocid > mLastDocid;
+    }
+
+    virtual Xapian::docid get_docid () const {
+      return mDocid;
+    }
+
+    virtual double get_weight () const {
+      return mWeights[mDocid - 1];
+    }
+
+    virtual std::string get_description () const {
+      return "StaticWeightPostingSource()";
+    }
+};
+
+#define XAPIAN_STATIC_WEIGHT_POSTING_SOURCE_GET_PRIVATE(obj) \
+  ((XapianStaticWeightPostingSourcePrivate *) xapian_static_weight_posting_source_get_instance_private ((XapianStaticWeightPostingSource *) (obj)))
+
+typedef struct {
+  char *path;
+} XapianStaticWeightPostingSourcePrivate;
+
+enum {
+  PROP_0,
+
+  PROP_PATH,
+
+  LAST_PROP
+};
+
+static GParamSpec *obj_props[LAST_PROP] = { NULL, };
+
+static void initable_iface_init (GInitableIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (XapianStaticWeightPostingSource, xapian_static_weight_posting_source,
+                         XAPIAN_TYPE_POSTING_SOURCE,
+                         G_ADD_PRIVATE (XapianStaticWeightPostingSource)
+                         G_IMPLEMENT_INTERFACE (G_TYPE_INITABLE, initable_iface_init))
+
+static gboolean
+xapian_static_weight_posting_source_init_internal (GInitable    *self,
+                                                   GCancellable *cancellable,
+                                                   GError      **error)
+{
+  XapianStaticWeightPostingSourcePrivate *priv = XAPIAN_STATIC_WEIGHT_POSTING_SOURCE_GET_PRIVATE (self);
+
+  if (priv->path == NULL)
+    {
+      g_set_error_literal (error, XAPIAN_ERROR,
+                           XAPIAN_ERROR_INVALID_ARGUMENT,
+                           "A path to a weights file is required");
+      return FALSE;
+    }
+
+  GBytes *bytes = static_weight_load (priv->path, error);
+  if (bytes == NULL)
+    return FALSE;
+
+  /* The file exists, since we just loaded it; we store its canonical
+   * path, which is used when serialising the posting source
+   */
+  char *real_path = realpath (priv->path, NULL);
+  if (real_path == NULL)
+    {
+      int saved_errno = errno;
+
+      g_set_error (error, G_FILE_ERROR,
+                   g_file_error_from_errno (saved_errno),
+                   "Unable to resolve the path '%s': %s",
+                   priv->path,
+                   g_strerror (saved_errno));
+      g_bytes_unref (bytes);
+      return FALSE;
+    }
+
+  xapian_posting_source_set_internal (XAPIAN_POSTING_SOURCE (self),
+                                      new StaticWeightPostingSource (real_path, bytes));
+
+  free (real_path);
+  g_bytes_unref (bytes);
+
+  return TRUE;
+}
+
+static void
+initable_iface_init (GInitableIface *iface)
+{
+  iface->init = xapian_static_weight_posting_source_init_internal;
+}
+
+static void
+xapian_static_weight_posting_source_finalize (GObject *gobject)
+{
+  XapianStaticWeightPostingSourcePrivate *priv = XAPIAN_STATIC_WEIGHT_POSTING_SOURCE_GET_PRIVATE (gobject);
+
+  g_free (priv->path);
+
+  G_OBJECT_CLASS (xapian_static_weight_posting_source_parent_class)->finalize (gobject);
+}
+
+static void
+xapian_static_weight_posting_source_set_property (GObject      *gobject,
+                                                  guint         prop_id,
+                                                  const GValue *value,
+                                                  GParamSpec   *pspec)
+{
+  XapianStaticWeightPostingSourcePrivate *priv = XAPIAN_STATIC_WEIGHT_POSTING_SOURCE_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_PATH:
+      g_free (priv->path);
+      priv->path = g_value_dup_string (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_static_weight_posting_source_get_property (GObject    *gobject,
+                                                  guint       prop_id,
+                                                  GValue     *value,
+                                                  GParamSpec *pspec)
+{
+  XapianStaticWeightPostingSourcePrivate *priv = XAPIAN_STATIC_WEIGHT_POSTING_SOURCE_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_PATH:
+      g_value_set_string (value, priv->path);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_static_weight_posting_source_class_init (XapianStaticWeightPostingSourceClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  /**
+   * XapianStaticWeightPostingSource:path:
+   *
+   * The path of the file containing the weights.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_PATH] =
+    g_param_spec_string ("path",
+                         "Path",
+                         "The path of the weights file",
+                         NULL,
+                         (GParamFlags) (G_PARAM_READWRITE |
+                                        G_PARAM_CONSTRUCT_ONLY |
+                                        G_PARAM_STATIC_STRINGS));
+
+  gobject_class->set_property = xapian_static_weight_posting_source_set_property;
+  gobject_class->get_property = xapian_static_weight_posting_source_get_property;
+  gobject_class->finalize = xapian_static_weight_posting_source_finalize;
+
+  g_object_class_install_properties (gobject_class, LAST_PROP, obj_props);
+}
+
+static void
+xapian_static_weight_posting_source_init (XapianStaticWeightPostingSource *self)
+{
+}
+
+/**
+ * xapian_static_weight_posting_source_new:
+ * @path: the path of a weights file
+ * @error: return location for a #GError, or %NULL
+ *
+ * Creates a new #XapianStaticWeightPostingSource reading the weights
+ * from the file at @path, as created by
+ * xapian_static_weight_posting_source_build_from_slot().
+ *
+ * If the initializion failed, @error is set, and this function
+ * will return %NULL.
+ *
+ * Returns: (transfer full): the newly created #XapianStaticWeightPostingSource instance
+ *
+ * Since: 2.0
+ */
+XapianStaticWeightPostingSource *
+xapian_static_weight_posting_source_new (const char  *path,
+                                         GError     **error)
+{
+  g_return_val_if_fail (path != NULL, NULL);
+
+  return static_cast<XapianStaticWeightPostingSource *> (g_initable_new (XAPIAN_TYPE_STATIC_WEIGHT_POSTING_SOURCE,
+                                                                         NULL, error,
+                                                                         "path", path,
+                                                                         NULL));
+}
+
+/**
+ * xapian_static_weight_posting_source_get_path:
+ * @self: a #XapianStaticWeightPostingSource
+ *
+ * Retrieves the value of the #XapianStaticWeightPostingSource:path property.
+ *
+ * Returns: (transfer none): the path of the weights file
+ *
+ * Since: 2.0
+ */
+const char *
+xapian_static_weight_posting_source_get_path (XapianStaticWeightPostingSource *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_STATIC_WEIGHT_POSTING_SOURCE (self), NULL);
+
+  XapianStaticWeightPostingSourcePrivate *priv = XAPIAN_STATIC_WEIGHT_POSTING_SOURCE_GET_PRIVATE (self);
+
+  return priv->path;
+}
+
+/**
+ * xapian_static_weight_posting_source_build_from_slot:
+ * @db: a #XapianDatabase
+ * @slot: the value slot containing the weights
+ * @path: the path of the weights file
+ * @error: return location for a #GError, or %NULL
+ *
+ * Creates a weights file at @path, suitable for
+ * xapian_static_weight_posting_source_new(), using the weights stored
+ * in the given @slot of each document in @db.
+ *
+ * The weights should have been stored using xapian_document_add_numeric_value();
+ * negative weights are clamped to zero, and documents with an empty
+ * value have no weight.
+ *
+ * If @path already exists, it is replaced atomically; posting sources
+ * already using the file keep using the old weights.
+ *
+ * Returns: %TRUE if the file was created, and %FALSE otherwise
+ *
+ * Since: 2.0
+ */
+gboolean
+xapian_static_weight_posting_source_build_from_slot (XapianDatabase  *db,
+                                                     unsigned int     slot,
+                                                     const char      *path,
+                                                     GError         **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_DATABASE (db), FALSE);
+  g_return_val_if_fail (path != NULL, FALSE);
+
+  Xapian::Database *aDB = xapian_database_get_internal (db);
+  StaticWeightHeader header;
+  std::vector<float> weights;
+
+  memset (&header, 0, sizeof (header));
+  memcpy (header.magic, STATIC_WEIGHT_MAGIC, STATIC_WEIGHT_MAGIC_LEN);
+  header.byte_order = STATIC_WEIGHT_BYTE_ORDER;
+
+  try
+    {
+      weights.assign (aDB->get_lastdocid (), NAN);
+
+      for (Xapian::ValueIterator it = aDB->valuestream_begin (slot);
+           it != aDB->valuestream_end (slot);
+           ++it)
+        {
+          double value = Xapian::sortable_unserialise (*it);
+
+          if (isnan (value))
+            continue;
+
+          float weight = (float) CLAMP (value, 0.0, (double) G_MAXFLOAT);
+
+          weights[it.get_docid () - 1] = weight;
+
+          header.max_weight = MAX (header.max_weight, (double) weight);
+          header.n_present += 1;
+        }
+    }
+  catch (const Xapian::Error &err)
+    {
+      GError *internal_error = NULL;
+
+      xapian_error_to_gerror (err, &internal_error);
+      g_propagate_error (error, internal_error);
+
+      return FALSE;
+    }
+
+  header.n_weights = weights.size ();
+
+  std::string data (reinterpret_cast<const char *> (&header), sizeof (header));
+  data.append (reinterpret_cast<const char *> (weights.data ()),
+               weights.size () * sizeof (float));
+
+  return g_file_set_contents (path, data.data (), data.size (), error);
+}
@@ -0,0 +1,281 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-term-field-processor
+ * @Title: XapianTermFieldProcessor
+ * @short_description: Map a field to a single term
+ *
+ * #XapianTermFieldProcessor is a #XapianFieldProcessor which turns the
+ * whole value of a field into a single term, by prepending the
+ * #XapianTermFieldProcessor:prefix to it.
+ *
+ * Unlike the fields added with xapian_query_parser_add_boolean_prefix(),
+ * the value is used verbatim, which makes this processor suitable for
+ * looking up documents by an exact identifier; if
+ * #XapianTermFieldProcessor:lowercase is set, the value is converted
+ * to lower case first, which is useful for tags.
+ *
+ * |[<!-- language="C" -->
+ *   XapianTermFieldProcessor *processor =
+ *     xapian_term_field_processor_new ("Q", FALSE);
+ *
+ *   xapian_query_parser_add_field_processor (parser, "id",
+ *                                            XAPIAN_FIELD_PROCESSOR (processor),
+ *                                            TRUE);
+ * ]|
+ */
+
+#include "config.h"
+
+#include <string>
+
+#include <xapian.h>
+
+#include "xapian-term-field-processor.h"
+
+#include "xapian-field-processor-private.h"
+
+#define XAPIAN_TERM_FIELD_PROCESSOR_GET_PRIVATE(obj) \
+  ((XapianTermFieldProcessorPrivate *) xapian_term_field_processor_get_instance_private ((XapianTermFieldProcessor *) (obj)))
+
+class TermFieldProcessor : public Xapian::FieldProcessor {
+    std::string mPrefix;
+    bool mLowercase;
+
+  public:
+    TermFieldProcessor (const std::string &aPrefix,
+                        bool               aLowercase)
+      : mPrefix (aPrefix), mLowercase (aLowercase)
+    {
+    }
+
+    virtual Xapian::Query operator() (const std::string &value) {
+      if (!mLowercase)
+        return Xapian::Query (mPrefix + value);
+
+      char *lower = g_utf8_strdown (value.data (), value.size ());
+      Xapian::Query res (mPrefix + lower);
+
+      g_free (lower);
+
+      return res;
+    }
+};
+
+typedef struct {
+  char *prefix;
+  gboolean lowercase;
+} XapianTermFieldProcessorPrivate;
+
+enum {
+  PROP_0,
+
+  PROP_PREFIX,
+  PROP_LOWERCASE,
+
+  LAST_PROP
+};
+
+static GParamSpec *obj_props[LAST_PROP] = { NULL, };
+
+G_DEFINE_TYPE_WITH_PRIVATE (XapianTermFieldProcessor, xapian_term_field_processor,
+                            XAPIAN_TYPE_FIELD_PROCESSOR)
+
+static void
+xapian_term_field_processor_constructed (GObject *gobject)
+{
+  XapianTermFieldProcessorPrivate *priv = XAPIAN_TERM_FIELD_PROCESSOR_GET_PRIVATE (gobject);
+
+  Xapian::FieldProcessor *aFieldProcessor =
+    new TermFieldProcessor (priv->prefix != NULL ? priv->prefix : "",
+                            priv->lowercase);
+
+  xapian_field_processor_set_internal (XAPIAN_FIELD_PROCESSOR (gobject), aFieldProcessor);
+
+  G_OBJECT_CLASS (xapian_term_field_processor_parent_class)->constructed (gobject);
+}
+
+static void
+xapian_term_field_processor_finalize (GObject *gobject)
+{
+  XapianTermFieldProcessorPrivate *priv = XAPIAN_TERM_FIELD_PROCESSOR_GET_PRIVATE (gobject);
+
+  g_free (priv->prefix);
+
+  G_OBJECT_CLASS (xapian_term_field_processor_parent_class)->finalize (gobject);
+}
+
+static void
+xapian_term_field_processor_set_property (GObject      *gobject,
+                                          guint         prop_id,
+                                          const GValue *value,
+                                          GParamSpec   *pspec)
+{
+  XapianTermFieldProcessorPrivate *priv = XAPIAN_TERM_FIELD_PROCESSOR_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_PREFIX:
+      g_free (priv->prefix);
+      priv->prefix = g_value_dup_string (value);
+      break;
+
+    case PROP_LOWERCASE:
+      priv->lowercase = g_value_get_boolean (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_term_field_processor_get_property (GObject    *gobject,
+                                          guint       prop_id,
+                                          GValue     *value,
+                                          GParamSpec *pspec)
+{
+  XapianTermFieldProcessorPrivate *priv = XAPIAN_TERM_FIELD_PROCESSOR_GET_PRIVATE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_PREFIX:
+      g_value_set_string (value, priv->prefix);
+      break;
+
+    case PROP_LOWERCASE:
+      g_value_set_boolean (value, priv->lowercase);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+xapian_term_field_processor_class_init (XapianTermFieldProcessorClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  /**
+   * XapianTermFieldProcessor:prefix:
+   *
+   * The prefix prepended to the value of the field.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_PREFIX] =
+    g_param_spec_string ("prefix",
+                         "Prefix",
+                         "The prefix of the terms",
+                         NULL,
+                         (GParamFlags) (G_PARAM_READWRITE |
+                                        G_PARAM_CONSTRUCT_ONLY |
+                                        G_PARAM_STATIC_STRINGS));
+
+  /**
+   * XapianTermFieldProcessor:lowercase:
+   *
+   * Whether the value of the field is converted to lower case.
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_LOWERCASE] =
+    g_param_spec_boolean ("lowercase",
+                          "Lowercase",
+                          "Whether the values are converted to lower case",
+                          FALSE,
+                          (GParamFlags) (G_PARAM_READWRITE |
+                                         G_PARAM_CONSTRUCT_ONLY |
+                                         G_PARAM_STATIC_STRINGS));
+
+  gobject_class->constructed = xapian_term_field_processor_constructed;
+  gobject_class->set_property = xapian_term_field_processor_set_property;
+  gobject_class->get_property = xapian_term_field_processor_get_property;
+  gobject_class->finalize = xapian_term_field_processor_finalize;
+
+  g_object_class_install_properties (gobject_class, LAST_PROP, obj_props);
+}
+
+static void
+xapian_term_field_processor_init (XapianTermFieldProcessor *self)
+{
+}
+
+/**
+ * xapian_term_field_processor_new:
+ * @prefix: the prefix of the terms
+ * @lowercase: whether the values are converted to lower case
+ *
+ * Creates a new #XapianTermFieldProcessor.
+ *
+ * Returns: (transfer full): the newly created #XapianTermFieldProcessor instance
+ *
+ * Since: 2.0
+ */
+XapianTermFieldProcessor *
+xapian_term_field_processor_new (const char *prefix,
+                                 gboolean    lowercase)
+{
+  g_return_val_if_fail (prefix != NULL, NULL);
+
+  return static_cast<XapianTermFieldProcessor *> (g_object_new (XAPIAN_TYPE_TERM_FIELD_PROCESSOR,
+                                                                "prefix", prefix,
+                                                                "lowercase", lowercase,
+                                                                NULL));
+}
+
+/**
+ * xapian_term_field_processor_get_prefix:
+ * @self: a #XapianTermFieldProcessor
+ *
+ * Retrieves the value of the #XapianTermFieldProcessor:prefix property.
+ *
+ * Returns: (transfer none): the prefix of the terms
+ *
+ * Since: 2.0
+ */
+const char *
+xapian_term_field_processor_get_prefix (XapianTermFieldProcessor *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_TERM_FIELD_PROCESSOR (self), NULL);
+
+  XapianTermFieldProcessorPrivate *priv = XAPIAN_TERM_FIELD_PROCESSOR_GET_PRIVATE (self);
+
+  return priv->prefix;
+}
+
+/**
+ * xapian_term_field_processor_get_lowercase:
+ * @self: a #XapianTermFieldProcessor
+ *
+ * Retrieves the value of the #XapianTermFieldProcessor:lowercase property.
+ *
+ * Returns: %TRUE if the values are converted to lower case
+ *
+ * Since: 2.0
+ */
+gboolean
+xapian_term_field_processor_get_lowercase (XapianTermFieldProcessor *self)
+{
+  g_return_val_if_fail (XAPIAN_IS_TERM_FIELD_PROCESSOR (self), FALSE);
+
+  XapianTermFieldProcessorPrivate *priv = XAPIAN_TERM_FIELD_PROCESSOR_GET_PRIVATE (self);
+
+  return priv->lowercase;
+}
@@ -24,6 +24,12 @@
 
 #include "config.h"
 
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
 #include <xapian.h>
 
 #include "xapian-term-generator.h"
@@ -36,12 +42,32 @@
 #include "xapian-stopper-private.h"
 #include "xapian-writable-database.h"
 
+/* The default maximum length of a word, as used by Xapian::TermGenerator */
+#define DEFAULT_MAX_WORD_LENGTH         64
+
+/* The size of each read when indexing a stream */
+#define INDEX_STREAM_CHUNK_SIZE         (64 * 1024)
+
+/* The schema of a field, as set by xapian_term_generator_add_field() */
+struct TermGeneratorField {
+  std::string prefix;
+  unsigned int wdf_inc;
+  bool positional;
+  XapianStemStrategy strategy;
+};
+
 #define XAPIAN_TERM_GENERATOR_GET_PRIVATE(obj) \
   ((XapianTermGeneratorPrivate *) xapian_term_generator_get_instance_private ((XapianTermGenerator *) (obj)))
 
 typedef struct {
   Xapian::TermGenerator *mGenerator;
 
+  /* Prefixes indexed without positional information */
+  std::set<std::string> *mPositionless;
+
+  /* The field schema used by xapian_term_generator_index_fields() */
+  std::map<std::string, TermGeneratorField> *mFields;
+
   XapianWritableDatabase *database;
 
   XapianStem *stemmer;
@@ -50,6 +76,16 @@ typedef struct {
   XapianStopper *stopper;
 
   XapianDocument *document;
+
+  guint max_word_length;
+  guint max_terms;
+
+  /* Terms and postings dropped from the current document because of
+   * the max-terms limit; words longer than max-word-length are skipped
+   * by Xapian::TermGenerator without notice, so they are not counted
+   */
+  guint capped_terms;
+  guint capped_tokens;
 } XapianTermGeneratorPrivate;
 
 enum {
@@ -61,6 +97,8 @@ enum {
   PROP_DATABASE,
   PROP_DOCUMENT,
   PROP_FLAGS,
+  PROP_MAX_WORD_LENGTH,
+  PROP_MAX_TERMS,
 
   LAST_PROP
 };
@@ -75,6 +113,8 @@ xapian_term_generator_finalize (GObject *gobject)
   XapianTermGeneratorPrivate *priv = XAPIAN_TERM_GENERATOR_GET_PRIVATE (gobject);
 
   delete priv->mGenerator;
+  delete priv->mPositionless;
+  delete priv->mFields;
 
   G_OBJECT_CLASS (xapian_term_generator_parent_class)->finalize (gobject);
 }
@@ -123,7 +163,15 @@ xapian_term_generator_set_property (GObject      *gobject,
       break;
 
     case PROP_FLAGS:
-      xapian_term_generator_set_flags (self, (XapianTermGeneratorFeature) g_value_get_enum (value));
+      xapian_term_generator_set_flags (self, (XapianTermGeneratorFeature) g_value_get_flags (value));
+      break;
+
+    case PROP_MAX_WORD_LENGTH:
+      xapian_term_generator_set_max_word_length (self, g_value_get_uint (value));
+      break;
+
+    case PROP_MAX_TERMS:
+      xapian_term_generator_set_max_terms (self, g_value_get_uint (value));
       break;
 
     default:
@@ -161,6 +209,14 @@ xapian_term_generator_get_property (GObject    *gobject,
       g_value_set_object (value, priv->document);
       break;
 
+    case PROP_MAX_WORD_LENGTH:
+      g_value_set_uint (value, priv->max_word_length);
+      break;
+
+    case PROP_MAX_TERMS:
+      g_value_set_uint (value, priv->max_terms);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -259,6 +315,48 @@ xapian_term_generator_class_init (XapianTermGeneratorClass *klass)
                         (GParamFlags) (G_PARAM_WRITABLE |
                                       G_PARAM_STATIC_STRINGS));
 
+  /**
+   * XapianTermGenerator:max-word-length:
+   *
+   * The maximum length of a word, in bytes; longer words, like the
+   * ones found in encoded data or long URLs, are not indexed.
+   *
+   * The skipped words are not counted by
+   * xapian_term_generator_get_capped_terms_count().
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_MAX_WORD_LENGTH] =
+    g_param_spec_uint ("max-word-length",
+                       "Max Word Length",
+                       "The maximum length of an indexed word",
+                       1, G_MAXUINT,
+                       DEFAULT_MAX_WORD_LENGTH,
+                       (GParamFlags) (G_PARAM_READWRITE |
+                                      G_PARAM_STATIC_STRINGS));
+
+  /**
+   * XapianTermGenerator:max-terms:
+   *
+   * The maximum number of distinct terms in the current document, or
+   * 0 for no limit.
+   *
+   * Once the limit is reached, new terms are dropped, keeping the
+   * ones appearing first in the text; terms already in the document
+   * are still indexed. See
+   * xapian_term_generator_get_capped_terms_count().
+   *
+   * Since: 2.0
+   */
+  obj_props[PROP_MAX_TERMS] =
+    g_param_spec_uint ("max-terms",
+                       "Max Terms",
+                       "The maximum number of distinct terms in a document",
+                       0, G_MAXUINT,
+                       0,
+                       (GParamFlags) (G_PARAM_READWRITE |
+                                      G_PARAM_STATIC_STRINGS));
+
   gobject_class->set_property = xapian_term_generator_set_property;
   gobject_class->get_property = xapian_term_generator_get_property;
   gobject_class->dispose = xapian_term_generator_dispose;
@@ -273,6 +371,206 @@ xapian_term_generator_init (XapianTermGenerator *self)
   XapianTermGeneratorPrivate *priv = XAPIAN_TERM_GENERATOR_GET_PRIVATE (self);
 
   priv->mGenerator = new Xapian::TermGenerator ();
+  priv->mPositionless = new std::set<std::string> ();
+  priv->mFields = new std::map<std::string, TermGeneratorField> ();
+
+  priv->max_word_length = DEFAULT_MAX_WORD_LENGTH;
+}
+
+static Xapian::TermGenerator::stem_strategy
+stem_strategy_to_internal (XapianStemStrategy strategy)
+{
+  switch (strategy)
+    {
+    case XAPIAN_STEM_STRATEGY_STEM_NONE:
+      return Xapian::TermGenerator::STEM_NONE;
+
+    case XAPIAN_STEM_STRATEGY_STEM_SOME:
+      return Xapian::TermGenerator::STEM_SOME;
+
+    case XAPIAN_STEM_STRATEGY_STEM_ALL:
+      return Xapian::TermGenerator::STEM_ALL;
+
+    case XAPIAN_STEM_STRATEGY_STEM_ALL_Z:
+      return Xapian::TermGenerator::STEM_ALL_Z;
+
+    default:
+      g_assert_not_reached ();
+    }
+
+  return Xapian::TermGenerator::STEM_NONE;
+}
+
+static void
+index_text_unlimited (XapianTermGeneratorPrivate *priv,
+                      const std::string          &text,
+                      unsigned int                wdf_inc,
+                      const std::string          &prefix,
+                      bool                        positional)
+{
+  if (positional)
+    priv->mGenerator->index_text (text, wdf_inc, prefix);
+  else
+    priv->mGenerator->index_text_without_positions (text, wdf_inc, prefix);
+}
+
+/* A term of the scratch document which is not in the current document */
+typedef struct {
+  Xapian::termpos first_pos;
+  std::string term;
+  Xapian::termcount wdf;
+  std::vector<Xapian::termpos> positions;
+} NewTerm;
+
+/* Indexes @text into the current document, honouring the max-terms
+ * limit.
+ *
+ * Each word generates at most two terms (the unstemmed and the stemmed
+ * forms, or a unigram and a bigram for CJK text), so as long as the
+ * document has room for two terms per character, @text is indexed
+ * directly.
+ *
+ * Otherwise, the text is indexed into a scratch document first, and
+ * then merged into the current document; this is the only way to
+ * filter the output of Xapian::TermGenerator. New terms are admitted
+ * in the order in which they appear in @text, so the scratch document
+ * always stores positions, even if they are not copied; terms without
+ * positions, like the stemmed forms, are admitted last.
+ */
+static void
+index_text_internal (XapianTermGeneratorPrivate *priv,
+                     const std::string          &text,
+                     unsigned int                wdf_inc,
+                     const std::string          &prefix,
+                     bool                        positional)
+{
+  if (priv->max_terms == 0)
+    {
+      index_text_unlimited (priv, text, wdf_inc, prefix, positional);
+      return;
+    }
+
+  Xapian::Document target = priv->mGenerator->get_document ();
+  Xapian::termcount n_terms = target.termlist_count ();
+  guint64 max_new_terms = 2 * (guint64) g_utf8_strlen (text.data (), text.size ());
+
+  if (n_terms + max_new_terms <= priv->max_terms)
+    {
+      index_text_unlimited (priv, text, wdf_inc, prefix, positional);
+      return;
+    }
+
+  Xapian::Document scratch;
+
+  /* Changing the document resets the term position */
+  Xapian::termpos pos = priv->mGenerator->get_termpos ();
+
+  priv->mGenerator->set_document (scratch);
+  priv->mGenerator->set_termpos (pos);
+
+  try
+    {
+      index_text_unlimited (priv, text, wdf_inc, prefix, true);
+    }
+  catch (...)
+    {
+      priv->mGenerator->set_document (target);
+      priv->mGenerator->set_termpos (pos);
+      throw;
+    }
+
+  /* Indexing without positions does not move the term position */
+  if (positional)
+    pos = priv->mGenerator->get_termpos ();
+
+  priv->mGenerator->set_document (target);
+  priv->mGenerator->set_termpos (pos);
+
+  /* Both term lists are sorted, so we can find the terms already in
+   * the document, which can always be updated, in a single pass
+   */
+  std::vector<NewTerm> new_terms;
+  Xapian::TermIterator existing = target.termlist_begin ();
+  Xapian::TermIterator existing_end = target.termlist_end ();
+
+  for (Xapian::TermIterator it = scratch.termlist_begin (); it != scratch.termlist_end (); ++it)
+    {
+      const std::string term = *it;
+
+      while (existing != existing_end && *existing < term)
+        ++existing;
+
+      if (existing != existing_end && *existing == term)
+        {
+          /* Copy the positions without touching the wdf, and then add
+           * the whole wdf at once
+           */
+          if (positional)
+            {
+              for (Xapian::PositionIterator p = it.positionlist_begin (); p != it.positionlist_end (); ++p)
+                target.add_posting (term, *p, 0);
+            }
+
+          target.add_term (term, it.get_wdf ());
+          continue;
+        }
+
+      NewTerm new_term;
+
+      Xapian::PositionIterator first = it.positionlist_begin ();
+
+      new_term.first_pos = first != it.positionlist_end () ? *first : G_MAXUINT32;
+      new_term.term = term;
+      new_term.wdf = it.get_wdf ();
+
+      if (positional)
+        {
+          for (Xapian::PositionIterator p = it.positionlist_begin (); p != it.positionlist_end (); ++p)
+            new_term.positions.push_back (*p);
+        }
+
+      new_terms.push_back (std::move (new_term));
+    }
+
+  std::stable_sort (new_terms.begin (), new_terms.end (),
+                    [] (const NewTerm &a, const NewTerm &b) {
+                      return a.first_pos < b.first_pos;
+                    });
+
+  for (const NewTerm &new_term : new_terms)
+    {
+      if (n_terms >= priv->max_terms)
+        {
+          priv->capped_terms += 1;
+          priv->capped_tokens += new_term.wdf;
+          continue;
+        }
+
+      for (Xapian::termpos p : new_term.positions)
+        target.add_posting (new_term.term, p, 0);
+
+      target.add_term (new_term.term, new_term.wdf);
+      n_terms += 1;
+    }
+}
+
+/* Reports an error from the functions that cannot return a GError,
+ * like indexing CJK words with a Xapian built without ICU
+ */
+static void
+report_index_error (const Xapian::Error &err)
+{
+  g_critical ("Unable to index text: %s", err.get_description ().c_str ());
+}
+
+/* Indexes @text, with or without positions depending on @prefix */
+static void
+index_text_for_prefix (XapianTermGeneratorPrivate *priv,
+                       const std::string          &text,
+                       unsigned int                wdf_inc,
+                       const std::string          &prefix)
+{
+  index_text_internal (priv, text, wdf_inc, prefix, priv->mPositionless->count (prefix) == 0);
 }
 
 /**
@@ -335,31 +633,7 @@ xapian_term_generator_set_stemming_strategy (XapianTermGenerator *generator,
 
   priv->stemming_strategy = strategy;
 
-  Xapian::TermGenerator::stem_strategy stem_strategy;
-
-  switch (priv->stemming_strategy)
-    {
-    case XAPIAN_STEM_STRATEGY_STEM_NONE:
-      stem_strategy = Xapian::TermGenerator::STEM_NONE;
-      break;
-
-    case XAPIAN_STEM_STRATEGY_STEM_SOME:
-      stem_strategy = Xapian::TermGenerator::STEM_SOME;
-      break;
-
-    case XAPIAN_STEM_STRATEGY_STEM_ALL:
-      stem_strategy = Xapian::TermGenerator::STEM_ALL;
-      break;
-
-    case XAPIAN_STEM_STRATEGY_STEM_ALL_Z:
-      stem_strategy = Xapian::TermGenerator::STEM_ALL_Z;
-      break;
-
-    default:
-      g_assert_not_reached ();
-    }
-
-  priv->mGenerator->set_stemming_strategy (stem_strategy);
+  priv->mGenerator->set_stemming_strategy (stem_strategy_to_internal (strategy));
 
   g_object_notify_by_pspec (G_OBJECT (generator), obj_props[PROP_STEMMING_STRATEGY]);
 }
@@ -430,6 +704,10 @@ xapian_term_generator_set_database (XapianTermGenerator    *generator,
  *
  * Sets the generator's flags
  *
+ * The CJK flags should match the ones used by the #XapianQueryParser
+ * when parsing queries against the indexed data, otherwise CJK text
+ * in queries will not match the indexed terms.
+ *
  * Since: 2.0
  */
 void
@@ -442,10 +720,166 @@ xapian_term_generator_set_flags (XapianTermGenerator        *generator,
 
   if ((flags & XAPIAN_TERM_GENERATOR_FEATURE_SPELLING) != 0)
     real_flags |= Xapian::TermGenerator::FLAG_SPELLING;
+  if ((flags & XAPIAN_TERM_GENERATOR_FEATURE_CJK_NGRAM) != 0)
+    real_flags |= Xapian::TermGenerator::FLAG_CJK_NGRAM;
+  if ((flags & XAPIAN_TERM_GENERATOR_FEATURE_CJK_WORDS) != 0)
+    real_flags |= Xapian::TermGenerator::FLAG_CJK_WORDS;
 
   priv->mGenerator->set_flags(static_cast<Xapian::TermGenerator::flags>(real_flags));
 }
 
+/**
+ * xapian_term_generator_set_max_word_length:
+ * @generator: a #XapianTermGenerator
+ * @max_word_length: the maximum length of a word, in bytes
+ *
+ * Sets the maximum length of the words indexed by @generator; longer
+ * words are ignored.
+ *
+ * Since: 2.0
+ */
+void
+xapian_term_generator_set_max_word_length (XapianTermGenerator *generator,
+                                           unsigned int         max_word_length)
+{
+  g_return_if_fail (XAPIAN_IS_TERM_GENERATOR (generator));
+  g_return_if_fail (max_word_length > 0);
+
+  XapianTermGeneratorPrivate *priv = XAPIAN_TERM_GENERATOR_GET_PRIVATE (generator);
+
+  if (priv->max_word_length == max_word_length)
+    return;
+
+  priv->max_word_length = max_word_length;
+
+  priv->mGenerator->set_max_word_length (max_word_length);
+
+  g_object_notify_by_pspec (G_OBJECT (generator), obj_props[PROP_MAX_WORD_LENGTH]);
+}
+
+/**
+ * xapian_term_generator_get_max_word_length:
+ * @generator: a #XapianTermGenerator
+ *
+ * Retrieves the value of the #XapianTermGenerator:max-word-length property.
+ *
+ * Returns: the maximum length of a word, in bytes
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_term_generator_get_max_word_length (XapianTermGenerator *generator)
+{
+  g_return_val_if_fail (XAPIAN_IS_TERM_GENERATOR (generator), 0);
+
+  XapianTermGeneratorPrivate *priv = XAPIAN_TERM_GENERATOR_GET_PRIVATE (generator);
+
+  return priv->max_word_length;
+}
+
+/**
+ * xapian_term_generator_set_max_terms:
+ * @generator: a #XapianTermGenerator
+ * @max_terms: the maximum number of distinct terms, or 0 for no limit
+ *
+ * Sets the maximum number of distinct terms in the current document.
+ *
+ * Setting a limit bounds the cost of indexing machine generated
+ * content; it also makes indexing slightly slower, as the terms have
+ * to be checked before being added to the document.
+ *
+ * Since: 2.0
+ */
+void
+xapian_term_generator_set_max_terms (XapianTermGenerator *generator,
+                                     unsigned int         max_terms)
+{
+  g_return_if_fail (XAPIAN_IS_TERM_GENERATOR (generator));
+
+  XapianTermGeneratorPrivate *priv = XAPIAN_TERM_GENERATOR_GET_PRIVATE (generator);
+
+  if (priv->max_terms == max_terms)
+    return;
+
+  priv->max_terms = max_terms;
+
+  g_object_notify_by_pspec (G_OBJECT (generator), obj_props[PROP_MAX_TERMS]);
+}
+
+/**
+ * xapian_term_generator_get_max_terms:
+ * @generator: a #XapianTermGenerator
+ *
+ * Retrieves the value of the #XapianTermGenerator:max-terms property.
+ *
+ * Returns: the maximum number of distinct terms, or 0 for no limit
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_term_generator_get_max_terms (XapianTermGenerator *generator)
+{
+  g_return_val_if_fail (XAPIAN_IS_TERM_GENERATOR (generator), 0);
+
+  XapianTermGeneratorPrivate *priv = XAPIAN_TERM_GENERATOR_GET_PRIVATE (generator);
+
+  return priv->max_terms;
+}
+
+/**
+ * xapian_term_generator_get_capped_terms_count:
+ * @generator: a #XapianTermGenerator
+ *
+ * Retrieves the number of distinct terms that were not added to the
+ * current document because of the #XapianTermGenerator:max-terms limit.
+ *
+ * Only the terms dropped by the #XapianTermGenerator:max-terms limit
+ * are counted; the words skipped because they are longer than the
+ * #XapianTermGenerator:max-word-length limit are not.
+ *
+ * The counter is reset by xapian_term_generator_set_document().
+ *
+ * Returns: the number of dropped terms
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_term_generator_get_capped_terms_count (XapianTermGenerator *generator)
+{
+  g_return_val_if_fail (XAPIAN_IS_TERM_GENERATOR (generator), 0);
+
+  XapianTermGeneratorPrivate *priv = XAPIAN_TERM_GENERATOR_GET_PRIVATE (generator);
+
+  return priv->capped_terms;
+}
+
+/**
+ * xapian_term_generator_get_capped_tokens_count:
+ * @generator: a #XapianTermGenerator
+ *
+ * Retrieves the number of tokens that were not added to the current
+ * document because of the #XapianTermGenerator:max-terms limit; this
+ * is the sum of the WDF of the dropped terms.
+ *
+ * Like xapian_term_generator_get_capped_terms_count(), this does not
+ * include the words longer than #XapianTermGenerator:max-word-length.
+ *
+ * The counter is reset by xapian_term_generator_set_document().
+ *
+ * Returns: the number of dropped tokens
+ *
+ * Since: 2.0
+ */
+unsigned int
+xapian_term_generator_get_capped_tokens_count (XapianTermGenerator *generator)
+{
+  g_return_val_if_fail (XAPIAN_IS_TERM_GENERATOR (generator), 0);
+
+  XapianTermGeneratorPrivate *priv = XAPIAN_TERM_GENERATOR_GET_PRIVATE (generator);
+
+  return priv->capped_tokens;
+}
+
 /**
  * xapian_term_generator_set_document:
  * @generator: a #XapianTermGenerator
@@ -462,6 +896,9 @@ xapian_term_generator_set_document (XapianTermGenerator *generator,
 
   XapianTermGeneratorPrivate *priv = XAPIAN_TERM_GENERATOR_GET_PRIVATE (generator);
 
+  priv->capped_terms = 0;
+  priv->capped_tokens = 0;
+
   if (priv->document == document)
     return;
 
@@ -504,6 +941,17 @@ xapian_term_generator_index_text (XapianTermGenerator *generator,
  * Unlike xapian_term_generator_index_text(), this function also
  * allows setting the WDF increment and the default prefix for
  * the indexed data.
+ *
+ * If @prefix has been marked as not positional using
+ * xapian_term_generator_set_prefix_positional(), @data is indexed
+ * without positional information.
+ *
+ * If indexing fails, for instance because the
+ * %XAPIAN_TERM_GENERATOR_FEATURE_CJK_WORDS flag is set and Xapian
+ * was built without ICU support, a critical warning is emitted and
+ * the current document may be left partially indexed; use
+ * xapian_term_generator_index_stream() or
+ * xapian_term_generator_index_fields() to handle the error instead.
  */
 void
 xapian_term_generator_index_text_full (XapianTermGenerator *generator,
@@ -519,5 +967,445 @@ xapian_term_generator_index_text_full (XapianTermGenerator *generator,
 
   XapianTermGeneratorPrivate *priv = XAPIAN_TERM_GENERATOR_GET_PRIVATE (generator);
 
-  priv->mGenerator->index_text (std::string (data), wdf_inc, std::string (prefix));
+  try
+    {
+      index_text_for_prefix (priv, std::string (data), wdf_inc, std::string (prefix));
+    }
+  catch (const Xapian::Error &err)
+    {
+      report_index_error (err);
+    }
+}
+
+/**
+ * xapian_term_generator_index_text_without_positions:
+ * @generator: a #XapianTermGenerator
+ * @data: the data to be indexed
+ * @wdf_inc: the increment of the WDF
+ * @prefix: (nullable): the default prefix for the indexed data
+ *
+ * Indexes @data into the current document, without storing
+ * positional information.
+ *
+ * Terms indexed this way cannot be matched by phrase or proximity
+ * queries, but take less space in the database; this is useful for
+ * data like tags, URLs or metadata.
+ *
+ * Errors are reported like in xapian_term_generator_index_text_full().
+ *
+ * Since: 2.0
+ */
+void
+xapian_term_generator_index_text_without_positions (XapianTermGenerator *generator,
+                                                    const char          *data,
+                                                    unsigned int         wdf_inc,
+                                                    const char          *prefix)
+{
+  g_return_if_fail (XAPIAN_IS_TERM_GENERATOR (generator));
+  g_return_if_fail (data != NULL);
+
+  if (prefix == NULL)
+    prefix = "";
+
+  XapianTermGeneratorPrivate *priv = XAPIAN_TERM_GENERATOR_GET_PRIVATE (generator);
+
+  try
+    {
+      index_text_internal (priv, std::string (data), wdf_inc, std::string (prefix), false);
+    }
+  catch (const Xapian::Error &err)
+    {
+      report_index_error (err);
+    }
+}
+
+/**
+ * xapian_term_generator_set_prefix_positional:
+ * @generator: a #XapianTermGenerator
+ * @prefix: (nullable): a term prefix
+ * @positional: whether to store positional information
+ *
+ * Sets whether the data indexed with the given @prefix should
+ * store positional information.
+ *
+ * All prefixes are positional by default; data indexed using
+ * xapian_term_generator_index_text_full() or
+ * xapian_term_generator_index_stream() with a prefix that is not
+ * positional is indexed as if using
+ * xapian_term_generator_index_text_without_positions().
+ *
+ * Since: 2.0
+ */
+void
+xapian_term_generator_set_prefix_positional (XapianTermGenerator *generator,
+                                             const char          *prefix,
+                                             gboolean             positional)
+{
+  g_return_if_fail (XAPIAN_IS_TERM_GENERATOR (generator));
+
+  if (prefix == NULL)
+    prefix = "";
+
+  XapianTermGeneratorPrivate *priv = XAPIAN_TERM_GENERATOR_GET_PRIVATE (generator);
+
+  if (positional)
+    priv->mPositionless->erase (std::string (prefix));
+  else
+    priv->mPositionless->insert (std::string (prefix));
+}
+
+/**
+ * xapian_term_generator_get_prefix_positional:
+ * @generator: a #XapianTermGenerator
+ * @prefix: (nullable): a term prefix
+ *
+ * Checks whether the data indexed with the given @prefix stores
+ * positional information.
+ *
+ * See also: xapian_term_generator_set_prefix_positional()
+ *
+ * Returns: %TRUE if the @prefix is positional
+ *
+ * Since: 2.0
+ */
+gboolean
+xapian_term_generator_get_prefix_positional (XapianTermGenerator *generator,
+                                             const char          *prefix)
+{
+  g_return_val_if_fail (XAPIAN_IS_TERM_GENERATOR (generator), TRUE);
+
+  if (prefix == NULL)
+    prefix = "";
+
+  XapianTermGeneratorPrivate *priv = XAPIAN_TERM_GENERATOR_GET_PRIVATE (generator);
+
+  return priv->mPositionless->count (std::string (prefix)) == 0;
+}
+
+/* Returns the length of the prefix of @data that can be indexed without
+ * splitting a word, or a UTF-8 sequence, in two; the rest is carried
+ * over to the next chunk of the stream.
+ */
+static gsize
+find_chunk_boundary (const char *data,
+                     gsize       len)
+{
+  /* ASCII whitespace never appears inside a multi-byte UTF-8
+   * sequence, so we can split right after it
+   */
+  for (gsize i = len; i > 0; i--)
+    {
+      if (g_ascii_isspace (data[i - 1]))
+        return i;
+    }
+
+  /* Without ASCII whitespace (e.g. in CJK text) we look for Unicode
+   * spaces and punctuation, like U+3000 IDEOGRAPHIC SPACE or U+3002
+   * IDEOGRAPHIC FULL STOP, which do not belong to a word either
+   */
+  const char *end = data + len;
+  const char *p = end;
+
+  while ((p = g_utf8_find_prev_char (data, p)) != NULL)
+    {
+      gunichar c = g_utf8_get_char_validated (p, end - p);
+
+      /* Skip the incomplete character at the end, and invalid data */
+      if (c == (gunichar) -1 || c == (gunichar) -2)
+        continue;
+
+      if (g_unichar_isspace (c) || g_unichar_ispunct (c))
+        return g_utf8_next_char (p) - data;
+    }
+
+  /* If there is no separator at all we split before the last
+   * character, which may be incomplete
+   */
+  gsize i = len;
+  while (i > 0 && len - i < 3 && (data[i - 1] & 0xc0) == 0x80)
+    i--;
+
+  if (i > 0 && (data[i - 1] & 0xc0) == 0xc0)
+    i--;
+
+  return i;
+}
+
+/**
+ * xapian_term_generator_index_stream:
+ * @generator: a #XapianTermGenerator
+ * @stream: a #GInputStream containing UTF-8 text
+ * @wdf_inc: the increment of the WDF
+ * @prefix: (nullable): the default prefix for the indexed data
+ * @cancellable: (nullable): a #GCancellable
+ * @error: return location for a #GError
+ *
+ * Indexes the contents of @stream into the current document.
+ *
+ * Unlike xapian_term_generator_index_text_full(), this function does
+ * not need to hold the whole text in memory: @stream is read and
+ * indexed in fixed size chunks. Words and UTF-8 sequences spanning
+ * two chunks are kept intact, and the term positions are the same
+ * as if the whole contents of @stream were indexed at once.
+ *
+ * Like xapian_term_generator_index_text_full(), this function honours
+ * the positional setting of @prefix.
+ *
+ * The @stream is not closed by this function. If reading from @stream
+ * fails, the text read until then has already been added to the
+ * current document, which is left partially indexed.
+ *
+ * Returns: %TRUE if the whole @stream was indexed, and %FALSE otherwise
+ *
+ * Since: 2.0
+ */
+gboolean
+xapian_term_generator_index_stream (XapianTermGenerator *generator,
+                                    GInputStream        *stream,
+                                    unsigned int         wdf_inc,
+                                    const char          *prefix,
+                                    GCancellable        *cancellable,
+                                    GError             **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_TERM_GENERATOR (generator), FALSE);
+  g_return_val_if_fail (G_IS_INPUT_STREAM (stream), FALSE);
+  g_return_val_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable), FALSE);
+  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  if (prefix == NULL)
+    prefix = "";
+
+  XapianTermGeneratorPrivate *priv = XAPIAN_TERM_GENERATOR_GET_PRIVATE (generator);
+
+  std::string aPrefix (prefix);
+  std::string buffer;
+  std::string text;
+
+  buffer.reserve (INDEX_STREAM_CHUNK_SIZE * 2);
+
+  try
+    {
+      while (TRUE)
+        {
+          gsize pending = buffer.size ();
+
+          buffer.resize (pending + INDEX_STREAM_CHUNK_SIZE);
+
+          gssize n_read = g_input_stream_read (stream,
+                                               &buffer[pending],
+                                               INDEX_STREAM_CHUNK_SIZE,
+                                               cancellable,
+                                               error);
+          if (n_read < 0)
+            return FALSE;
+
+          buffer.resize (pending + n_read);
+
+          if (n_read == 0)
+            break;
+
+          gsize boundary = find_chunk_boundary (buffer.data (), buffer.size ());
+
+          /* The buffer only contains the start of a character */
+          if (boundary == 0)
+            continue;
+
+          text.assign (buffer, 0, boundary);
+          buffer.erase (0, boundary);
+
+          index_text_for_prefix (priv, text, wdf_inc, aPrefix);
+        }
+
+      if (!buffer.empty ())
+        index_text_for_prefix (priv, buffer, wdf_inc, aPrefix);
+    }
+  catch (const Xapian::Error &err)
+    {
+      GError *internal_error = NULL;
+
+      xapian_error_to_gerror (err, &internal_error);
+      g_propagate_error (error, internal_error);
+
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+/**
+ * xapian_term_generator_add_field:
+ * @generator: a #XapianTermGenerator
+ * @field: the name of the field
+ * @prefix: (nullable): the prefix for the terms of the field
+ * @wdf_inc: the increment of the WDF
+ * @positional: whether to store positional information
+ * @strategy: the stemming strategy for the field
+ *
+ * Adds a field to the schema used by xapian_term_generator_index_fields().
+ *
+ * If a field with the same name already exists, it is replaced.
+ *
+ * Since: 2.0
+ */
+void
+xapian_term_generator_add_field (XapianTermGenerator *generator,
+                                 const char          *field,
+                                 const char          *prefix,
+                                 unsigned int         wdf_inc,
+                                 gboolean             positional,
+                                 XapianStemStrategy   strategy)
+{
+  g_return_if_fail (XAPIAN_IS_TERM_GENERATOR (generator));
+  g_return_if_fail (field != NULL);
+  g_return_if_fail ((guint) strategy <= XAPIAN_STEM_STRATEGY_STEM_ALL_Z);
+
+  if (prefix == NULL)
+    prefix = "";
+
+  XapianTermGeneratorPrivate *priv = XAPIAN_TERM_GENERATOR_GET_PRIVATE (generator);
+
+  TermGeneratorField &spec = (*priv->mFields)[std::string (field)];
+  spec.prefix = prefix;
+  spec.wdf_inc = wdf_inc;
+  spec.positional = positional != FALSE;
+  spec.strategy = strategy;
+}
+
+/**
+ * xapian_term_generator_index_fields:
+ * @generator: a #XapianTermGenerator
+ * @fields: a #GVariant of type `a{sv}`
+ * @error: return location for a #GError
+ *
+ * Indexes multiple fields into the current document in a single call.
+ *
+ * The keys of @fields must be the names of fields added using
+ * xapian_term_generator_add_field(); each value must be either a string
+ * (`s`) or an array of strings (`as`). Each value is indexed using the
+ * prefix, WDF increment, positional setting and stemming strategy of
+ * its field.
+ *
+ * The term position is increased between values, so phrase searches
+ * do not match across them.
+ *
+ * If @fields contains an unknown field, or a value of the wrong type,
+ * nothing is indexed and an error is returned.
+ *
+ * If @fields is a floating reference, it is consumed.
+ *
+ * Returns: %TRUE if the fields were indexed, and %FALSE otherwise
+ *
+ * Since: 2.0
+ */
+gboolean
+xapian_term_generator_index_fields (XapianTermGenerator *generator,
+                                    GVariant            *fields,
+                                    GError             **error)
+{
+  g_return_val_if_fail (XAPIAN_IS_TERM_GENERATOR (generator), FALSE);
+  g_return_val_if_fail (fields != NULL, FALSE);
+  g_return_val_if_fail (g_variant_is_of_type (fields, G_VARIANT_TYPE_VARDICT), FALSE);
+  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  XapianTermGeneratorPrivate *priv = XAPIAN_TERM_GENERATOR_GET_PRIVATE (generator);
+
+  g_variant_ref_sink (fields);
+
+  /* Validate everything first, so we do not leave a partially
+   * indexed document behind
+   */
+  std::vector<std::pair<const TermGeneratorField *, GVariant *> > values;
+  gboolean res = TRUE;
+
+  gsize n_fields = g_variant_n_children (fields);
+  values.reserve (n_fields);
+
+  for (gsize i = 0; i < n_fields; i++)
+    {
+      const char *name;
+      GVariant *value;
+
+      g_variant_get_child (fields, i, "{&sv}", &name, &value);
+
+      auto it = priv->mFields->find (std::string (name));
+      if (it == priv->mFields->end ())
+        {
+          g_set_error (error, XAPIAN_ERROR,
+                       XAPIAN_ERROR_INVALID_ARGUMENT,
+                       "Unknown field '%s'",
+                       name);
+          g_variant_unref (value);
+          res = FALSE;
+          break;
+        }
+
+      if (!g_variant_is_of_type (value, G_VARIANT_TYPE_STRING) &&
+          !g_variant_is_of_type (value, G_VARIANT_TYPE_STRING_ARRAY))
+        {
+          g_set_error (error, XAPIAN_ERROR,
+                       XAPIAN_ERROR_INVALID_ARGUMENT,
+                       "Invalid value of type '%s' for field '%s'",
+                       g_variant_get_type_string (value),
+                       name);
+          g_variant_unref (value);
+          res = FALSE;
+          break;
+        }
+
+      values.push_back (std::make_pair (&it->second, value));
+    }
+
+  if (res)
+    {
+      try
+        {
+          for (auto &entry : values)
+            {
+              const TermGeneratorField *spec = entry.first;
+              GVariant *value = entry.second;
+              gsize n_strings = 1;
+
+              if (g_variant_is_of_type (value, G_VARIANT_TYPE_STRING_ARRAY))
+                n_strings = g_variant_n_children (value);
+
+              priv->mGenerator->set_stemming_strategy (stem_strategy_to_internal (spec->strategy));
+
+              for (gsize i = 0; i < n_strings; i++)
+                {
+                  gsize len;
+
+                  /* Released even if indexing throws */
+                  g_autoptr(GVariant) child =
+                    g_variant_is_of_type (value, G_VARIANT_TYPE_STRING_ARRAY)
+                      ? g_variant_get_child_value (value, i)
+                      : g_variant_ref (value);
+
+                  const char *str = g_variant_get_string (child, &len);
+
+                  if (priv->mGenerator->get_termpos () != 0)
+                    priv->mGenerator->increase_termpos ();
+
+                  index_text_internal (priv, std::string (str, len), spec->wdf_inc, spec->prefix, spec->positional);
+                }
+            }
+        }
+      catch (const Xapian::Error &err)
+        {
+          GError *internal_error = NULL;
+
+          xapian_error_to_gerror (err, &internal_error);
+          g_propagate_error (error, internal_error);
+
+          res = FALSE;
+        }
+
+      priv->mGenerator->set_stemming_strategy (stem_strategy_to_internal (priv->stemming_strategy));
+    }
+
+  for (auto &entry : values)
+    g_variant_unref (entry.second);
+
+  g_variant_unref (fields);
+
+  return res;
 }
@@ -56,6 +56,20 @@ XAPIAN_GLIB_AVAILABLE_IN_2_0
 void                    xapian_term_generator_set_stopper               (XapianTermGenerator    *generator,
                                                                          XapianStopper          *stopper);
 XAPIAN_GLIB_AVAILABLE_IN_2_0
+void                    xapian_term_generator_set_max_word_length       (XapianTermGenerator    *generator,
+                                                                         unsigned int            max_word_length);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+unsigned int            xapian_term_generator_get_max_word_length       (XapianTermGenerator    *generator);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+void                    xapian_term_generator_set_max_terms             (XapianTermGenerator    *generator,
+                                                                         unsigned int            max_terms);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+unsigned int            xapian_term_generator_get_max_terms             (XapianTermGenerator    *generator);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+unsigned int            xapian_term_generator_get_capped_terms_count    (XapianTermGenerator    *generator);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+unsigned int            xapian_term_generator_get_capped_tokens_count   (XapianTermGenerator    *generator);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
 void                    xapian_term_generator_set_document              (XapianTermGenerator    *generator,
                                                                          XapianDocument         *document);
 XAPIAN_GLIB_AVAILABLE_IN_2_0
@@ -66,6 +80,36 @@ void                    xapian_term_generator_index_text_full           (XapianT
                                                                          const char             *data,
                                                                          unsigned int            wdf_inc,
                                                                          const char             *prefix);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+void                    xapian_term_generator_index_text_without_positions (XapianTermGenerator *generator,
+                                                                            const char          *data,
+                                                                            unsigned int         wdf_inc,
+                                                                            const char          *prefix);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+void                    xapian_term_generator_set_prefix_positional     (XapianTermGenerator    *generator,
+                                                                         const char             *prefix,
+                                                                         gboolean                positional);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+gboolean                xapian_term_generator_get_prefix_positional     (XapianTermGenerator    *generator,
+                                                                         const char             *prefix);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+gboolean                xapian_term_generator_index_stream              (XapianTermGenerator    *generator,
+                                                                         GInputStream           *stream,
+                                                                         unsigned int            wdf_inc,
+                                                                         const char             *prefix,
+                                                                         GCancellable           *cancellable,
+                                                                         GError                **error);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+void                    xapian_term_generator_add_field                 (XapianTermGenerator    *generator,
+                                                                         const char             *field,
+                                                                         const char             *prefix,
+                                                                         unsigned int            wdf_inc,
+                                                                         gboolean                positional,
+                                                                         XapianStemStrategy      strategy);
+XAPIAN_GLIB_AVAILABLE_IN_2_0
+gboolean                xapian_term_generator_index_fields              (XapianTermGenerator    *generator,
+                                                                         GVariant               *fields,
+                                                                         GError                **error);
 
 G_END_DECLS
 
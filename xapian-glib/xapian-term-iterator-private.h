@@ -18,8 +18,10 @@
 #define __XAPIAN_GLIB_TERM_ITERATOR_PRIVATE_H__
 
 #include <xapian.h>
+#include "xapian-database.h"
 #include "xapian-term-iterator.h"
 
-XapianTermIterator *    xapian_term_iterator_new        (const Xapian::TermIterator &it);
+XapianTermIterator *    xapian_term_iterator_new        (const Xapian::TermIterator &it,
+                                                         XapianDatabase             *database);
 
 #endif /* __XAPIAN_GLIB_TERM_ITERATOR_PRIVATE_H__ */
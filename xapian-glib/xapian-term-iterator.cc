@@ -17,7 +17,7 @@
 #include <config.h>
 
 #include "xapian-term-iterator-private.h"
-#include "xapian-error-private.h"
+#include "xapian-database-private.h"
 
 #include <xapian/iterator.h>
 
@@ -99,6 +99,9 @@ class IteratorData {
 
 typedef struct {
   IteratorData *data;
+
+  /* The database the terms are read from, if any */
+  XapianDatabase *database;
 } XapianTermIteratorPrivate;
 
 #define XAPIAN_TERM_ITERATOR_GET_PRIVATE(obj) \
@@ -113,6 +116,8 @@ xapian_term_iterator_finalize (GObject *gobject)
 
   delete priv->data;
 
+  g_clear_object (&priv->database);
+
   G_OBJECT_CLASS (xapian_term_iterator_parent_class)->finalize (gobject);
 }
 
@@ -132,15 +137,20 @@ xapian_term_iterator_init (XapianTermIterator *self)
 /*< private >
  * xapian_term_iterator_new:
  * @it: a Xapian::TermIterator
+ * @database: (nullable): the #XapianDatabase the terms are read from
  *
  * Creates a new #XapianTermIterator from the given `Xapian::TermIterator` instance.
  *
+ * The errors thrown while reading from @database are reported using
+ * xapian_database_error_to_gerror().
+ *
  * Returns: (transfer full): the newly created #XapianTermIterator
  *
  * Since: 2.0
  */
 XapianTermIterator *
-xapian_term_iterator_new (const Xapian::TermIterator &it)
+xapian_term_iterator_new (const Xapian::TermIterator &it,
+                          XapianDatabase             *database)
 {
   XapianTermIterator *iter;
   XapianTermIteratorPrivate *priv;
@@ -149,6 +159,9 @@ xapian_term_iterator_new (const Xapian::TermIterator &it)
   priv = XAPIAN_TERM_ITERATOR_GET_PRIVATE (iter);
   priv->data->set_iterator (it);
 
+  if (database != NULL)
+    priv->database = static_cast<XapianDatabase *> (g_object_ref (database));
+
   return iter;
 }
 
@@ -221,10 +234,7 @@ xapian_term_iterator_get_wdf (XapianTermIterator *iter,
     }
   catch (const Xapian::Error &err)
     {
-      GError *internal_error = NULL;
-
-      xapian_error_to_gerror (err, &internal_error);
-      g_propagate_error (error, internal_error);
+      xapian_database_error_to_gerror (priv->database, err, error);
 
       return 0;
     }
@@ -259,10 +269,7 @@ xapian_term_iterator_get_term_freq (XapianTermIterator *iter,
     }
   catch (const Xapian::Error &err)
     {
-      GError *internal_error = NULL;
-
-      xapian_error_to_gerror (err, &internal_error);
-      g_propagate_error (error, internal_error);
+      xapian_database_error_to_gerror (priv->database, err, error);
 
       return FALSE;
     }
@@ -0,0 +1,189 @@
+/* Copyright 2014  Endless Mobile
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * SECTION:xapian-value-map-posting-source
+ * @Title: XapianValueMapPostingSource
+ * @short_description: Posting source mapping values to weights
+ *
+ * #XapianValueMapPostingSource is a posting source which assigns a
+ * weight to each document according to the value stored in a slot,
+ * using a table of mappings between values and weights.
+ *
+ * This can be used to boost documents by category, for instance to
+ * give a higher weight to documents in a preferred language:
+ *
+ * |[<!-- language="C" -->
+ *   XapianValueMapPostingSource *source =
+ *     xapian_value_map_posting_source_new (LANGUAGE_SLOT, &error);
+ *
+ *   xapian_value_map_posting_source_add_mapping (source, "en", 2.0);
+ *   xapian_value_map_posting_source_add_mapping (source, "fr", 1.0);
+ *   xapian_value_map_posting_source_set_default_weight (source, 0.5);
+ * ]|
+ *
+ * Documents with a value that does not have a mapping receive the
+ * default weight; documents without a value in the slot are not
+ * returned by the posting source.
+ *
+ * The mappings should be set before using the posting source in a
+ * #XapianQuery.
+ */
+
+#include "config.h"
+#include "xapian-posting-source-private.h"
+#include "xapian-value-map-posting-source.h"
+#include "xapian-error-private.h"
+
+static void initable_iface_init (GInitableIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (XapianValueMapPostingSource, xapian_value_map_posting_source,
+                         XAPIAN_TYPE_VALUE_POSTING_SOURCE,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_INITABLE, initable_iface_init))
+
+static gboolean
+xapian_value_map_posting_source_init_internal (GInitable    *self,
+                                               GCancellable *cancellable,
+                                               GError      **error)
+{
+  XapianPostingSource *pSource = XAPIAN_POSTING_SOURCE (self);
+  Xapian::ValueMapPostingSource *mValueMapPostingSource;
+
+  try
+    {
+      guint slot = xapian_value_posting_source_get_slot (XAPIAN_VALUE_POSTING_SOURCE (self));
+      mValueMapPostingSource = new Xapian::ValueMapPostingSource (slot);
+      xapian_posting_source_set_internal (pSource, (Xapian::PostingSource *) mValueMapPostingSource);
+
+      return TRUE;
+    }
+  catch (const Xapian::Error &err)
+    {
+      GError *internal_error = NULL;
+
+      xapian_error_to_gerror (err, &internal_error);
+      g_propagate_error (error, internal_error);
+
+      return FALSE;
+    }
+}
+
+static void
+initable_iface_init (GInitableIface *iface)
+{
+  iface->init = xapian_value_map_posting_source_init_internal;
+}
+
+static void
+xapian_value_map_posting_source_init (XapianValueMapPostingSource *self)
+{
+}
+
+static void
+xapian_value_map_posting_source_class_init (XapianValueMapPostingSourceClass *klass)
+{
+}
+
+static Xapian::ValueMapPostingSource *
+xapian_value_map_posting_source_get_internal (XapianValueMapPostingSource *self)
+{
+  Xapian::PostingSource *aPostingSource = xapian_posting_source_get_internal (XAPIAN_POSTING_SOURCE (self));
+
+  return static_cast<Xapian::ValueMapPostingSource *> (aPostingSource);
+}
+
+/**
+ * xapian_value_map_posting_source_new:
+ * @slot: slot in the database entries to use for source
+ * @error: return location for a #GError, or %NULL
+ *
+ * If the initializion failed, @error is set, and this function
+ * will return %NULL.
+ *
+ * Returns: (transfer full): the newly created #XapianValueMapPostingSource instance
+ *
+ * Since: 2.0
+ */
+XapianValueMapPostingSource *
+xapian_value_map_posting_source_new (unsigned int   slot,
+                                     GError       **error)
+{
+  return static_cast<XapianValueMapPostingSource *> (g_initable_new (XAPIAN_TYPE_VALUE_MAP_POSTING_SOURCE,
+                                                                     NULL, error,
+                                                                     "slot", slot,
+                                                                     NULL));
+}
+
+/**
+ * xapian_value_map_posting_source_add_mapping:
+ * @self: a #XapianValueMapPostingSource
+ * @value: a value stored in the slot
+ * @weight: the weight of the documents with the given @value
+ *
+ * Adds a mapping between @value and @weight, replacing any existing
+ * mapping for @value.
+ *
+ * Since: 2.0
+ */
+void
+xapian_value_map_posting_source_add_mapping (XapianValueMapPostingSource *self,
+                                             const char                  *value,
+                                             double                       weight)
+{
+  g_return_if_fail (XAPIAN_IS_VALUE_MAP_POSTING_SOURCE (self));
+  g_return_if_fail (value != NULL);
+  g_return_if_fail (weight >= 0);
+
+  xapian_value_map_posting_source_get_internal (self)->add_mapping (std::string (value), weight);
+}
+
+/**
+ * xapian_value_map_posting_source_clear_mappings:
+ * @self: a #XapianValueMapPostingSource
+ *
+ * Removes all the mappings added with
+ * xapian_value_map_posting_source_add_mapping().
+ *
+ * Since: 2.0
+ */
+void
+xapian_value_map_posting_source_clear_mappings (XapianValueMapPostingSource *self)
+{
+  g_return_if_fail (XAPIAN_IS_VALUE_MAP_POSTING_SOURCE (self));
+
+  xapian_value_map_posting_source_get_internal (self)->clear_mappings ();
+}
+
+/**
+ * xapian_value_map_posting_source_set_default_weight:
+ * @self: a #XapianValueMapPostingSource
+ * @weight: the default weight
+ *
+ * Sets the weight of the documents with a value that does not have
+ * a mapping. The default weight is 0.
+ *
+ * Since: 2.0
+ */
+void
+xapian_value_map_posting_source_set_default_weight (XapianValueMapPostingSource *self,
+                                                    double                       weight)
+{
+  g_return_if_fail (XAPIAN_IS_VALUE_MAP_POSTING_SOURCE (self));
+  g_return_if_fail (weight >= 0);
+
+  xapian_value_map_posting_source_get_internal (self)->set_default_weight (weight);
+}